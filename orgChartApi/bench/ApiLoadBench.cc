@@ -0,0 +1,123 @@
+// Closed-loop HTTP load against a running org_chart server: every connection
+// sends its next request as soon as the previous response arrived, for the
+// given number of seconds, and the rate and latencies of the 200 responses
+// are reported. Run the server with ../config.sqlite.json to measure the
+// HTTP/JSON path on one box without a database server.
+//
+// It registers a user of its own to get a token, so every run starts from
+// the same state only when the server was restarted before it.
+//
+//   api_load_bench [path] [connections] [seconds] [http://host:port]
+
+#include <drogon/HttpClient.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Worker {
+    HttpClientPtr client;
+    std::vector<double> latencies;
+    size_t errors{0};
+};
+
+std::string registerUser(const std::string &host, trantor::EventLoop *loop) {
+    auto client = HttpClient::newHttpClient(host, loop);
+    Json::Value user;
+    user["username"] = "load" + std::to_string(Clock::now().time_since_epoch().count());
+    user["password"] = "load-password";
+    auto req = HttpRequest::newHttpJsonRequest(user);
+    req->setMethod(Post);
+    req->setPath("/auth/register");
+    auto result = client->sendRequest(req, 10.0);
+    if (result.first != ReqResult::Ok || result.second->getStatusCode() != k201Created) {
+        std::fprintf(stderr, "can't register a user at %s\n", host.c_str());
+        std::exit(1);
+    }
+    return (*result.second->getJsonObject())["token"].asString();
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty())
+        return 0.0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string path = argc > 1 ? argv[1] : "/persons";
+    size_t connections = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+    std::string host = argc > 4 ? argv[4] : "http://127.0.0.1:3000";
+
+    trantor::EventLoopThreadPool loops(4, "ApiLoad");
+    loops.start();
+    auto token = registerUser(host, loops.getNextLoop());
+
+    std::vector<Worker> workers(connections);
+    std::atomic<size_t> running{connections};
+    std::promise<void> done;
+    auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    auto send = std::make_shared<std::function<void(Worker &)>>();
+    *send = [&, sendPtr = std::weak_ptr<std::function<void(Worker &)>>(send)](Worker &worker) {
+        if (Clock::now() >= end) {
+            if (--running == 0)
+                done.set_value();
+            return;
+        }
+        auto req = HttpRequest::newHttpRequest();
+        req->setPath(path);
+        req->addHeader("Authorization", "Bearer " + token);
+        auto start = Clock::now();
+        worker.client->sendRequest(req, [&worker, start, sendPtr](ReqResult result, const HttpResponsePtr &resp) {
+            if (result == ReqResult::Ok && resp->getStatusCode() == k200OK) {
+                worker.latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            } else {
+                ++worker.errors;
+            }
+            if (auto next = sendPtr.lock())
+                (*next)(worker);
+        });
+    };
+    auto start = Clock::now();
+    for (auto &worker : workers) {
+        worker.client = HttpClient::newHttpClient(host, loops.getNextLoop());
+        // each client runs on one loop, so its worker is only touched there
+        worker.client->getLoop()->queueInLoop([&worker, send]() { (*send)(worker); });
+    }
+    done.get_future().wait();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    size_t errors = 0;
+    for (auto &worker : workers) {
+        latencies.insert(latencies.end(), worker.latencies.begin(), worker.latencies.end());
+        errors += worker.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("path:          %s\n", path.c_str());
+    std::printf("connections:   %zu\n", connections);
+    std::printf("requests/sec:  %.0f\n", latencies.size() / elapsed);
+    std::printf("errors:        %zu\n", errors);
+    std::printf("p50 ms:        %.2f\n", percentile(latencies, 0.50));
+    std::printf("p99 ms:        %.2f\n", percentile(latencies, 0.99));
+    std::printf("max ms:        %.2f\n", latencies.empty() ? 0.0 : latencies.back());
+    for (auto &worker : workers) {
+        worker.client.reset();
+    }
+    return 0;
+}
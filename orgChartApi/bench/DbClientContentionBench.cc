@@ -0,0 +1,87 @@
+// Measures how fast 1 to 64 threads can submit queries to one DbClient at
+// the same time, and the end to end rate until all of them completed. Every
+// query is a trivial "select 1" against in-memory SQLite connections, so the
+// submit rate is dominated by handing queries to connections and queueing
+// them while all connections are busy.
+//
+// Also checks that every submitted query completes exactly once.
+//
+//   dbclient_contention_bench [connections] [queries per round]
+
+#include <drogon/orm/DbClient.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t connections = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    size_t queries = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    auto client = DbClient::newSqlite3Client("filename=:memory:", connections);
+    // Wait until every connection is open
+    for (size_t i = 0; i < connections; ++i) {
+        client->execSqlSync("select 1");
+    }
+
+    std::printf("%8s %14s %14s %10s\n", "threads", "submitted/sec", "completed/sec", "failed");
+    bool ok = true;
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        size_t perThread = queries / threads;
+        size_t total = perThread * threads;
+        std::atomic<size_t> completed{0};
+        std::atomic<size_t> failed{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        auto done = [&]() {
+            if (completed.fetch_add(1) + 1 == total) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_one();
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> callers;
+        for (size_t t = 0; t < threads; ++t) {
+            callers.emplace_back([&]() {
+                for (size_t i = 0; i < perThread; ++i) {
+                    client->execSqlAsync(
+                        "select 1", [&](const Result &) { done(); },
+                        [&](const DrogonDbException &) {
+                            ++failed;
+                            done();
+                        });
+                }
+            });
+        }
+        for (auto &caller : callers) {
+            caller.join();
+        }
+        double submitSeconds = secondsSince(start);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!finished.wait_for(lock, std::chrono::seconds(60), [&]() { return completed.load() == total; })) {
+                std::printf("%8zu timed out, %zu of %zu queries completed\n", threads, completed.load(), total);
+                return 1;
+            }
+        }
+        double seconds = secondsSince(start);
+        std::printf("%8zu %14.0f %14.0f %10zu\n", threads, total / submitSeconds, total / seconds, failed.load());
+        ok = ok && failed.load() == 0;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// Measures Mapper<Person>::findAll throughput and the memory held per row
+// by the Person model. Runs against an in-memory SQLite copy of the person
+// table, so no database server is needed.
+//
+// The model layout is whatever models/ was generated with; build once more
+// against models generated with "value_types": false to get the baseline.
+//
+//   person_findall_bench [rows] [iterations]
+
+#include "Person.h"
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Mapper.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace drogon::orm;
+using drogon_model::org_chart::Person;
+
+namespace {
+
+// Heap usage of the calling thread while counting is on
+thread_local bool counting = false;
+thread_local size_t allocations = 0;
+thread_local size_t allocatedBytes = 0;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+void *operator new(size_t size) {
+    if (counting) {
+        ++allocations;
+        allocatedBytes += size;
+    }
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char **argv) {
+    size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    auto client = DbClient::newSqlite3Client("filename=:memory:", 1);
+    client->execSqlSync(
+        "create table person (id integer primary key, job_id integer not null, department_id integer not null, "
+        "manager_id integer not null, first_name varchar(50) not null, last_name varchar(50) not null, "
+        "hire_date date not null)");
+    {
+        auto transaction = client->newTransaction();
+        for (size_t i = 1; i <= rows; ++i) {
+            transaction->execSqlSync(
+                "insert into person (id, job_id, department_id, manager_id, first_name, last_name, hire_date) "
+                "values (?, ?, ?, ?, ?, ?, ?)",
+                static_cast<int32_t>(i), static_cast<int32_t>(i % 20 + 1), static_cast<int32_t>(i % 8 + 1),
+                static_cast<int32_t>(i / 10 + 1), "First" + std::to_string(i), "Last" + std::to_string(i),
+                std::string("2015-06-01"));
+        }
+    }
+
+    Mapper<Person> mapper(client);
+    size_t fetched = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fetched += mapper.findAll().size();
+    }
+    double findAllSeconds = secondsSince(start);
+
+    // Building the models from a result that is already in memory isolates
+    // the cost of the model layout from the query itself
+    auto result = client->execSqlSync("select * from person");
+    std::vector<Person> persons;
+    persons.reserve(result.size());
+    counting = true;
+    start = std::chrono::steady_clock::now();
+    for (const auto &row : result) {
+        persons.emplace_back(row);
+    }
+    double buildSeconds = secondsSince(start);
+    counting = false;
+
+    double rowCount = static_cast<double>(result.size());
+    std::printf("rows:                %zu\n", result.size());
+    std::printf("findAll rows/sec:    %.0f\n", fetched / findAllSeconds);
+    std::printf("build rows/sec:      %.0f\n", rowCount / buildSeconds);
+    std::printf("sizeof(Person):      %zu\n", sizeof(Person));
+    std::printf("heap allocs/row:     %.2f\n", allocations / rowCount);
+    std::printf("bytes/row:           %.1f\n", sizeof(Person) + allocatedBytes / rowCount);
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Measures Mapper<Person>::findAll on PostgreSQL with results in text format
+// and with "binary_results", where the integer and date columns arrive in
+// network byte order instead of as text to be parsed.
+//
+// Each client fills its own temporary person table, which hides the real one
+// for that connection, so any database the user can connect to will do.
+//
+//   pg_binary_result_bench [conninfo] [rows] [iterations]
+
+#include "Person.h"
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Mapper.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+using drogon_model::org_chart::Person;
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string connInfo = argc > 1 ? argv[1] : "host=127.0.0.1 port=5433 dbname=org_chart user=postgres password=password";
+    int32_t rows = argc > 2 ? static_cast<int32_t>(std::strtol(argv[2], nullptr, 10)) : 100000;
+    size_t iterations = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10;
+
+    std::printf("%8s %16s %16s\n", "format", "findAll rows/sec", "build rows/sec");
+    for (bool binary : {false, true}) {
+        // A single connection, so the temporary table is seen by every query
+        auto client = DbClient::newPgClient(connInfo, 1, binary);
+        try {
+            client->execSqlSync(
+                "create temp table person (id integer primary key, job_id integer not null, "
+                "department_id integer not null, manager_id integer not null, first_name varchar(50) not null, "
+                "last_name varchar(50) not null, hire_date date not null)");
+            client->execSqlSync(
+                "insert into person select i, i % 20 + 1, i % 8 + 1, i / 10 + 1, 'First' || i, 'Last' || i, "
+                "date '2015-06-01' + i % 3000 from generate_series(1, $1) as i",
+                rows);
+        } catch (const DrogonDbException &e) {
+            std::printf("cannot create the person table: %s\n", e.base().what());
+            return 1;
+        }
+
+        Mapper<Person> mapper(client);
+        // The first result tells the connection whether the columns can be
+        // fetched in binary format
+        mapper.findAll();
+        size_t fetched = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fetched += mapper.findAll().size();
+        }
+        double findAllSeconds = secondsSince(start);
+
+        // Building the models from a result that is already in memory
+        // isolates the decoding from the query itself; again the second
+        // result is the one in binary format
+        const std::string sql = "select * from person where id > $1";
+        client->execSqlSync(sql, 0);
+        auto result = client->execSqlSync(sql, 0);
+        std::vector<Person> persons;
+        persons.reserve(result.size());
+        start = std::chrono::steady_clock::now();
+        for (const auto &row : result) {
+            persons.emplace_back(row);
+        }
+        double buildSeconds = secondsSince(start);
+
+        std::printf("%8s %16.0f %16.0f\n", binary ? "binary" : "text", fetched / findAllSeconds,
+                    result.size() / buildSeconds);
+    }
+    return 0;
+}
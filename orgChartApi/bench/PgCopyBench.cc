@@ -0,0 +1,132 @@
+// Measures loading persons into PostgreSQL with multi-row INSERT statements
+// of bound parameters against DbClient::copyIn(), and reading them back with
+// a select against DbClient::copyOut().
+//
+// The client fills its own temporary person table, which hides the real one
+// for that connection, so any database the user can connect to will do.
+//
+//   pg_copy_bench [conninfo] [rows] [rows per insert]
+
+#include <drogon/orm/CopyTextWriter.h>
+#include <drogon/orm/DbClient.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+
+using namespace drogon::orm;
+
+namespace {
+
+const char kColumns[] = "id, job_id, department_id, manager_id, first_name, last_name, hire_date";
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Waits for a copyIn() or copyOut() to end, returns its error if it failed
+std::string waitFor(std::promise<std::string> &done) {
+    return done.get_future().get();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string connInfo = argc > 1 ? argv[1] : "host=127.0.0.1 port=5433 dbname=org_chart user=postgres password=password";
+    int32_t rows = argc > 2 ? static_cast<int32_t>(std::strtol(argv[2], nullptr, 10)) : 100000;
+    int32_t batch = argc > 3 ? static_cast<int32_t>(std::strtol(argv[3], nullptr, 10)) : 1000;
+    batch = (std::max)(batch, 1);
+    const trantor::Date hireDate = trantor::Date::fromDbStringLocal("2015-06-01");
+
+    // A single connection, so the temporary table is seen by every statement
+    auto client = DbClient::newPgClient(connInfo, 1);
+    try {
+        client->execSqlSync(
+            "create temp table person (id integer primary key, job_id integer not null, "
+            "department_id integer not null, manager_id integer not null, first_name varchar(50) not null, "
+            "last_name varchar(50) not null, hire_date date not null)");
+    } catch (const DrogonDbException &e) {
+        std::printf("cannot create the person table: %s\n", e.base().what());
+        return 1;
+    }
+
+    std::printf("%10s %14s\n", "load", "rows/sec");
+
+    // One statement for every batch, the last one may be shorter
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t first = 1; first <= rows; first += batch) {
+        int32_t count = (std::min)(batch, rows - first + 1);
+        std::string sql = std::string("insert into person (") + kColumns + ") values ";
+        for (int32_t i = 0; i < count; ++i) {
+            int32_t p = i * 7;
+            sql += (i ? ",($" : "($") + std::to_string(p + 1);
+            for (int32_t c = 2; c <= 7; ++c) {
+                sql += ",$" + std::to_string(p + c);
+            }
+            sql += ')';
+        }
+        auto binder = *client << sql;
+        for (int32_t id = first; id < first + count; ++id) {
+            binder << id << id % 20 + 1 << id % 8 + 1 << id / 10 + 1 << "First" + std::to_string(id)
+                   << "Last" + std::to_string(id) << hireDate;
+        }
+        binder << drogon::orm::Mode::Blocking;
+        binder >> [](const Result &) {} >> [](const DrogonDbException &e) {
+            std::printf("insert failed: %s\n", e.base().what());
+            std::exit(1);
+        };
+        binder.exec();
+    }
+    std::printf("%10s %14.0f\n", "insert", rows / secondsSince(start));
+
+    client->execSqlSync("truncate person");
+    start = std::chrono::steady_clock::now();
+    {
+        std::promise<std::string> done;
+        int32_t next = 1;
+        client->copyIn(
+            std::string("copy person (") + kColumns + ") from stdin",
+            [&next, rows, batch, &hireDate](std::string &buffer) {
+                CopyTextWriter writer(buffer);
+                for (int32_t i = 0; i < batch && next <= rows; ++i, ++next) {
+                    writer << next << next % 20 + 1 << next % 8 + 1 << next / 10 + 1
+                           << "First" + std::to_string(next) << "Last" + std::to_string(next) << hireDate;
+                    writer.endRow();
+                }
+                return next <= rows;
+            },
+            [&done](const Result &) { done.set_value(std::string()); },
+            [&done](const DrogonDbException &e) { done.set_value(e.base().what()); });
+        auto error = waitFor(done);
+        if (!error.empty()) {
+            std::printf("copy in failed: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    std::printf("%10s %14.0f\n", "copy in", rows / secondsSince(start));
+
+    std::printf("%10s %14s\n", "read", "rows/sec");
+    start = std::chrono::steady_clock::now();
+    auto result = client->execSqlSync(std::string("select ") + kColumns + " from person");
+    std::printf("%10s %14.0f\n", "select", result.size() / secondsSince(start));
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::promise<std::string> done;
+        size_t received = 0;
+        client->copyOut(
+            std::string("copy person (") + kColumns + ") to stdout",
+            [&received](const char *, size_t) { ++received; },
+            [&done](const Result &) { done.set_value(std::string()); },
+            [&done](const DrogonDbException &e) { done.set_value(e.base().what()); });
+        auto error = waitFor(done);
+        if (!error.empty()) {
+            std::printf("copy out failed: %s\n", error.c_str());
+            return 1;
+        }
+        std::printf("%10s %14.0f\n", "copy out", received / secondsSince(start));
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Measures PostgreSQL throughput of the queries behind GET /persons and
+// GET /persons/{id}, one list for every four single lookups, at pool sizes 1
+// to 4. A fixed number of requests is kept in flight, so most queries wait
+// for a connection; with libpq 14 or newer drogon writes the waiting queries
+// to a connection as one pipeline and reads the results back in order.
+// Configure drogon with -DLIBPQ_BATCH_MODE=OFF to get the baseline of one
+// query per round trip.
+//
+// Needs the org_chart database created and seeded with scripts/.
+//
+//   pg_pipeline_bench [conninfo] [seconds] [in flight]
+
+#include <drogon/config.h>
+#include <drogon/orm/DbClient.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace drogon::orm;
+
+namespace {
+
+const std::string kSelect =
+    "select person.id, person.first_name, person.last_name, person.hire_date, person.job_id, job.title as "
+    "job_title, person.department_id, department.name as department_name, person.manager_id, "
+    "concat(manager.first_name, ' ', manager.last_name) as manager_full_name from person "
+    "join job on person.job_id = job.id join department on person.department_id = department.id "
+    "join person as manager on person.manager_id = manager.id";
+const std::string kListSql = kSelect + " order by person.id asc limit $1 offset $2";
+const std::string kGetOneSql = kSelect + " where person.id = $1";
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string connInfo = argc > 1 ? argv[1] : "host=127.0.0.1 port=5433 dbname=org_chart user=postgres password=password";
+    double seconds = argc > 2 ? std::strtod(argv[2], nullptr) : 5.0;
+    size_t inFlight = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+    std::printf("pipeline mode: %s\n", LIBPQ_SUPPORTS_BATCH_MODE ? "yes" : "no");
+    std::printf("%5s %12s %12s %10s\n", "pool", "queries/sec", "lists/sec", "failed");
+    for (size_t pool = 1; pool <= 4; ++pool) {
+        auto client = DbClient::newPgClient(connInfo, pool);
+        int32_t maxId;
+        try {
+            // Also waits until a connection is open
+            maxId = client->execSqlSync("select max(id) from person")[0][0].as<int32_t>();
+        } catch (const DrogonDbException &e) {
+            std::printf("cannot query person: %s\n", e.base().what());
+            return 1;
+        }
+        if (maxId < 1) {
+            std::printf("the person table is empty\n");
+            return 1;
+        }
+
+        std::atomic<bool> running{true};
+        std::atomic<size_t> queries{0};
+        std::atomic<size_t> lists{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<size_t> active{inFlight};
+        std::mutex mutex;
+        std::condition_variable drained;
+
+        // Every request issues the next one from its callback until time is up
+        std::function<void(size_t)> issue = [&](size_t n) {
+            if (!running.load()) {
+                if (active.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    drained.notify_one();
+                }
+                return;
+            }
+            auto next = [&issue, n]() { issue(n + 1); };
+            auto fail = [&failed, next](const DrogonDbException &) {
+                ++failed;
+                next();
+            };
+            if (n % 5 == 0) {
+                client->execSqlAsync(
+                    kListSql,
+                    [&, next](const Result &) {
+                        ++queries;
+                        ++lists;
+                        next();
+                    },
+                    fail, static_cast<int64_t>(25), static_cast<int64_t>(n * 7 % maxId));
+            } else {
+                client->execSqlAsync(
+                    kGetOneSql,
+                    [&, next](const Result &) {
+                        ++queries;
+                        next();
+                    },
+                    fail, static_cast<int32_t>(n * 7919 % maxId + 1));
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < inFlight; ++i) {
+            issue(i * 5 + i % 5);
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        running = false;
+        double elapsed = secondsSince(start);
+        size_t done = queries.load();
+        size_t listCount = lists.load();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            drained.wait(lock, [&]() { return active.load() == 0; });
+        }
+        std::printf("%5zu %12.0f %12.0f %10zu\n", pool, done / elapsed, listCount / elapsed, failed.load());
+    }
+    return 0;
+}
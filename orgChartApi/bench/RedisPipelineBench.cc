@@ -0,0 +1,291 @@
+// Measures how fast the Redis client gets the cached rows of one page of
+// GET /persons, 25 keys, from several threads at once: once with one GET per
+// key, once with a single MGET through getMultipleAsync(). The GETs issued in
+// one iteration of a connection's event loop are written to the server
+// together, so the bench also reports how many commands the server found in
+// each read.
+//
+// Without a server address the bench starts a stand-in on 127.0.0.1 that
+// answers PING, GET, SET and MGET from memory, so it needs no redis-server
+// but its replies are cheaper than the real ones. Drogon has to be built with
+// hiredis.
+//
+//   redis_pipeline_bench [host:port] [seconds] [threads]
+
+#include <drogon/nosql/RedisClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <trantor/net/TcpServer.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace drogon::nosql;
+
+namespace {
+
+const size_t kKeysPerPage = 25;
+const size_t kKeys = 1000;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string keyFor(size_t i) {
+    return "org_chart:person:" + std::to_string(i);
+}
+
+// Just enough RESP for the bench, every command arrives as an array of bulk
+// strings since that is what hiredis sends
+class StandInServer {
+ public:
+    explicit StandInServer(trantor::EventLoop *loop)
+        : server_(loop, trantor::InetAddress("127.0.0.1", 0), "RedisStandIn") {
+        server_.setRecvMessageCallback([this](const trantor::TcpConnectionPtr &conn, trantor::MsgBuffer *buffer) {
+            ++reads_;
+            std::string reply;
+            std::vector<std::string> command;
+            while (parse(buffer, command)) {
+                ++commands_;
+                answer(command, reply);
+            }
+            conn->send(reply);
+        });
+        server_.start();
+    }
+
+    uint16_t port() const { return server_.address().toPort(); }
+    size_t reads() const { return reads_.load(); }
+    size_t commands() const { return commands_.load(); }
+
+ private:
+    // Takes one complete command off the buffer, leaves a partial one there
+    static bool parse(trantor::MsgBuffer *buffer, std::vector<std::string> &command) {
+        const char *p = buffer->peek();
+        const char *end = p + buffer->readableBytes();
+        auto readLine = [&p, end](long &value) {
+            const char *crlf = std::search(p, end, "\r\n", "\r\n" + 2);
+            if (crlf == end) {
+                return false;
+            }
+            value = std::strtol(p + 1, nullptr, 10);
+            p = crlf + 2;
+            return true;
+        };
+        long count;
+        if (p == end || *p != '*' || !readLine(count)) {
+            return false;
+        }
+        command.clear();
+        for (long i = 0; i < count; ++i) {
+            long length;
+            if (!readLine(length) || end - p < length + 2) {
+                return false;
+            }
+            command.emplace_back(p, length);
+            p += length + 2;
+        }
+        buffer->retrieve(p - buffer->peek());
+        return true;
+    }
+
+    void answer(const std::vector<std::string> &command, std::string &reply) {
+        auto bulk = [&reply](const std::string *value) {
+            if (!value) {
+                reply += "$-1\r\n";
+                return;
+            }
+            reply += "$" + std::to_string(value->size()) + "\r\n" + *value + "\r\n";
+        };
+        auto find = [this](const std::string &key) -> const std::string * {
+            auto it = values_.find(key);
+            return it == values_.end() ? nullptr : &it->second;
+        };
+        const std::string name = command.empty() ? "" : command[0];
+        if ((name == "set" || name == "SET") && command.size() >= 3) {
+            values_[command[1]] = command[2];
+            reply += "+OK\r\n";
+        } else if ((name == "get" || name == "GET") && command.size() == 2) {
+            bulk(find(command[1]));
+        } else if ((name == "mget" || name == "MGET") && command.size() >= 2) {
+            reply += "*" + std::to_string(command.size() - 1) + "\r\n";
+            for (size_t i = 1; i < command.size(); ++i) {
+                bulk(find(command[i]));
+            }
+        } else if (name == "ping" || name == "PING") {
+            reply += "+PONG\r\n";
+        } else {
+            reply += "-ERR unknown command\r\n";
+        }
+    }
+
+    trantor::TcpServer server_;
+    // Only touched in the server's loop
+    std::map<std::string, std::string> values_;
+    std::atomic<size_t> reads_{0};
+    std::atomic<size_t> commands_{0};
+};
+
+// Runs fetchPage() from every thread until time is up and returns the pages
+// fetched per second
+double run(size_t threads, double seconds, const std::function<void(size_t, std::function<void(bool)> &&)> &fetchPage, size_t &failed) {
+    std::atomic<bool> running{true};
+    std::atomic<size_t> pages{0};
+    std::atomic<size_t> errors{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> callers;
+    for (size_t t = 0; t < threads; ++t) {
+        callers.emplace_back([&, t]() {
+            // One page in flight per thread, like a request waiting for its rows
+            for (size_t n = t; running.load(); n += threads) {
+                std::mutex mutex;
+                std::condition_variable fetched;
+                bool done = false;
+                fetchPage(n * kKeysPerPage % kKeys, [&](bool ok) {
+                    if (!ok) {
+                        ++errors;
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done = true;
+                    fetched.notify_one();
+                });
+                std::unique_lock<std::mutex> lock(mutex);
+                fetched.wait(lock, [&done]() { return done; });
+                ++pages;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto &caller : callers) {
+        caller.join();
+    }
+    failed = errors.load();
+    return pages.load() / secondsSince(start);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string address = argc > 1 ? argv[1] : "";
+    double seconds = argc > 2 ? std::strtod(argv[2], nullptr) : 3.0;
+    size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8;
+
+    trantor::EventLoopThread serverThread("RedisStandIn");
+    std::unique_ptr<StandInServer> standIn;
+    std::string host = "127.0.0.1";
+    uint16_t port;
+    if (address.empty()) {
+        serverThread.run();
+        std::promise<void> started;
+        serverThread.getLoop()->runInLoop([&]() {
+            standIn = std::make_unique<StandInServer>(serverThread.getLoop());
+            started.set_value();
+        });
+        started.get_future().wait();
+        port = standIn->port();
+    } else {
+        auto colon = address.rfind(':');
+        host = address.substr(0, colon);
+        port = static_cast<uint16_t>(colon == std::string::npos ? 6379 : std::strtoul(address.c_str() + colon + 1, nullptr, 10));
+    }
+
+    auto client = RedisClient::newRedisClient(trantor::InetAddress(host, port), 1);
+    // Commands sent before the connection is open wait for it
+    std::promise<std::string> filled;
+    for (size_t i = 0; i < kKeys; ++i) {
+        client->execCommandAsync(
+            [i, &filled](const RedisResult &) {
+                if (i + 1 == kKeys) {
+                    filled.set_value("");
+                }
+            },
+            [i, &filled](const RedisException &e) {
+                if (i + 1 == kKeys) {
+                    filled.set_value(e.what());
+                }
+            },
+            "set %s %s", keyFor(i).c_str(), ("person " + std::to_string(i)).c_str());
+    }
+    auto error = filled.get_future().get();
+    if (!error.empty()) {
+        std::printf("cannot fill the keys: %s\n", error.c_str());
+        return 1;
+    }
+
+    auto getEach = [&client](size_t first, std::function<void(bool)> &&done) {
+        auto left = std::make_shared<std::atomic<size_t>>(kKeysPerPage);
+        auto ok = std::make_shared<std::atomic<bool>>(true);
+        auto doneOne = [left, ok, done = std::move(done)]() {
+            if (left->fetch_sub(1) == 1) {
+                done(ok->load());
+            }
+        };
+        for (size_t i = 0; i < kKeysPerPage; ++i) {
+            client->execCommandAsync(
+                [doneOne, ok](const RedisResult &r) {
+                    if (r.type() != RedisResultType::kString) {
+                        *ok = false;
+                    }
+                    doneOne();
+                },
+                [doneOne, ok](const RedisException &) {
+                    *ok = false;
+                    doneOne();
+                },
+                "get %s", keyFor(first + i).c_str());
+        }
+    };
+    auto getMultiple = [&client](size_t first, std::function<void(bool)> &&done) {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < kKeysPerPage; ++i) {
+            keys.emplace_back(keyFor(first + i));
+        }
+        auto donePtr = std::make_shared<std::function<void(bool)>>(std::move(done));
+        client->getMultipleAsync(
+            keys,
+            [donePtr](std::vector<std::shared_ptr<std::string>> &&values) {
+                bool ok = values.size() == kKeysPerPage;
+                for (auto &value : values) {
+                    ok = ok && value;
+                }
+                (*donePtr)(ok);
+            },
+            [donePtr](const RedisException &) { (*donePtr)(false); });
+    };
+
+    std::printf("%6s %12s %12s %16s %10s\n", "mode", "pages/sec", "keys/sec", "commands/read", "failed");
+    for (auto mode : {std::make_pair("get", std::function<void(size_t, std::function<void(bool)> &&)>(getEach)),
+                      std::make_pair("mget", std::function<void(size_t, std::function<void(bool)> &&)>(getMultiple))}) {
+        size_t reads = standIn ? standIn->reads() : 0;
+        size_t commands = standIn ? standIn->commands() : 0;
+        size_t failed;
+        double pages = run(threads, seconds, mode.second, failed);
+        if (standIn) {
+            double perRead = static_cast<double>(standIn->commands() - commands) / (standIn->reads() - reads);
+            std::printf("%6s %12.0f %12.0f %16.1f %10zu\n", mode.first, pages, pages * kKeysPerPage, perRead, failed);
+        } else {
+            std::printf("%6s %12.0f %12.0f %16s %10zu\n", mode.first, pages, pages * kKeysPerPage, "-", failed);
+        }
+    }
+    client.reset();
+    if (standIn) {
+        std::promise<void> stopped;
+        serverThread.getLoop()->runInLoop([&]() {
+            standIn.reset();
+            stopped.set_value();
+        });
+        stopped.get_future().wait();
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Measures the heap allocations and time it takes to bind the parameters of
+// a query and hand it to the client, for the query shapes of the
+// controllers. The client is a stub that drops every query, so only the
+// binder and the callbacks it builds are measured, not a database.
+//
+//   sql_binder_bench [queries]
+
+#include <drogon/orm/DbClient.h>
+#include <trantor/utils/Date.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+using namespace drogon::orm;
+
+namespace {
+
+// Heap usage of the calling thread while counting is on
+thread_local bool counting = false;
+thread_local size_t allocations = 0;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+class NullDbClient : public DbClient {
+  public:
+    NullDbClient() {
+        type_ = ClientType::PostgreSQL;
+    }
+    std::shared_ptr<Transaction> newTransaction(const std::function<void(bool)> &) noexcept(false) override {
+        return nullptr;
+    }
+    void newTransactionAsync(const std::function<void(const std::shared_ptr<Transaction> &)> &callback) override {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override {
+        return true;
+    }
+    void setTimeout(double) override {
+    }
+
+  private:
+    void execSql(const char *, size_t, size_t, std::vector<const char *> &&, std::vector<int> &&,
+                 std::vector<int> &&, ResultCallback &&, std::function<void(const std::exception_ptr &)> &&) override {
+    }
+};
+
+const std::string kListSql = "select * from person order by person.id asc limit $1 offset $2";
+const std::string kGetOneSql = "select * from person where person.id = $1";
+const std::string kInsertSql =
+    "insert into person (job_id, department_id, manager_id, first_name, last_name, hire_date) "
+    "values ($1, $2, $3, $4, $5, $6) returning *";
+
+void report(const char *name, size_t queries, const std::function<void(size_t)> &query) {
+    allocations = 0;
+    counting = true;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries; ++i) {
+        query(i);
+    }
+    double seconds = secondsSince(start);
+    counting = false;
+    std::printf("%-8s %14.2f %12.0f\n", name, static_cast<double>(allocations) / queries, seconds * 1e9 / queries);
+}
+
+}  // namespace
+
+void *operator new(size_t size) {
+    if (counting) {
+        ++allocations;
+    }
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char **argv) {
+    size_t queries = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    NullDbClient client;
+    auto ignore = [](const Result &) {};
+    auto fail = [](const DrogonDbException &) {};
+    const std::string firstName = "Gary";
+    const std::string lastName = "Reed";
+    const trantor::Date hireDate = trantor::Date(2018, 4, 7);
+
+    std::printf("%-8s %14s %12s\n", "query", "allocs/query", "ns/query");
+    report("list", queries, [&](size_t i) {
+        client << kListSql << static_cast<int64_t>(25) << static_cast<int64_t>(i % 1000) >> ignore >> fail;
+    });
+    report("get one", queries, [&](size_t i) {
+        client << kGetOneSql << static_cast<int32_t>(i % 1000 + 1) >> ignore >> fail;
+    });
+    report("insert", queries, [&](size_t i) {
+        client << kInsertSql << static_cast<int32_t>(i % 20 + 1) << static_cast<int32_t>(i % 8 + 1)
+               << static_cast<int32_t>(i % 100 + 1) << firstName << lastName << hireDate >> ignore >> fail;
+    });
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "AdminController.h"
+#include "../utils/utils.h"
+
+using namespace drogon;
+
+void AdminController::getDbStats(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const {
+    LOG_DEBUG << "getDbStats";
+    static const char *const buckets[] = {"0", "100us", "1ms", "10ms", "100ms", "1s", "inf"};
+    auto stats = getDbClient()->stats();
+
+    Json::Value waitTime{};
+    for (size_t i = 0; i < stats.waitTimeHistogram.size(); ++i) {
+        waitTime[buckets[i]] = static_cast<Json::UInt64>(stats.waitTimeHistogram[i]);
+    }
+    Json::Value ret{};
+    ret["connections"] = static_cast<Json::UInt64>(stats.connections);
+    ret["min_connections"] = static_cast<Json::UInt64>(stats.minConnections);
+    ret["max_connections"] = static_cast<Json::UInt64>(stats.maxConnections);
+    ret["in_flight"] = static_cast<Json::UInt64>(stats.busyConnections);
+    ret["queue_depth"] = static_cast<Json::UInt64>(stats.queueDepth);
+    ret["rejected"] = static_cast<Json::UInt64>(stats.rejected);
+    ret["queue_wait"] = std::move(waitTime);
+    Json::Value statements{};
+    statements["cached"] = static_cast<Json::UInt64>(stats.preparedStatements);
+    statements["hits"] = static_cast<Json::UInt64>(stats.preparedStatementHits);
+    statements["misses"] = static_cast<Json::UInt64>(stats.preparedStatementMisses);
+    statements["evictions"] = static_cast<Json::UInt64>(stats.preparedStatementEvictions);
+    ret["prepared_statements"] = std::move(statements);
+    auto resp = HttpResponse::newHttpJsonResponse(ret);
+    resp->setStatusCode(HttpStatusCode::k200OK);
+    callback(resp);
+}
+
+void AdminController::getSqlStats(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const {
+    LOG_DEBUG << "getSqlStats";
+    static const char *const buckets[] = {"100us", "1ms", "10ms", "100ms", "1s", "inf"};
+    auto limit = req->getOptionalParameter<int>("limit").value_or(25);
+    // The read client covers the primary too, the statements come busiest first
+    auto stats = getReadDbClient()->statementStats();
+
+    uint64_t totalMicroseconds = 0;
+    for (const auto &stat : stats) {
+        totalMicroseconds += stat.execMicroseconds;
+    }
+    Json::Value statements{Json::arrayValue};
+    for (const auto &stat : stats) {
+        if (limit >= 0 && statements.size() >= static_cast<Json::ArrayIndex>(limit)) {
+            break;
+        }
+        Json::Value execTime{};
+        for (size_t i = 0; i < stat.execTimeHistogram.size(); ++i) {
+            execTime[buckets[i]] = static_cast<Json::UInt64>(stat.execTimeHistogram[i]);
+        }
+        Json::Value statement{};
+        statement["sql"] = stat.sql;
+        statement["calls"] = static_cast<Json::UInt64>(stat.calls);
+        statement["errors"] = static_cast<Json::UInt64>(stat.errors);
+        statement["rows"] = static_cast<Json::UInt64>(stat.rows);
+        statement["queue_us"] = static_cast<Json::UInt64>(stat.queueMicroseconds);
+        statement["exec_us"] = static_cast<Json::UInt64>(stat.execMicroseconds);
+        statement["mean_exec_us"] = static_cast<Json::UInt64>(stat.execMicroseconds / stat.calls);
+        statement["share"] = totalMicroseconds > 0 ? static_cast<double>(stat.execMicroseconds) / totalMicroseconds : 0.0;
+        statement["exec_time"] = std::move(execTime);
+        statements.append(std::move(statement));
+    }
+    Json::Value ret{};
+    ret["exec_us"] = static_cast<Json::UInt64>(totalMicroseconds);
+    ret["statements"] = std::move(statements);
+    auto resp = HttpResponse::newHttpJsonResponse(ret);
+    resp->setStatusCode(HttpStatusCode::k200OK);
+    callback(resp);
+}
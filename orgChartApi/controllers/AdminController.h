@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+using namespace drogon;
+
+class AdminController : public drogon::HttpController<AdminController> {
+ public:
+    METHOD_LIST_BEGIN
+      ADD_METHOD_TO(AdminController::getDbStats, "/admin/db", Get, "LoginFilter");
+      ADD_METHOD_TO(AdminController::getSqlStats, "/admin/sql", Get, "LoginFilter");
+    METHOD_LIST_END
+
+    void getDbStats(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    void getSqlStats(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+};
@@ -1,5 +1,6 @@
 #include "DepartmentsController.h"
 #include "../utils/utils.h"
+#include "../plugins/ModelCachePlugin.h"
 #include "../models/Person.h"
 #include <string>
 #include <memory>
@@ -28,9 +29,14 @@ void DepartmentsController::get(const HttpRequestPtr &req, std::function<void(co
     auto sortOrderEnum = sortOrder == "asc" ? SortOrder::ASC : SortOrder::DESC;
 
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
-    Mapper<Department> mp(dbClientPtr);
-    mp.orderBy(sortField, sortOrderEnum).offset(offset).limit(limit).findAll(
+    auto dbClientPtr = getReadDbClient(req);
+    ModelCachePlugin::findAll<Department>(
+        dbClientPtr,
+        getFreshDbClient(req),
+        sortField,
+        sortOrderEnum,
+        offset,
+        limit,
         [callbackPtr](const std::vector<Department> &departments) {
             Json::Value ret{};
             for (auto d : departments) {
@@ -51,10 +57,11 @@ void DepartmentsController::get(const HttpRequestPtr &req, std::function<void(co
 void DepartmentsController::getOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int departmentId) const {
     LOG_DEBUG << "getOne departmentId: "<< departmentId;
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getReadDbClient(req);
 
-    Mapper<Department> mp(dbClientPtr);
-    mp.findByPrimaryKey(
+    ModelCachePlugin::findByPrimaryKey<Department>(
+        dbClientPtr,
+        getFreshDbClient(req),
         departmentId,
         [callbackPtr](const Department &department) {
             Json::Value ret{};
@@ -81,12 +88,13 @@ void DepartmentsController::getOne(const HttpRequestPtr &req, std::function<void
 void DepartmentsController::createOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, Department &&pDepartment) const {
     LOG_DEBUG << "createOne";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Department> mp(dbClientPtr);
     mp.insert(
         pDepartment,
         [callbackPtr](const Department &department) {
+            ModelCachePlugin::invalidateLists<Department>();
             Json::Value ret{};
             ret = department.toJson();
             auto resp = HttpResponse::newHttpJsonResponse(ret);
@@ -103,7 +111,7 @@ void DepartmentsController::createOne(const HttpRequestPtr &req, std::function<v
 
 void DepartmentsController::updateOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int departmentId, Department &&pDepartmentDetails) const {
     LOG_DEBUG << "updateOne departmentId: " << departmentId;
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     // blocking IO
     Mapper<Department> mp(dbClientPtr);
@@ -125,8 +133,10 @@ void DepartmentsController::updateOne(const HttpRequestPtr &req, std::function<v
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
     mp.update(
         department,
-        [callbackPtr](const std::size_t count)
+        [callbackPtr, departmentId](const std::size_t count)
         {
+            ModelCachePlugin::invalidate<Department>(departmentId);
+            ModelCachePlugin::invalidateLists<Department>();
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -144,12 +154,14 @@ void DepartmentsController::updateOne(const HttpRequestPtr &req, std::function<v
 void DepartmentsController::deleteOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int departmentId) const {
     LOG_DEBUG << "deleteOne departmentId: ";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Department> mp(dbClientPtr);
     mp.deleteBy(
         Criteria(Department::Cols::_id, CompareOperator::EQ, departmentId),
-        [callbackPtr](const std::size_t count) {
+        [callbackPtr, departmentId](const std::size_t count) {
+            ModelCachePlugin::invalidate<Department>(departmentId);
+            ModelCachePlugin::invalidateLists<Department>();
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -165,45 +177,50 @@ void DepartmentsController::deleteOne(const HttpRequestPtr &req, std::function<v
 void DepartmentsController::getDepartmentPersons(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int departmentId) const {
     LOG_DEBUG << "getDepartmentPersons departmentId: "<< departmentId;
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getReadDbClient(req);
 
-    // blocking IO
-    Mapper<Department> mp(dbClientPtr);
-    Department department;
-    try {
-        department = mp.findFutureByPrimaryKey(departmentId).get();
-    } catch (const DrogonDbException & e) {
-        Json::Value ret{};
-        ret["error"] = "resource not found";
-        auto resp = HttpResponse::newHttpJsonResponse(ret);
-        resp->setStatusCode(HttpStatusCode::k404NotFound);
-        callback(resp);
-    }
-
-    department.getPersons(dbClientPtr,
-      [callbackPtr](const std::vector<Person> persons) {
-          if (persons.empty()) {
-              Json::Value ret{};
-              ret["error"] = "resource not found";
-              auto resp = HttpResponse::newHttpJsonResponse(ret);
-              resp->setStatusCode(HttpStatusCode::k404NotFound);
-              (*callbackPtr)(resp);
-          } else {
-              Json::Value ret{};
-              for (auto p : persons) {
-                  ret.append(p.toJson());
-              }
-              auto resp = HttpResponse::newHttpJsonResponse(ret);
-              resp->setStatusCode(HttpStatusCode::k200OK);
-              (*callbackPtr)(resp);
-          }
-      },
-      [callbackPtr](const DrogonDbException &e) {
-          LOG_ERROR << e.base().what();
-          Json::Value ret{};
-          ret["error"] = "database error";
-          auto resp = HttpResponse::newHttpJsonResponse(ret);
-          resp->setStatusCode(HttpStatusCode::k500InternalServerError);
-          (*callbackPtr)(resp);
-      });
+    ModelCachePlugin::findByPrimaryKey<Department>(
+        dbClientPtr,
+        getFreshDbClient(req),
+        departmentId,
+        [callbackPtr, dbClientPtr](const Department &department) {
+            department.getPersons(dbClientPtr,
+              [callbackPtr](const std::vector<Person> persons) {
+                  if (persons.empty()) {
+                      Json::Value ret{};
+                      ret["error"] = "resource not found";
+                      auto resp = HttpResponse::newHttpJsonResponse(ret);
+                      resp->setStatusCode(HttpStatusCode::k404NotFound);
+                      (*callbackPtr)(resp);
+                  } else {
+                      Json::Value ret{};
+                      for (auto p : persons) {
+                          ret.append(p.toJson());
+                      }
+                      auto resp = HttpResponse::newHttpJsonResponse(ret);
+                      resp->setStatusCode(HttpStatusCode::k200OK);
+                      (*callbackPtr)(resp);
+                  }
+              },
+              [callbackPtr](const DrogonDbException &e) {
+                  LOG_ERROR << e.base().what();
+                  Json::Value ret{};
+                  ret["error"] = "database error";
+                  auto resp = HttpResponse::newHttpJsonResponse(ret);
+                  resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+                  (*callbackPtr)(resp);
+              });
+        },
+        [callbackPtr](const DrogonDbException &e) {
+            if (dynamic_cast<const drogon::orm::UnexpectedRows *>(&e.base())) {
+                auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+                resp->setStatusCode(HttpStatusCode::k404NotFound);
+                (*callbackPtr)(resp);
+                return;
+            }
+            LOG_ERROR << e.base().what();
+            auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
+            resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+            (*callbackPtr)(resp);
+        });
 }
@@ -1,5 +1,6 @@
 #include "JobsController.h"
 #include "../utils/utils.h"
+#include "../plugins/ModelCachePlugin.h"
 #include "../models/Person.h"
 #include <string>
 #include <memory>
@@ -27,9 +28,14 @@ void JobsController::get(const HttpRequestPtr &req, std::function<void(const Htt
     auto sortOrderEnum = sortOrder == "asc" ? SortOrder::ASC : SortOrder::DESC;
 
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
-    Mapper<Job> mp(dbClientPtr);
-    mp.orderBy(sortField, sortOrderEnum).offset(offset).limit(limit).findAll(
+    auto dbClientPtr = getReadDbClient(req);
+    ModelCachePlugin::findAll<Job>(
+        dbClientPtr,
+        getFreshDbClient(req),
+        sortField,
+        sortOrderEnum,
+        offset,
+        limit,
         [callbackPtr](const std::vector<Job> &jobs) {
             Json::Value ret{};
             for (auto j : jobs) {
@@ -50,10 +56,11 @@ void JobsController::get(const HttpRequestPtr &req, std::function<void(const Htt
 void JobsController::getOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int jobId) const {
     LOG_DEBUG << "getOne jobId: "<< jobId;
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getReadDbClient(req);
 
-    Mapper<Job> mp(dbClientPtr);
-    mp.findByPrimaryKey(
+    ModelCachePlugin::findByPrimaryKey<Job>(
+        dbClientPtr,
+        getFreshDbClient(req),
         jobId,
         [callbackPtr](const Job &job) {
             Json::Value ret{};
@@ -80,12 +87,13 @@ void JobsController::getOne(const HttpRequestPtr &req, std::function<void(const
 void JobsController::createOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, Job &&pJob) const {
     LOG_DEBUG << "createOne";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Job> mp(dbClientPtr);
     mp.insert(
         pJob,
         [callbackPtr](const Job &job) {
+            ModelCachePlugin::invalidateLists<Job>();
             Json::Value ret{};
             ret = job.toJson();
             auto resp = HttpResponse::newHttpJsonResponse(ret);
@@ -112,7 +120,7 @@ void JobsController::updateOne(const HttpRequestPtr &req, std::function<void(con
       return;
     }
 
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     // blocking IO
     Mapper<Job> mp(dbClientPtr);
@@ -134,8 +142,10 @@ void JobsController::updateOne(const HttpRequestPtr &req, std::function<void(con
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
     mp.update(
         job,
-        [callbackPtr](const std::size_t count)
+        [callbackPtr, jobId](const std::size_t count)
         {
+            ModelCachePlugin::invalidate<Job>(jobId);
+            ModelCachePlugin::invalidateLists<Job>();
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -153,12 +163,14 @@ void JobsController::updateOne(const HttpRequestPtr &req, std::function<void(con
 void JobsController::deleteOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int jobId) const {
     LOG_DEBUG << "deleteOne jobId: ";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Job> mp(dbClientPtr);
     mp.deleteBy(
         Criteria(Job::Cols::_id, CompareOperator::EQ, jobId),
-        [callbackPtr](const std::size_t count) {
+        [callbackPtr, jobId](const std::size_t count) {
+            ModelCachePlugin::invalidate<Job>(jobId);
+            ModelCachePlugin::invalidateLists<Job>();
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -174,45 +186,50 @@ void JobsController::deleteOne(const HttpRequestPtr &req, std::function<void(con
 void JobsController::getJobPersons(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int jobId) const {
     LOG_DEBUG << "getJobPersons jobId: "<< jobId;
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getReadDbClient(req);
 
-    // blocking IO
-    Mapper<Job> mp(dbClientPtr);
-    Job job;
-    try {
-        job = mp.findFutureByPrimaryKey(jobId).get();
-    } catch (const DrogonDbException & e) {
-        Json::Value ret{};
-        ret["error"] = "resource not found";
-        auto resp = HttpResponse::newHttpJsonResponse(ret);
-        resp->setStatusCode(HttpStatusCode::k404NotFound);
-        callback(resp);
-    }
-
-    job.getPersons(dbClientPtr,
-        [callbackPtr](const std::vector<Person> persons) {
-           if (persons.empty()) {
-              Json::Value ret{};
-              ret["error"] = "resource not found";
-              auto resp = HttpResponse::newHttpJsonResponse(ret);
-              resp->setStatusCode(HttpStatusCode::k404NotFound);
-              (*callbackPtr)(resp);
-          } else {
-              Json::Value ret{};
-              for (auto p : persons) {
-                  ret.append(p.toJson());
-              }
-              auto resp = HttpResponse::newHttpJsonResponse(ret);
-              resp->setStatusCode(HttpStatusCode::k200OK);
-              (*callbackPtr)(resp);
-          }
+    ModelCachePlugin::findByPrimaryKey<Job>(
+        dbClientPtr,
+        getFreshDbClient(req),
+        jobId,
+        [callbackPtr, dbClientPtr](const Job &job) {
+            job.getPersons(dbClientPtr,
+                [callbackPtr](const std::vector<Person> persons) {
+                   if (persons.empty()) {
+                      Json::Value ret{};
+                      ret["error"] = "resource not found";
+                      auto resp = HttpResponse::newHttpJsonResponse(ret);
+                      resp->setStatusCode(HttpStatusCode::k404NotFound);
+                      (*callbackPtr)(resp);
+                  } else {
+                      Json::Value ret{};
+                      for (auto p : persons) {
+                          ret.append(p.toJson());
+                      }
+                      auto resp = HttpResponse::newHttpJsonResponse(ret);
+                      resp->setStatusCode(HttpStatusCode::k200OK);
+                      (*callbackPtr)(resp);
+                  }
+                },
+                [callbackPtr](const DrogonDbException &e) {
+                  LOG_ERROR << e.base().what();
+                  Json::Value ret{};
+                  ret["error"] = "database error";
+                  auto resp = HttpResponse::newHttpJsonResponse(ret);
+                  resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+                  (*callbackPtr)(resp);
+                });
         },
         [callbackPtr](const DrogonDbException &e) {
-          LOG_ERROR << e.base().what();
-          Json::Value ret{};
-          ret["error"] = "database error";
-          auto resp = HttpResponse::newHttpJsonResponse(ret);
-          resp->setStatusCode(HttpStatusCode::k500InternalServerError);
-          (*callbackPtr)(resp);
+            if (dynamic_cast<const drogon::orm::UnexpectedRows *>(&e.base())) {
+                auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+                resp->setStatusCode(HttpStatusCode::k404NotFound);
+                (*callbackPtr)(resp);
+                return;
+            }
+            LOG_ERROR << e.base().what();
+            auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
+            resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+            (*callbackPtr)(resp);
         });
 }
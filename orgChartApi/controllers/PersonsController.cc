@@ -1,9 +1,14 @@
 #include "PersonsController.h"
 #include "../utils/utils.h"
+#include "../plugins/ModelCachePlugin.h"
 #include <memory>
 #include <utility>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <vector>
-#include <regex>
 
 using namespace drogon::orm;
 using namespace drogon_model::org_chart;
@@ -28,27 +33,38 @@ void PersonsController::get(const HttpRequestPtr &req, std::function<void(const
     auto limit = req->getOptionalParameter<int>("limit").value_or(25);
     auto offset = req->getOptionalParameter<int>("offset").value_or(0);
 
+    unsigned fields;
+    std::string err;
+    if (!parseFields(req, fields, err)) {
+        badRequest(std::move(callback), err);
+        return;
+    }
+    auto ids = req->getOptionalParameter<std::string>("ids");
+    if (ids) {
+        getByIds(req, *ids, fields, std::move(callback));
+        return;
+    }
+    // sort_field is spliced into the SQL and must name a person column, which
+    // also keeps it unambiguous when the manager self-join is present
+    static const std::set<std::string> sortFields{"id", "first_name", "last_name", "hire_date", "job_id", "department_id", "manager_id"};
+    if (sortFields.find(sort_field) == sortFields.end()) {
+        badRequest(std::move(callback), "invalid sort_field");
+        return;
+    }
+    if (sort_order != "asc" && sort_order != "desc") {
+        badRequest(std::move(callback), "invalid sort_order");
+        return;
+    }
+
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
-    const char *sql = "select person.*, \n\
-                       job.title as job_title, \n\
-                       department.name as department_name, \n\
-                       concat(manager.first_name, ' ', manager.last_name) as manager_full_name \n\
-                       from person \n\
-                       join job on person.job_id =job.id \n\
-                       join department on person.department_id=department.id \n\
-                       join person as manager on person.manager_id = manager.id \n\
-                       order by $sort_field $sort_order \n\
-                       limit $1 offset $2;";
-
-    // hack workaroun
-    auto sql_sub = std::regex_replace(sql, std::regex("\\$sort_field"), sort_field);
-    sql_sub = std::regex_replace(sql_sub, std::regex("\\$sort_order"), sort_order);
-
-    *dbClientPtr << std::string(sql_sub)
-                 << std::to_string(limit)
-                 << std::to_string(offset)
-                 >> [callbackPtr](const Result &result)
+    auto dbClientPtr = getReadDbClient(req);
+    auto sql = selectSql(fields);
+    sql += " order by person." + sort_field + " " + sort_order + " limit $1 offset $2";
+
+    *dbClientPtr << sql
+                 << static_cast<int64_t>(limit)
+                 << static_cast<int64_t>(offset)
+                 >> [callbackPtr, fields](const Result &result)
                    {
                       if (result.empty()) {
                           auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
@@ -59,8 +75,7 @@ void PersonsController::get(const HttpRequestPtr &req, std::function<void(const
 
                       Json::Value ret{};
                       for (auto row : result) {
-                          PersonInfo personInfo{row};
-                          PersonDetails personDetails{personInfo};
+                          PersonDetails personDetails{row, fields};
                           ret.append(personDetails.toJson());
                       }
 
@@ -77,24 +92,91 @@ void PersonsController::get(const HttpRequestPtr &req, std::function<void(const
                    };
 }
 
+void PersonsController::getByIds(const HttpRequestPtr &req, const std::string &ids, unsigned fields, std::function<void(const HttpResponsePtr &)> &&callback) const {
+    LOG_DEBUG << "getByIds ids: " << ids;
+    const size_t maxIds = 100;
+    std::vector<int> personIds;
+    std::string idArray;
+    for (const auto &id : drogon::utils::splitString(ids, ",")) {
+        if (id.empty() || id.size() > 9 || id.find_first_not_of("0123456789") != std::string::npos) {
+            badRequest(std::move(callback), "invalid id: " + id);
+            return;
+        }
+        auto personId = std::stoi(id);
+        if (std::find(personIds.begin(), personIds.end(), personId) != personIds.end()) {
+            continue;
+        }
+        if (personIds.size() == maxIds) {
+            badRequest(std::move(callback), "too many ids, at most " + std::to_string(maxIds));
+            return;
+        }
+        if (!personIds.empty()) idArray += ",";
+        idArray += id;
+        personIds.push_back(personId);
+    }
+    if (personIds.empty()) {
+        badRequest(std::move(callback), "ids must not be empty");
+        return;
+    }
+
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    auto dbClientPtr = getReadDbClient(req);
+    // one round-trip for the whole batch, the array is bound as a single text parameter
+    auto sql = selectByIdsSql(fields, dbClientPtr->type(), idArray);
+
+    *dbClientPtr << sql
+                 << idArray
+                 >> [callbackPtr, fields, personIds = std::move(personIds)](const Result &result)
+                   {
+                      std::unordered_map<int, Json::Value> found;
+                      for (auto row : result) {
+                          PersonDetails personDetails{row, fields};
+                          found.emplace(row["id"].as<int32_t>(), personDetails.toJson());
+                      }
+
+                      // answer in request order and report the ids that do not exist
+                      Json::Value persons{Json::arrayValue};
+                      Json::Value missing{Json::arrayValue};
+                      for (auto personId : personIds) {
+                          auto iter = found.find(personId);
+                          if (iter == found.end()) {
+                              missing.append(personId);
+                          } else {
+                              persons.append(std::move(iter->second));
+                          }
+                      }
+                      Json::Value ret{};
+                      ret["persons"] = std::move(persons);
+                      ret["missing"] = std::move(missing);
+                      auto resp = HttpResponse::newHttpJsonResponse(ret);
+                      resp->setStatusCode(HttpStatusCode::k200OK);
+                      (*callbackPtr)(resp);
+                   }
+                 >> [callbackPtr](const DrogonDbException &e)
+                   {
+                      LOG_ERROR << e.base().what();
+                      auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
+                      resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+                      (*callbackPtr)(resp);
+                   };
+}
+
 void PersonsController::getOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int personId) const {
     LOG_DEBUG << "getOne personId: "<< personId;
+    unsigned fields;
+    std::string err;
+    if (!parseFields(req, fields, err)) {
+        badRequest(std::move(callback), err);
+        return;
+    }
+
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
-
-    const char *sql = "select person.*, \n\
-                       job.title as job_title, \n\
-                       department.name as department_name, \n\
-                       concat(manager.first_name, ' ', manager.last_name) as manager_full_name \n\
-                       from person \n\
-                       join job on person.job_id =job.id \n\
-                       join department on person.department_id=department.id \n\
-                       join person as manager on person.manager_id = manager.id \n\
-                       where person.id = $1";
-
-    *dbClientPtr << std::string(sql)
+    auto dbClientPtr = getReadDbClient(req);
+    auto sql = selectSql(fields) + " where person.id = $1";
+
+    *dbClientPtr << sql
                  << personId
-                 >> [callbackPtr](const Result &result)
+                 >> [callbackPtr, fields](const Result &result)
                    {
                       if (result.empty()) {
                           auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
@@ -103,9 +185,7 @@ void PersonsController::getOne(const HttpRequestPtr &req, std::function<void(con
                           return;
                       }
 
-                      auto row = result[0];
-                      PersonInfo personInfo{row};
-                      PersonDetails personDetails{personInfo};
+                      PersonDetails personDetails{result[0], fields};
 
                       Json::Value ret = personDetails.toJson();
                       auto resp = HttpResponse::newHttpJsonResponse(ret);
@@ -124,7 +204,7 @@ void PersonsController::getOne(const HttpRequestPtr &req, std::function<void(con
 void PersonsController::createOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, Person &&pPerson) const {
     LOG_DEBUG << "createOne";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Person> mp(dbClientPtr);
     mp.insert(
@@ -146,7 +226,7 @@ void PersonsController::createOne(const HttpRequestPtr &req, std::function<void(
 
 void PersonsController::updateOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int personId, Person &&pPerson) const {
     LOG_DEBUG << "updateOne personId: " << personId;
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     // blocking IO
     Mapper<Person> mp(dbClientPtr);
@@ -179,8 +259,9 @@ void PersonsController::updateOne(const HttpRequestPtr &req, std::function<void(
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
     mp.update(
         person,
-        [callbackPtr](const std::size_t count)
+        [callbackPtr, personId](const std::size_t count)
         {
+            ModelCachePlugin::invalidate<Person>(personId);
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -198,12 +279,13 @@ void PersonsController::updateOne(const HttpRequestPtr &req, std::function<void(
 void PersonsController::deleteOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int personId) const {
     LOG_DEBUG << "deleteOne personId: ";
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getDbClient(req);
 
     Mapper<Person> mp(dbClientPtr);
     mp.deleteBy(
         Criteria(Person::Cols::_id, CompareOperator::EQ, personId),
-        [callbackPtr](const std::size_t count) {
+        [callbackPtr, personId](const std::size_t count) {
+            ModelCachePlugin::invalidate<Person>(personId);
             auto resp = HttpResponse::newHttpResponse();
             resp->setStatusCode(HttpStatusCode::k204NoContent);
             (*callbackPtr)(resp);
@@ -219,70 +301,157 @@ void PersonsController::deleteOne(const HttpRequestPtr &req, std::function<void(
 void PersonsController::getDirectReports(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int personId) const {
     LOG_DEBUG << "getDirectReports personId: "<< personId;
     auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
-    auto dbClientPtr = drogon::app().getDbClient();
+    auto dbClientPtr = getReadDbClient(req);
 
-    // blocking IO
-    Mapper<Person> mp(dbClientPtr);
-    Person department;
-    try {
-        department = mp.findFutureByPrimaryKey(personId).get();
-    } catch (const DrogonDbException & e) {
-        auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
-        resp->setStatusCode(HttpStatusCode::k404NotFound);
-        callback(resp);
+    ModelCachePlugin::findByPrimaryKey<Person>(
+        dbClientPtr,
+        getFreshDbClient(req),
+        personId,
+        [callbackPtr, dbClientPtr](const Person &person) {
+            person.getPersons(dbClientPtr,
+              [callbackPtr](const std::vector<Person> persons) {
+                  if (persons.empty()) {
+                     auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+                     resp->setStatusCode(HttpStatusCode::k404NotFound);
+                     (*callbackPtr)(resp);
+                  } else {
+                     Json::Value ret{};
+                     for (auto p : persons) {
+                         ret.append(p.toJson());
+                     }
+                     auto resp = HttpResponse::newHttpJsonResponse(ret);
+                     resp->setStatusCode(HttpStatusCode::k200OK);
+                     (*callbackPtr)(resp);
+                  }
+              },
+              [callbackPtr](const DrogonDbException &e) {
+                  LOG_ERROR << e.base().what();
+                  auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
+                  resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+                  (*callbackPtr)(resp);
+              });
+        },
+        [callbackPtr](const DrogonDbException &e) {
+            if (dynamic_cast<const drogon::orm::UnexpectedRows *>(&e.base())) {
+                auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+                resp->setStatusCode(HttpStatusCode::k404NotFound);
+                (*callbackPtr)(resp);
+                return;
+            }
+            LOG_ERROR << e.base().what();
+            auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
+            resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+            (*callbackPtr)(resp);
+        });
+}
+
+bool PersonsController::parseFields(const HttpRequestPtr &req, unsigned &fields, std::string &err) {
+    static const std::map<std::string, unsigned> topLevel{
+        {"id", kId}, {"first_name", kFirstName}, {"last_name", kLastName}, {"hire_date", kHireDate}};
+    static const std::map<std::string, unsigned> embedded{
+        {"manager", kManager}, {"department", kDepartment}, {"job", kJob}};
+
+    fields = kAllFields;
+    auto fieldsParam = req->getOptionalParameter<std::string>("fields");
+    if (fieldsParam) {
+        fields &= ~(kId | kFirstName | kLastName | kHireDate);
+        for (const auto &name : drogon::utils::splitString(*fieldsParam, ",")) {
+            auto iter = topLevel.find(name);
+            if (iter == topLevel.end()) {
+                err = "unknown field: " + name;
+                return false;
+            }
+            fields |= iter->second;
+        }
     }
+    // an empty embed= drops every nested object
+    auto embedParam = req->getOptionalParameter<std::string>("embed");
+    if (embedParam) {
+        fields &= ~(kManager | kDepartment | kJob);
+        for (const auto &name : drogon::utils::splitString(*embedParam, ",")) {
+            auto iter = embedded.find(name);
+            if (iter == embedded.end()) {
+                err = "unknown embed: " + name;
+                return false;
+            }
+            fields |= iter->second;
+        }
+    }
+    return true;
+}
 
-    department.getPersons(dbClientPtr,
-      [callbackPtr](const std::vector<Person> persons) {
-          if (persons.empty()) {
-             auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
-             resp->setStatusCode(HttpStatusCode::k404NotFound);
-             (*callbackPtr)(resp);
-          } else {
-             Json::Value ret{};
-             for (auto p : persons) {
-                 ret.append(p.toJson());
-             }
-             auto resp = HttpResponse::newHttpJsonResponse(ret);
-             resp->setStatusCode(HttpStatusCode::k200OK);
-             (*callbackPtr)(resp);
-          }
-      },
-      [callbackPtr](const DrogonDbException &e) {
-          LOG_ERROR << e.base().what();
-          auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("database error"));
-          resp->setStatusCode(HttpStatusCode::k500InternalServerError);
-          (*callbackPtr)(resp);
-      });
+std::string PersonsController::selectSql(unsigned fields) {
+    // person.id is always selected, it is the default sort key and the batch lookup key
+    std::string sql = "select person.id";
+    if (fields & kFirstName) sql += ", person.first_name";
+    if (fields & kLastName) sql += ", person.last_name";
+    if (fields & kHireDate) sql += ", person.hire_date";
+    if (fields & kJob) sql += ", person.job_id, job.title as job_title";
+    if (fields & kDepartment) sql += ", person.department_id, department.name as department_name";
+    if (fields & kManager) sql += ", person.manager_id, manager.first_name || ' ' || manager.last_name as manager_full_name";
+    // the joins stay whatever the fields, they leave out the persons whose job,
+    // department or manager is missing, and a page must hold the same rows
+    // with fields= as without
+    sql += " from person"
+           " join job on person.job_id = job.id"
+           " join department on person.department_id = department.id"
+           " join person as manager on person.manager_id = manager.id";
+    return sql;
 }
 
-PersonsController::PersonDetails::PersonDetails(const PersonInfo &personInfo) {
-    id = personInfo.getValueOfId();
-    first_name = personInfo.getValueOfFirstName();
-    last_name = personInfo.getValueOfLastName();
-    hire_date = personInfo.getValueOfHireDate();
-    Json::Value managerJson{};
-    managerJson["id"] = personInfo.getValueOfManagerId();
-    managerJson["full_name"] = personInfo.getValueOfManagerFullName();
-    this->manager = managerJson;
-    Json::Value departmentJson{};
-    departmentJson["id"] = personInfo.getValueOfDepartmentId();
-    departmentJson["name"] = personInfo.getValueOfDepartmentName();
-    this->department = departmentJson;
-    Json::Value jobJson{};
-    jobJson["id"] = personInfo.getValueOfJobId();
-    jobJson["title"] = personInfo.getValueOfJobTitle();
-    this->job = jobJson;
+std::string PersonsController::selectByIdsSql(unsigned fields, ClientType type, std::string &ids) {
+    if (type == ClientType::Sqlite3) {
+        ids = "[" + ids + "]";
+        return selectSql(fields) + " where person.id in (select value from json_each($1))";
+    }
+    ids = "{" + ids + "}";
+    return selectSql(fields) + " where person.id = any($1::int[])";
+}
+
+PersonsController::PersonDetails::PersonDetails(const Row &row, unsigned fields) : fields(fields) {
+    id = row["id"].as<int32_t>();
+    if (fields & kFirstName) {
+        first_name = row["first_name"].as<std::string>();
+    }
+    if (fields & kLastName) {
+        last_name = row["last_name"].as<std::string>();
+    }
+    if ((fields & kHireDate) && !row["hire_date"].isNull()) {
+        auto daysStr = row["hire_date"].as<std::string>();
+        struct tm stm;
+        memset(&stm, 0, sizeof(stm));
+        strptime(daysStr.c_str(), "%Y-%m-%d", &stm);
+        time_t t = mktime(&stm);
+        hire_date = trantor::Date(t * 1000000);
+    }
+    if (fields & kManager) {
+        Json::Value managerJson{};
+        managerJson["id"] = row["manager_id"].as<int32_t>();
+        managerJson["full_name"] = row["manager_full_name"].as<std::string>();
+        this->manager = managerJson;
+    }
+    if (fields & kDepartment) {
+        Json::Value departmentJson{};
+        departmentJson["id"] = row["department_id"].as<int32_t>();
+        departmentJson["name"] = row["department_name"].as<std::string>();
+        this->department = departmentJson;
+    }
+    if (fields & kJob) {
+        Json::Value jobJson{};
+        jobJson["id"] = row["job_id"].as<int32_t>();
+        jobJson["title"] = row["job_title"].as<std::string>();
+        this->job = jobJson;
+    }
 }
 
 auto PersonsController::PersonDetails::toJson() -> Json::Value {
     Json::Value ret{};
-    ret["id"] = id;
-    ret["first_name"] = first_name;
-    ret["last_name"] = last_name;
-    ret["hire_date"] = hire_date.toDbStringLocal();
-    ret["manager"] = manager;
-    ret["department"] = department;
-    ret["job"] = job;
+    if (fields & kId) ret["id"] = id;
+    if (fields & kFirstName) ret["first_name"] = first_name;
+    if (fields & kLastName) ret["last_name"] = last_name;
+    if (fields & kHireDate) ret["hire_date"] = hire_date.toDbStringLocal();
+    if (fields & kManager) ret["manager"] = manager;
+    if (fields & kDepartment) ret["department"] = department;
+    if (fields & kJob) ret["job"] = job;
     return ret;
 }
@@ -26,8 +26,26 @@ class PersonsController : public drogon::HttpController<PersonsController> {
     void deleteOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int pPersonId) const;
     void getDirectReports(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int pPersonId) const;
 
+    // Parts of a person response selectable with the fields= and embed= query parameters.
+    enum PersonField : unsigned {
+        kId = 1 << 0,
+        kFirstName = 1 << 1,
+        kLastName = 1 << 2,
+        kHireDate = 1 << 3,
+        kManager = 1 << 4,
+        kDepartment = 1 << 5,
+        kJob = 1 << 6,
+        kAllFields = kId | kFirstName | kLastName | kHireDate | kManager | kDepartment | kJob
+    };
+
+    static std::string selectSql(unsigned fields);
+    // The select of getByIds(). ids is the comma separated list of ids, it is
+    // turned into the JSON array (SQLite) or the int[] (PostgreSQL) bound as $1.
+    static std::string selectByIdsSql(unsigned fields, orm::ClientType type, std::string &ids);
+
  private:
     struct PersonDetails {
+        unsigned fields{kAllFields};
         int id;
         std::string first_name;
         std::string last_name;
@@ -36,7 +54,10 @@ class PersonsController : public drogon::HttpController<PersonsController> {
         Json::Value department;
         Json::Value job;
         PersonDetails() {}
-        explicit PersonDetails(const PersonInfo &personInfo);
+        PersonDetails(const drogon::orm::Row &row, unsigned fields);
         Json::Value toJson();
     };
+
+    void getByIds(const HttpRequestPtr &req, const std::string &ids, unsigned fields, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    static bool parseFields(const HttpRequestPtr &req, unsigned &fields, std::string &err);
 };
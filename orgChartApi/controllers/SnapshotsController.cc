@@ -0,0 +1,107 @@
+#include "SnapshotsController.h"
+#include "../plugins/SnapshotPlugin.h"
+#include "../utils/utils.h"
+#include <ctime>
+#include <memory>
+#include <regex>
+#include <utility>
+
+using namespace drogon;
+
+void SnapshotsController::createOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const {
+    LOG_DEBUG << "createOne";
+    auto callbackPtr = std::make_shared<std::function<void(const HttpResponsePtr &)>>(std::move(callback));
+    auto *snapshotPtr = drogon::app().getPlugin<SnapshotPlugin>();
+
+    snapshotPtr->capture([callbackPtr](const std::string &date) {
+        if (date.empty()) {
+            auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("snapshot failed"));
+            resp->setStatusCode(HttpStatusCode::k500InternalServerError);
+            (*callbackPtr)(resp);
+            return;
+        }
+        Json::Value ret{};
+        ret["date"] = date;
+        auto resp = HttpResponse::newHttpJsonResponse(ret);
+        resp->setStatusCode(HttpStatusCode::k201Created);
+        (*callbackPtr)(resp);
+    });
+}
+
+void SnapshotsController::getOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, const std::string &date) const {
+    LOG_DEBUG << "getOne date: " << date;
+    auto snapshot = openSnapshot(date);
+    if (!snapshot) {
+        auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+        resp->setStatusCode(HttpStatusCode::k404NotFound);
+        callback(resp);
+        return;
+    }
+
+    Json::Value persons{Json::arrayValue};
+    for (const auto &row : snapshot->rows()) {
+        persons.append(rowToJson(*snapshot, row));
+    }
+    Json::Value ret{};
+    ret["date"] = date;
+    ret["taken_at"] = trantor::Date(snapshot->takenAt() * 1000000).toDbStringLocal();
+    ret["persons"] = std::move(persons);
+    auto resp = HttpResponse::newHttpJsonResponse(ret);
+    resp->setStatusCode(HttpStatusCode::k200OK);
+    callback(resp);
+}
+
+void SnapshotsController::getSnapshotPerson(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, const std::string &date, int personId) const {
+    LOG_DEBUG << "getSnapshotPerson date: " << date << " personId: " << personId;
+    auto snapshot = openSnapshot(date);
+    const OrgSnapshotView::Row *row = snapshot ? snapshot->find(personId) : nullptr;
+    if (!row) {
+        auto resp = HttpResponse::newHttpJsonResponse(makeErrResp("resource not found"));
+        resp->setStatusCode(HttpStatusCode::k404NotFound);
+        callback(resp);
+        return;
+    }
+
+    auto resp = HttpResponse::newHttpJsonResponse(rowToJson(*snapshot, *row));
+    resp->setStatusCode(HttpStatusCode::k200OK);
+    callback(resp);
+}
+
+std::shared_ptr<OrgSnapshotView> SnapshotsController::openSnapshot(const std::string &date) {
+    // the date becomes part of a file path
+    static const std::regex datePattern("^[0-9]{4}-[0-9]{2}-[0-9]{2}$");
+    if (!std::regex_match(date, datePattern)) {
+        return nullptr;
+    }
+    auto *snapshotPtr = drogon::app().getPlugin<SnapshotPlugin>();
+    return OrgSnapshotView::open(snapshotPtr->pathFor(date));
+}
+
+Json::Value SnapshotsController::rowToJson(const OrgSnapshotView &snapshot, const OrgSnapshotView::Row &row) {
+    time_t hireTime = static_cast<time_t>(row.hireDay) * 86400;
+    struct tm hireTm;
+    gmtime_r(&hireTime, &hireTm);
+    char hireDate[16];
+    strftime(hireDate, sizeof(hireDate), "%Y-%m-%d", &hireTm);
+
+    Json::Value ret{};
+    ret["id"] = row.id;
+    ret["first_name"] = std::string(row.firstName);
+    ret["last_name"] = std::string(row.lastName);
+    ret["hire_date"] = hireDate;
+    Json::Value managerJson{};
+    managerJson["id"] = row.managerId;
+    if (const auto *manager = snapshot.find(row.managerId)) {
+        managerJson["full_name"] = std::string(manager->firstName) + " " + std::string(manager->lastName);
+    }
+    ret["manager"] = managerJson;
+    Json::Value departmentJson{};
+    departmentJson["id"] = row.departmentId;
+    departmentJson["name"] = std::string(row.departmentName);
+    ret["department"] = departmentJson;
+    Json::Value jobJson{};
+    jobJson["id"] = row.jobId;
+    jobJson["title"] = std::string(row.jobTitle);
+    ret["job"] = jobJson;
+    return ret;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <string>
+#include "../utils/OrgSnapshot.h"
+
+using namespace drogon;
+
+class SnapshotsController : public drogon::HttpController<SnapshotsController> {
+ public:
+    METHOD_LIST_BEGIN
+      ADD_METHOD_TO(SnapshotsController::createOne, "/snapshots", Post, "LoginFilter");
+      ADD_METHOD_TO(SnapshotsController::getOne, "/snapshots/{1}", Get, "LoginFilter");
+      ADD_METHOD_TO(SnapshotsController::getSnapshotPerson, "/snapshots/{1}/persons/{2}", Get, "LoginFilter");
+    METHOD_LIST_END
+
+    void createOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    void getOne(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, const std::string &date) const;
+    void getSnapshotPerson(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, const std::string &date, int personId) const;
+
+ private:
+    static std::shared_ptr<OrgSnapshotView> openSnapshot(const std::string &date);
+    static Json::Value rowToJson(const OrgSnapshotView &snapshot, const OrgSnapshotView::Row &row);
+};
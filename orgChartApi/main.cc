@@ -1,7 +1,9 @@
 #include <drogon/drogon.h>
-int main() {
-    LOG_DEBUG << "Load config file";
-    drogon::app().loadConfigFile("../config.json");
+int main(int argc, char *argv[]) {
+    // e.g. ../config.sqlite.json to run on an in-memory SQLite database
+    auto configFile = argc > 1 ? argv[1] : "../config.json";
+    LOG_DEBUG << "Load config file " << configFile;
+    drogon::app().loadConfigFile(configFile);
 
     LOG_DEBUG << "running on localhost:3000";
     drogon::app().run();
@@ -35,11 +35,13 @@ Department::Department(const Row &r, const ssize_t indexOffset) noexcept
     {
         if(!r["id"].isNull())
         {
-            id_=std::make_shared<int32_t>(r["id"].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r["id"].as<int32_t>());
         }
         if(!r["name"].isNull())
         {
-            name_=std::make_shared<std::string>(r["name"].as<std::string>());
+            nullMask_[1] = false;
+            name_=std::string(r["name"].as<std::string>());
         }
     }
     else
@@ -54,12 +56,14 @@ Department::Department(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 0;
         if(!r[index].isNull())
         {
-            id_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 1;
         if(!r[index].isNull())
         {
-            name_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[1] = false;
+            name_=std::string(r[index].as<std::string>());
         }
     }
 
@@ -77,7 +81,8 @@ Department::Department(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[0] = true;
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -85,7 +90,8 @@ Department::Department(const Json::Value &pJson, const std::vector<std::string>
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            name_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            name_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
 }
@@ -97,7 +103,8 @@ Department::Department(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[0]=true;
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("name"))
@@ -105,7 +112,8 @@ Department::Department(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1]=true;
         if(!pJson["name"].isNull())
         {
-            name_=std::make_shared<std::string>(pJson["name"].asString());
+            nullMask_[1] = false;
+            name_=std::string(pJson["name"].asString());
         }
     }
 }
@@ -122,7 +130,8 @@ void Department::updateByMasqueradedJson(const Json::Value &pJson,
     {
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -130,7 +139,8 @@ void Department::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            name_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            name_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
 }
@@ -141,7 +151,8 @@ void Department::updateByJson(const Json::Value &pJson) noexcept(false)
     {
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("name"))
@@ -149,7 +160,8 @@ void Department::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1] = true;
         if(!pJson["name"].isNull())
         {
-            name_=std::make_shared<std::string>(pJson["name"].asString());
+            nullMask_[1] = false;
+            name_=std::string(pJson["name"].asString());
         }
     }
 }
@@ -157,49 +169,54 @@ void Department::updateByJson(const Json::Value &pJson) noexcept(false)
 const int32_t &Department::getValueOfId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(id_)
-        return *id_;
+    if(!nullMask_[0])
+        return id_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Department::getId() const noexcept
+const int32_t *Department::getId() const noexcept
 {
-    return id_;
+    return !nullMask_[0] ? &id_ : nullptr;
 }
 void Department::setId(const int32_t &pId) noexcept
 {
-    id_ = std::make_shared<int32_t>(pId);
+    nullMask_[0] = false;
+    id_ = int32_t(pId);
     dirtyFlag_[0] = true;
 }
 const typename Department::PrimaryKeyType & Department::getPrimaryKey() const
 {
-    assert(id_);
-    return *id_;
+    assert(!nullMask_[0]);
+    return id_;
 }
 
 const std::string &Department::getValueOfName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(name_)
-        return *name_;
+    if(!nullMask_[1])
+        return name_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &Department::getName() const noexcept
+const std::string *Department::getName() const noexcept
 {
-    return name_;
+    return !nullMask_[1] ? &name_ : nullptr;
 }
 void Department::setName(const std::string &pName) noexcept
 {
-    name_ = std::make_shared<std::string>(pName);
+    nullMask_[1] = false;
+    name_ = std::string(pName);
     dirtyFlag_[1] = true;
 }
 void Department::setName(std::string &&pName) noexcept
 {
-    name_ = std::make_shared<std::string>(std::move(pName));
+    nullMask_[1] = false;
+    name_ = std::string(std::move(pName));
     dirtyFlag_[1] = true;
 }
 
 void Department::updateId(const uint64_t id)
 {
+    nullMask_[0] = false;
+    id_ = int32_t(static_cast<int32_t>(id));
 }
 
 const std::vector<std::string> &Department::insertColumns() noexcept
@@ -490,7 +507,7 @@ void Department::getPersons(const DbClientPtr &clientPtr,
 {
     const static std::string sql = "select * from person where department_id = $1";
     *clientPtr << sql
-               << *id_
+               << id_
                >> [rcb = std::move(rcb)](const Result &r){
                    std::vector<Person> ret;
                    ret.reserve(r.size());
@@ -21,6 +21,7 @@
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <bitset>
 #include <stdint.h>
 #include <iostream>
 
@@ -99,16 +100,16 @@ class Department
     /**  For column id  */
     ///Get the value of the column id, returns the default value if the column is null
     const int32_t &getValueOfId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getId() const noexcept;
     ///Set the value of the column id
     void setId(const int32_t &pId) noexcept;
 
     /**  For column name  */
     ///Get the value of the column name, returns the default value if the column is null
     const std::string &getValueOfName() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getName() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getName() const noexcept;
     ///Set the value of the column name
     void setName(const std::string &pName) noexcept;
     void setName(std::string &&pName) noexcept;
@@ -134,8 +135,10 @@ class Department
     void updateArgs(drogon::orm::internal::SqlBinder &binder) const;
     ///For mysql or sqlite3
     void updateId(const uint64_t id);
-    std::shared_ptr<int32_t> id_;
-    std::shared_ptr<std::string> name_;
+    int32_t id_{};
+    std::string name_{};
+    ///A set bit marks a null column, all columns are null initially
+    std::bitset<2> nullMask_{std::bitset<2>().set()};
     struct MetaData
     {
         const std::string colName_;
@@ -165,8 +168,6 @@ class Department
         std::string sql="insert into " + tableName + " (";
         size_t parametersCount = 0;
         needSelection = false;
-            sql += "id,";
-            ++parametersCount;
         if(dirtyFlag_[1])
         {
             sql += "name,";
@@ -184,7 +185,6 @@ class Department
         int placeholder=1;
         char placeholderStr[64];
         size_t n=0;
-        sql +="default,";
         if(dirtyFlag_[1])
         {
             n = sprintf(placeholderStr,"$%d,",placeholder++);
@@ -35,11 +35,13 @@ Job::Job(const Row &r, const ssize_t indexOffset) noexcept
     {
         if(!r["id"].isNull())
         {
-            id_=std::make_shared<int32_t>(r["id"].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r["id"].as<int32_t>());
         }
         if(!r["title"].isNull())
         {
-            title_=std::make_shared<std::string>(r["title"].as<std::string>());
+            nullMask_[1] = false;
+            title_=std::string(r["title"].as<std::string>());
         }
     }
     else
@@ -54,12 +56,14 @@ Job::Job(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 0;
         if(!r[index].isNull())
         {
-            id_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 1;
         if(!r[index].isNull())
         {
-            title_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[1] = false;
+            title_=std::string(r[index].as<std::string>());
         }
     }
 
@@ -77,7 +81,8 @@ Job::Job(const Json::Value &pJson, const std::vector<std::string> &pMasquerading
         dirtyFlag_[0] = true;
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -85,7 +90,8 @@ Job::Job(const Json::Value &pJson, const std::vector<std::string> &pMasquerading
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            title_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            title_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
 }
@@ -97,7 +103,8 @@ Job::Job(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[0]=true;
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("title"))
@@ -105,7 +112,8 @@ Job::Job(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1]=true;
         if(!pJson["title"].isNull())
         {
-            title_=std::make_shared<std::string>(pJson["title"].asString());
+            nullMask_[1] = false;
+            title_=std::string(pJson["title"].asString());
         }
     }
 }
@@ -122,7 +130,8 @@ void Job::updateByMasqueradedJson(const Json::Value &pJson,
     {
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -130,7 +139,8 @@ void Job::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            title_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            title_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
 }
@@ -141,7 +151,8 @@ void Job::updateByJson(const Json::Value &pJson) noexcept(false)
     {
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("title"))
@@ -149,7 +160,8 @@ void Job::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1] = true;
         if(!pJson["title"].isNull())
         {
-            title_=std::make_shared<std::string>(pJson["title"].asString());
+            nullMask_[1] = false;
+            title_=std::string(pJson["title"].asString());
         }
     }
 }
@@ -157,49 +169,54 @@ void Job::updateByJson(const Json::Value &pJson) noexcept(false)
 const int32_t &Job::getValueOfId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(id_)
-        return *id_;
+    if(!nullMask_[0])
+        return id_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Job::getId() const noexcept
+const int32_t *Job::getId() const noexcept
 {
-    return id_;
+    return !nullMask_[0] ? &id_ : nullptr;
 }
 void Job::setId(const int32_t &pId) noexcept
 {
-    id_ = std::make_shared<int32_t>(pId);
+    nullMask_[0] = false;
+    id_ = int32_t(pId);
     dirtyFlag_[0] = true;
 }
 const typename Job::PrimaryKeyType & Job::getPrimaryKey() const
 {
-    assert(id_);
-    return *id_;
+    assert(!nullMask_[0]);
+    return id_;
 }
 
 const std::string &Job::getValueOfTitle() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(title_)
-        return *title_;
+    if(!nullMask_[1])
+        return title_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &Job::getTitle() const noexcept
+const std::string *Job::getTitle() const noexcept
 {
-    return title_;
+    return !nullMask_[1] ? &title_ : nullptr;
 }
 void Job::setTitle(const std::string &pTitle) noexcept
 {
-    title_ = std::make_shared<std::string>(pTitle);
+    nullMask_[1] = false;
+    title_ = std::string(pTitle);
     dirtyFlag_[1] = true;
 }
 void Job::setTitle(std::string &&pTitle) noexcept
 {
-    title_ = std::make_shared<std::string>(std::move(pTitle));
+    nullMask_[1] = false;
+    title_ = std::string(std::move(pTitle));
     dirtyFlag_[1] = true;
 }
 
 void Job::updateId(const uint64_t id)
 {
+    nullMask_[0] = false;
+    id_ = int32_t(static_cast<int32_t>(id));
 }
 
 const std::vector<std::string> &Job::insertColumns() noexcept
@@ -490,7 +507,7 @@ void Job::getPersons(const DbClientPtr &clientPtr,
 {
     const static std::string sql = "select * from person where job_id = $1";
     *clientPtr << sql
-               << *id_
+               << id_
                >> [rcb = std::move(rcb)](const Result &r){
                    std::vector<Person> ret;
                    ret.reserve(r.size());
@@ -21,6 +21,7 @@
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <bitset>
 #include <stdint.h>
 #include <iostream>
 
@@ -99,16 +100,16 @@ class Job
     /**  For column id  */
     ///Get the value of the column id, returns the default value if the column is null
     const int32_t &getValueOfId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getId() const noexcept;
     ///Set the value of the column id
     void setId(const int32_t &pId) noexcept;
 
     /**  For column title  */
     ///Get the value of the column title, returns the default value if the column is null
     const std::string &getValueOfTitle() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getTitle() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getTitle() const noexcept;
     ///Set the value of the column title
     void setTitle(const std::string &pTitle) noexcept;
     void setTitle(std::string &&pTitle) noexcept;
@@ -134,8 +135,10 @@ class Job
     void updateArgs(drogon::orm::internal::SqlBinder &binder) const;
     ///For mysql or sqlite3
     void updateId(const uint64_t id);
-    std::shared_ptr<int32_t> id_;
-    std::shared_ptr<std::string> title_;
+    int32_t id_{};
+    std::string title_{};
+    ///A set bit marks a null column, all columns are null initially
+    std::bitset<2> nullMask_{std::bitset<2>().set()};
     struct MetaData
     {
         const std::string colName_;
@@ -165,8 +168,6 @@ class Job
         std::string sql="insert into " + tableName + " (";
         size_t parametersCount = 0;
         needSelection = false;
-            sql += "id,";
-            ++parametersCount;
         if(dirtyFlag_[1])
         {
             sql += "title,";
@@ -184,7 +185,6 @@ class Job
         int placeholder=1;
         char placeholderStr[64];
         size_t n=0;
-        sql +="default,";
         if(dirtyFlag_[1])
         {
             n = sprintf(placeholderStr,"$%d,",placeholder++);
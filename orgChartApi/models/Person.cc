@@ -46,36 +46,38 @@ Person::Person(const Row &r, const ssize_t indexOffset) noexcept
     {
         if(!r["id"].isNull())
         {
-            id_=std::make_shared<int32_t>(r["id"].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r["id"].as<int32_t>());
         }
         if(!r["job_id"].isNull())
         {
-            jobId_=std::make_shared<int32_t>(r["job_id"].as<int32_t>());
+            nullMask_[1] = false;
+            jobId_=int32_t(r["job_id"].as<int32_t>());
         }
         if(!r["department_id"].isNull())
         {
-            departmentId_=std::make_shared<int32_t>(r["department_id"].as<int32_t>());
+            nullMask_[2] = false;
+            departmentId_=int32_t(r["department_id"].as<int32_t>());
         }
         if(!r["manager_id"].isNull())
         {
-            managerId_=std::make_shared<int32_t>(r["manager_id"].as<int32_t>());
+            nullMask_[3] = false;
+            managerId_=int32_t(r["manager_id"].as<int32_t>());
         }
         if(!r["first_name"].isNull())
         {
-            firstName_=std::make_shared<std::string>(r["first_name"].as<std::string>());
+            nullMask_[4] = false;
+            firstName_=std::string(r["first_name"].as<std::string>());
         }
         if(!r["last_name"].isNull())
         {
-            lastName_=std::make_shared<std::string>(r["last_name"].as<std::string>());
+            nullMask_[5] = false;
+            lastName_=std::string(r["last_name"].as<std::string>());
         }
         if(!r["hire_date"].isNull())
         {
-            auto daysStr = r["hire_date"].as<std::string>();
-            struct tm stm;
-            memset(&stm,0,sizeof(stm));
-            strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
-            time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(r["hire_date"].as<::trantor::Date>());
         }
     }
     else
@@ -90,42 +92,44 @@ Person::Person(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 0;
         if(!r[index].isNull())
         {
-            id_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 1;
         if(!r[index].isNull())
         {
-            jobId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[1] = false;
+            jobId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 2;
         if(!r[index].isNull())
         {
-            departmentId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[2] = false;
+            departmentId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 3;
         if(!r[index].isNull())
         {
-            managerId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[3] = false;
+            managerId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 4;
         if(!r[index].isNull())
         {
-            firstName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[4] = false;
+            firstName_=std::string(r[index].as<std::string>());
         }
         index = offset + 5;
         if(!r[index].isNull())
         {
-            lastName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[5] = false;
+            lastName_=std::string(r[index].as<std::string>());
         }
         index = offset + 6;
         if(!r[index].isNull())
         {
-            auto daysStr = r[index].as<std::string>();
-            struct tm stm;
-            memset(&stm,0,sizeof(stm));
-            strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
-            time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(r[index].as<::trantor::Date>());
         }
     }
 
@@ -143,7 +147,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[0] = true;
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -151,7 +156,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            jobId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[1]].asInt64());
+            nullMask_[1] = false;
+            jobId_=int32_t((int32_t)pJson[pMasqueradingVector[1]].asInt64());
         }
     }
     if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
@@ -159,7 +165,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[2] = true;
         if(!pJson[pMasqueradingVector[2]].isNull())
         {
-            departmentId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[2]].asInt64());
+            nullMask_[2] = false;
+            departmentId_=int32_t((int32_t)pJson[pMasqueradingVector[2]].asInt64());
         }
     }
     if(!pMasqueradingVector[3].empty() && pJson.isMember(pMasqueradingVector[3]))
@@ -167,7 +174,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[3] = true;
         if(!pJson[pMasqueradingVector[3]].isNull())
         {
-            managerId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[3]].asInt64());
+            nullMask_[3] = false;
+            managerId_=int32_t((int32_t)pJson[pMasqueradingVector[3]].asInt64());
         }
     }
     if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
@@ -175,7 +183,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[4] = true;
         if(!pJson[pMasqueradingVector[4]].isNull())
         {
-            firstName_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
+            nullMask_[4] = false;
+            firstName_=std::string(pJson[pMasqueradingVector[4]].asString());
         }
     }
     if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
@@ -183,7 +192,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
         dirtyFlag_[5] = true;
         if(!pJson[pMasqueradingVector[5]].isNull())
         {
-            lastName_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
+            nullMask_[5] = false;
+            lastName_=std::string(pJson[pMasqueradingVector[5]].asString());
         }
     }
     if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
@@ -196,7 +206,8 @@ Person::Person(const Json::Value &pJson, const std::vector<std::string> &pMasque
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
     }
 }
@@ -208,7 +219,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[0]=true;
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("job_id"))
@@ -216,7 +228,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1]=true;
         if(!pJson["job_id"].isNull())
         {
-            jobId_=std::make_shared<int32_t>((int32_t)pJson["job_id"].asInt64());
+            nullMask_[1] = false;
+            jobId_=int32_t((int32_t)pJson["job_id"].asInt64());
         }
     }
     if(pJson.isMember("department_id"))
@@ -224,7 +237,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[2]=true;
         if(!pJson["department_id"].isNull())
         {
-            departmentId_=std::make_shared<int32_t>((int32_t)pJson["department_id"].asInt64());
+            nullMask_[2] = false;
+            departmentId_=int32_t((int32_t)pJson["department_id"].asInt64());
         }
     }
     if(pJson.isMember("manager_id"))
@@ -232,7 +246,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[3]=true;
         if(!pJson["manager_id"].isNull())
         {
-            managerId_=std::make_shared<int32_t>((int32_t)pJson["manager_id"].asInt64());
+            nullMask_[3] = false;
+            managerId_=int32_t((int32_t)pJson["manager_id"].asInt64());
         }
     }
     if(pJson.isMember("first_name"))
@@ -240,7 +255,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[4]=true;
         if(!pJson["first_name"].isNull())
         {
-            firstName_=std::make_shared<std::string>(pJson["first_name"].asString());
+            nullMask_[4] = false;
+            firstName_=std::string(pJson["first_name"].asString());
         }
     }
     if(pJson.isMember("last_name"))
@@ -248,7 +264,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[5]=true;
         if(!pJson["last_name"].isNull())
         {
-            lastName_=std::make_shared<std::string>(pJson["last_name"].asString());
+            nullMask_[5] = false;
+            lastName_=std::string(pJson["last_name"].asString());
         }
     }
     if(pJson.isMember("hire_date"))
@@ -261,7 +278,8 @@ Person::Person(const Json::Value &pJson) noexcept(false)
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
     }
 }
@@ -278,7 +296,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
     {
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -286,7 +305,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            jobId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[1]].asInt64());
+            nullMask_[1] = false;
+            jobId_=int32_t((int32_t)pJson[pMasqueradingVector[1]].asInt64());
         }
     }
     if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
@@ -294,7 +314,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[2] = true;
         if(!pJson[pMasqueradingVector[2]].isNull())
         {
-            departmentId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[2]].asInt64());
+            nullMask_[2] = false;
+            departmentId_=int32_t((int32_t)pJson[pMasqueradingVector[2]].asInt64());
         }
     }
     if(!pMasqueradingVector[3].empty() && pJson.isMember(pMasqueradingVector[3]))
@@ -302,7 +323,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[3] = true;
         if(!pJson[pMasqueradingVector[3]].isNull())
         {
-            managerId_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[3]].asInt64());
+            nullMask_[3] = false;
+            managerId_=int32_t((int32_t)pJson[pMasqueradingVector[3]].asInt64());
         }
     }
     if(!pMasqueradingVector[4].empty() && pJson.isMember(pMasqueradingVector[4]))
@@ -310,7 +332,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[4] = true;
         if(!pJson[pMasqueradingVector[4]].isNull())
         {
-            firstName_=std::make_shared<std::string>(pJson[pMasqueradingVector[4]].asString());
+            nullMask_[4] = false;
+            firstName_=std::string(pJson[pMasqueradingVector[4]].asString());
         }
     }
     if(!pMasqueradingVector[5].empty() && pJson.isMember(pMasqueradingVector[5]))
@@ -318,7 +341,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[5] = true;
         if(!pJson[pMasqueradingVector[5]].isNull())
         {
-            lastName_=std::make_shared<std::string>(pJson[pMasqueradingVector[5]].asString());
+            nullMask_[5] = false;
+            lastName_=std::string(pJson[pMasqueradingVector[5]].asString());
         }
     }
     if(!pMasqueradingVector[6].empty() && pJson.isMember(pMasqueradingVector[6]))
@@ -331,7 +355,8 @@ void Person::updateByMasqueradedJson(const Json::Value &pJson,
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
     }
 }
@@ -342,7 +367,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
     {
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("job_id"))
@@ -350,7 +376,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1] = true;
         if(!pJson["job_id"].isNull())
         {
-            jobId_=std::make_shared<int32_t>((int32_t)pJson["job_id"].asInt64());
+            nullMask_[1] = false;
+            jobId_=int32_t((int32_t)pJson["job_id"].asInt64());
         }
     }
     if(pJson.isMember("department_id"))
@@ -358,7 +385,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[2] = true;
         if(!pJson["department_id"].isNull())
         {
-            departmentId_=std::make_shared<int32_t>((int32_t)pJson["department_id"].asInt64());
+            nullMask_[2] = false;
+            departmentId_=int32_t((int32_t)pJson["department_id"].asInt64());
         }
     }
     if(pJson.isMember("manager_id"))
@@ -366,7 +394,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[3] = true;
         if(!pJson["manager_id"].isNull())
         {
-            managerId_=std::make_shared<int32_t>((int32_t)pJson["manager_id"].asInt64());
+            nullMask_[3] = false;
+            managerId_=int32_t((int32_t)pJson["manager_id"].asInt64());
         }
     }
     if(pJson.isMember("first_name"))
@@ -374,7 +403,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[4] = true;
         if(!pJson["first_name"].isNull())
         {
-            firstName_=std::make_shared<std::string>(pJson["first_name"].asString());
+            nullMask_[4] = false;
+            firstName_=std::string(pJson["first_name"].asString());
         }
     }
     if(pJson.isMember("last_name"))
@@ -382,7 +412,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[5] = true;
         if(!pJson["last_name"].isNull())
         {
-            lastName_=std::make_shared<std::string>(pJson["last_name"].asString());
+            nullMask_[5] = false;
+            lastName_=std::string(pJson["last_name"].asString());
         }
     }
     if(pJson.isMember("hire_date"))
@@ -395,7 +426,8 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[6] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
     }
 }
@@ -403,139 +435,150 @@ void Person::updateByJson(const Json::Value &pJson) noexcept(false)
 const int32_t &Person::getValueOfId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(id_)
-        return *id_;
+    if(!nullMask_[0])
+        return id_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Person::getId() const noexcept
+const int32_t *Person::getId() const noexcept
 {
-    return id_;
+    return !nullMask_[0] ? &id_ : nullptr;
 }
 void Person::setId(const int32_t &pId) noexcept
 {
-    id_ = std::make_shared<int32_t>(pId);
+    nullMask_[0] = false;
+    id_ = int32_t(pId);
     dirtyFlag_[0] = true;
 }
 const typename Person::PrimaryKeyType & Person::getPrimaryKey() const
 {
-    assert(id_);
-    return *id_;
+    assert(!nullMask_[0]);
+    return id_;
 }
 
 const int32_t &Person::getValueOfJobId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(jobId_)
-        return *jobId_;
+    if(!nullMask_[1])
+        return jobId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Person::getJobId() const noexcept
+const int32_t *Person::getJobId() const noexcept
 {
-    return jobId_;
+    return !nullMask_[1] ? &jobId_ : nullptr;
 }
 void Person::setJobId(const int32_t &pJobId) noexcept
 {
-    jobId_ = std::make_shared<int32_t>(pJobId);
+    nullMask_[1] = false;
+    jobId_ = int32_t(pJobId);
     dirtyFlag_[1] = true;
 }
 
 const int32_t &Person::getValueOfDepartmentId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(departmentId_)
-        return *departmentId_;
+    if(!nullMask_[2])
+        return departmentId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Person::getDepartmentId() const noexcept
+const int32_t *Person::getDepartmentId() const noexcept
 {
-    return departmentId_;
+    return !nullMask_[2] ? &departmentId_ : nullptr;
 }
 void Person::setDepartmentId(const int32_t &pDepartmentId) noexcept
 {
-    departmentId_ = std::make_shared<int32_t>(pDepartmentId);
+    nullMask_[2] = false;
+    departmentId_ = int32_t(pDepartmentId);
     dirtyFlag_[2] = true;
 }
 
 const int32_t &Person::getValueOfManagerId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(managerId_)
-        return *managerId_;
+    if(!nullMask_[3])
+        return managerId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &Person::getManagerId() const noexcept
+const int32_t *Person::getManagerId() const noexcept
 {
-    return managerId_;
+    return !nullMask_[3] ? &managerId_ : nullptr;
 }
 void Person::setManagerId(const int32_t &pManagerId) noexcept
 {
-    managerId_ = std::make_shared<int32_t>(pManagerId);
+    nullMask_[3] = false;
+    managerId_ = int32_t(pManagerId);
     dirtyFlag_[3] = true;
 }
 
 const std::string &Person::getValueOfFirstName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(firstName_)
-        return *firstName_;
+    if(!nullMask_[4])
+        return firstName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &Person::getFirstName() const noexcept
+const std::string *Person::getFirstName() const noexcept
 {
-    return firstName_;
+    return !nullMask_[4] ? &firstName_ : nullptr;
 }
 void Person::setFirstName(const std::string &pFirstName) noexcept
 {
-    firstName_ = std::make_shared<std::string>(pFirstName);
+    nullMask_[4] = false;
+    firstName_ = std::string(pFirstName);
     dirtyFlag_[4] = true;
 }
 void Person::setFirstName(std::string &&pFirstName) noexcept
 {
-    firstName_ = std::make_shared<std::string>(std::move(pFirstName));
+    nullMask_[4] = false;
+    firstName_ = std::string(std::move(pFirstName));
     dirtyFlag_[4] = true;
 }
 
 const std::string &Person::getValueOfLastName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(lastName_)
-        return *lastName_;
+    if(!nullMask_[5])
+        return lastName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &Person::getLastName() const noexcept
+const std::string *Person::getLastName() const noexcept
 {
-    return lastName_;
+    return !nullMask_[5] ? &lastName_ : nullptr;
 }
 void Person::setLastName(const std::string &pLastName) noexcept
 {
-    lastName_ = std::make_shared<std::string>(pLastName);
+    nullMask_[5] = false;
+    lastName_ = std::string(pLastName);
     dirtyFlag_[5] = true;
 }
 void Person::setLastName(std::string &&pLastName) noexcept
 {
-    lastName_ = std::make_shared<std::string>(std::move(pLastName));
+    nullMask_[5] = false;
+    lastName_ = std::string(std::move(pLastName));
     dirtyFlag_[5] = true;
 }
 
 const ::trantor::Date &Person::getValueOfHireDate() const noexcept
 {
     const static ::trantor::Date defaultValue = ::trantor::Date();
-    if(hireDate_)
-        return *hireDate_;
+    if(!nullMask_[6])
+        return hireDate_;
     return defaultValue;
 }
-const std::shared_ptr<::trantor::Date> &Person::getHireDate() const noexcept
+const ::trantor::Date *Person::getHireDate() const noexcept
 {
-    return hireDate_;
+    return !nullMask_[6] ? &hireDate_ : nullptr;
 }
 void Person::setHireDate(const ::trantor::Date &pHireDate) noexcept
 {
-    hireDate_ = std::make_shared<::trantor::Date>(pHireDate.roundDay());
+    nullMask_[6] = false;
+    hireDate_ = ::trantor::Date(pHireDate.roundDay());
     dirtyFlag_[6] = true;
 }
 
 void Person::updateId(const uint64_t id)
 {
+    nullMask_[0] = false;
+    id_ = int32_t(static_cast<int32_t>(id));
 }
 
 const std::vector<std::string> &Person::insertColumns() noexcept
@@ -1330,7 +1373,7 @@ void Person::getDepartment(const DbClientPtr &clientPtr,
 {
     const static std::string sql = "select * from department where id = $1";
     *clientPtr << sql
-               << *departmentId_
+               << departmentId_
                >> [rcb = std::move(rcb), ecb](const Result &r){
                     if (r.size() == 0)
                     {
@@ -1353,7 +1396,7 @@ void Person::getJob(const DbClientPtr &clientPtr,
 {
     const static std::string sql = "select * from job where id = $1";
     *clientPtr << sql
-               << *jobId_
+               << jobId_
                >> [rcb = std::move(rcb), ecb](const Result &r){
                     if (r.size() == 0)
                     {
@@ -1376,7 +1419,7 @@ void Person::getPersons(const DbClientPtr &clientPtr,
 {
     const static std::string sql = "select * from person where manager_id = $1";
     *clientPtr << sql
-               << *id_
+               << id_
                >> [rcb = std::move(rcb)](const Result &r){
                    std::vector<Person> ret;
                    ret.reserve(r.size());
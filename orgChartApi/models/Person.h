@@ -21,6 +21,7 @@
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <bitset>
 #include <stdint.h>
 #include <iostream>
 
@@ -106,40 +107,40 @@ class Person
     /**  For column id  */
     ///Get the value of the column id, returns the default value if the column is null
     const int32_t &getValueOfId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getId() const noexcept;
     ///Set the value of the column id
     void setId(const int32_t &pId) noexcept;
 
     /**  For column job_id  */
     ///Get the value of the column job_id, returns the default value if the column is null
     const int32_t &getValueOfJobId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getJobId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getJobId() const noexcept;
     ///Set the value of the column job_id
     void setJobId(const int32_t &pJobId) noexcept;
 
     /**  For column department_id  */
     ///Get the value of the column department_id, returns the default value if the column is null
     const int32_t &getValueOfDepartmentId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getDepartmentId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getDepartmentId() const noexcept;
     ///Set the value of the column department_id
     void setDepartmentId(const int32_t &pDepartmentId) noexcept;
 
     /**  For column manager_id  */
     ///Get the value of the column manager_id, returns the default value if the column is null
     const int32_t &getValueOfManagerId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getManagerId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getManagerId() const noexcept;
     ///Set the value of the column manager_id
     void setManagerId(const int32_t &pManagerId) noexcept;
 
     /**  For column first_name  */
     ///Get the value of the column first_name, returns the default value if the column is null
     const std::string &getValueOfFirstName() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getFirstName() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getFirstName() const noexcept;
     ///Set the value of the column first_name
     void setFirstName(const std::string &pFirstName) noexcept;
     void setFirstName(std::string &&pFirstName) noexcept;
@@ -147,8 +148,8 @@ class Person
     /**  For column last_name  */
     ///Get the value of the column last_name, returns the default value if the column is null
     const std::string &getValueOfLastName() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getLastName() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getLastName() const noexcept;
     ///Set the value of the column last_name
     void setLastName(const std::string &pLastName) noexcept;
     void setLastName(std::string &&pLastName) noexcept;
@@ -156,8 +157,8 @@ class Person
     /**  For column hire_date  */
     ///Get the value of the column hire_date, returns the default value if the column is null
     const ::trantor::Date &getValueOfHireDate() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<::trantor::Date> &getHireDate() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const ::trantor::Date *getHireDate() const noexcept;
     ///Set the value of the column hire_date
     void setHireDate(const ::trantor::Date &pHireDate) noexcept;
 
@@ -188,13 +189,15 @@ class Person
     void updateArgs(drogon::orm::internal::SqlBinder &binder) const;
     ///For mysql or sqlite3
     void updateId(const uint64_t id);
-    std::shared_ptr<int32_t> id_;
-    std::shared_ptr<int32_t> jobId_;
-    std::shared_ptr<int32_t> departmentId_;
-    std::shared_ptr<int32_t> managerId_;
-    std::shared_ptr<std::string> firstName_;
-    std::shared_ptr<std::string> lastName_;
-    std::shared_ptr<::trantor::Date> hireDate_;
+    int32_t id_{};
+    int32_t jobId_{};
+    int32_t departmentId_{};
+    int32_t managerId_{};
+    std::string firstName_{};
+    std::string lastName_{};
+    ::trantor::Date hireDate_{};
+    ///A set bit marks a null column, all columns are null initially
+    std::bitset<7> nullMask_{std::bitset<7>().set()};
     struct MetaData
     {
         const std::string colName_;
@@ -224,8 +227,6 @@ class Person
         std::string sql="insert into " + tableName + " (";
         size_t parametersCount = 0;
         needSelection = false;
-            sql += "id,";
-            ++parametersCount;
         if(dirtyFlag_[1])
         {
             sql += "job_id,";
@@ -268,7 +269,6 @@ class Person
         int placeholder=1;
         char placeholderStr[64];
         size_t n=0;
-        sql +="default,";
         if(dirtyFlag_[1])
         {
             n = sprintf(placeholderStr,"$%d,",placeholder++);
@@ -13,39 +13,48 @@ PersonInfo::PersonInfo(const Row &r, const ssize_t indexOffset) noexcept
     {
         if(!r["id"].isNull())
         {
-            id_=std::make_shared<int32_t>(r["id"].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r["id"].as<int32_t>());
         }
         if(!r["job_id"].isNull())
         {
-            jobId_=std::make_shared<int32_t>(r["job_id"].as<int32_t>());
+            nullMask_[1] = false;
+            jobId_=int32_t(r["job_id"].as<int32_t>());
         }
         if(!r["job_title"].isNull())
         {
-            jobTitle_=std::make_shared<std::string>(r["job_title"].as<std::string>());
+            nullMask_[2] = false;
+            jobTitle_=std::string(r["job_title"].as<std::string>());
         }
         if(!r["department_id"].isNull())
         {
-            departmentId_=std::make_shared<int32_t>(r["department_id"].as<int32_t>());
+            nullMask_[3] = false;
+            departmentId_=int32_t(r["department_id"].as<int32_t>());
         }
         if(!r["department_name"].isNull())
         {
-            departmentName_=std::make_shared<std::string>(r["department_name"].as<std::string>());
+            nullMask_[4] = false;
+            departmentName_=std::string(r["department_name"].as<std::string>());
         }
         if(!r["manager_id"].isNull())
         {
-            managerId_=std::make_shared<int32_t>(r["manager_id"].as<int32_t>());
+            nullMask_[5] = false;
+            managerId_=int32_t(r["manager_id"].as<int32_t>());
         }
         if(!r["manager_full_name"].isNull())
         {
-            managerFullName_=std::make_shared<std::string>(r["manager_full_name"].as<std::string>());
+            nullMask_[6] = false;
+            managerFullName_=std::string(r["manager_full_name"].as<std::string>());
         }
         if(!r["first_name"].isNull())
         {
-            firstName_=std::make_shared<std::string>(r["first_name"].as<std::string>());
+            nullMask_[7] = false;
+            firstName_=std::string(r["first_name"].as<std::string>());
         }
         if(!r["last_name"].isNull())
         {
-            lastName_=std::make_shared<std::string>(r["last_name"].as<std::string>());
+            nullMask_[8] = false;
+            lastName_=std::string(r["last_name"].as<std::string>());
         }
         if(!r["hire_date"].isNull())
         {
@@ -54,7 +63,8 @@ PersonInfo::PersonInfo(const Row &r, const ssize_t indexOffset) noexcept
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[9] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
     }
     else
@@ -69,32 +79,38 @@ PersonInfo::PersonInfo(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 0;
         if(!r[index].isNull())
         {
-            id_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 1;
         if(!r[index].isNull())
         {
-            jobId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[1] = false;
+            jobId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 2;
         if(!r[index].isNull())
         {
-            departmentId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[3] = false;
+            departmentId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 3;
         if(!r[index].isNull())
         {
-            managerId_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[5] = false;
+            managerId_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 4;
         if(!r[index].isNull())
         {
-            firstName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[7] = false;
+            firstName_=std::string(r[index].as<std::string>());
         }
         index = offset + 5;
         if(!r[index].isNull())
         {
-            lastName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[8] = false;
+            lastName_=std::string(r[index].as<std::string>());
         }
         index = offset + 6;
         if(!r[index].isNull())
@@ -104,22 +120,26 @@ PersonInfo::PersonInfo(const Row &r, const ssize_t indexOffset) noexcept
             memset(&stm,0,sizeof(stm));
             strptime(daysStr.c_str(),"%Y-%m-%d",&stm);
             time_t t = mktime(&stm);
-            hireDate_=std::make_shared<::trantor::Date>(t*1000000);
+            nullMask_[9] = false;
+            hireDate_=::trantor::Date(t*1000000);
         }
         index = offset + 7;
         if(!r[index].isNull())
         {
-            jobTitle_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[2] = false;
+            jobTitle_=std::string(r[index].as<std::string>());
         }
         index = offset + 8;
         if(!r[index].isNull())
         {
-            departmentName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[4] = false;
+            departmentName_=std::string(r[index].as<std::string>());
         }
         index = offset + 9;
         if(!r[index].isNull())
         {
-            managerFullName_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[6] = false;
+            managerFullName_=std::string(r[index].as<std::string>());
         }
     }
 
@@ -128,121 +148,121 @@ PersonInfo::PersonInfo(const Row &r, const ssize_t indexOffset) noexcept
 const int32_t &PersonInfo::getValueOfId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(id_)
-        return *id_;
+    if(!nullMask_[0])
+        return id_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &PersonInfo::getId() const noexcept
+const int32_t *PersonInfo::getId() const noexcept
 {
-    return id_;
+    return !nullMask_[0] ? &id_ : nullptr;
 }
 
 const int32_t &PersonInfo::getValueOfJobId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(jobId_)
-        return *jobId_;
+    if(!nullMask_[1])
+        return jobId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &PersonInfo::getJobId() const noexcept
+const int32_t *PersonInfo::getJobId() const noexcept
 {
-    return jobId_;
+    return !nullMask_[1] ? &jobId_ : nullptr;
 }
 
 const std::string &PersonInfo::getValueOfJobTitle() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(jobTitle_)
-        return *jobTitle_;
+    if(!nullMask_[2])
+        return jobTitle_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &PersonInfo::getJobTitle() const noexcept
+const std::string *PersonInfo::getJobTitle() const noexcept
 {
-    return jobTitle_;
+    return !nullMask_[2] ? &jobTitle_ : nullptr;
 }
 
 const int32_t &PersonInfo::getValueOfDepartmentId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(departmentId_)
-        return *departmentId_;
+    if(!nullMask_[3])
+        return departmentId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &PersonInfo::getDepartmentId() const noexcept
+const int32_t *PersonInfo::getDepartmentId() const noexcept
 {
-    return departmentId_;
+    return !nullMask_[3] ? &departmentId_ : nullptr;
 }
 
 const std::string &PersonInfo::getValueOfDepartmentName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(departmentName_)
-        return *departmentName_;
+    if(!nullMask_[4])
+        return departmentName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &PersonInfo::getDepartmentName() const noexcept
+const std::string *PersonInfo::getDepartmentName() const noexcept
 {
-    return departmentName_;
+    return !nullMask_[4] ? &departmentName_ : nullptr;
 }
 
 const int32_t &PersonInfo::getValueOfManagerId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(managerId_)
-        return *managerId_;
+    if(!nullMask_[5])
+        return managerId_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &PersonInfo::getManagerId() const noexcept
+const int32_t *PersonInfo::getManagerId() const noexcept
 {
-    return managerId_;
+    return !nullMask_[5] ? &managerId_ : nullptr;
 }
 
 const std::string &PersonInfo::getValueOfManagerFullName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(managerFullName_)
-        return *managerFullName_;
+    if(!nullMask_[6])
+        return managerFullName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &PersonInfo::getManagerFullName() const noexcept
+const std::string *PersonInfo::getManagerFullName() const noexcept
 {
-    return managerFullName_;
+    return !nullMask_[6] ? &managerFullName_ : nullptr;
 }
 
 const std::string &PersonInfo::getValueOfFirstName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(firstName_)
-        return *firstName_;
+    if(!nullMask_[7])
+        return firstName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &PersonInfo::getFirstName() const noexcept
+const std::string *PersonInfo::getFirstName() const noexcept
 {
-    return firstName_;
+    return !nullMask_[7] ? &firstName_ : nullptr;
 }
 
 const std::string &PersonInfo::getValueOfLastName() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(lastName_)
-        return *lastName_;
+    if(!nullMask_[8])
+        return lastName_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &PersonInfo::getLastName() const noexcept
+const std::string *PersonInfo::getLastName() const noexcept
 {
-    return lastName_;
+    return !nullMask_[8] ? &lastName_ : nullptr;
 }
 
 const ::trantor::Date &PersonInfo::getValueOfHireDate() const noexcept
 {
     const static ::trantor::Date defaultValue = ::trantor::Date();
-    if(hireDate_)
-        return *hireDate_;
+    if(!nullMask_[9])
+        return hireDate_;
     return defaultValue;
 }
-const std::shared_ptr<::trantor::Date> &PersonInfo::getHireDate() const noexcept
+const ::trantor::Date *PersonInfo::getHireDate() const noexcept
 {
-    return hireDate_;
+    return !nullMask_[9] ? &hireDate_ : nullptr;
 }
 
 Json::Value PersonInfo::toJson() const
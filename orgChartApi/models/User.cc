@@ -36,15 +36,18 @@ User::User(const Row &r, const ssize_t indexOffset) noexcept
     {
         if(!r["id"].isNull())
         {
-            id_=std::make_shared<int32_t>(r["id"].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r["id"].as<int32_t>());
         }
         if(!r["username"].isNull())
         {
-            username_=std::make_shared<std::string>(r["username"].as<std::string>());
+            nullMask_[1] = false;
+            username_=std::string(r["username"].as<std::string>());
         }
         if(!r["password"].isNull())
         {
-            password_=std::make_shared<std::string>(r["password"].as<std::string>());
+            nullMask_[2] = false;
+            password_=std::string(r["password"].as<std::string>());
         }
     }
     else
@@ -59,17 +62,20 @@ User::User(const Row &r, const ssize_t indexOffset) noexcept
         index = offset + 0;
         if(!r[index].isNull())
         {
-            id_=std::make_shared<int32_t>(r[index].as<int32_t>());
+            nullMask_[0] = false;
+            id_=int32_t(r[index].as<int32_t>());
         }
         index = offset + 1;
         if(!r[index].isNull())
         {
-            username_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[1] = false;
+            username_=std::string(r[index].as<std::string>());
         }
         index = offset + 2;
         if(!r[index].isNull())
         {
-            password_=std::make_shared<std::string>(r[index].as<std::string>());
+            nullMask_[2] = false;
+            password_=std::string(r[index].as<std::string>());
         }
     }
 
@@ -87,7 +93,8 @@ User::User(const Json::Value &pJson, const std::vector<std::string> &pMasqueradi
         dirtyFlag_[0] = true;
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -95,7 +102,8 @@ User::User(const Json::Value &pJson, const std::vector<std::string> &pMasqueradi
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            username_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            username_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
     if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
@@ -103,7 +111,8 @@ User::User(const Json::Value &pJson, const std::vector<std::string> &pMasqueradi
         dirtyFlag_[2] = true;
         if(!pJson[pMasqueradingVector[2]].isNull())
         {
-            password_=std::make_shared<std::string>(pJson[pMasqueradingVector[2]].asString());
+            nullMask_[2] = false;
+            password_=std::string(pJson[pMasqueradingVector[2]].asString());
         }
     }
 }
@@ -115,7 +124,8 @@ User::User(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[0]=true;
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("username"))
@@ -123,7 +133,8 @@ User::User(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1]=true;
         if(!pJson["username"].isNull())
         {
-            username_=std::make_shared<std::string>(pJson["username"].asString());
+            nullMask_[1] = false;
+            username_=std::string(pJson["username"].asString());
         }
     }
     if(pJson.isMember("password"))
@@ -131,7 +142,8 @@ User::User(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[2]=true;
         if(!pJson["password"].isNull())
         {
-            password_=std::make_shared<std::string>(pJson["password"].asString());
+            nullMask_[2] = false;
+            password_=std::string(pJson["password"].asString());
         }
     }
 }
@@ -148,7 +160,8 @@ void User::updateByMasqueradedJson(const Json::Value &pJson,
     {
         if(!pJson[pMasqueradingVector[0]].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson[pMasqueradingVector[0]].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson[pMasqueradingVector[0]].asInt64());
         }
     }
     if(!pMasqueradingVector[1].empty() && pJson.isMember(pMasqueradingVector[1]))
@@ -156,7 +169,8 @@ void User::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[1] = true;
         if(!pJson[pMasqueradingVector[1]].isNull())
         {
-            username_=std::make_shared<std::string>(pJson[pMasqueradingVector[1]].asString());
+            nullMask_[1] = false;
+            username_=std::string(pJson[pMasqueradingVector[1]].asString());
         }
     }
     if(!pMasqueradingVector[2].empty() && pJson.isMember(pMasqueradingVector[2]))
@@ -164,7 +178,8 @@ void User::updateByMasqueradedJson(const Json::Value &pJson,
         dirtyFlag_[2] = true;
         if(!pJson[pMasqueradingVector[2]].isNull())
         {
-            password_=std::make_shared<std::string>(pJson[pMasqueradingVector[2]].asString());
+            nullMask_[2] = false;
+            password_=std::string(pJson[pMasqueradingVector[2]].asString());
         }
     }
 }
@@ -175,7 +190,8 @@ void User::updateByJson(const Json::Value &pJson) noexcept(false)
     {
         if(!pJson["id"].isNull())
         {
-            id_=std::make_shared<int32_t>((int32_t)pJson["id"].asInt64());
+            nullMask_[0] = false;
+            id_=int32_t((int32_t)pJson["id"].asInt64());
         }
     }
     if(pJson.isMember("username"))
@@ -183,7 +199,8 @@ void User::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[1] = true;
         if(!pJson["username"].isNull())
         {
-            username_=std::make_shared<std::string>(pJson["username"].asString());
+            nullMask_[1] = false;
+            username_=std::string(pJson["username"].asString());
         }
     }
     if(pJson.isMember("password"))
@@ -191,7 +208,8 @@ void User::updateByJson(const Json::Value &pJson) noexcept(false)
         dirtyFlag_[2] = true;
         if(!pJson["password"].isNull())
         {
-            password_=std::make_shared<std::string>(pJson["password"].asString());
+            nullMask_[2] = false;
+            password_=std::string(pJson["password"].asString());
         }
     }
 }
@@ -199,71 +217,78 @@ void User::updateByJson(const Json::Value &pJson) noexcept(false)
 const int32_t &User::getValueOfId() const noexcept
 {
     const static int32_t defaultValue = int32_t();
-    if(id_)
-        return *id_;
+    if(!nullMask_[0])
+        return id_;
     return defaultValue;
 }
-const std::shared_ptr<int32_t> &User::getId() const noexcept
+const int32_t *User::getId() const noexcept
 {
-    return id_;
+    return !nullMask_[0] ? &id_ : nullptr;
 }
 void User::setId(const int32_t &pId) noexcept
 {
-    id_ = std::make_shared<int32_t>(pId);
+    nullMask_[0] = false;
+    id_ = int32_t(pId);
     dirtyFlag_[0] = true;
 }
 const typename User::PrimaryKeyType & User::getPrimaryKey() const
 {
-    assert(id_);
-    return *id_;
+    assert(!nullMask_[0]);
+    return id_;
 }
 
 const std::string &User::getValueOfUsername() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(username_)
-        return *username_;
+    if(!nullMask_[1])
+        return username_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &User::getUsername() const noexcept
+const std::string *User::getUsername() const noexcept
 {
-    return username_;
+    return !nullMask_[1] ? &username_ : nullptr;
 }
 void User::setUsername(const std::string &pUsername) noexcept
 {
-    username_ = std::make_shared<std::string>(pUsername);
+    nullMask_[1] = false;
+    username_ = std::string(pUsername);
     dirtyFlag_[1] = true;
 }
 void User::setUsername(std::string &&pUsername) noexcept
 {
-    username_ = std::make_shared<std::string>(std::move(pUsername));
+    nullMask_[1] = false;
+    username_ = std::string(std::move(pUsername));
     dirtyFlag_[1] = true;
 }
 
 const std::string &User::getValueOfPassword() const noexcept
 {
     const static std::string defaultValue = std::string();
-    if(password_)
-        return *password_;
+    if(!nullMask_[2])
+        return password_;
     return defaultValue;
 }
-const std::shared_ptr<std::string> &User::getPassword() const noexcept
+const std::string *User::getPassword() const noexcept
 {
-    return password_;
+    return !nullMask_[2] ? &password_ : nullptr;
 }
 void User::setPassword(const std::string &pPassword) noexcept
 {
-    password_ = std::make_shared<std::string>(pPassword);
+    nullMask_[2] = false;
+    password_ = std::string(pPassword);
     dirtyFlag_[2] = true;
 }
 void User::setPassword(std::string &&pPassword) noexcept
 {
-    password_ = std::make_shared<std::string>(std::move(pPassword));
+    nullMask_[2] = false;
+    password_ = std::string(std::move(pPassword));
     dirtyFlag_[2] = true;
 }
 
 void User::updateId(const uint64_t id)
 {
+    nullMask_[0] = false;
+    id_ = int32_t(static_cast<int32_t>(id));
 }
 
 const std::vector<std::string> &User::insertColumns() noexcept
@@ -469,8 +494,8 @@ bool User::validateJsonForCreation(const Json::Value &pJson, std::string &err)
     return true;
 }
 bool User::validateMasqueradedJsonForCreation(const Json::Value &pJson,
-                                               const std::vector<std::string> &pMasqueradingVector,
-                                               std::string &err)
+                                              const std::vector<std::string> &pMasqueradingVector,
+                                              std::string &err)
 {
     if(pMasqueradingVector.size() != 3)
     {
@@ -545,8 +570,8 @@ bool User::validateJsonForUpdate(const Json::Value &pJson, std::string &err)
     return true;
 }
 bool User::validateMasqueradedJsonForUpdate(const Json::Value &pJson,
-                                             const std::vector<std::string> &pMasqueradingVector,
-                                             std::string &err)
+                                            const std::vector<std::string> &pMasqueradingVector,
+                                            std::string &err)
 {
     if(pMasqueradingVector.size() != 3)
     {
@@ -583,10 +608,10 @@ bool User::validateMasqueradedJsonForUpdate(const Json::Value &pJson,
     return true;
 }
 bool User::validJsonOfField(size_t index,
-                             const std::string &fieldName,
-                             const Json::Value &pJson,
-                             std::string &err,
-                             bool isForCreation)
+                            const std::string &fieldName,
+                            const Json::Value &pJson,
+                            std::string &err,
+                            bool isForCreation)
 {
     switch(index)
     {
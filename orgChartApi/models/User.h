@@ -21,6 +21,7 @@
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <bitset>
 #include <stdint.h>
 #include <iostream>
 
@@ -99,16 +100,16 @@ class User
     /**  For column id  */
     ///Get the value of the column id, returns the default value if the column is null
     const int32_t &getValueOfId() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<int32_t> &getId() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const int32_t *getId() const noexcept;
     ///Set the value of the column id
     void setId(const int32_t &pId) noexcept;
 
     /**  For column username  */
     ///Get the value of the column username, returns the default value if the column is null
     const std::string &getValueOfUsername() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getUsername() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getUsername() const noexcept;
     ///Set the value of the column username
     void setUsername(const std::string &pUsername) noexcept;
     void setUsername(std::string &&pUsername) noexcept;
@@ -116,8 +117,8 @@ class User
     /**  For column password  */
     ///Get the value of the column password, returns the default value if the column is null
     const std::string &getValueOfPassword() const noexcept;
-    ///Return a shared_ptr object pointing to the column const value, or an empty shared_ptr object if the column is null
-    const std::shared_ptr<std::string> &getPassword() const noexcept;
+    ///Return a pointer to the column const value, or nullptr if the column is null
+    const std::string *getPassword() const noexcept;
     ///Set the value of the column password
     void setPassword(const std::string &pPassword) noexcept;
     void setPassword(std::string &&pPassword) noexcept;
@@ -140,9 +141,11 @@ class User
     void updateArgs(drogon::orm::internal::SqlBinder &binder) const;
     ///For mysql or sqlite3
     void updateId(const uint64_t id);
-    std::shared_ptr<int32_t> id_;
-    std::shared_ptr<std::string> username_;
-    std::shared_ptr<std::string> password_;
+    int32_t id_{};
+    std::string username_{};
+    std::string password_{};
+    ///A set bit marks a null column, all columns are null initially
+    std::bitset<3> nullMask_{std::bitset<3>().set()};
     struct MetaData
     {
         const std::string colName_;
@@ -172,8 +175,6 @@ class User
         std::string sql="insert into " + tableName + " (";
         size_t parametersCount = 0;
         needSelection = false;
-            sql += "id,";
-            ++parametersCount;
         if(dirtyFlag_[1])
         {
             sql += "username,";
@@ -196,7 +197,6 @@ class User
         int placeholder=1;
         char placeholderStr[64];
         size_t n=0;
-        sql +="default,";
         if(dirtyFlag_[1])
         {
             n = sprintf(placeholderStr,"$%d,",placeholder++);
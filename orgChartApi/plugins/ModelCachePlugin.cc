@@ -0,0 +1,282 @@
+#include "ModelCachePlugin.h"
+#include <random>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+
+// KEYS: the entry, its generation
+const char *readEntryScript = "return {redis.call('get', KEYS[1]), redis.call('get', KEYS[2])}";
+
+// KEYS: the entry, its generation; ARGV: the entry, the generation read
+// before the row, the TTL
+const char *storeEntryScript =
+    "if (redis.call('get', KEYS[2]) or '0') ~= ARGV[2] then return 0 end "
+    "return redis.call('set', KEYS[1], ARGV[1], 'ex', ARGV[3])";
+
+// KEYS: the entry, its generation; ARGV: how long the generation is kept,
+// far longer than any fill runs
+const char *dropEntryScript =
+    "redis.call('incr', KEYS[2]) "
+    "redis.call('expire', KEYS[2], ARGV[1]) "
+    "return redis.call('del', KEYS[1])";
+
+// KEYS: the pages, their generation; ARGV: the field of the page, whose
+// generation is kept in the field <field>:generation. A nil reply is false in
+// Lua and nil again in the array returned.
+const char *readListScript =
+    "return {redis.call('hget', KEYS[1], ARGV[1]), "
+    "redis.call('hget', KEYS[1], ARGV[1] .. ':generation'), "
+    "redis.call('get', KEYS[2])}";
+
+// KEYS: the pages, their generation; ARGV: the field of the page, the page,
+// the generation read before computing it, the TTL of the pages
+const char *storeListScript =
+    "if (redis.call('get', KEYS[2]) or '0') ~= ARGV[3] then return 0 end "
+    "redis.call('hset', KEYS[1], ARGV[1], ARGV[2], ARGV[1] .. ':generation', ARGV[3]) "
+    "redis.call('expire', KEYS[1], ARGV[4]) "
+    "return 1";
+
+// KEYS: the lock; ARGV: the token of the request releasing it
+const char *unlockScript =
+    "if redis.call('get', KEYS[1]) == ARGV[1] then return redis.call('del', KEYS[1]) end "
+    "return 0";
+
+using GenerationCallback = std::function<void(const std::string *data, const std::string &generation)>;
+
+// Passes on the reply of a read script, {value or nil, generation or nil}
+void replyWithGeneration(const GenerationCallback &callback, const nosql::RedisResult &result) {
+    if (result.type() != nosql::RedisResultType::kArray) {
+        callback(nullptr, "");
+        return;
+    }
+    auto values = result.asArray();
+    // no generation yet is generation 0, the one the store scripts assume
+    auto generation = values.size() == 2 && values[1].type() == nosql::RedisResultType::kString ? values[1].asString() : "0";
+    if (!values.empty() && values[0].type() == nosql::RedisResultType::kString) {
+        auto data = values[0].asString();
+        callback(&data, generation);
+        return;
+    }
+    callback(nullptr, generation);
+}
+
+}  // namespace
+
+void ModelCachePlugin::initAndStart(const Json::Value &config) {
+    LOG_DEBUG << "ModelCache initialized and Start";
+    prefix = config.get("prefix", prefix).asString();
+    ttl = config.get("ttl", ttl).asInt();
+    listTtl = config.get("list_ttl", listTtl).asInt();
+    staleTtl = config.get("stale_ttl", staleTtl).asInt();
+    beta = config.get("beta", beta).asDouble();
+    redisClient = app().getRedisClient(config.get("redis_client", "default").asString());
+    if (!redisClient) {
+        LOG_ERROR << "model cache: no such redis client, lookups go to the database";
+        return;
+    }
+
+    // rows written by anything else than this API announce themselves on the channel, e.g. "person:12"
+    auto dbClientPtr = app().getDbClient();
+    if (dbClientPtr->type() != ClientType::PostgreSQL || !config.get("listen", true).asBool()) {
+        return;
+    }
+    listener = DbListener::newPgListener(dbClientPtr->connectionInfo());
+    listener->listen("org_chart_changes", [this](const std::string &payload) {
+        dropEntry(prefix + payload);
+        // the pages of the row's table go too
+        dropLists(payload.substr(0, payload.find(':')));
+    });
+    listener->setReconnectCallback([]() {
+        LOG_WARN << "model cache: changes may have been missed, stale entries live until their TTL";
+    });
+}
+
+void ModelCachePlugin::shutdown() {
+    LOG_DEBUG << "ModelCache shut down";
+    listener.reset();
+}
+
+void ModelCachePlugin::invalidate(const std::string &table, int32_t id) {
+    auto *plugin = instance();
+    if (!plugin) {
+        return;
+    }
+    plugin->dropEntry(plugin->keyFor(table, id));
+}
+
+void ModelCachePlugin::invalidateLists(const std::string &table) {
+    auto *plugin = instance();
+    if (!plugin) {
+        return;
+    }
+    plugin->dropLists(table);
+}
+
+ModelCachePlugin *ModelCachePlugin::instance() {
+    // a plugin missing from the config is still created here, but never started
+    auto *plugin = app().getPlugin<ModelCachePlugin>();
+    return plugin && plugin->redisClient ? plugin : nullptr;
+}
+
+auto ModelCachePlugin::keyFor(const std::string &table, int32_t id) const -> std::string {
+    return prefix + table + ":" + std::to_string(id);
+}
+
+void ModelCachePlugin::dropEntry(const std::string &key) const {
+    redisClient->execCommandAsync(
+        [](const nosql::RedisResult &) {},
+        [](const nosql::RedisException &e) { LOG_WARN << "model cache: " << e.what(); },
+        "eval %s 2 %s %s %d", dropEntryScript, key.c_str(), (key + ":generation").c_str(), ttl);
+}
+
+void ModelCachePlugin::readEntry(const std::string &key, GenerationCallback &&callback) const {
+    auto callbackPtr = std::make_shared<GenerationCallback>(std::move(callback));
+    redisClient->execCommandAsync(
+        [callbackPtr](const nosql::RedisResult &result) { replyWithGeneration(*callbackPtr, result); },
+        [callbackPtr](const nosql::RedisException &e) {
+            LOG_WARN << "model cache: " << e.what();
+            (*callbackPtr)(nullptr, "");
+        },
+        "eval %s 2 %s %s", readEntryScript, key.c_str(), (key + ":generation").c_str());
+}
+
+void ModelCachePlugin::store(const std::string &key, const std::string &generation, const std::string &value) const {
+    if (generation.empty()) {
+        return;
+    }
+    redisClient->execCommandAsync(
+        [](const nosql::RedisResult &) {},
+        [](const nosql::RedisException &e) { LOG_WARN << "model cache: " << e.what(); },
+        "eval %s 2 %s %s %b %s %d",
+        storeEntryScript,
+        key.c_str(),
+        (key + ":generation").c_str(),
+        value.data(),
+        value.size(),
+        generation.c_str(),
+        ttl);
+}
+
+auto ModelCachePlugin::listKeyFor(const std::string &table) const -> std::string {
+    return prefix + "list:" + table;
+}
+
+void ModelCachePlugin::dropLists(const std::string &table) const {
+    // the pages stay, served while they are recomputed. The generation never
+    // expires, so it can't fall back to a value some fill still holds.
+    redisClient->execCommandAsync(
+        [](const nosql::RedisResult &) {},
+        [](const nosql::RedisException &e) { LOG_WARN << "model cache: " << e.what(); },
+        "incr %s", (listKeyFor(table) + ":generation").c_str());
+}
+
+void ModelCachePlugin::readList(const std::string &table,
+                                const std::string &field,
+                                std::function<void(const std::string *data, const std::string &pageGeneration, const std::string &generation)> &&callback) const {
+    auto key = listKeyFor(table);
+    auto callbackPtr = std::make_shared<std::function<void(const std::string *, const std::string &, const std::string &)>>(std::move(callback));
+    redisClient->execCommandAsync(
+        [callbackPtr](const nosql::RedisResult &result) {
+            if (result.type() != nosql::RedisResultType::kArray) {
+                (*callbackPtr)(nullptr, "", "");
+                return;
+            }
+            auto values = result.asArray();
+            auto stringAt = [&values](size_t i, const std::string &missing) {
+                return values.size() > i && values[i].type() == nosql::RedisResultType::kString ? values[i].asString() : missing;
+            };
+            // a page stored before pages had a generation is outdated, no
+            // generation yet is generation 0, the one storeList() assumes
+            auto pageGeneration = stringAt(1, "");
+            auto generation = stringAt(2, "0");
+            if (!values.empty() && values[0].type() == nosql::RedisResultType::kString) {
+                auto data = values[0].asString();
+                (*callbackPtr)(&data, pageGeneration, generation);
+                return;
+            }
+            (*callbackPtr)(nullptr, pageGeneration, generation);
+        },
+        [callbackPtr](const nosql::RedisException &e) {
+            LOG_WARN << "model cache: " << e.what();
+            (*callbackPtr)(nullptr, "", "");
+        },
+        "eval %s 2 %s %s %s", readListScript, key.c_str(), (key + ":generation").c_str(), field.c_str());
+}
+
+void ModelCachePlugin::storeList(const std::string &table,
+                                 const std::string &field,
+                                 const std::string &generation,
+                                 const std::string &value,
+                                 int64_t delta,
+                                 std::function<void()> &&done) const {
+    if (generation.empty()) {
+        done();
+        return;
+    }
+    CacheEntry entry;
+    entry.expiresAt = trantor::Date::now().microSecondsSinceEpoch() + listTtl * 1000000LL;
+    entry.delta = delta;
+    entry.value = value;
+    auto data = encodeCacheEntry(entry);
+    auto key = listKeyFor(table);
+    auto donePtr = std::make_shared<std::function<void()>>(std::move(done));
+    // the pages left unread for listTtl + staleTtl seconds go together
+    redisClient->execCommandAsync(
+        [donePtr](const nosql::RedisResult &) { (*donePtr)(); },
+        [donePtr](const nosql::RedisException &e) {
+            LOG_WARN << "model cache: " << e.what();
+            (*donePtr)();
+        },
+        "eval %s 2 %s %s %s %b %s %d",
+        storeListScript,
+        key.c_str(),
+        (key + ":generation").c_str(),
+        field.c_str(),
+        data.data(),
+        data.size(),
+        generation.c_str(),
+        listTtl + staleTtl);
+}
+
+bool ModelCachePlugin::refreshEarly(const CacheEntry &entry, int64_t now) const {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    return shouldRefreshEarly(entry, now, beta, 1.0 - uniform(generator));
+}
+
+void ModelCachePlugin::refreshOnce(const std::string &table,
+                                   const std::string &field,
+                                   std::function<void(std::function<void()> &&done)> &&recompute,
+                                   std::function<void()> &&busy) const {
+    // expires by itself should the request holding it never finish
+    static const int lockMilliseconds = 10000;
+    auto lockKey = listKeyFor(table) + ":lock:" + field;
+    auto token = utils::getUuid();
+    auto recomputePtr = std::make_shared<std::function<void(std::function<void()> &&)>>(std::move(recompute));
+    auto busyPtr = std::make_shared<std::function<void()>>(std::move(busy));
+    redisClient->execCommandAsync(
+        [this, lockKey, token, recomputePtr, busyPtr](const nosql::RedisResult &result) {
+            // nil when another request is refreshing the page already
+            if (result.type() == nosql::RedisResultType::kNil) {
+                (*busyPtr)();
+                return;
+            }
+            (*recomputePtr)([this, lockKey, token]() {
+                redisClient->execCommandAsync(
+                    [](const nosql::RedisResult &) {},
+                    [](const nosql::RedisException &e) { LOG_WARN << "model cache: " << e.what(); },
+                    "eval %s 1 %s %s", unlockScript, lockKey.c_str(), token.c_str());
+            });
+        },
+        [recomputePtr](const nosql::RedisException &e) {
+            LOG_WARN << "model cache: " << e.what();
+            (*recomputePtr)([]() {});
+        },
+        "set %s %s nx px %d", lockKey.c_str(), token.c_str(), lockMilliseconds);
+}
+
+void ModelCachePlugin::retryLater(std::function<void()> &&retry) const {
+    app().getLoop()->runAfter(missRetryInterval, std::move(retry));
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "../utils/CacheEntry.h"
+#include "../utils/ModelCodec.h"
+#include <drogon/drogon.h>
+#include <drogon/orm/DbListener.h>
+#include <drogon/orm/Mapper.h>
+#include <drogon/plugins/Plugin.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cache-aside for the primary key lookups of persons, jobs and departments,
+// kept in the Redis client named by "redis_client" as <prefix><table>:<id>,
+// see utils/ModelCodec.h for the format. A miss is filled from the primary
+// database with a TTL of "ttl" seconds, and the controllers drop an entry
+// after every update or delete of its row, so the API instances sharing the
+// Redis server share the entries. On PostgreSQL the org_chart_changes
+// notifications drop the entries of the rows written outside of the API too.
+// Dropping an entry bumps its generation in <prefix><table>:<id>:generation,
+// and a fill only stores the row while the generation is the one read with
+// the miss, so a row read before a write can't be cached after it.
+//
+// The pages of /jobs and /departments are kept in the hash <prefix>list:<table>
+// with a soft TTL of "list_ttl" seconds, each next to the generation of its
+// table's pages it was computed under. Creating, updating or deleting a row
+// bumps that generation in <prefix>list:<table>:generation, which outdates
+// the pages without dropping them, and a page read from the database before
+// the bump is not stored. Every read may recompute its page ahead of the soft
+// expiry, the likelier the slower the page was to compute and the closer its
+// expiry (XFetch, see utils/CacheEntry.h). Only the request that takes the
+// page's lock in Redis queries the database: for an expiring page it does so
+// after answering from the cached one, for an outdated page or a miss before
+// answering. Meanwhile the others serve the cached page, expired or outdated,
+// for up to "stale_ttl" seconds past its soft expiry, and on a miss wait for
+// the lock holder to store the page, querying the database themselves only
+// if it takes too long.
+//
+// Without the plugin, or while Redis fails, the lookups go to the database.
+class ModelCachePlugin : public drogon::Plugin<ModelCachePlugin> {
+ public:
+    virtual void initAndStart(const Json::Value &config) override;
+    virtual void shutdown() override;
+
+    // Mapper<T>::findByPrimaryKey() through the cache. Without the cache the
+    // row is read from readDbClientPtr, but a miss is filled from
+    // dbClientPtr, the primary: a replica lagging behind a write would put
+    // the old row back in the cache for the whole TTL. dbClientPtr must not
+    // coalesce reads either, see getFreshDbClient().
+    template <typename T>
+    static void findByPrimaryKey(const drogon::orm::DbClientPtr &readDbClientPtr,
+                                 const drogon::orm::DbClientPtr &dbClientPtr,
+                                 int32_t id,
+                                 std::function<void(const T &)> &&callback,
+                                 std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback);
+
+    // Drops the entry of a row that was just updated or deleted
+    template <typename T>
+    static void invalidate(int32_t id) {
+        invalidate(T::tableName, id);
+    }
+    static void invalidate(const std::string &table, int32_t id);
+
+    // Mapper<T>::orderBy(sortField, sortOrder).offset(offset).limit(limit)
+    // .findAll() through the cache. As with findByPrimaryKey(), the pages are
+    // read from readDbClientPtr without the cache, and from dbClientPtr, the
+    // primary, to fill or refresh the cache.
+    template <typename T>
+    static void findAll(const drogon::orm::DbClientPtr &readDbClientPtr,
+                        const drogon::orm::DbClientPtr &dbClientPtr,
+                        const std::string &sortField,
+                        drogon::orm::SortOrder sortOrder,
+                        size_t offset,
+                        size_t limit,
+                        std::function<void(const std::vector<T> &)> &&callback,
+                        std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback);
+
+    // Outdates the cached pages of a table after a row was created, updated or deleted
+    template <typename T>
+    static void invalidateLists() {
+        invalidateLists(T::tableName);
+    }
+    static void invalidateLists(const std::string &table);
+
+ private:
+    // The running plugin, or nullptr when there is no cache
+    static ModelCachePlugin *instance();
+    auto keyFor(const std::string &table, int32_t id) const -> std::string;
+    // Drops an entry and bumps its generation
+    void dropEntry(const std::string &key) const;
+    // Reads an entry with its generation, data is nullptr on a miss. A Redis
+    // error is a miss with an empty generation, which no store matches.
+    void readEntry(const std::string &key,
+                   std::function<void(const std::string *data, const std::string &generation)> &&callback) const;
+    // Stores an entry unless its generation is no longer the one read before
+    // the row was
+    void store(const std::string &key, const std::string &generation, const std::string &value) const;
+    auto listKeyFor(const std::string &table) const -> std::string;
+    // Bumps the generation of a table's pages
+    void dropLists(const std::string &table) const;
+    // Reads a page with the generation it was stored under and the current
+    // generation of its table's pages, data is nullptr on a miss. A Redis
+    // error is a miss with an empty generation, which no store matches.
+    void readList(const std::string &table,
+                  const std::string &field,
+                  std::function<void(const std::string *data, const std::string &pageGeneration, const std::string &generation)> &&callback) const;
+    // Stores a page unless the generation of its table's pages is no longer
+    // the one read before the page was computed, then calls done
+    void storeList(const std::string &table,
+                   const std::string &field,
+                   const std::string &generation,
+                   const std::string &value,
+                   int64_t delta,
+                   std::function<void()> &&done) const;
+    // Draws whether a read at now recomputes the entry, see shouldRefreshEarly()
+    bool refreshEarly(const CacheEntry &entry, int64_t now) const;
+    // Runs recompute, which calls done once the page is stored or failed,
+    // unless another request holds the lock of the page, then busy. The lock
+    // holds a token of its own, so a request whose lock expired can't release
+    // the next one. Without Redis to take the lock from, recompute runs.
+    void refreshOnce(const std::string &table,
+                     const std::string &field,
+                     std::function<void(std::function<void()> &&done)> &&recompute,
+                     std::function<void()> &&busy) const;
+    // Runs retry a little later, when a miss waits for another request's fill
+    void retryLater(std::function<void()> &&retry) const;
+
+    // A findAll() in progress, looked up again after waiting on a miss
+    template <typename T>
+    struct PageLookup {
+        std::string table;
+        std::string field;
+        // reads the page from the primary, stores it under the generation
+        // given and then calls back
+        std::function<void(const std::string &generation,
+                           std::function<void(const std::vector<T> &)> &&callback,
+                           std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback)>
+            fill;
+        std::function<void(const std::vector<T> &)> callback;
+        std::function<void(const drogon::orm::DrogonDbException &)> errorCallback;
+    };
+    // Serves a page from the cache or through its lock; a miss that finds the
+    // lock taken looks the page up again up to retries more times
+    template <typename T>
+    void findPage(const std::shared_ptr<PageLookup<T>> &lookup, int retries) const;
+    // How many times, and how often, a miss looks for the lock holder's page
+    static constexpr int missRetries = 10;
+    static constexpr double missRetryInterval = 0.05;
+
+    drogon::nosql::RedisClientPtr redisClient;
+    std::string prefix{"org_chart:"};
+    int ttl{300};
+    int listTtl{30};
+    int staleTtl{300};
+    double beta{1.0};
+    drogon::orm::DbListenerPtr listener;
+};
+
+template <typename T>
+void ModelCachePlugin::findByPrimaryKey(const drogon::orm::DbClientPtr &readDbClientPtr,
+                                        const drogon::orm::DbClientPtr &dbClientPtr,
+                                        int32_t id,
+                                        std::function<void(const T &)> &&callback,
+                                        std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback) {
+    auto *plugin = instance();
+    if (!plugin) {
+        drogon::orm::Mapper<T> mp(readDbClientPtr);
+        mp.findByPrimaryKey(id, std::move(callback), std::move(errorCallback));
+        return;
+    }
+    auto key = plugin->keyFor(T::tableName, id);
+    auto callbackPtr = std::make_shared<std::function<void(const T &)>>(std::move(callback));
+    auto errorCallbackPtr = std::make_shared<std::function<void(const drogon::orm::DrogonDbException &)>>(std::move(errorCallback));
+    plugin->readEntry(key, [plugin, dbClientPtr, id, key, callbackPtr, errorCallbackPtr](const std::string *data, const std::string &generation) {
+        T model;
+        // an entry of another format version is a miss too
+        if (data && decodeModel(*data, model)) {
+            (*callbackPtr)(model);
+            return;
+        }
+        drogon::orm::Mapper<T> mp(dbClientPtr);
+        mp.findByPrimaryKey(
+            id,
+            [plugin, key, generation, callbackPtr](const T &model) {
+                plugin->store(key, generation, encodeModel(model));
+                (*callbackPtr)(model);
+            },
+            [errorCallbackPtr](const drogon::orm::DrogonDbException &e) { (*errorCallbackPtr)(e); });
+    });
+}
+
+template <typename T>
+void ModelCachePlugin::findAll(const drogon::orm::DbClientPtr &readDbClientPtr,
+                               const drogon::orm::DbClientPtr &dbClientPtr,
+                               const std::string &sortField,
+                               drogon::orm::SortOrder sortOrder,
+                               size_t offset,
+                               size_t limit,
+                               std::function<void(const std::vector<T> &)> &&callback,
+                               std::function<void(const drogon::orm::DrogonDbException &)> &&errorCallback) {
+    using ListCallback = std::function<void(const std::vector<T> &)>;
+    using ErrorCallback = std::function<void(const drogon::orm::DrogonDbException &)>;
+    auto query = [sortField, sortOrder, offset, limit](const drogon::orm::DbClientPtr &client, ListCallback &&cb, ErrorCallback &&ecb) {
+        drogon::orm::Mapper<T> mp(client);
+        mp.orderBy(sortField, sortOrder).offset(offset).limit(limit).findAll(std::move(cb), std::move(ecb));
+    };
+    auto *plugin = instance();
+    if (!plugin) {
+        query(readDbClientPtr, std::move(callback), std::move(errorCallback));
+        return;
+    }
+    auto lookup = std::make_shared<PageLookup<T>>();
+    lookup->table = T::tableName;
+    lookup->field = sortField + (sortOrder == drogon::orm::SortOrder::ASC ? ":asc:" : ":desc:") + std::to_string(offset) +
+                    ":" + std::to_string(limit);
+    // times the query as the delta of XFetch
+    lookup->fill = [plugin, query, dbClientPtr, table = lookup->table, field = lookup->field](const std::string &generation,
+                                                                                            ListCallback &&cb,
+                                                                                            ErrorCallback &&ecb) {
+        auto start = std::chrono::steady_clock::now();
+        query(
+            dbClientPtr,
+            [plugin, table, field, generation, start, cb = std::move(cb)](const std::vector<T> &models) {
+                auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+                // so the lock is released once the page can be read
+                plugin->storeList(table, field, generation, encodeModels(models), delta.count(), [cb, models]() { cb(models); });
+            },
+            std::move(ecb));
+    };
+    lookup->callback = std::move(callback);
+    lookup->errorCallback = std::move(errorCallback);
+    plugin->findPage(lookup, missRetries);
+}
+
+template <typename T>
+void ModelCachePlugin::findPage(const std::shared_ptr<PageLookup<T>> &lookup, int retries) const {
+    readList(lookup->table, lookup->field, [this, lookup, retries](const std::string *data, const std::string &pageGeneration, const std::string &generation) {
+        // answers from the database once the page is stored
+        auto fillAndAnswer = [lookup, generation](std::function<void()> &&done) {
+            auto donePtr = std::make_shared<std::function<void()>>(std::move(done));
+            lookup->fill(
+                generation,
+                [lookup, donePtr](const std::vector<T> &models) {
+                    (*donePtr)();
+                    lookup->callback(models);
+                },
+                [lookup, donePtr](const drogon::orm::DrogonDbException &e) {
+                    (*donePtr)();
+                    lookup->errorCallback(e);
+                });
+        };
+        // Redis failed, there is no lock to take either
+        if (generation.empty()) {
+            fillAndAnswer([]() {});
+            return;
+        }
+        CacheEntry entry;
+        std::vector<T> models;
+        auto now = trantor::Date::now().microSecondsSinceEpoch();
+        // a miss, an entry of another format version, or one too stale to serve
+        if (!data || !decodeCacheEntry(*data, entry) || now >= entry.expiresAt + staleTtl * 1000000LL ||
+            !decodeModels(entry.value, models)) {
+            refreshOnce(lookup->table, lookup->field, std::move(fillAndAnswer), [this, lookup, generation, retries]() {
+                if (retries > 0) {
+                    retryLater([this, lookup, retries]() { findPage(lookup, retries - 1); });
+                    return;
+                }
+                // the lock holder is slow, or gone without storing the page
+                lookup->fill(
+                    generation,
+                    [lookup](const std::vector<T> &models) { lookup->callback(models); },
+                    [lookup](const drogon::orm::DrogonDbException &e) { lookup->errorCallback(e); });
+            });
+            return;
+        }
+        // a row was written since the page was computed
+        if (pageGeneration != generation) {
+            refreshOnce(lookup->table, lookup->field, std::move(fillAndAnswer), [lookup, models]() { lookup->callback(models); });
+            return;
+        }
+        lookup->callback(models);
+        if (!refreshEarly(entry, now)) {
+            return;
+        }
+        refreshOnce(
+            lookup->table,
+            lookup->field,
+            [lookup, generation](std::function<void()> &&done) {
+                auto donePtr = std::make_shared<std::function<void()>>(std::move(done));
+                lookup->fill(
+                    generation,
+                    [donePtr](const std::vector<T> &) { (*donePtr)(); },
+                    [donePtr](const drogon::orm::DrogonDbException &e) {
+                        LOG_WARN << "model cache: refresh failed: " << e.base().what();
+                        (*donePtr)();
+                    });
+            },
+            []() {});
+    });
+}
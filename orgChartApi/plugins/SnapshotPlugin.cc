@@ -0,0 +1,103 @@
+#include "SnapshotPlugin.h"
+#include "../utils/OrgSnapshot.h"
+#include "../utils/utils.h"
+#include <drogon/drogon.h>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+void SnapshotPlugin::initAndStart(const Json::Value &config) {
+    LOG_DEBUG << "Snapshot initialized and Start";
+    path = config.get("path", path).asString();
+    interval = config.get("interval", interval).asDouble();
+    utils::createPath(path);
+
+    // take today's snapshot on startup if it is missing, then one per interval
+    auto today = trantor::Date::now().toCustomedFormattedStringLocal("%Y-%m-%d");
+    if (access(pathFor(today).c_str(), F_OK) != 0) {
+        app().getLoop()->queueInLoop([this]() { capture([](const std::string &) {}); });
+    }
+    app().getLoop()->runEvery(interval, [this]() { capture([](const std::string &) {}); });
+}
+
+void SnapshotPlugin::shutdown() {
+    LOG_DEBUG << "Snapshot shut down";
+}
+
+auto SnapshotPlugin::pathFor(const std::string &date) const -> std::string {
+    return path + "/" + date + ".snap";
+}
+
+void SnapshotPlugin::capture(std::function<void(const std::string &)> &&callback) const {
+    auto callbackPtr = std::make_shared<std::function<void(const std::string &)>>(std::move(callback));
+    auto date = trantor::Date::now().toCustomedFormattedStringLocal("%Y-%m-%d");
+    auto file = pathFor(date);
+    auto dbClientPtr = getDbClient();
+
+    // days since the epoch, SQLite has no date type to subtract
+    auto hireDay = dbClientPtr->type() == ClientType::Sqlite3
+                       ? "cast(julianday(person.hire_date) - 2440587.5 as integer)"
+                       : "person.hire_date - date '1970-01-01'";
+    auto sql = std::string("select person.id, person.manager_id, person.department_id, person.job_id, \n\
+                       ") + hireDay + " as hire_day, \n\
+                       person.first_name, person.last_name, \n\
+                       department.name as department_name, \n\
+                       job.title as job_title \n\
+                       from person \n\
+                       join job on person.job_id = job.id \n\
+                       join department on person.department_id = department.id";
+
+    // the rows arrive in chunks from a cursor, so only the records are held in memory and not the
+    // whole result as well; the cursor reads one snapshot of the tables however long it takes
+    auto records = std::make_shared<std::vector<SnapshotRecord>>();
+    dbClientPtr->execSqlStreaming(
+        sql, 1000,
+        [records](const Result &result, std::function<void(bool)> &&next) {
+            for (auto row : result) {
+                SnapshotRecord record;
+                record.id = row["id"].as<int32_t>();
+                record.managerId = row["manager_id"].as<int32_t>();
+                record.departmentId = row["department_id"].as<int32_t>();
+                record.jobId = row["job_id"].as<int32_t>();
+                record.hireDay = row["hire_day"].as<int32_t>();
+                record.firstName = row["first_name"].as<std::string>();
+                record.lastName = row["last_name"].as<std::string>();
+                record.departmentName = row["department_name"].as<std::string>();
+                record.jobTitle = row["job_title"].as<std::string>();
+                records->push_back(std::move(record));
+            }
+            next(true);
+        },
+        [callbackPtr, records, date, file]() {
+            auto blob = encodeOrgSnapshot(*records, trantor::Date::now().secondsSinceEpoch());
+
+            // blocking IO, write next to the target and rename so readers never see a partial file
+            auto tmpFile = file + ".tmp";
+            {
+                std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+                out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+                if (!out) {
+                    LOG_ERROR << "failed to write snapshot " << tmpFile;
+                    (*callbackPtr)("");
+                    return;
+                }
+            }
+            if (std::rename(tmpFile.c_str(), file.c_str()) != 0) {
+                LOG_ERROR << "failed to store snapshot " << file;
+                (*callbackPtr)("");
+                return;
+            }
+            LOG_INFO << "snapshot " << date << ": " << records->size() << " persons, " << blob.size() << " bytes";
+            (*callbackPtr)(date);
+        },
+        [callbackPtr](const DrogonDbException &e) {
+            LOG_ERROR << e.base().what();
+            (*callbackPtr)("");
+        });
+}
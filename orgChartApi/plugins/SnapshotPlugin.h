@@ -0,0 +1,22 @@
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <functional>
+#include <string>
+
+// Takes a point-in-time snapshot of the org chart once per interval and stores
+// it as <path>/<YYYY-MM-DD>.snap, see utils/OrgSnapshot.h for the format.
+class SnapshotPlugin : public drogon::Plugin<SnapshotPlugin> {
+ public:
+    virtual void initAndStart(const Json::Value &config) override;
+    virtual void shutdown() override;
+
+    // Captures the current org chart into today's snapshot file. The callback
+    // receives the snapshot date, or an empty string on failure.
+    void capture(std::function<void(const std::string &)> &&callback) const;
+    auto pathFor(const std::string &date) const -> std::string;
+
+ private:
+    std::string path{"./snapshots"};
+    double interval{86400.0};
+};
@@ -0,0 +1,76 @@
+#include "SqliteSchemaPlugin.h"
+#include <drogon/drogon.h>
+#include <fstream>
+#include <sstream>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+void SqliteSchemaPlugin::initAndStart(const Json::Value &config) {
+    LOG_DEBUG << "SqliteSchema initialized and Start";
+    auto dbClientPtr = app().getDbClient();
+    if (dbClientPtr->type() != ClientType::Sqlite3) {
+        return;
+    }
+    // plugins start before the server listens, so blocking here holds back the first request
+    auto tables = dbClientPtr->execSqlSync("select name from sqlite_master where type = 'table' and name = 'person'");
+    if (!tables.empty()) {
+        return;
+    }
+    for (auto &script : config["scripts"]) {
+        runScript(dbClientPtr, script.asString());
+    }
+}
+
+void SqliteSchemaPlugin::runScript(const DbClientPtr &dbClientPtr, const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        LOG_FATAL << "Can't read the SQL script " << path;
+        abort();
+    }
+    std::stringstream content;
+    content << in.rdbuf();
+    for (auto &statement : splitStatements(content.str())) {
+        dbClientPtr->execSqlSync(statement);
+    }
+    LOG_INFO << "Ran " << path;
+}
+
+void SqliteSchemaPlugin::shutdown() {
+    LOG_DEBUG << "SqliteSchema shut down";
+}
+
+std::vector<std::string> SqliteSchemaPlugin::splitStatements(const std::string &script) {
+    std::vector<std::string> statements;
+    std::string statement;
+    auto finish = [&statements, &statement]() {
+        auto first = statement.find_first_not_of(" \t\r\n");
+        if (first != std::string::npos) {
+            auto last = statement.find_last_not_of(" \t\r\n");
+            statements.push_back(statement.substr(first, last - first + 1));
+        }
+        statement.clear();
+    };
+    bool quoted = false;
+    bool comment = false;
+    for (size_t i = 0; i < script.size(); ++i) {
+        auto ch = script[i];
+        if (comment) {
+            comment = ch != '\n';
+            continue;
+        }
+        if (!quoted && ch == '-' && i + 1 < script.size() && script[i + 1] == '-') {
+            comment = true;
+            continue;
+        }
+        if (ch == '\'') {
+            quoted = !quoted;
+        } else if (ch == ';' && !quoted) {
+            finish();
+            continue;
+        }
+        statement.push_back(ch);
+    }
+    finish();
+    return statements;
+}
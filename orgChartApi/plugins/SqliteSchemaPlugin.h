@@ -0,0 +1,22 @@
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <drogon/plugins/Plugin.h>
+#include <string>
+#include <vector>
+
+// Creates the org chart schema in the default database when it is SQLite and
+// has no person table yet, by running the SQL scripts listed in "scripts" in
+// order. An in-memory database starts out empty every time, so the plugin
+// must come before the plugins that read the tables.
+class SqliteSchemaPlugin : public drogon::Plugin<SqliteSchemaPlugin> {
+ public:
+    virtual void initAndStart(const Json::Value &config) override;
+    virtual void shutdown() override;
+
+    // The statements of a script, split at the semicolons outside of quotes
+    static std::vector<std::string> splitStatements(const std::string &script);
+    // Runs the statements of the script at path one after another, aborts when
+    // the file can't be read
+    static void runScript(const drogon::orm::DbClientPtr &dbClientPtr, const std::string &path);
+};
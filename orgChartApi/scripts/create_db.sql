@@ -27,3 +27,27 @@ CREATE TABLE users (
     username VARCHAR(50) UNIQUE NOT NULL,
     password VARCHAR UNIQUE NOT NULL
 );
+
+-- Tell listeners on the org_chart_changes channel which row of which table
+-- changed, as '<table>:<id>', so in-process caches of every replica of the
+-- API can drop it.
+CREATE FUNCTION notify_org_chart_change() RETURNS trigger AS $$
+DECLARE
+    row_id int;
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        row_id := OLD.id;
+    ELSE
+        row_id := NEW.id;
+    END IF;
+    PERFORM pg_notify('org_chart_changes', TG_TABLE_NAME || ':' || row_id);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER job_changed AFTER INSERT OR UPDATE OR DELETE ON job
+    FOR EACH ROW EXECUTE FUNCTION notify_org_chart_change();
+CREATE TRIGGER department_changed AFTER INSERT OR UPDATE OR DELETE ON department
+    FOR EACH ROW EXECUTE FUNCTION notify_org_chart_change();
+CREATE TRIGGER person_changed AFTER INSERT OR UPDATE OR DELETE ON person
+    FOR EACH ROW EXECUTE FUNCTION notify_org_chart_change();
@@ -0,0 +1,32 @@
+-- The schema of create_db.sql for SQLite, used by config.sqlite.json to run
+-- the API without a database server. SQLite does not enforce the foreign
+-- keys unless asked to, and has no LISTEN/NOTIFY, so there are no triggers.
+CREATE TABLE job (
+    id INTEGER PRIMARY KEY,
+    title VARCHAR(50) UNIQUE NOT NULL
+);
+
+CREATE TABLE department (
+    id INTEGER PRIMARY KEY,
+    name VARCHAR(50) UNIQUE NOT NULL
+);
+
+CREATE TABLE person (
+    id INTEGER PRIMARY KEY,
+    job_id int NOT NULL,
+    department_id int NOT NULL,
+    manager_id int NOT NULL,
+    first_name VARCHAR(50) UNIQUE NOT NULL,
+    last_name VARCHAR(50) UNIQUE NOT NULL,
+    hire_date DATE UNIQUE NOT NULL,
+    UNIQUE (first_name, last_name),
+    CONSTRAINT fk_job FOREIGN KEY(job_id) REFERENCES job(id) ON DELETE SET NULL,
+    CONSTRAINT fk_department FOREIGN KEY(department_id) REFERENCES department(id) ON DELETE SET NULL,
+    CONSTRAINT fk_manager FOREIGN KEY(manager_id) REFERENCES person(id) ON DELETE SET NULL
+);
+
+CREATE TABLE users (
+    id INTEGER PRIMARY KEY,
+    username VARCHAR(50) UNIQUE NOT NULL,
+    password VARCHAR UNIQUE NOT NULL
+);
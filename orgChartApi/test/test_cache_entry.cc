@@ -0,0 +1,48 @@
+#include <drogon/drogon_test.h>
+#include "../utils/CacheEntry.h"
+#include <cmath>
+#include <string>
+
+DROGON_TEST(CacheEntryRoundTrip)
+{
+    CacheEntry entry;
+    entry.expiresAt = 1646092800000000;
+    entry.delta = 2500;
+    entry.value = std::string("page\0data", 9);
+
+    CacheEntry decoded;
+    REQUIRE(decodeCacheEntry(encodeCacheEntry(entry), decoded));
+    CHECK(decoded.expiresAt == entry.expiresAt);
+    CHECK(decoded.delta == entry.delta);
+    CHECK(decoded.value == entry.value);
+
+    auto data = encodeCacheEntry(entry);
+    decoded.delta = 7;
+    CHECK(!decodeCacheEntry(data.substr(0, 16), decoded));
+    CHECK(!decodeCacheEntry("", decoded));
+    data[0] = 2;
+    CHECK(!decodeCacheEntry(data, decoded));
+    // a failed decode leaves the entry alone
+    CHECK(decoded.delta == 7);
+}
+
+DROGON_TEST(CacheEntryRefreshEarly)
+{
+    CacheEntry entry;
+    entry.expiresAt = 1000000;
+    entry.delta = 1000;
+
+    // past the soft expiry every read recomputes
+    CHECK(shouldRefreshEarly(entry, 1000000, 1.0, 1.0));
+    CHECK(shouldRefreshEarly(entry, 2000000, 1.0, 0.5));
+    // far ahead of it only a very unlikely draw does
+    CHECK(!shouldRefreshEarly(entry, 900000, 1.0, 0.5));
+    CHECK(shouldRefreshEarly(entry, 900000, 1.0, std::exp(-100.0)));
+    // ahead by delta the draws below 1/e recompute, more with a larger beta
+    CHECK(shouldRefreshEarly(entry, 999000, 1.0, 0.3));
+    CHECK(!shouldRefreshEarly(entry, 999000, 1.0, 0.4));
+    CHECK(shouldRefreshEarly(entry, 999000, 2.0, 0.6));
+    // a value computed instantly is only recomputed once expired
+    entry.delta = 0;
+    CHECK(!shouldRefreshEarly(entry, 999999, 1.0, 1e-9));
+}
@@ -0,0 +1,84 @@
+#include <drogon/drogon_test.h>
+#include "../utils/ModelCodec.h"
+#include <string>
+#include <vector>
+
+using namespace drogon_model::org_chart;
+
+DROGON_TEST(ModelCodecRoundTrip)
+{
+    Person person;
+    person.setId(12);
+    person.setJobId(4);
+    person.setDepartmentId(2);
+    person.setManagerId(8);
+    person.setFirstName("Yancey");
+    person.setLastName("Trenton");
+    person.setHireDate(trantor::Date(1646092800000000));
+
+    Person decoded;
+    REQUIRE(decodeModel(encodeModel(person), decoded));
+    CHECK(decoded.toJson() == person.toJson());
+
+    // null columns stay null
+    Job job;
+    job.setId(3);
+    Job decodedJob;
+    REQUIRE(decodeModel(encodeModel(job), decodedJob));
+    CHECK(decodedJob.getValueOfId() == 3);
+    CHECK(decodedJob.getTitle() == nullptr);
+
+    Department department;
+    department.setId(-1);
+    department.setName(std::string("Infra\0structure", 15));
+    Department decodedDepartment;
+    REQUIRE(decodeModel(encodeModel(department), decodedDepartment));
+    CHECK(decodedDepartment.getValueOfId() == -1);
+    CHECK(decodedDepartment.getValueOfName() == department.getValueOfName());
+}
+
+DROGON_TEST(ModelCodecRejectsCorruptValue)
+{
+    Job job;
+    job.setId(3);
+    job.setTitle("CEO");
+    auto data = encodeModel(job);
+
+    Job decoded;
+    decoded.setId(7);
+    CHECK(!decodeModel(data.substr(0, data.size() - 1), decoded));
+    CHECK(!decodeModel(data + "x", decoded));
+    CHECK(!decodeModel("", decoded));
+    auto otherVersion = data;
+    otherVersion[0] = 2;
+    CHECK(!decodeModel(otherVersion, decoded));
+    // a failed decode leaves the model alone
+    CHECK(decoded.getValueOfId() == 7);
+}
+
+DROGON_TEST(ModelCodecLists)
+{
+    std::vector<Job> jobs(3);
+    jobs[0].setId(1);
+    jobs[0].setTitle("CEO");
+    jobs[1].setId(2);
+    jobs[2].setId(3);
+    jobs[2].setTitle("Engineer");
+
+    std::vector<Job> decoded;
+    REQUIRE(decodeModels(encodeModels(jobs), decoded));
+    REQUIRE(decoded.size() == 3UL);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        CHECK(decoded[i].toJson() == jobs[i].toJson());
+    }
+
+    std::vector<Department> departments;
+    REQUIRE(decodeModels(encodeModels(departments), departments));
+    CHECK(departments.empty());
+
+    // one bad model fails the list and leaves it alone
+    auto data = encodeModels(jobs);
+    CHECK(!decodeModels(data.substr(0, data.size() - 1), decoded));
+    CHECK(!decodeModels(data + "x", decoded));
+    CHECK(decoded.size() == 3UL);
+}
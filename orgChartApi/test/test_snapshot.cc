@@ -0,0 +1,57 @@
+#include <drogon/drogon_test.h>
+#include "../utils/OrgSnapshot.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+std::string writeSnapshot(const std::string &name, const std::string &blob) {
+    auto path = "/tmp/" + name + ".snap";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+    return path;
+}
+}  // namespace
+
+DROGON_TEST(OrgSnapshotRoundTrip)
+{
+    std::vector<SnapshotRecord> records{
+        {3, 1, 1, 2, 17598, "Madonna", "Axl", "Product", "M1"},
+        {1, 1, 1, 1, 16102, "Sabryna", "Peers", "Product", "CEO"},
+        {12, 8, 2, 4, 19053, "Yancey", "Trenton", "Infrastructure", "E5"},
+        {8, 1, 2, 2, 18202, "Sterling", "Haley", "Infrastructure", "M1"},
+    };
+    auto blob = encodeOrgSnapshot(records, 1700000000);
+    auto path = writeSnapshot("org_snapshot_roundtrip", blob);
+
+    auto snapshot = OrgSnapshotView::open(path);
+    REQUIRE(snapshot != nullptr);
+    CHECK(snapshot->takenAt() == 1700000000);
+    REQUIRE(snapshot->rows().size() == 4);
+    CHECK(snapshot->rows()[0].id == 1);
+    CHECK(snapshot->rows()[3].id == 12);
+
+    const auto *row = snapshot->find(12);
+    REQUIRE(row != nullptr);
+    CHECK(row->managerId == 8);
+    CHECK(row->departmentId == 2);
+    CHECK(row->jobId == 4);
+    CHECK(row->hireDay == 19053);
+    CHECK(row->firstName == "Yancey");
+    CHECK(row->lastName == "Trenton");
+    CHECK(row->departmentName == "Infrastructure");
+    CHECK(row->jobTitle == "E5");
+    CHECK(snapshot->find(2) == nullptr);
+    std::remove(path.c_str());
+}
+
+DROGON_TEST(OrgSnapshotRejectsCorruptFile)
+{
+    std::vector<SnapshotRecord> records{{1, 1, 1, 1, 16102, "Sabryna", "Peers", "Product", "CEO"}};
+    auto blob = encodeOrgSnapshot(records, 0);
+    auto path = writeSnapshot("org_snapshot_truncated", blob.substr(0, blob.size() - 3));
+    CHECK(OrgSnapshotView::open(path) == nullptr);
+    std::remove(path.c_str());
+    CHECK(OrgSnapshotView::open("/tmp/org_snapshot_missing.snap") == nullptr);
+}
@@ -0,0 +1,79 @@
+#include <drogon/drogon_test.h>
+#include "../controllers/PersonsController.h"
+#include "../plugins/SqliteSchemaPlugin.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+DROGON_TEST(SqliteSchemaSplitStatements)
+{
+    auto statements = SqliteSchemaPlugin::splitStatements(
+        "-- a comment; not a statement\n"
+        "CREATE TABLE job (id INTEGER PRIMARY KEY, title VARCHAR(50));\n"
+        "INSERT INTO job(id, title) VALUES (1, 'CEO; acting'), (2, 'M1');\n"
+        "  \n");
+    REQUIRE(statements.size() == 2);
+    CHECK(statements[0] == "CREATE TABLE job (id INTEGER PRIMARY KEY, title VARCHAR(50))");
+    CHECK(statements[1] == "INSERT INTO job(id, title) VALUES (1, 'CEO; acting'), (2, 'M1')");
+    CHECK(SqliteSchemaPlugin::splitStatements("  \n-- nothing\n").empty());
+}
+
+// The SQLite forms of the person queries: the id list bound as a JSON array
+// and read back with json_each, and the manager's name joined with ||
+DROGON_TEST(SqlitePersonQueries)
+{
+    using namespace drogon::orm;
+    std::string dir(__FILE__);
+    dir.erase(dir.find_last_of('/') + 1);
+    auto dbClientPtr = DbClient::newSqlite3Client("filename=:memory:", 1);
+    SqliteSchemaPlugin::runScript(dbClientPtr, dir + "../scripts/sqlite/create_db.sql");
+    SqliteSchemaPlugin::runScript(dbClientPtr, dir + "../scripts/seed_db.sql");
+
+    std::string ids = "4,2";
+    auto sql = PersonsController::selectByIdsSql(PersonsController::kAllFields, ClientType::Sqlite3, ids);
+    CHECK(ids == "[4,2]");
+    auto result = dbClientPtr->execSqlSync(sql + " order by person.id", ids);
+    REQUIRE(result.size() == 2);
+    CHECK(result[0]["id"].as<int>() == 2);
+    CHECK(result[0]["manager_id"].as<int>() == 1);
+    CHECK(result[0]["manager_full_name"].as<std::string>() == "Sabryna Peers");
+    CHECK(result[0]["job_title"].as<std::string>() == "M1");
+    CHECK(result[0]["department_name"].as<std::string>() == "Product");
+    CHECK(result[1]["id"].as<int>() == 4);
+    CHECK(result[1]["first_name"].as<std::string>() == "Marcia");
+    CHECK(result[1]["manager_full_name"].as<std::string>() == "Tayler Shantee");
+
+    ids = "999";
+    sql = PersonsController::selectByIdsSql(PersonsController::kId, ClientType::Sqlite3, ids);
+    CHECK(dbClientPtr->execSqlSync(sql, ids).empty());
+}
+
+// fields= and embed= pick the columns, never the rows: a person whose manager
+// is missing is left out whatever is selected
+DROGON_TEST(SqlitePersonFieldsKeepRows)
+{
+    using namespace drogon::orm;
+    std::string dir(__FILE__);
+    dir.erase(dir.find_last_of('/') + 1);
+    auto dbClientPtr = DbClient::newSqlite3Client("filename=:memory:", 1);
+    SqliteSchemaPlugin::runScript(dbClientPtr, dir + "../scripts/sqlite/create_db.sql");
+    SqliteSchemaPlugin::runScript(dbClientPtr, dir + "../scripts/seed_db.sql");
+    dbClientPtr->execSqlSync(
+        "insert into person(id, job_id, department_id, manager_id, first_name, last_name, hire_date) "
+        "values (1000, 3, 1, 999, 'Dangling', 'Manager', '2023-01-01')");
+
+    auto ids = [&dbClientPtr](unsigned fields) {
+        std::vector<int> ids;
+        auto sql = PersonsController::selectSql(fields) + " order by person.id limit $1 offset $2";
+        for (auto row : dbClientPtr->execSqlSync(sql, static_cast<int64_t>(100), static_cast<int64_t>(0))) {
+            ids.push_back(row["id"].as<int>());
+        }
+        return ids;
+    };
+    auto all = ids(PersonsController::kAllFields);
+    CHECK(!all.empty());
+    CHECK(std::find(all.begin(), all.end(), 1000) == all.end());
+    CHECK(ids(PersonsController::kId) == all);
+    CHECK(ids(PersonsController::kId | PersonsController::kFirstName) == all);
+    CHECK(ids(PersonsController::kId | PersonsController::kJob) == all);
+}
@@ -2,11 +2,8 @@
 
 int main()
 {
-    PQisInBatchMode(NULL);
-    PQbatchIsAborted(NULL);
-    PQqueriesInBatch(NULL);
-    PQbeginBatchMode(NULL);
-    PQendBatchMode(NULL);
-    PQsendEndBatch(NULL);
-    PQgetNextQuery(NULL);
+    PQenterPipelineMode(NULL);
+    PQexitPipelineMode(NULL);
+    PQpipelineSync(NULL);
+    PQpipelineStatus(NULL);
 }
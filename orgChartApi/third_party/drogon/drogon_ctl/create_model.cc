@@ -168,6 +168,8 @@ void create_model::createModelClassFromPG(
     data["primaryKeyName"] = "";
     data["dbName"] = dbname_;
     data["rdbms"] = std::string("postgresql");
+    data["valueTypes"] = valueTypes_;
+    data["sqlite3Compatible"] = sqlite3Compatible_;
     data["relationships"] = relationships;
     data["convertMethods"] = convertMethods;
     if (schema != "public")
@@ -446,6 +448,8 @@ void create_model::createModelClassFromMysql(
     data["primaryKeyName"] = "";
     data["dbName"] = dbname_;
     data["rdbms"] = std::string("mysql");
+    data["valueTypes"] = valueTypes_;
+    data["sqlite3Compatible"] = sqlite3Compatible_;
     data["relationships"] = relationships;
     data["convertMethods"] = convertMethods;
     std::vector<ColumnInfo> cols;
@@ -619,6 +623,8 @@ void create_model::createModelClassFromSqlite3(
     data["primaryKeyName"] = "";
     data["dbName"] = std::string("sqlite3");
     data["rdbms"] = std::string("sqlite3");
+    data["valueTypes"] = valueTypes_;
+    data["sqlite3Compatible"] = sqlite3Compatible_;
     data["relationships"] = relationships;
     data["convertMethods"] = convertMethods;
     std::vector<ColumnInfo> cols;
@@ -786,6 +792,8 @@ void create_model::createModel(const std::string &path,
     auto restfulApiConfig = config["restful_api_controllers"];
     auto relationships = getRelationships(config["relationships"]);
     auto convertMethods = getConvertMethods(config["convert"]);
+    valueTypes_ = config.get("value_types", false).asBool();
+    sqlite3Compatible_ = config.get("sqlite3_compatible", false).asBool();
     if (dbType == "postgresql")
     {
 #if USE_POSTGRESQL
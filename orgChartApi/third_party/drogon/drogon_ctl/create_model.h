@@ -399,5 +399,7 @@ class create_model : public DrObject<create_model>, public CommandHandler
                                     const Json::Value &restfulApiConfig);
     std::string dbname_;
     bool forceOverwrite_{false};
+    bool valueTypes_{false};
+    bool sqlite3Compatible_{false};
 };
 }  // namespace drogon_ctl
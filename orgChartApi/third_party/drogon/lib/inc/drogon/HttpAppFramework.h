@@ -1194,6 +1194,18 @@ class DROGON_EXPORT HttpAppFramework : public trantor::NonCopyable
     virtual orm::DbClientPtr getFastDbClient(
         const std::string &name = "default") = 0;
 
+    /// Get the database client for reads by name
+    /**
+     * The client sends read-only statements to the healthy replicas of the
+     * database added by addDbReplica() and everything else to the primary.
+     * Without replicas it's the same client as getDbClient() returns.
+     *
+     * @note
+     * This method must be called after the framework has been run.
+     */
+    virtual orm::DbClientPtr getReadDbClient(
+        const std::string &name = "default") = 0;
+
     /**
      * @brief Check if all database clients in the framework are available
      * (connect to the database successfully).
@@ -1268,6 +1280,24 @@ class DROGON_EXPORT HttpAppFramework : public trantor::NonCopyable
      * @param characterSet The character set of the database server.
      * @param timeout The timeout in seconds for executing SQL queries. zero or
      * negative value means no timeout.
+     * @param loopAffinity Run the connections on the IO loops and let each
+     * query prefer a connection on the loop of the calling thread. It's valid
+     * only if @param isFast is false and the database is not sqlite3. As with
+     * fast clients, synchronous interfaces must not be called on IO threads.
+     * @param maxConnectionNum If it's larger than @param connectionNum, the
+     * pool grows up to this number of connections while queries wait for a
+     * connection and shrinks back to @param connectionNum when they are idle.
+     * It's valid only if @param isFast is false.
+     * @param binaryResults Fetch the results of prepared statements whose
+     * columns are all integers, bool, character types, date or timestamp in
+     * binary format. It's valid only for postgresql.
+     * @param routeReads Let getDbClient() return the same client as
+     * getReadDbClient(), so read-only statements go to the replicas.
+     * @param maxReplicaLag The replay lag in seconds beyond which a
+     * postgresql replica is not read from.
+     * @param journalMode The journal mode the sqlite3 connections set on
+     * their database, e.g. "wal". Empty keeps the mode of the file. It's
+     * valid only for sqlite3.
      *
      * @note
      * This operation can be performed by an option in the configuration file.
@@ -1284,7 +1314,33 @@ class DROGON_EXPORT HttpAppFramework : public trantor::NonCopyable
         const std::string &name = "default",
         const bool isFast = false,
         const std::string &characterSet = "",
-        double timeout = -1.0) = 0;
+        double timeout = -1.0,
+        const bool loopAffinity = false,
+        const size_t maxConnectionNum = 0,
+        const bool binaryResults = false,
+        const bool routeReads = false,
+        const double maxReplicaLag = 5.0,
+        const std::string &journalMode = "") = 0;
+
+    /// Add a read replica to a database client
+    /**
+     * @param name The name of the client created by createDbClient(). The
+     * replica has the same type, number of connections and options as the
+     * client. It's not valid for fast clients and sqlite3.
+     * @param host IP or host name of the replica.
+     * @param port The port on which the replica is listening.
+     *
+     * @note
+     * This operation can be performed by an option in the configuration file.
+     */
+    virtual HttpAppFramework &addDbReplica(
+        const std::string &name,
+        const std::string &host,
+        const unsigned short port,
+        const std::string &databaseName,
+        const std::string &userName,
+        const std::string &password,
+        const std::string &characterSet = "") = 0;
 
     /// Create a redis client
     /**
@@ -532,6 +532,12 @@ static void loadDbClients(const Json::Value &dbClients)
             characterSet = client.get("client_encoding", "").asString();
         }
         auto timeout = client.get("timeout", -1.0).asDouble();
+        auto loopAffinity = client.get("loop_affinity", false).asBool();
+        auto maxConnNum = client.get("max_connections", 0).asUInt();
+        auto binaryResults = client.get("binary_results", false).asBool();
+        auto routeReads = client.get("route_reads", false).asBool();
+        auto maxReplicaLag = client.get("max_replica_lag", 5.0).asDouble();
+        auto journalMode = client.get("journal_mode", "").asString();
         drogon::app().createDbClient(type,
                                      host,
                                      (unsigned short)port,
@@ -543,7 +549,29 @@ static void loadDbClients(const Json::Value &dbClients)
                                      name,
                                      isFast,
                                      characterSet,
-                                     timeout);
+                                     timeout,
+                                     loopAffinity,
+                                     maxConnNum,
+                                     binaryResults,
+                                     routeReads,
+                                     maxReplicaLag,
+                                     journalMode);
+        for (auto const &replica : client["replicas"])
+        {
+            auto replicaPassword = replica.get("passwd", "").asString();
+            if (replicaPassword.empty())
+            {
+                replicaPassword = replica.get("password", password).asString();
+            }
+            drogon::app().addDbReplica(
+                name,
+                replica.get("host", "127.0.0.1").asString(),
+                (unsigned short)replica.get("port", port).asUInt(),
+                replica.get("dbname", dbname).asString(),
+                replica.get("user", user).asString(),
+                replicaPassword,
+                characterSet);
+        }
     }
 }
 
@@ -42,6 +42,14 @@ class DbClientManager : public trantor::NonCopyable
         assert(iter != dbFastClientsMap_.end());
         return iter->second.getThreadData();
     }
+
+    DbClientPtr getReadDbClient(const std::string &name)
+    {
+        auto iter = readDbClientsMap_.find(name);
+        if (iter != readDbClientsMap_.end())
+            return iter->second;
+        return getDbClient(name);
+    }
     void createDbClient(const std::string &dbType,
                         const std::string &host,
                         const unsigned short port,
@@ -53,20 +61,43 @@ class DbClientManager : public trantor::NonCopyable
                         const std::string &name,
                         const bool isFast,
                         const std::string &characterSet,
-                        double timeout);
+                        double timeout,
+                        const bool loopAffinity,
+                        const size_t maxConnectionNum,
+                        const bool binaryResults,
+                        const bool routeReads,
+                        const double maxReplicaLag,
+                        const std::string &journalMode);
+    void addDbReplica(const std::string &name,
+                      const std::string &host,
+                      const unsigned short port,
+                      const std::string &databaseName,
+                      const std::string &userName,
+                      const std::string &password,
+                      const std::string &characterSet);
     bool areAllDbClientsAvailable() const noexcept;
 
   private:
     std::map<std::string, DbClientPtr> dbClientsMap_;
+    std::map<std::string, DbClientPtr> readDbClientsMap_;
     struct DbInfo
     {
         std::string name_;
         std::string connectionInfo_;
         ClientType dbType_;
         bool isFast_;
+        bool loopAffinity_;
+        bool binaryResults_;
+        bool routeReads_;
         size_t connectionNumber_;
+        size_t maxConnectionNumber_;
         double timeout_;
+        double maxReplicaLag_;
+        std::vector<std::string> replicaConnectionInfos_;
     };
+    DbClientPtr newDbClient(const DbInfo &dbInfo,
+                            const std::string &connectionInfo,
+                            const std::vector<trantor::EventLoop *> &ioloops);
     std::vector<DbInfo> dbInfos_;
     std::map<std::string, IOThreadStorage<orm::DbClientPtr>> dbFastClientsMap_;
 };
@@ -38,7 +38,26 @@ void DbClientManager::createDbClient(const std::string & /*dbType*/,
                                      const std::string & /*name*/,
                                      const bool /*isFast*/,
                                      const std::string & /*characterSet*/,
-                                     double /*timeout*/)
+                                     double /*timeout*/,
+                                     const bool /*loopAffinity*/,
+                                     const size_t /*maxConnectionNum*/,
+                                     const bool /*binaryResults*/,
+                                     const bool /*routeReads*/,
+                                     const double /*maxReplicaLag*/,
+                                     const std::string & /*journalMode*/)
+{
+    LOG_FATAL << "No database is supported by drogon, please install the "
+                 "database development library first.";
+    abort();
+}
+
+void DbClientManager::addDbReplica(const std::string & /*name*/,
+                                   const std::string & /*host*/,
+                                   const unsigned short /*port*/,
+                                   const std::string & /*databaseName*/,
+                                   const std::string & /*userName*/,
+                                   const std::string & /*password*/,
+                                   const std::string & /*characterSet*/)
 {
     LOG_FATAL << "No database is supported by drogon, please install the "
                  "database development library first.";
@@ -944,6 +944,10 @@ orm::DbClientPtr HttpAppFrameworkImpl::getFastDbClient(const std::string &name)
 {
     return dbClientManagerPtr_->getFastDbClient(name);
 }
+orm::DbClientPtr HttpAppFrameworkImpl::getReadDbClient(const std::string &name)
+{
+    return dbClientManagerPtr_->getReadDbClient(name);
+}
 nosql::RedisClientPtr HttpAppFrameworkImpl::getRedisClient(
     const std::string &name)
 {
@@ -966,7 +970,13 @@ HttpAppFramework &HttpAppFrameworkImpl::createDbClient(
     const std::string &name,
     const bool isFast,
     const std::string &characterSet,
-    double timeout)
+    double timeout,
+    const bool loopAffinity,
+    const size_t maxConnectionNum,
+    const bool binaryResults,
+    const bool routeReads,
+    const double maxReplicaLag,
+    const std::string &journalMode)
 {
     assert(!running_);
     dbClientManagerPtr_->createDbClient(dbType,
@@ -980,7 +990,28 @@ HttpAppFramework &HttpAppFrameworkImpl::createDbClient(
                                         name,
                                         isFast,
                                         characterSet,
-                                        timeout);
+                                        timeout,
+                                        loopAffinity,
+                                        maxConnectionNum,
+                                        binaryResults,
+                                        routeReads,
+                                        maxReplicaLag,
+                                        journalMode);
+    return *this;
+}
+
+HttpAppFramework &HttpAppFrameworkImpl::addDbReplica(
+    const std::string &name,
+    const std::string &host,
+    const unsigned short port,
+    const std::string &databaseName,
+    const std::string &userName,
+    const std::string &password,
+    const std::string &characterSet)
+{
+    assert(!running_);
+    dbClientManagerPtr_->addDbReplica(
+        name, host, port, databaseName, userName, password, characterSet);
     return *this;
 }
 
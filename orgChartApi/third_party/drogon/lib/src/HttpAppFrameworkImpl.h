@@ -466,6 +466,7 @@ class HttpAppFrameworkImpl final : public HttpAppFramework
 
     orm::DbClientPtr getDbClient(const std::string &name) override;
     orm::DbClientPtr getFastDbClient(const std::string &name) override;
+    orm::DbClientPtr getReadDbClient(const std::string &name) override;
     HttpAppFramework &createDbClient(const std::string &dbType,
                                      const std::string &host,
                                      unsigned short port,
@@ -477,7 +478,20 @@ class HttpAppFrameworkImpl final : public HttpAppFramework
                                      const std::string &name,
                                      bool isFast,
                                      const std::string &characterSet,
-                                     double timeout) override;
+                                     double timeout,
+                                     bool loopAffinity,
+                                     size_t maxConnectionNum,
+                                     bool binaryResults,
+                                     bool routeReads,
+                                     double maxReplicaLag,
+                                     const std::string &journalMode) override;
+    HttpAppFramework &addDbReplica(const std::string &name,
+                                   const std::string &host,
+                                   const unsigned short port,
+                                   const std::string &databaseName,
+                                   const std::string &userName,
+                                   const std::string &password,
+                                   const std::string &characterSet) override;
     HttpAppFramework &createRedisClient(const std::string &ip,
                                         unsigned short port,
                                         const std::string &name,
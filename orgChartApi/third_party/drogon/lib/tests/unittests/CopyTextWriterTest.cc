@@ -0,0 +1,102 @@
+#include <drogon/drogon_test.h>
+#include <drogon/orm/CopyTextWriter.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Exception.h>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+
+using namespace drogon::orm;
+
+namespace
+{
+class SqliteDbClient : public DbClient
+{
+  public:
+    SqliteDbClient()
+    {
+        type_ = ClientType::Sqlite3;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+  private:
+    void execSql(const char *,
+                 size_t,
+                 size_t,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&,
+                 std::function<void(const std::exception_ptr &)> &&) override
+    {
+    }
+};
+}  // namespace
+
+DROGON_TEST(CopyTextWriterTest)
+{
+    std::string buffer;
+    CopyTextWriter writer(buffer);
+    writer << 1 << "Gary" << std::string("Reed") << nullptr << true;
+    writer.endRow();
+    writer << 2.5 << "tab\there" << "new\nline\r" << "back\\slash" << false;
+    writer.endRow();
+    CHECK(buffer ==
+          "1\tGary\tReed\t\\N\tt\n"
+          "2.5\ttab\\there\tnew\\nline\\r\tback\\\\slash\tf\n");
+
+    // Floating point numbers keep every digit, a char is text
+    buffer.clear();
+    writer << 0.1 << 1234567.891011121 << 1e-300 << 0.1f << -0.0
+           << std::numeric_limits<double>::infinity()
+           << std::numeric_limits<double>::quiet_NaN() << 'x';
+    writer.endRow();
+    CHECK(buffer ==
+          "0.1\t1234567.891011121\t1e-300\t0.1\t-0\tInfinity\tNaN\tx\n");
+    buffer.clear();
+    writer << 1.0 / 3;
+    writer.endRow();
+    CHECK(std::strtod(buffer.c_str(), nullptr) == 1.0 / 3);
+
+    // Every control character COPY knows an escape for is escaped
+    buffer.clear();
+    writer << "\b\f\v\x01";
+    writer.endRow();
+    CHECK(buffer == "\\b\\f\\v\x01\n");
+
+    // An empty string is an empty field, null is \N
+    buffer.clear();
+    writer << "";
+    writer.endRow();
+    CHECK(buffer == "\n");
+
+    // COPY needs PostgreSQL
+    auto client = std::make_shared<SqliteDbClient>();
+    bool failed = false;
+    client->copyIn(
+        "copy person from stdin",
+        [](std::string &) { return false; },
+        [](const Result &) {},
+        [&failed](const DrogonDbException &e) {
+            failed = dynamic_cast<const Failure *>(&e.base()) != nullptr;
+        });
+    CHECK(failed);
+}
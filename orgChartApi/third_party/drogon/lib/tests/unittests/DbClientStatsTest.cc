@@ -0,0 +1,106 @@
+#include <drogon/config.h>
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace drogon::orm;
+
+#if USE_SQLITE3
+DROGON_TEST(DbClientStatsTest)
+{
+    auto client = DbClient::newSqlite3Client("filename=:memory:", 1);
+    // Waits until the connection is open
+    client->execSqlSync("select 1");
+    // The result comes before the connection is idle again
+    for (int i = 0; i < 100 && client->stats().busyConnections > 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::vector<std::future<Result>> results;
+    for (int i = 0; i < 20; ++i)
+    {
+        results.push_back(client->execSqlAsyncFuture("select 1"));
+    }
+    for (auto &result : results)
+    {
+        result.get();
+    }
+
+    auto stats = client->stats();
+    CHECK(stats.connections == 1);
+    CHECK(stats.minConnections == 1);
+    CHECK(stats.maxConnections == 1);
+    CHECK(stats.queueDepth == 0);
+    CHECK(stats.rejected == 0);
+    // The sync query and the first async one find the connection idle, the
+    // others wait for it
+    CHECK(std::accumulate(stats.waitTimeHistogram.begin(),
+                          stats.waitTimeHistogram.end(),
+                          uint64_t{0}) == 21);
+    CHECK(stats.waitTimeHistogram[0] >= 1);
+}
+
+// A smoke test of parking connections under load, not a regression test:
+// handleNewTask() re-picking another connection after parking its own is
+// only reached by chance here, and the test passed on the code that kept
+// using the first connection's slot on that path.
+DROGON_TEST(DbClientParkSmokeTest)
+{
+    auto client = DbClient::newSqlite3Client("filename=:memory:", 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        client->execSqlSync("select 1");
+    }
+
+    // Short bursts from several threads, so that tasks keep being queued
+    // while connections are being parked on the ready stacks
+    std::atomic<size_t> completed{0};
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 16; ++t)
+    {
+        callers.emplace_back([&client, &completed, t]() {
+            for (int round = 0; round < 1500; ++round)
+            {
+                std::vector<std::future<Result>> results;
+                for (int i = 0; i <= (round + t) % 3; ++i)
+                {
+                    results.push_back(client->execSqlAsyncFuture("select 1"));
+                }
+                for (auto &result : results)
+                {
+                    result.get();
+                    ++completed;
+                }
+            }
+        });
+    }
+    for (auto &caller : callers)
+    {
+        caller.join();
+    }
+    CHECK(completed.load() == 16 * 500 * (1 + 2 + 3));
+
+    // A connection popped while parking must not stay busy for good
+    for (int i = 0; i < 100 && client->stats().busyConnections > 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(client->stats().busyConnections == 0);
+    std::vector<std::future<Result>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+        results.push_back(client->execSqlAsyncFuture("select 1"));
+    }
+    for (auto &result : results)
+    {
+        CHECK(result.wait_for(std::chrono::seconds(5)) ==
+              std::future_status::ready);
+    }
+}
+#endif
@@ -0,0 +1,130 @@
+#include <drogon/config.h>
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Runs nothing, only records that a statement came without a deadline
+class PlainClient : public DbClient
+{
+  public:
+    PlainClient()
+    {
+        type_ = ClientType::Sqlite3;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    // time_point::max() for the statements without a deadline
+    std::vector<std::chrono::steady_clock::time_point> deadlines_;
+
+  private:
+    void execSql(const char *,
+                 size_t,
+                 size_t,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&,
+                 std::function<void(const std::exception_ptr &)> &&) override
+    {
+        deadlines_.push_back(std::chrono::steady_clock::time_point::max());
+    }
+};
+
+// Records the deadline of every statement
+class DeadlineClient : public PlainClient
+{
+  private:
+    void execSqlWithDeadline(
+        const char *,
+        size_t,
+        size_t,
+        std::vector<const char *> &&,
+        std::vector<int> &&,
+        std::vector<int> &&,
+        ResultCallback &&,
+        std::function<void(const std::exception_ptr &)> &&,
+        std::chrono::steady_clock::time_point deadline) override
+    {
+        deadlines_.push_back(deadline);
+    }
+};
+}  // namespace
+
+DROGON_TEST(DeadlineDbClientTest)
+{
+    auto ignore = [](const Result &) {};
+    auto fail = [](const DrogonDbException &) {};
+    auto inner = std::make_shared<DeadlineClient>();
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    auto client = DbClient::newDeadlineClient(inner, deadline);
+    *client << "select * from job" >> ignore >> fail;
+    REQUIRE(inner->deadlines_.size() == 1);
+    CHECK(inner->deadlines_[0] == deadline);
+
+    // The earlier of two deadlines wins, also through a single-flight client
+    auto earlier = deadline - 5s;
+    client = DbClient::newDeadlineClient(
+        DbClient::newDeadlineClient(DbClient::newSingleFlightClient(inner),
+                                    earlier),
+        deadline);
+    *client << "select * from job" >> ignore >> fail;
+    REQUIRE(inner->deadlines_.size() == 2);
+    CHECK(inner->deadlines_[1] == earlier);
+
+    // A client that can't enforce deadlines runs the statement, unless its
+    // deadline has passed
+    auto plain = std::make_shared<PlainClient>();
+    client = DbClient::newDeadlineClient(plain, deadline);
+    *client << "select * from job" >> ignore >> fail;
+    REQUIRE(plain->deadlines_.size() == 1);
+    CHECK(plain->deadlines_[0] == std::chrono::steady_clock::time_point::max());
+    bool timedOut = false;
+    client = DbClient::newDeadlineClient(plain,
+                                         std::chrono::steady_clock::now() - 1s);
+    *client << "select * from job" >> ignore >>
+        [&timedOut](const DrogonDbException &e) {
+            timedOut = dynamic_cast<const TimeoutError *>(&e) != nullptr;
+        };
+    CHECK(timedOut);
+    CHECK(plain->deadlines_.size() == 1);
+}
+
+#if USE_SQLITE3
+DROGON_TEST(DeadlineSqliteTest)
+{
+    auto sqlite = DbClient::newSqlite3Client("filename=:memory:", 1);
+    auto client = DbClient::newDeadlineClient(
+        sqlite, std::chrono::steady_clock::now() + 10s);
+    auto result = client->execSqlSync("select 42");
+    CHECK(result[0][0].as<int>() == 42);
+
+    client = DbClient::newDeadlineClient(sqlite,
+                                         std::chrono::steady_clock::now());
+    CHECK_THROWS_AS(client->execSqlSync("select 42"), TimeoutError);
+}
+#endif
@@ -0,0 +1,79 @@
+#include "../../orm_lib/src/GroupCommitDbClient.h"
+#include <drogon/config.h>
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+using namespace std::chrono_literals;
+
+DROGON_TEST(GroupCommitDbClientTest)
+{
+    auto groupable = [](const std::string &sql) {
+        return GroupCommitDbClient::isGroupable(sql.data(), sql.length());
+    };
+    CHECK(groupable("insert into job (title) values ($1)"));
+    CHECK(groupable("  UPDATE job set title=$1"));
+    CHECK(groupable("Delete from job"));
+    CHECK(groupable("delete"));
+    CHECK(!groupable("select * from job"));
+    CHECK(!groupable("deleted"));
+    CHECK(!groupable("with x as (delete from job) select 1"));
+    CHECK(!groupable(""));
+}
+
+#if USE_SQLITE3
+namespace
+{
+std::future<bool> insert(const DbClientPtr &client, const std::string &title)
+{
+    auto done = std::make_shared<std::promise<bool>>();
+    client->execSqlAsync(
+        "insert into job (title) values (?)",
+        [done](const Result &) { done->set_value(true); },
+        [done](const DrogonDbException &) { done->set_value(false); },
+        title);
+    return done->get_future();
+}
+}  // namespace
+
+DROGON_TEST(GroupCommitSqliteTest)
+{
+    auto sqlite = DbClient::newSqlite3Client(
+        "filename=file:group_commit_test?mode=memory&cache=shared", 1);
+    sqlite->execSqlSync(
+        "create table job (id integer primary key, title text unique)");
+
+    // The duplicate fails alone, the statements around it are committed
+    auto client = DbClient::newGroupCommitClient(sqlite, 0.05, 64);
+    std::vector<std::future<bool>> results;
+    results.push_back(insert(client, "Engineer"));
+    results.push_back(insert(client, "Engineer"));
+    results.push_back(insert(client, "Manager"));
+    CHECK(results[0].get());
+    CHECK(!results[1].get());
+    CHECK(results[2].get());
+    auto result = sqlite->execSqlSync("select count(*) from job");
+    CHECK(result[0][0].as<int>() == 2);
+
+    // A full group doesn't wait for its window, reads never do
+    client = DbClient::newGroupCommitClient(sqlite, 60.0, 2);
+    auto first = insert(client, "Designer");
+    auto second = insert(client, "Writer");
+    REQUIRE(second.wait_for(5s) == std::future_status::ready);
+    CHECK(first.get());
+    CHECK(second.get());
+    result = client->execSqlSync("select count(*) from job");
+    CHECK(result[0][0].as<int>() == 4);
+
+    // The statements still waiting are committed when the client goes away
+    auto last = insert(client, "Tester");
+    client.reset();
+    REQUIRE(last.wait_for(5s) == std::future_status::ready);
+    CHECK(last.get());
+}
+#endif
@@ -0,0 +1,163 @@
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Mapper.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+// The parts of a drogon_ctl model the mapper uses below
+class Worker
+{
+  public:
+    using PrimaryKeyType = int32_t;
+    const static std::string tableName;
+    const static std::string primaryKeyName;
+
+    explicit Worker(const Row &)
+    {
+    }
+    Worker(std::vector<bool> dirty) : dirty_(std::move(dirty))
+    {
+    }
+    static const std::string &sqlForFindingByPrimaryKey()
+    {
+        static const std::string sql =
+            "select * from " + tableName + " where id = $1";
+        return sql;
+    }
+    static const std::string &sqlForDeletingByPrimaryKey()
+    {
+        static const std::string sql =
+            "delete from " + tableName + " where id = $1";
+        return sql;
+    }
+    static size_t getColumnNumber() noexcept
+    {
+        return 3;
+    }
+    static const std::string &getColumnName(size_t index) noexcept(false)
+    {
+        static const std::vector<std::string> names = {"id", "name", "title"};
+        return names[index];
+    }
+    const std::vector<std::string> updateColumns() const
+    {
+        std::vector<std::string> ret;
+        for (size_t i = 1; i < dirty_.size(); ++i)
+        {
+            if (dirty_[i])
+                ret.push_back(getColumnName(i));
+        }
+        return ret;
+    }
+    void updateArgs(drogon::orm::internal::SqlBinder &binder) const
+    {
+        for (size_t i = 1; i < dirty_.size(); ++i)
+        {
+            if (dirty_[i])
+                binder << getColumnName(i);
+        }
+    }
+    int32_t getPrimaryKey() const
+    {
+        return 7;
+    }
+
+  private:
+    std::vector<bool> dirty_;
+};
+const std::string Worker::tableName = "worker";
+const std::string Worker::primaryKeyName = "id";
+
+// Records the text and the address of every statement it's given
+class StatementDbClient : public DbClient
+{
+  public:
+    explicit StatementDbClient(ClientType type)
+    {
+        type_ = type;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    std::vector<std::string> statements_;
+    std::vector<const char *> addresses_;
+
+  private:
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&,
+                 std::function<void(const std::exception_ptr &)> &&) override
+    {
+        statements_.emplace_back(sql, sqlLength);
+        addresses_.push_back(sql);
+    }
+};
+}  // namespace
+
+DROGON_TEST(MapperSqlTest)
+{
+    auto client = std::make_shared<StatementDbClient>(ClientType::PostgreSQL);
+    Mapper<Worker> mapper(client);
+    auto ignoreCount = [](size_t) {};
+    auto ignoreRow = [](Worker) {};
+    auto fail = [](const DrogonDbException &) {};
+
+    mapper.forUpdate().findByPrimaryKey(7, ignoreRow, fail);
+    mapper.findByPrimaryKey(7, ignoreRow, fail);
+    mapper.deleteOne(Worker({true, true, true}), ignoreCount, fail);
+    REQUIRE(client->statements_.size() == 3);
+    CHECK(client->statements_[0] ==
+          "select * from worker where id = $1 for update");
+    CHECK(client->statements_[1] == "select * from worker where id = $1");
+    CHECK(client->statements_[2] == "delete from worker  where id = $1");
+
+    // Each set of updated columns has a statement of its own, which later
+    // updates share instead of building it again
+    mapper.update(Worker({false, true, true}), ignoreCount, fail);
+    mapper.update(Worker({false, false, true}), ignoreCount, fail);
+    mapper.update(Worker({false, true, true}), ignoreCount, fail);
+    REQUIRE(client->statements_.size() == 6);
+    CHECK(client->statements_[3] ==
+          "update worker set name = $1,title = $2  where id = $3");
+    CHECK(client->statements_[4] ==
+          "update worker set title = $1  where id = $2");
+    CHECK(client->statements_[5] == client->statements_[3]);
+    CHECK(client->addresses_[5] == client->addresses_[3]);
+    mapper.findByPrimaryKey(7, ignoreRow, fail);
+    CHECK(client->addresses_.back() == client->addresses_[1]);
+
+    // Other databases get their own placeholders
+    auto sqlite = std::make_shared<StatementDbClient>(ClientType::Sqlite3);
+    Mapper<Worker> sqliteMapper(sqlite);
+    sqliteMapper.update(Worker({false, true, true}), ignoreCount, fail);
+    sqliteMapper.deleteOne(Worker({false, true, true}), ignoreCount, fail);
+    REQUIRE(sqlite->statements_.size() == 2);
+    CHECK(sqlite->statements_[0] ==
+          "update worker set name = ?,title = ?  where id = ?");
+    CHECK(sqlite->statements_[1] == "delete from worker  where id = ?");
+}
@@ -0,0 +1,73 @@
+#include "../../orm_lib/src/postgresql_impl/PgBinaryFormat.h"
+#include <drogon/drogon_test.h>
+
+using namespace drogon::orm;
+
+static std::string bigEndian(int64_t value, int bytes)
+{
+    std::string data(bytes, '\0');
+    for (int i = bytes - 1; i >= 0; --i)
+    {
+        data[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    return data;
+}
+
+DROGON_TEST(PgBinaryFormatTest)
+{
+    int64_t integer;
+    auto int2 = bigEndian(-300, 2);
+    CHECK(pg_binary::readInteger(pg_binary::kInt2, int2.data(), integer));
+    CHECK(integer == -300);
+    auto int4 = bigEndian(-2, 4);
+    CHECK(pg_binary::readInteger(pg_binary::kInt4, int4.data(), integer));
+    CHECK(integer == -2);
+    auto int8 = bigEndian(5000000000LL, 8);
+    CHECK(pg_binary::readInteger(pg_binary::kInt8, int8.data(), integer));
+    CHECK(integer == 5000000000LL);
+    CHECK(pg_binary::toText(pg_binary::kInt8, int8.data(), 8) == "5000000000");
+    CHECK(pg_binary::toText(pg_binary::kBool, "\1", 1) == "t");
+    CHECK(pg_binary::toText(pg_binary::kBool, "\0", 1) == "f");
+    CHECK(!pg_binary::readInteger(pg_binary::kText, "12", integer));
+    CHECK(pg_binary::toText(pg_binary::kVarchar, "abc", 3) == "abc");
+
+    pg_binary::DateTime dt;
+    auto date = bigEndian(6671, 4);
+    CHECK(pg_binary::readDateTime(pg_binary::kDate, date.data(), dt));
+    CHECK(dt.year == 2018);
+    CHECK(dt.month == 4);
+    CHECK(dt.day == 7);
+    CHECK(pg_binary::toText(pg_binary::kDate, date.data(), 4) == "2018-04-07");
+
+    auto timestamp = bigEndian(668149567890000LL, 8);
+    CHECK(pg_binary::readDateTime(pg_binary::kTimestamp, timestamp.data(), dt));
+    CHECK(dt.hour == 5);
+    CHECK(dt.minute == 6);
+    CHECK(dt.second == 7);
+    CHECK(dt.microsecond == 890000);
+    CHECK(pg_binary::toText(pg_binary::kTimestamp, timestamp.data(), 8) ==
+          "2021-03-04 05:06:07.89");
+
+    // Half a second before the epoch
+    auto beforeEpoch = bigEndian(-500000, 8);
+    CHECK(pg_binary::toText(pg_binary::kTimestamp, beforeEpoch.data(), 8) ==
+          "1999-12-31 23:59:59.5");
+
+    auto firstDay = bigEndian(-730119, 4);
+    CHECK(pg_binary::toText(pg_binary::kDate, firstDay.data(), 4) ==
+          "0001-01-01");
+    auto yearZero = bigEndian(-730119 - 366, 4);
+    CHECK(pg_binary::toText(pg_binary::kDate, yearZero.data(), 4) ==
+          "0001-01-01 BC");
+
+    auto infinity = bigEndian(pg_binary::kTimestampInfinity, 8);
+    CHECK(!pg_binary::readDateTime(pg_binary::kTimestamp,
+                                   infinity.data(),
+                                   dt));
+    CHECK(pg_binary::toText(pg_binary::kTimestamp, infinity.data(), 8) ==
+          "infinity");
+    auto negInfinity = bigEndian(pg_binary::kDateNegInfinity, 4);
+    CHECK(pg_binary::toText(pg_binary::kDate, negInfinity.data(), 4) ==
+          "-infinity");
+}
@@ -0,0 +1,67 @@
+#include "../../orm_lib/src/postgresql_impl/PostgreSQLResultImpl.h"
+#include <drogon/drogon_test.h>
+#include <drogon/orm/Exception.h>
+#include <drogon/orm/Field.h>
+#include <drogon/orm/Result.h>
+#include <drogon/orm/Row.h>
+#include <libpq-fe.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+// A text result of the given columns and one row with their numbers
+std::shared_ptr<PGresult> makeResult(std::vector<std::string> names)
+{
+    std::shared_ptr<PGresult> result(PQmakeEmptyPGresult(nullptr,
+                                                         PGRES_TUPLES_OK),
+                                     [](PGresult *p) { PQclear(p); });
+    std::vector<PGresAttDesc> attributes(names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        attributes[i] = PGresAttDesc{};
+        attributes[i].name = &names[i][0];
+        attributes[i].typid = 25;  // text
+        attributes[i].typlen = -1;
+        attributes[i].atttypmod = -1;
+    }
+    PQsetResultAttrs(result.get(),
+                     static_cast<int>(attributes.size()),
+                     attributes.data());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        auto value = std::to_string(i);
+        PQsetvalue(result.get(),
+                   0,
+                   static_cast<int>(i),
+                   &value[0],
+                   static_cast<int>(value.length()));
+    }
+    return result;
+}
+}  // namespace
+
+DROGON_TEST(PgResultTest)
+{
+    Result result(std::make_shared<PostgreSQLResultImpl>(
+        makeResult({"id", "job_title", "Mixed", "id"})));
+    auto row = result[0];
+    CHECK(row["job_title"].as<std::string>() == "1");
+    CHECK(row[std::string("job_title")].as<std::string>() == "1");
+    // The first of two columns with the same name
+    CHECK(row["id"].as<std::string>() == "0");
+
+    // Unquoted names are folded to lower case, quoted ones aren't
+    CHECK(row["JOB_TITLE"].as<std::string>() == "1");
+    CHECK(row["\"Mixed\""].as<std::string>() == "2");
+    CHECK_THROWS_AS(row["Mixed"], RangeError);
+    CHECK_THROWS_AS(row["mixed"], RangeError);
+    CHECK_THROWS_AS(row["manager_id"], RangeError);
+
+    // Other rows share the names of the result
+    auto copy = result;
+    CHECK(copy[0].at("job_title").as<std::string>() == "1");
+}
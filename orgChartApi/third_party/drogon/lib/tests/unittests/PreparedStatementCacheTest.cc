@@ -0,0 +1,37 @@
+#include "../../orm_lib/src/postgresql_impl/PreparedStatementCache.h"
+#include <drogon/drogon_test.h>
+
+using namespace drogon::orm;
+
+DROGON_TEST(PreparedStatementCacheTest)
+{
+    auto counters = std::make_shared<PreparedStatementCounters>();
+    {
+        PreparedStatementCache cache(2, counters);
+        CHECK(cache.find("select 1") == nullptr);
+        CHECK(cache.insert("select 1", "1").empty());
+        CHECK(cache.insert("select 2", "2", true).empty());
+        CHECK(cache.size() == 2);
+
+        // "select 1" becomes the most recently used, so "select 2" goes
+        auto statement = cache.find("select 1");
+        REQUIRE(statement != nullptr);
+        CHECK(statement->name_ == "1");
+        CHECK(cache.insert("select 3", "3") == "2");
+        CHECK(cache.size() == 2);
+        CHECK(cache.find("select 2") == nullptr);
+        REQUIRE(cache.find("select 3") != nullptr);
+
+        // Preparing the same sql again replaces the old statement
+        CHECK(cache.insert("select 3", "4") == "3");
+        CHECK(cache.size() == 2);
+        REQUIRE(cache.find("select 3") != nullptr);
+        CHECK(cache.find("select 3")->name_ == "4");
+
+        CHECK(counters->hits_ == 4);
+        CHECK(counters->misses_ == 2);
+        CHECK(counters->evictions_ == 1);
+        CHECK(counters->cached_ == 2);
+    }
+    CHECK(counters->cached_ == 0);
+}
@@ -0,0 +1,118 @@
+#include "../../orm_lib/src/ReplicaDbClient.h"
+#include <drogon/drogon_test.h>
+#include <drogon/orm/Exception.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+// Records the statements it's given and fails them while it's broken
+class RecordingDbClient : public DbClient
+{
+  public:
+    RecordingDbClient()
+    {
+        // The replicas of other databases than PostgreSQL start healthy
+        type_ = ClientType::Sqlite3;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        ++transactions_;
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        ++transactions_;
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    std::vector<std::string> statements_;
+    size_t transactions_{0};
+    bool broken_{false};
+
+  private:
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override
+    {
+        statements_.emplace_back(sql, sqlLength);
+        if (broken_)
+        {
+            exceptCallback(std::make_exception_ptr(
+                BrokenConnection("The connection is broken")));
+        }
+    }
+};
+}  // namespace
+
+DROGON_TEST(ReplicaDbClientTest)
+{
+    auto primary = std::make_shared<RecordingDbClient>();
+    auto first = std::make_shared<RecordingDbClient>();
+    auto second = std::make_shared<RecordingDbClient>();
+    auto client = std::make_shared<ReplicaDbClient>(
+        primary, std::vector<DbClientPtr>{first, second}, 5.0);
+    auto fail = [](const DrogonDbException &) {};
+    auto ignore = [](const Result &) {};
+
+    // Reads alternate between the replicas, writes go to the primary
+    for (int i = 0; i < 4; ++i)
+    {
+        *client << "select * from person where id = $1" << i >> ignore >>
+            fail;
+    }
+    *client << "update person set first_name = $1" << "Gary" >> ignore >>
+        fail;
+    CHECK(first->statements_.size() == 2);
+    CHECK(second->statements_.size() == 2);
+    REQUIRE(primary->statements_.size() == 1);
+    CHECK(primary->statements_[0] == "update person set first_name = $1");
+
+    client->newTransactionAsync([](const std::shared_ptr<Transaction> &) {});
+    CHECK(primary->transactions_ == 1);
+    CHECK(first->transactions_ + second->transactions_ == 0);
+
+    // A replica that lags too far behind is skipped until it catches up
+    client->updateReplica(0, true, 10.0);
+    for (int i = 0; i < 2; ++i)
+    {
+        *client << "select * from job" >> ignore >> fail;
+    }
+    CHECK(first->statements_.size() == 2);
+    CHECK(second->statements_.size() == 4);
+    client->updateReplica(1, false, 0);
+    *client << "select * from job" >> ignore >> fail;
+    CHECK(primary->statements_.size() == 2);
+    client->updateReplica(0, true, 1.0);
+    *client << "select * from job" >> ignore >> fail;
+    CHECK(first->statements_.size() == 3);
+
+    // A read whose replica connection breaks runs again on the primary
+    first->broken_ = true;
+    bool failed = false;
+    *client << "select * from department" >> ignore >>
+        [&failed](const DrogonDbException &) { failed = true; };
+    CHECK(first->statements_.size() == 4);
+    REQUIRE(primary->statements_.size() == 3);
+    CHECK(primary->statements_[2] == "select * from department");
+    CHECK(!failed);
+}
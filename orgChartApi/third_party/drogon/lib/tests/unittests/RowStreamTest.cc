@@ -0,0 +1,178 @@
+#include "../../orm_lib/src/ResultImpl.h"
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+// A result of one integer column with the given number of rows
+class CountResultImpl : public ResultImpl
+{
+  public:
+    explicit CountResultImpl(SizeType rows) : rows_(rows)
+    {
+    }
+    SizeType size() const noexcept override
+    {
+        return rows_;
+    }
+    RowSizeType columns() const noexcept override
+    {
+        return 1;
+    }
+    const char *columnName(RowSizeType) const override
+    {
+        return "id";
+    }
+    SizeType affectedRows() const noexcept override
+    {
+        return 0;
+    }
+    RowSizeType columnNumber(const char[]) const override
+    {
+        return 0;
+    }
+    const char *getValue(SizeType, RowSizeType) const override
+    {
+        return "1";
+    }
+    bool isNull(SizeType, RowSizeType) const override
+    {
+        return false;
+    }
+    FieldSizeType getLength(SizeType, RowSizeType) const override
+    {
+        return 1;
+    }
+
+  private:
+    SizeType rows_;
+};
+
+// Answers every fetch with the next chunk of a cursor over rows_ rows
+class CursorTransaction : public Transaction,
+                          public std::enable_shared_from_this<CursorTransaction>
+{
+  public:
+    CursorTransaction(size_t rows, size_t chunkRows)
+        : rows_(rows), chunkRows_(chunkRows)
+    {
+        type_ = ClientType::PostgreSQL;
+    }
+    void rollback() override
+    {
+    }
+    void setCommitCallback(const std::function<void(bool)> &) override
+    {
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return shared_from_this();
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(shared_from_this());
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    std::vector<std::string> statements_;
+    std::vector<size_t> parameterCounts_;
+
+  private:
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)> &&) override
+    {
+        statements_.emplace_back(sql, sqlLength);
+        parameterCounts_.push_back(paraNum);
+        size_t rows = 0;
+        if (statements_.back().compare(0, 5, "fetch") == 0)
+        {
+            rows = (std::min)(chunkRows_, rows_ - fetched_);
+            fetched_ += rows;
+        }
+        rcb(Result(std::make_shared<CountResultImpl>(rows)));
+    }
+
+    size_t rows_;
+    size_t chunkRows_;
+    size_t fetched_{0};
+};
+}  // namespace
+
+DROGON_TEST(RowStreamTest)
+{
+    auto transaction = std::make_shared<CursorTransaction>(5, 2);
+    std::vector<size_t> chunks;
+    std::function<void(bool)> next;
+    bool finished = false;
+    transaction->execSqlStreaming(
+        "select id from person where id > $1",
+        2,
+        [&](const Result &result, std::function<void(bool)> &&more) {
+            chunks.push_back(result.size());
+            next = std::move(more);
+        },
+        [&finished]() { finished = true; },
+        [](const DrogonDbException &) {},
+        0);
+    REQUIRE(transaction->statements_.size() == 2);
+    CHECK(transaction->statements_[0] ==
+          "declare drogon_row_stream no scroll cursor for select id from "
+          "person where id > $1");
+    CHECK(transaction->parameterCounts_[0] == 1);
+    CHECK(transaction->statements_[1] ==
+          "fetch forward 2 from drogon_row_stream");
+
+    // Nothing more is fetched until the consumer asks for it
+    CHECK(chunks == std::vector<size_t>{2});
+    CHECK(transaction->statements_.size() == 2);
+    next(true);
+    CHECK(chunks == (std::vector<size_t>{2, 2}));
+    next(true);
+    CHECK(chunks == (std::vector<size_t>{2, 2, 1}));
+    CHECK(!finished);
+
+    // The short chunk was the last one, the cursor is closed without
+    // another fetch
+    next(true);
+    CHECK(finished);
+    CHECK(transaction->statements_.size() == 5);
+    CHECK(transaction->statements_.back() == "close drogon_row_stream");
+
+    // A consumer can end the stream early
+    transaction = std::make_shared<CursorTransaction>(10, 3);
+    finished = false;
+    chunks.clear();
+    transaction->execSqlStreaming(
+        "select id from person",
+        3,
+        [&](const Result &result, std::function<void(bool)> &&more) {
+            chunks.push_back(result.size());
+            more(false);
+        },
+        [&finished]() { finished = true; },
+        [](const DrogonDbException &) {});
+    CHECK(chunks == std::vector<size_t>{3});
+    CHECK(finished);
+    CHECK(transaction->statements_.back() == "close drogon_row_stream");
+}
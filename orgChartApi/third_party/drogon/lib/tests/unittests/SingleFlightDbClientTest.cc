@@ -0,0 +1,127 @@
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+class RecordingDbClient : public DbClient
+{
+  public:
+    RecordingDbClient()
+    {
+        type_ = ClientType::PostgreSQL;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    std::vector<std::pair<ResultCallback, ExceptPtrCallback>> calls_;
+
+  private:
+    void execSql(const char *,
+                 size_t,
+                 size_t,
+                 std::vector<const char *> &&,
+                 std::vector<int> &&,
+                 std::vector<int> &&,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override
+    {
+        calls_.emplace_back(std::move(rcb), std::move(exceptCallback));
+    }
+};
+}  // namespace
+
+DROGON_TEST(SingleFlightDbClientTest)
+{
+    auto recorder = std::make_shared<RecordingDbClient>();
+    auto client = DbClient::newSingleFlightClient(recorder);
+    int results = 0;
+    int errors = 0;
+    auto query = [&](const std::string &sql, int id) {
+        *client << sql << id >> [&results](const Result &) { ++results; } >>
+            [&errors](const DrogonDbException &) { ++errors; };
+    };
+
+    query("select * from person where id = $1", 1);
+    query("select * from person where id = $1", 1);
+    query("SELECT * from person where id = $1", 1);
+    query("select * from person where id = $1", 2);
+    REQUIRE(recorder->calls_.size() == 3);
+
+    recorder->calls_[0].first(Result(nullptr));
+    CHECK(results == 2);
+
+    // The first flight is done, the next identical query runs again
+    query("select * from person where id = $1", 1);
+    CHECK(recorder->calls_.size() == 4);
+
+    query("select * from person where id = $1", 2);
+    CHECK(recorder->calls_.size() == 4);
+    recorder->calls_[2].second(
+        std::make_exception_ptr(Failure("connection lost")));
+    CHECK(errors == 2);
+
+    // Writes and locking reads are never coalesced
+    query("delete from person where id = $1", 3);
+    query("delete from person where id = $1", 3);
+    query("select * from person where id = $1 for update", 3);
+    query("select * from person where id = $1 for update", 3);
+    CHECK(recorder->calls_.size() == 8);
+}
+
+DROGON_TEST(SingleFlightDeadlineTest)
+{
+    auto recorder = std::make_shared<RecordingDbClient>();
+    auto client = DbClient::newSingleFlightClient(recorder);
+    auto now = std::chrono::steady_clock::now();
+    auto shortClient =
+        DbClient::newDeadlineClient(client, now + std::chrono::seconds(1));
+    auto longClient =
+        DbClient::newDeadlineClient(client, now + std::chrono::seconds(10));
+    int results = 0;
+    int errors = 0;
+    auto query = [&](const DbClientPtr &c) {
+        *c << "select * from person where id = $1" << 1 >>
+            [&results](const Result &) { ++results; } >>
+            [&errors](const DrogonDbException &) { ++errors; };
+    };
+
+    // A later deadline doesn't join a query that may fail earlier
+    query(shortClient);
+    query(longClient);
+    REQUIRE(recorder->calls_.size() == 2);
+    // The next callers join the query with the later deadline
+    query(longClient);
+    query(shortClient);
+    CHECK(recorder->calls_.size() == 2);
+
+    recorder->calls_[0].second(
+        std::make_exception_ptr(TimeoutError("deadline exceeded")));
+    CHECK(errors == 1);
+    CHECK(results == 0);
+    recorder->calls_[1].first(Result(nullptr));
+    CHECK(results == 3);
+    CHECK(errors == 1);
+}
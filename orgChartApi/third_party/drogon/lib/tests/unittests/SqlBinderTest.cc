@@ -0,0 +1,133 @@
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/utils/Date.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+namespace
+{
+struct BoundParameter
+{
+    bool isNull_;
+    std::string data_;
+    int length_;
+    int format_;
+};
+
+// Copies the parameters of every query while they are still alive
+class BindingDbClient : public DbClient
+{
+  public:
+    explicit BindingDbClient(ClientType type)
+    {
+        type_ = type;
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &) noexcept(false) override
+    {
+        return nullptr;
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        callback(nullptr);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return true;
+    }
+    void setTimeout(double) override
+    {
+    }
+
+    std::vector<BoundParameter> parameters_;
+
+  private:
+    void execSql(const char *,
+                 size_t,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 ResultCallback &&,
+                 std::function<void(const std::exception_ptr &)> &&) override
+    {
+        parameters_.clear();
+        for (size_t i = 0; i < paraNum; ++i)
+        {
+            BoundParameter parameter{parameters[i] == nullptr,
+                                     "",
+                                     length[i],
+                                     format[i]};
+            // The numbers of sqlite3 are native 8 byte values here
+            if (parameters[i] && type_ == ClientType::Sqlite3)
+                parameter.data_.assign(parameters[i], 8);
+            else if (parameters[i] && format[i] == 1)
+                parameter.data_.assign(parameters[i], length[i]);
+            else if (parameters[i])
+                parameter.data_ = parameters[i];
+            parameters_.push_back(std::move(parameter));
+        }
+    }
+};
+}  // namespace
+
+DROGON_TEST(SqlBinderTest)
+{
+    BindingDbClient client(ClientType::PostgreSQL);
+    const std::string longText(100, 'x');
+    client << "select $1, $2, $3, $4, $5, $6" << static_cast<int16_t>(-2)
+           << static_cast<int32_t>(7) << static_cast<int64_t>(1) << 258
+           << std::string("short") << longText;
+    REQUIRE(client.parameters_.size() == 6);
+    CHECK(client.parameters_[0].data_ == std::string("\xff\xfe", 2));
+    CHECK(client.parameters_[1].data_ == std::string("\0\0\0\7", 4));
+    CHECK(client.parameters_[1].format_ == 1);
+    CHECK(client.parameters_[2].data_ == std::string("\0\0\0\0\0\0\0\1", 8));
+    CHECK(client.parameters_[3].data_ == std::string("\0\0\1\2", 4));
+    CHECK(client.parameters_[4].data_ == "short");
+    CHECK(client.parameters_[4].length_ == 5);
+    CHECK(client.parameters_[4].format_ == 0);
+    CHECK(client.parameters_[5].data_ == longText);
+
+    // Dates are bound as text, nulls as null pointers
+    auto date = trantor::Date::fromDbStringLocal("2018-04-07 10:11:12");
+    client << "select $1, $2, $3" << date << nullptr
+           << trantor::Date(2018, 4, 7);
+    REQUIRE(client.parameters_.size() == 3);
+    CHECK(client.parameters_[0].data_ == "2018-04-07 10:11:12");
+    CHECK(client.parameters_[0].format_ == 0);
+    CHECK(client.parameters_[1].isNull_);
+    CHECK(client.parameters_[2].data_ == "2018-04-07");
+
+    // Parameters beyond the inline slots are kept as separate objects
+    {
+        auto binder = client << "select $1";
+        for (int32_t i = 0; i < 20; ++i)
+        {
+            binder << i;
+        }
+    }
+    REQUIRE(client.parameters_.size() == 20);
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        CHECK(client.parameters_[i].data_ ==
+              std::string("\0\0\0", 3) + static_cast<char>(i));
+    }
+
+    BindingDbClient sqlite(ClientType::Sqlite3);
+    sqlite << "select ?, ?" << static_cast<int64_t>(-5) << 1.5;
+    REQUIRE(sqlite.parameters_.size() == 2);
+    CHECK(sqlite.parameters_[0].format_ == Sqlite3TypeInt64);
+    int64_t integer;
+    memcpy(&integer, sqlite.parameters_[0].data_.data(), sizeof(integer));
+    CHECK(integer == -5);
+    CHECK(sqlite.parameters_[1].format_ == Sqlite3TypeDouble);
+    double real;
+    memcpy(&real, sqlite.parameters_[1].data_.data(), sizeof(real));
+    CHECK(real == 1.5);
+}
@@ -0,0 +1,45 @@
+#include <drogon/config.h>
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace drogon::orm;
+
+#if USE_SQLITE3
+DROGON_TEST(Sqlite3ConnectionTest)
+{
+    // Every connection sees the tables of the others in a shared in-memory
+    // database
+    auto memory = DbClient::newSqlite3Client(
+        "filename=file:sqlite3_connection_test?mode=memory&cache=shared", 2);
+    memory->execSqlSync(
+        "create table job (id integer primary key, title text)");
+    for (int i = 0; i < 4; ++i)
+    {
+        memory->execSqlSync("insert into job (title) values (?)",
+                            "Job " + std::to_string(i));
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        auto result = memory->execSqlSync("select count(*) from job");
+        CHECK(result[0][0].as<int>() == 4);
+    }
+
+    auto filename =
+        "/tmp/sqlite3_connection_test_" + std::to_string(getpid()) + ".db";
+    {
+        auto file = DbClient::newSqlite3Client(
+            "filename=" + filename + " journal_mode=WAL", 2);
+        auto result = file->execSqlSync("pragma journal_mode");
+        CHECK(result[0][0].as<std::string>() == "wal");
+        result = file->execSqlSync("pragma synchronous");
+        // NORMAL
+        CHECK(result[0][0].as<int>() == 1);
+    }
+    std::remove(filename.c_str());
+    std::remove((filename + "-wal").c_str());
+    std::remove((filename + "-shm").c_str());
+}
+#endif
@@ -0,0 +1,100 @@
+#include "../../orm_lib/src/StatementStats.h"
+#include <drogon/config.h>
+#include <drogon/drogon_test.h>
+#include <drogon/orm/DbClient.h>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace drogon::orm;
+
+DROGON_TEST(StatementStatsTest)
+{
+    CHECK(StatementStats::normalize(
+              "select *\n  from person where id = 42 and name = 'O''Brien'") ==
+          "select * from person where id = ? and name = ?");
+    // Placeholders, identifiers with digits and quoted names are kept
+    CHECK(StatementStats::normalize(
+              " update job2 set \"Title 1\" = $1 where id = $2 limit 10 ") ==
+          "update job2 set \"Title 1\" = $1 where id = $2 limit ?");
+    CHECK(StatementStats::normalize("select 1.5e3, -7") == "select ?, -?");
+    CHECK(StatementStats::normalize("fetch forward 1000 from cursor_1") ==
+          "fetch forward ? from cursor_1");
+
+    std::vector<StatementStat> merged;
+    StatementStat select;
+    select.sql = "select ?";
+    select.calls = 2;
+    select.execMicroseconds = 10;
+    merged.push_back(select);
+    StatementStat more = select;
+    more.execMicroseconds = 20;
+    StatementStat update;
+    update.sql = "update job set title = $1";
+    update.calls = 1;
+    update.execMicroseconds = 50;
+    StatementStats::merge(merged, {more, update});
+    REQUIRE(merged.size() == 2);
+    CHECK(merged[0].sql == update.sql);
+    CHECK(merged[1].calls == 4);
+    CHECK(merged[1].execMicroseconds == 30);
+}
+
+#if USE_SQLITE3
+DROGON_TEST(StatementStatsClientTest)
+{
+    auto client = DbClient::newSqlite3Client("filename=:memory:", 1);
+    client->execSqlSync("create table job (id integer, title text)");
+    for (int i = 0; i < 3; ++i)
+    {
+        client->execSqlSync("insert into job values (" + std::to_string(i) +
+                            ", 'Job " + std::to_string(i) + "')");
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        client->execSqlSync("select * from job where id >= ?", 1);
+    }
+    try
+    {
+        client->execSqlSync("select * from missing_table");
+    }
+    catch (const DrogonDbException &)
+    {
+    }
+
+    auto stats = client->statementStats();
+    auto find = [&stats](const std::string &sql) {
+        return std::find_if(stats.begin(),
+                            stats.end(),
+                            [&sql](const StatementStat &stat) {
+                                return stat.sql == sql;
+                            });
+    };
+    auto insert = find("insert into job values (?, ?)");
+    REQUIRE(insert != stats.end());
+    CHECK(insert->calls == 3);
+    CHECK(insert->rows == 3);
+    CHECK(insert->errors == 0);
+
+    auto select = find("select * from job where id >= ?");
+    REQUIRE(select != stats.end());
+    CHECK(select->calls == 5);
+    CHECK(select->rows == 10);
+    CHECK(std::accumulate(select->execTimeHistogram.begin(),
+                          select->execTimeHistogram.end(),
+                          uint64_t{0}) == 5);
+
+    auto missing = find("select * from missing_table");
+    REQUIRE(missing != stats.end());
+    CHECK(missing->calls == 1);
+    CHECK(missing->errors == 1);
+
+    // The busiest statement comes first
+    CHECK(std::is_sorted(stats.begin(),
+                         stats.end(),
+                         [](const StatementStat &a, const StatementStat &b) {
+                             return a.execMicroseconds > b.execMicroseconds;
+                         }));
+}
+#endif
@@ -21,6 +21,8 @@
 #include <trantor/utils/Logger.h>
 #include <memory>
 #include <functional>
+#include <string>
+#include <vector>
 #ifdef __cpp_impl_coroutine
 #include <drogon/utils/coroutine.h>
 #endif
@@ -122,6 +124,80 @@ class DROGON_EXPORT RedisClient
                                   string_view command,
                                   ...) noexcept = 0;
 
+    /**
+     * @brief Execute a redis command given as a list of arguments
+     *
+     * @param arguments The command name followed by its arguments, each one
+     * is sent as is, so it may contain spaces or binary data.
+     * @param resultCallback The callback is called when a redis reply is
+     * received successfully.
+     * @param exceptionCallback The callback is called when an error occurs.
+     * For example:
+     * @code
+       redisClientPtr->execCommandArgvAsync({"mget", key1, key2},
+           [](const RedisResult &r){
+           for (auto &item : r.asArray())
+               std::cout << item.getStringForDisplaying() << std::endl;
+       },[](const std::exception &err){
+           std::cerr << err.what() << std::endl;
+       });
+       @endcode
+     * @note Commands issued from other threads during one iteration of the
+     * connection's event loop are written to the server together, so issuing
+     * many commands at once pipelines them.
+     */
+    virtual void execCommandArgvAsync(
+        const std::vector<std::string> &arguments,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback) noexcept = 0;
+
+    /**
+     * @brief Get the values of several keys with a single MGET.
+     *
+     * @param keys The keys to get.
+     * @param callback The callback is called with one value per key, in the
+     * order of the keys. The value of a missing key, or of a key that does not
+     * hold a string, is nullptr.
+     * @param exceptionCallback The callback is called when an error occurs.
+     */
+    void getMultipleAsync(
+        const std::vector<std::string> &keys,
+        std::function<void(std::vector<std::shared_ptr<std::string>> &&)>
+            &&callback,
+        RedisExceptionCallback &&exceptionCallback) noexcept
+    {
+        if (keys.empty())
+        {
+            callback({});
+            return;
+        }
+        std::vector<std::string> arguments;
+        arguments.reserve(keys.size() + 1);
+        arguments.emplace_back("mget");
+        arguments.insert(arguments.end(), keys.begin(), keys.end());
+        execCommandArgvAsync(
+            arguments,
+            [callback = std::move(callback)](const RedisResult &result) {
+                std::vector<std::shared_ptr<std::string>> values;
+                if (result.type() == RedisResultType::kArray)
+                {
+                    auto items = result.asArray();
+                    values.reserve(items.size());
+                    for (auto &item : items)
+                    {
+                        if (item.type() == RedisResultType::kString)
+                            values.emplace_back(
+                                std::make_shared<std::string>(
+                                    item.asString()));
+                        else
+                            values.emplace_back(nullptr);
+                    }
+                }
+                callback(std::move(values));
+            },
+            std::move(exceptionCallback));
+    }
+
     /**
      * @brief Create a redis transaction object.
      *
@@ -15,6 +15,7 @@
 #include "RedisClientImpl.h"
 #include "RedisTransactionImpl.h"
 #include "../../lib/src/TaskTimeoutFlag.h"
+#include <algorithm>
 using namespace drogon::nosql;
 std::shared_ptr<RedisClient> RedisClient::newRedisClient(
     const trantor::InetAddress &serverAddress,
@@ -113,62 +114,97 @@ void RedisClientImpl::execCommandAsync(
     string_view command,
     ...) noexcept
 {
-    if (timeout_ > 0.0)
+    LOG_TRACE << "redis command: " << command;
+    std::string formattedCmd;
+    va_list args;
+    va_start(args, command);
+    try
+    {
+        formattedCmd = RedisConnection::getFormattedCommand(command, args);
+    }
+    catch (const RedisException &err)
     {
-        va_list args;
-        va_start(args, command);
-        execCommandAsyncWithTimeout(command,
-                                    std::move(resultCallback),
-                                    std::move(exceptionCallback),
-                                    args);
         va_end(args);
+        exceptionCallback(err);
         return;
     }
-    RedisConnectionPtr connPtr;
+    va_end(args);
+    execFormattedCommandAsync(std::move(formattedCmd),
+                              std::move(resultCallback),
+                              std::move(exceptionCallback));
+}
+
+void RedisClientImpl::execCommandArgvAsync(
+    const std::vector<std::string> &arguments,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback) noexcept
+{
+    std::string formattedCmd;
+    try
     {
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        if (!readyConnections_.empty())
-        {
-            if (connectionPos_ >= readyConnections_.size())
-            {
-                connPtr = readyConnections_[0];
-                connectionPos_ = 1;
-            }
-            else
-            {
-                connPtr = readyConnections_[connectionPos_++];
-            }
-        }
+        formattedCmd = RedisConnection::getFormattedCommand(arguments);
     }
-    if (connPtr)
+    catch (const RedisException &err)
     {
-        va_list args;
-        va_start(args, command);
-        connPtr->sendvCommand(command,
+        exceptionCallback(err);
+        return;
+    }
+    execFormattedCommandAsync(std::move(formattedCmd),
                               std::move(resultCallback),
-                              std::move(exceptionCallback),
-                              args);
-        va_end(args);
+                              std::move(exceptionCallback));
+}
+
+RedisConnectionPtr RedisClientImpl::nextConnection()
+{
+    // While commands wait for a connection, the next ones wait behind them
+    // instead of overtaking them
+    if (readyConnections_.empty() || !tasks_.empty())
+        return nullptr;
+    if (connectionPos_ >= readyConnections_.size())
+    {
+        connectionPos_ = 1;
+        return readyConnections_[0];
     }
-    else
+    return readyConnections_[connectionPos_++];
+}
+
+void RedisClientImpl::execFormattedCommandAsync(
+    std::string &&formattedCmd,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback)
+{
+    if (timeout_ > 0.0)
+    {
+        execFormattedCommandAsyncWithTimeout(std::move(formattedCmd),
+                                             std::move(resultCallback),
+                                             std::move(exceptionCallback));
+        return;
+    }
+    RedisConnectionPtr connPtr;
     {
-        LOG_TRACE << "no connection available, push command to buffer";
-        va_list args;
-        va_start(args, command);
-        auto formattedCmd = RedisConnection::getFormattedCommand(command, args);
-        va_end(args);
         std::lock_guard<std::mutex> lock(connectionsMutex_);
-        tasks_.emplace_back(
-            std::make_shared<std::function<void(const RedisConnectionPtr &)>>(
-                [resultCallback = std::move(resultCallback),
-                 exceptionCallback = std::move(exceptionCallback),
-                 formattedCmd = std::move(formattedCmd)](
-                    const RedisConnectionPtr &connPtr) mutable {
-                    connPtr->sendFormattedCommand(std::move(formattedCmd),
-                                                  std::move(resultCallback),
-                                                  std::move(exceptionCallback));
-                }));
+        connPtr = nextConnection();
+        if (!connPtr)
+        {
+            LOG_TRACE << "no connection available, push command to buffer";
+            tasks_.emplace_back(
+                std::make_shared<
+                    std::function<void(const RedisConnectionPtr &)>>(
+                    [resultCallback = std::move(resultCallback),
+                     exceptionCallback = std::move(exceptionCallback),
+                     formattedCmd = std::move(formattedCmd)](
+                        const RedisConnectionPtr &connPtr) mutable {
+                        connPtr->sendFormattedCommand(
+                            std::move(formattedCmd),
+                            std::move(resultCallback),
+                            std::move(exceptionCallback));
+                    }));
+            return;
+        }
     }
+    connPtr->sendFormattedCommand(std::move(formattedCmd),
+                                  std::move(resultCallback),
+                                  std::move(exceptionCallback));
 }
 
 RedisClientImpl::~RedisClientImpl()
@@ -294,25 +330,65 @@ std::shared_ptr<RedisTransaction> RedisClientImpl::makeTransaction(
 
 void RedisClientImpl::handleNextTask(const RedisConnectionPtr &connPtr)
 {
-    std::shared_ptr<std::function<void(const RedisConnectionPtr &)>> taskPtr;
+    // The buffered commands are sent from the connection's loop, which sends
+    // the commands other threads hand to the connection in a later iteration,
+    // so those can't overtake them
+    auto loop = connPtr->getLoop();
+    if (!loop->isInLoopThread())
     {
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        if (!tasks_.empty())
-        {
-            taskPtr = std::move(tasks_.front());
-            tasks_.pop_front();
-        }
+        std::weak_ptr<RedisClientImpl> thisWeakPtr = shared_from_this();
+        loop->queueInLoop([thisWeakPtr, connPtr]() {
+            auto thisPtr = thisWeakPtr.lock();
+            if (thisPtr)
+            {
+                thisPtr->handleNextTask(connPtr);
+            }
+        });
+        return;
     }
-    if (taskPtr && (*taskPtr))
+    // Sends all the buffered commands in order, until a transaction buffered
+    // among them takes the connection
+    for (;;)
     {
-        (*taskPtr)(connPtr);
+        std::shared_ptr<std::function<void(const RedisConnectionPtr &)>>
+            taskPtr;
+        RedisConnectionPtr nextConnPtr;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            if (tasks_.empty())
+            {
+                return;
+            }
+            if (std::find(readyConnections_.begin(),
+                          readyConnections_.end(),
+                          connPtr) != readyConnections_.end())
+            {
+                taskPtr = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            else if (!readyConnections_.empty())
+            {
+                nextConnPtr = readyConnections_.front();
+            }
+        }
+        if (!taskPtr)
+        {
+            if (nextConnPtr)
+            {
+                handleNextTask(nextConnPtr);
+            }
+            return;
+        }
+        if (*taskPtr)
+        {
+            (*taskPtr)(connPtr);
+        }
     }
 }
-void RedisClientImpl::execCommandAsyncWithTimeout(
-    string_view command,
+void RedisClientImpl::execFormattedCommandAsyncWithTimeout(
+    std::string &&formattedCmd,
     RedisResultCallback &&resultCallback,
-    RedisExceptionCallback &&exceptionCallback,
-    va_list ap)
+    RedisExceptionCallback &&exceptionCallback)
 {
     auto expCbPtr =
         std::make_shared<RedisExceptionCallback>(std::move(exceptionCallback));
@@ -366,32 +442,12 @@ void RedisClientImpl::execCommandAsyncWithTimeout(
     RedisConnectionPtr connPtr;
     {
         std::lock_guard<std::mutex> lock(connectionsMutex_);
-        if (!readyConnections_.empty())
+        connPtr = nextConnection();
+        if (!connPtr)
         {
-            if (connectionPos_ >= readyConnections_.size())
-            {
-                connPtr = readyConnections_[0];
-                connectionPos_ = 1;
-            }
-            else
-            {
-                connPtr = readyConnections_[connectionPos_++];
-            }
-        }
-    }
-    if (connPtr)
-    {
-        connPtr->sendvCommand(command,
-                              std::move(newResultCallback),
-                              std::move(newExceptionCallback),
-                              ap);
-    }
-    else
-    {
-        LOG_TRACE << "no connection available, push command to buffer";
-        auto formattedCmd = RedisConnection::getFormattedCommand(command, ap);
-        auto bfCbPtr =
-            std::make_shared<std::function<void(const RedisConnectionPtr &)>>(
+            LOG_TRACE << "no connection available, push command to buffer";
+            auto bfCbPtr = std::make_shared<
+                std::function<void(const RedisConnectionPtr &)>>(
                 [resultCallback = std::move(newResultCallback),
                  exceptionCallback = std::move(newExceptionCallback),
                  formattedCmd = std::move(formattedCmd)](
@@ -400,9 +456,15 @@ void RedisClientImpl::execCommandAsyncWithTimeout(
                                                   std::move(resultCallback),
                                                   std::move(exceptionCallback));
                 });
-        (*bufferCbPtr) = bfCbPtr;
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        tasks_.emplace_back(bfCbPtr);
+            (*bufferCbPtr) = bfCbPtr;
+            tasks_.emplace_back(bfCbPtr);
+        }
+    }
+    if (connPtr)
+    {
+        connPtr->sendFormattedCommand(std::move(formattedCmd),
+                                      std::move(newResultCallback),
+                                      std::move(newExceptionCallback));
     }
     timeoutFlagPtr->runTimer();
 }
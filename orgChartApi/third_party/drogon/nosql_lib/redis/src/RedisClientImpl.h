@@ -40,6 +40,10 @@ class RedisClientImpl final
                           RedisExceptionCallback &&exceptionCallback,
                           string_view command,
                           ...) noexcept override;
+    void execCommandArgvAsync(
+        const std::vector<std::string> &arguments,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback) noexcept override;
     ~RedisClientImpl() override;
     RedisTransactionPtr newTransaction() noexcept(false) override
     {
@@ -83,10 +87,15 @@ class RedisClientImpl final
     std::shared_ptr<RedisTransaction> makeTransaction(
         const RedisConnectionPtr &connPtr);
     void handleNextTask(const RedisConnectionPtr &connPtr);
-    void execCommandAsyncWithTimeout(string_view command,
-                                     RedisResultCallback &&resultCallback,
-                                     RedisExceptionCallback &&exceptionCallback,
-                                     va_list ap);
+    // Called with connectionsMutex_ held
+    RedisConnectionPtr nextConnection();
+    void execFormattedCommandAsync(std::string &&formattedCmd,
+                                   RedisResultCallback &&resultCallback,
+                                   RedisExceptionCallback &&exceptionCallback);
+    void execFormattedCommandAsyncWithTimeout(
+        std::string &&formattedCmd,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback);
 };
 }  // namespace nosql
 }  // namespace drogon
@@ -15,6 +15,7 @@
 #include "RedisClientLockFree.h"
 #include "RedisTransactionImpl.h"
 #include "../../lib/src/TaskTimeoutFlag.h"
+#include <algorithm>
 using namespace drogon::nosql;
 
 RedisClientLockFree::RedisClientLockFree(
@@ -88,54 +89,86 @@ void RedisClientLockFree::execCommandAsync(
     ...) noexcept
 {
     loop_->assertInLoopThread();
-    if (timeout_ > 0.0)
+    LOG_TRACE << "redis command: " << command;
+    std::string formattedCmd;
+    va_list args;
+    va_start(args, command);
+    try
+    {
+        formattedCmd = RedisConnection::getFormattedCommand(command, args);
+    }
+    catch (const RedisException &err)
     {
-        va_list args;
-        va_start(args, command);
-        execCommandAsyncWithTimeout(command,
-                                    std::move(resultCallback),
-                                    std::move(exceptionCallback),
-                                    args);
         va_end(args);
+        exceptionCallback(err);
         return;
     }
-    RedisConnectionPtr connPtr;
+    va_end(args);
+    execFormattedCommandAsync(std::move(formattedCmd),
+                              std::move(resultCallback),
+                              std::move(exceptionCallback));
+}
+
+void RedisClientLockFree::execCommandArgvAsync(
+    const std::vector<std::string> &arguments,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback) noexcept
+{
+    loop_->assertInLoopThread();
+    std::string formattedCmd;
+    try
     {
-        if (!readyConnections_.empty())
-        {
-            if (connectionPos_ >= readyConnections_.size())
-            {
-                connPtr = readyConnections_[0];
-                connectionPos_ = 1;
-            }
-            else
-            {
-                connPtr = readyConnections_[connectionPos_++];
-            }
-        }
+        formattedCmd = RedisConnection::getFormattedCommand(arguments);
     }
-    if (connPtr)
+    catch (const RedisException &err)
     {
-        va_list args;
-        va_start(args, command);
-        connPtr->sendvCommand(command,
+        exceptionCallback(err);
+        return;
+    }
+    execFormattedCommandAsync(std::move(formattedCmd),
                               std::move(resultCallback),
-                              std::move(exceptionCallback),
-                              args);
-        va_end(args);
+                              std::move(exceptionCallback));
+}
+
+RedisConnectionPtr RedisClientLockFree::nextConnection()
+{
+    // While commands wait for a connection, the next ones wait behind them
+    // instead of overtaking them
+    if (readyConnections_.empty() || !tasks_.empty())
+        return nullptr;
+    if (connectionPos_ >= readyConnections_.size())
+    {
+        connectionPos_ = 1;
+        return readyConnections_[0];
+    }
+    return readyConnections_[connectionPos_++];
+}
+
+void RedisClientLockFree::execFormattedCommandAsync(
+    std::string &&formattedCmd,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback)
+{
+    if (timeout_ > 0.0)
+    {
+        execFormattedCommandAsyncWithTimeout(std::move(formattedCmd),
+                                             std::move(resultCallback),
+                                             std::move(exceptionCallback));
+        return;
+    }
+    auto connPtr = nextConnection();
+    if (connPtr)
+    {
+        connPtr->sendFormattedCommand(std::move(formattedCmd),
+                                      std::move(resultCallback),
+                                      std::move(exceptionCallback));
     }
     else
     {
         LOG_TRACE << "no connection available, push command to buffer";
-        std::weak_ptr<RedisClientLockFree> thisWeakPtr = shared_from_this();
-        va_list args;
-        va_start(args, command);
-        auto formattedCmd = RedisConnection::getFormattedCommand(command, args);
-        va_end(args);
         tasks_.emplace_back(
             std::make_shared<std::function<void(const RedisConnectionPtr &)>>(
-                [thisWeakPtr,
-                 resultCallback = std::move(resultCallback),
+                [resultCallback = std::move(resultCallback),
                  exceptionCallback = std::move(exceptionCallback),
                  formattedCmd = std::move(formattedCmd)](
                     const RedisConnectionPtr &connPtr) mutable {
@@ -261,25 +294,33 @@ std::shared_ptr<RedisTransaction> RedisClientLockFree::makeTransaction(
 void RedisClientLockFree::handleNextTask(const RedisConnectionPtr &connPtr)
 {
     loop_->assertInLoopThread();
-    std::shared_ptr<std::function<void(const RedisConnectionPtr &)>> taskPtr;
-
-    if (!tasks_.empty())
+    // Sends all the buffered commands in order, until a transaction buffered
+    // among them takes the connection
+    while (!tasks_.empty())
     {
-        taskPtr = std::move(tasks_.front());
+        if (std::find(readyConnections_.begin(),
+                      readyConnections_.end(),
+                      connPtr) == readyConnections_.end())
+        {
+            if (!readyConnections_.empty())
+            {
+                handleNextTask(readyConnections_.front());
+            }
+            return;
+        }
+        auto taskPtr = std::move(tasks_.front());
         tasks_.pop_front();
-    }
-
-    if (taskPtr && (*taskPtr))
-    {
-        (*taskPtr)(connPtr);
+        if (taskPtr && (*taskPtr))
+        {
+            (*taskPtr)(connPtr);
+        }
     }
 }
 
-void RedisClientLockFree::execCommandAsyncWithTimeout(
-    string_view command,
+void RedisClientLockFree::execFormattedCommandAsyncWithTimeout(
+    std::string &&formattedCmd,
     RedisResultCallback &&resultCallback,
-    RedisExceptionCallback &&exceptionCallback,
-    va_list ap)
+    RedisExceptionCallback &&exceptionCallback)
 {
     auto expCbPtr =
         std::make_shared<RedisExceptionCallback>(std::move(exceptionCallback));
@@ -329,32 +370,16 @@ void RedisClientLockFree::execCommandAsyncWithTimeout(
             (*expCbPtr)(err);
         }
     };
-    RedisConnectionPtr connPtr;
-    {
-        if (!readyConnections_.empty())
-        {
-            if (connectionPos_ >= readyConnections_.size())
-            {
-                connPtr = readyConnections_[0];
-                connectionPos_ = 1;
-            }
-            else
-            {
-                connPtr = readyConnections_[connectionPos_++];
-            }
-        }
-    }
+    auto connPtr = nextConnection();
     if (connPtr)
     {
-        connPtr->sendvCommand(command,
-                              std::move(newResultCallback),
-                              std::move(newExceptionCallback),
-                              ap);
+        connPtr->sendFormattedCommand(std::move(formattedCmd),
+                                      std::move(newResultCallback),
+                                      std::move(newExceptionCallback));
     }
     else
     {
         LOG_TRACE << "no connection available, push command to buffer";
-        auto formattedCmd = RedisConnection::getFormattedCommand(command, ap);
         auto bfCbPtr =
             std::make_shared<std::function<void(const RedisConnectionPtr &)>>(
                 [resultCallback = std::move(newResultCallback),
@@ -41,6 +41,10 @@ class RedisClientLockFree final
                           RedisExceptionCallback &&exceptionCallback,
                           string_view command,
                           ...) noexcept override;
+    void execCommandArgvAsync(
+        const std::vector<std::string> &arguments,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback) noexcept override;
     ~RedisClientLockFree() override;
     RedisTransactionPtr newTransaction() override
     {
@@ -76,10 +80,14 @@ class RedisClientLockFree final
     std::shared_ptr<RedisTransaction> makeTransaction(
         const RedisConnectionPtr &connPtr);
     void handleNextTask(const RedisConnectionPtr &connPtr);
-    void execCommandAsyncWithTimeout(string_view command,
-                                     RedisResultCallback &&resultCallback,
-                                     RedisExceptionCallback &&exceptionCallback,
-                                     va_list ap);
+    RedisConnectionPtr nextConnection();
+    void execFormattedCommandAsync(std::string &&formattedCmd,
+                                   RedisResultCallback &&resultCallback,
+                                   RedisExceptionCallback &&exceptionCallback);
+    void execFormattedCommandAsyncWithTimeout(
+        std::string &&formattedCmd,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback);
 };
 }  // namespace nosql
 }  // namespace drogon
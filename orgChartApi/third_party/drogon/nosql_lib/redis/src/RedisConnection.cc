@@ -258,18 +258,42 @@ void RedisConnection::sendCommandInLoop(
     RedisResultCallback &&resultCallback,
     RedisExceptionCallback &&exceptionCallback)
 {
+    // hiredis only appends the command to its output buffer here and writes
+    // the buffer once the socket is writable, so the commands sent in one
+    // iteration of the loop leave in one write
+    if (status_ == ConnectStatus::kEnd ||
+        redisAsyncFormattedCommand(
+            redisContext_,
+            [](redisAsyncContext *context, void *r, void * /*userData*/) {
+                auto thisPtr =
+                    static_cast<RedisConnection *>(context->ev.data);
+                thisPtr->handleResult(static_cast<redisReply *>(r));
+            },
+            nullptr,
+            command.c_str(),
+            command.length()) != REDIS_OK)
+    {
+        exceptionCallback(RedisException(RedisErrorCode::kConnectionBroken,
+                                         "Connection is broken"));
+        return;
+    }
     resultCallbacks_.emplace(std::move(resultCallback));
     exceptionCallbacks_.emplace(std::move(exceptionCallback));
+}
 
-    redisAsyncFormattedCommand(
-        redisContext_,
-        [](redisAsyncContext *context, void *r, void * /*userData*/) {
-            auto thisPtr = static_cast<RedisConnection *>(context->ev.data);
-            thisPtr->handleResult(static_cast<redisReply *>(r));
-        },
-        nullptr,
-        command.c_str(),
-        command.length());
+void RedisConnection::sendPendingCommandsInLoop()
+{
+    std::vector<PendingCommand> commands;
+    {
+        std::lock_guard<std::mutex> lock(pendingCommandsMutex_);
+        commands.swap(pendingCommands_);
+    }
+    for (auto &command : commands)
+    {
+        sendCommandInLoop(command.command_,
+                          std::move(command.resultCallback_),
+                          std::move(command.exceptionCallback_));
+    }
 }
 
 void RedisConnection::handleResult(redisReply *result)
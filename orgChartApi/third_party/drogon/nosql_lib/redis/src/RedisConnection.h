@@ -23,7 +23,9 @@
 #include <hiredis/async.h>
 #include <hiredis/hiredis.h>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 namespace drogon
 {
@@ -86,6 +88,43 @@ class RedisConnection : public trantor::NonCopyable,
         free(cmd);
         return fullCommand;
     }
+    static std::string getFormattedCommand(
+        const std::vector<std::string> &arguments) noexcept(false)
+    {
+        if (arguments.empty())
+        {
+            throw RedisException(RedisErrorCode::kInternalError,
+                                 "Empty command");
+        }
+        std::vector<const char *> argv;
+        std::vector<size_t> argvLength;
+        argv.reserve(arguments.size());
+        argvLength.reserve(arguments.size());
+        for (auto &argument : arguments)
+        {
+            argv.push_back(argument.data());
+            argvLength.push_back(argument.length());
+        }
+        char *cmd;
+        auto len = redisFormatCommandArgv(&cmd,
+                                          static_cast<int>(argv.size()),
+                                          argv.data(),
+                                          argvLength.data());
+        if (len <= 0)
+        {
+            throw RedisException(RedisErrorCode::kInternalError,
+                                 "Out of memory");
+        }
+        std::string fullCommand{cmd, static_cast<size_t>(len)};
+        free(cmd);
+        return fullCommand;
+    }
+    /**
+     * @brief Send a command formatted by getFormattedCommand(). Commands sent
+     * from other threads are queued and handed to the loop together, so
+     * that all the commands queued before the loop runs go out in one write
+     * and one wakeup of the loop; their replies come back in the same order.
+     */
     void sendFormattedCommand(std::string &&command,
                               RedisResultCallback &&resultCallback,
                               RedisExceptionCallback &&exceptionCallback)
@@ -95,18 +134,21 @@ class RedisConnection : public trantor::NonCopyable,
             sendCommandInLoop(command,
                               std::move(resultCallback),
                               std::move(exceptionCallback));
+            return;
+        }
+        bool first;
+        {
+            std::lock_guard<std::mutex> lock(pendingCommandsMutex_);
+            first = pendingCommands_.empty();
+            pendingCommands_.push_back({std::move(command),
+                                        std::move(resultCallback),
+                                        std::move(exceptionCallback)});
         }
-        else
+        if (first)
         {
-            loop_->queueInLoop(
-                [this,
-                 callback = std::move(resultCallback),
-                 exceptionCallback = std::move(exceptionCallback),
-                 command = std::move(command)]() mutable {
-                    sendCommandInLoop(command,
-                                      std::move(callback),
-                                      std::move(exceptionCallback));
-                });
+            loop_->queueInLoop([thisPtr = shared_from_this()]() {
+                thisPtr->sendPendingCommandsInLoop();
+            });
         }
     }
     void sendvCommand(string_view command,
@@ -117,25 +159,9 @@ class RedisConnection : public trantor::NonCopyable,
         LOG_TRACE << "redis command: " << command;
         try
         {
-            auto fullCommand = getFormattedCommand(command, ap);
-            if (loop_->isInLoopThread())
-            {
-                sendCommandInLoop(fullCommand,
-                                  std::move(resultCallback),
-                                  std::move(exceptionCallback));
-            }
-            else
-            {
-                loop_->queueInLoop(
-                    [this,
-                     callback = std::move(resultCallback),
-                     exceptionCallback = std::move(exceptionCallback),
-                     fullCommand = std::move(fullCommand)]() mutable {
-                        sendCommandInLoop(fullCommand,
-                                          std::move(callback),
-                                          std::move(exceptionCallback));
-                    });
-            }
+            sendFormattedCommand(getFormattedCommand(command, ap),
+                                 std::move(resultCallback),
+                                 std::move(exceptionCallback));
         }
         catch (const RedisException &err)
         {
@@ -181,6 +207,14 @@ class RedisConnection : public trantor::NonCopyable,
     std::function<void(const std::shared_ptr<RedisConnection> &)> idleCallback_;
     std::queue<RedisResultCallback> resultCallbacks_;
     std::queue<RedisExceptionCallback> exceptionCallbacks_;
+    struct PendingCommand
+    {
+        std::string command_;
+        RedisResultCallback resultCallback_;
+        RedisExceptionCallback exceptionCallback_;
+    };
+    std::mutex pendingCommandsMutex_;
+    std::vector<PendingCommand> pendingCommands_;
     ConnectStatus status_{ConnectStatus::kNone};
     void startConnectionInLoop();
     static void addWrite(void *userData);
@@ -194,6 +228,7 @@ class RedisConnection : public trantor::NonCopyable,
     void sendCommandInLoop(const std::string &command,
                            RedisResultCallback &&resultCallback,
                            RedisExceptionCallback &&exceptionCallback);
+    void sendPendingCommandsInLoop();
     void handleDisconnect();
 };
 using RedisConnectionPtr = std::shared_ptr<RedisConnection>;
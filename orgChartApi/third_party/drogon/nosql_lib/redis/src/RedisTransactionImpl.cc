@@ -39,6 +39,51 @@ void RedisTransactionImpl::execCommandAsync(
     RedisExceptionCallback &&exceptionCallback,
     string_view command,
     ...) noexcept
+{
+    LOG_TRACE << "redis command: " << command;
+    std::string formattedCmd;
+    va_list args;
+    va_start(args, command);
+    try
+    {
+        formattedCmd = RedisConnection::getFormattedCommand(command, args);
+    }
+    catch (const RedisException &err)
+    {
+        va_end(args);
+        exceptionCallback(err);
+        return;
+    }
+    va_end(args);
+    execFormattedCommandAsync(std::move(formattedCmd),
+                              std::move(resultCallback),
+                              std::move(exceptionCallback));
+}
+
+void RedisTransactionImpl::execCommandArgvAsync(
+    const std::vector<std::string> &arguments,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback) noexcept
+{
+    std::string formattedCmd;
+    try
+    {
+        formattedCmd = RedisConnection::getFormattedCommand(arguments);
+    }
+    catch (const RedisException &err)
+    {
+        exceptionCallback(err);
+        return;
+    }
+    execFormattedCommandAsync(std::move(formattedCmd),
+                              std::move(resultCallback),
+                              std::move(exceptionCallback));
+}
+
+void RedisTransactionImpl::execFormattedCommandAsync(
+    std::string &&formattedCmd,
+    RedisResultCallback &&resultCallback,
+    RedisExceptionCallback &&exceptionCallback)
 {
     if (isExecutedOrCancelled_)
     {
@@ -48,10 +93,8 @@ void RedisTransactionImpl::execCommandAsync(
     }
     if (timeout_ <= 0.0)
     {
-        va_list args;
-        va_start(args, command);
-        connPtr_->sendvCommand(
-            command,
+        connPtr_->sendFormattedCommand(
+            std::move(formattedCmd),
             std::move(resultCallback),
             [thisPtr = shared_from_this(),
              exceptionCallback =
@@ -59,9 +102,7 @@ void RedisTransactionImpl::execCommandAsync(
                 LOG_ERROR << err.what();
                 thisPtr->isExecutedOrCancelled_ = true;
                 exceptionCallback(err);
-            },
-            args);
-        va_end(args);
+            });
     }
     else
     {
@@ -77,10 +118,8 @@ void RedisTransactionImpl::execCommandAsync(
                                                "Command execution timeout"));
                 }
             });
-        va_list args;
-        va_start(args, command);
-        connPtr_->sendvCommand(
-            command,
+        connPtr_->sendFormattedCommand(
+            std::move(formattedCmd),
             [resultCallback = std::move(resultCallback),
              timeoutFlagPtr](const RedisResult &result) {
                 if (timeoutFlagPtr->done())
@@ -99,9 +138,7 @@ void RedisTransactionImpl::execCommandAsync(
                 thisPtr->isExecutedOrCancelled_ = true;
                 if (*expCbPtr)
                     (*expCbPtr)(err);
-            },
-            args);
-        va_end(args);
+            });
         timeoutFlagPtr->runTimer();
     }
 }
@@ -34,6 +34,10 @@ class RedisTransactionImpl final
                           RedisExceptionCallback &&exceptionCallback,
                           string_view command,
                           ...) noexcept override;
+    void execCommandArgvAsync(
+        const std::vector<std::string> &arguments,
+        RedisResultCallback &&resultCallback,
+        RedisExceptionCallback &&exceptionCallback) noexcept override;
     std::shared_ptr<RedisTransaction> newTransaction() override
     {
         return shared_from_this();
@@ -52,6 +56,9 @@ class RedisTransactionImpl final
     ~RedisTransactionImpl() override;
 
   private:
+    void execFormattedCommandAsync(std::string &&formattedCmd,
+                                   RedisResultCallback &&resultCallback,
+                                   RedisExceptionCallback &&exceptionCallback);
     bool isExecutedOrCancelled_{false};
     RedisConnectionPtr connPtr_;
     double timeout_{-1.0};
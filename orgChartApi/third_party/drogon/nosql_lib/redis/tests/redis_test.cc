@@ -2,6 +2,7 @@
 #include <drogon/nosql/RedisClient.h>
 #include <drogon/drogon_test.h>
 #include <drogon/drogon.h>
+#include <future>
 #include <iostream>
 #include <thread>
 
@@ -64,10 +65,52 @@ DROGON_TEST(RedisTest)
         [TEST_CTX](const RedisException &err) { MANDATE(err.what()); },
         "get %s",
         "xxxxx");
+    // 8 arguments are sent as is, spaces and zero bytes included
+    const std::string value("two words\0and a zero", 20);
+    redisClient->execCommandArgvAsync(
+        {"set", "pipeline_key_0", value},
+        [TEST_CTX](const drogon::nosql::RedisResult &r) { SUCCESS(); },
+        [TEST_CTX](const RedisException &err) { MANDATE(err.what()); });
+    // 9 many commands issued at once are pipelined, the replies come back in
+    // order
+    std::vector<std::string> keys{"pipeline_key_0"};
+    for (int i = 1; i < 100; ++i)
+    {
+        keys.emplace_back("pipeline_key_" + std::to_string(i));
+        redisClient->execCommandAsync(
+            [TEST_CTX](const drogon::nosql::RedisResult &r) { SUCCESS(); },
+            [TEST_CTX](const RedisException &err) { MANDATE(err.what()); },
+            "set %s %d",
+            keys.back().c_str(),
+            i);
+    }
+    keys.emplace_back("pipeline_missing_key");
+    redisClient->getMultipleAsync(
+        keys,
+        [TEST_CTX,
+         value](std::vector<std::shared_ptr<std::string>> &&values) {
+            MANDATE(values.size() == 101UL);
+            MANDATE(values[0] != nullptr);
+            CHECK(*values[0] == value);
+            for (int i = 1; i < 100; ++i)
+            {
+                MANDATE(values[i] != nullptr);
+                CHECK(*values[i] == std::to_string(i));
+            }
+            CHECK(values[100] == nullptr);
+        },
+        [TEST_CTX](const RedisException &err) { MANDATE(err.what()); });
+    // 10
+    redisClient->getMultipleAsync(
+        {},
+        [TEST_CTX](std::vector<std::shared_ptr<std::string>> &&values) {
+            MANDATE(values.empty());
+        },
+        [TEST_CTX](const RedisException &err) { MANDATE(err.what()); });
 
 #ifdef __cpp_impl_coroutine
     auto coro_test = [TEST_CTX]() -> drogon::Task<> {
-        // 8
+        // 11
         try
         {
             auto r = co_await redisClient->execCommandCoro("get %s", "haha");
@@ -82,6 +125,46 @@ DROGON_TEST(RedisTest)
 #endif
 }
 
+DROGON_TEST(RedisOrderTest)
+{
+    // The commands issued while a new client connects wait for a connection,
+    // the ones issued once it is up must not overtake them
+    auto client = drogon::nosql::RedisClient::newRedisClient(
+        trantor::InetAddress("127.0.0.1", 6379), 1);
+    REQUIRE(client != nullptr);
+    const int count = 20000;
+    auto replies = std::make_shared<int>(0);
+    auto outOfOrder = std::make_shared<int>(0);
+    auto done = std::make_shared<std::promise<void>>();
+    auto f = done->get_future();
+    for (int i = 0; i < count; ++i)
+    {
+        client->execCommandAsync(
+            [replies, outOfOrder, done, i, count](
+                const drogon::nosql::RedisResult &r) {
+                if (*replies != i || r.asString() != std::to_string(i))
+                {
+                    ++*outOfOrder;
+                }
+                if (++*replies == count)
+                {
+                    done->set_value();
+                }
+            },
+            [replies, outOfOrder, done, count](const RedisException &) {
+                ++*outOfOrder;
+                if (++*replies == count)
+                {
+                    done->set_value();
+                }
+            },
+            "echo %d",
+            i);
+    }
+    MANDATE(f.wait_for(10s) == std::future_status::ready);
+    CHECK(*outOfOrder == 0);
+}
+
 int main(int argc, char **argv)
 {
 #ifndef USE_REDIS
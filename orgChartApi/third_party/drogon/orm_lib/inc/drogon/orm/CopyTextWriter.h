@@ -0,0 +1,185 @@
+/**
+ *
+ *  @file CopyTextWriter.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/utils/string_view.h>
+#include <trantor/utils/Date.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace drogon
+{
+namespace orm
+{
+/**
+ * @brief Appends rows in the text format of PostgreSQL COPY to a buffer, for
+ * the producer of DbClient::copyIn(). Fields are separated by tabs, rows end
+ * with a newline and null is \N. In strings, backslashes, tabs, newlines,
+ * carriage returns, backspaces, form feeds and vertical tabs are escaped.
+ * Floating point numbers are written with as many digits as it takes to read
+ * them back unchanged, a char is written as a one character string.
+ *
+ * @code
+   CopyTextWriter writer(buffer);
+   writer << person.getValueOfFirstName() << nullptr << 42;
+   writer.endRow();
+   @endcode
+ */
+class CopyTextWriter
+{
+  public:
+    explicit CopyTextWriter(std::string &buffer) : buffer_(buffer)
+    {
+    }
+
+    CopyTextWriter &operator<<(const string_view &value)
+    {
+        separate();
+        for (auto ch : value)
+        {
+            switch (ch)
+            {
+                case '\\':
+                    buffer_.append("\\\\");
+                    break;
+                case '\t':
+                    buffer_.append("\\t");
+                    break;
+                case '\n':
+                    buffer_.append("\\n");
+                    break;
+                case '\r':
+                    buffer_.append("\\r");
+                    break;
+                case '\b':
+                    buffer_.append("\\b");
+                    break;
+                case '\f':
+                    buffer_.append("\\f");
+                    break;
+                case '\v':
+                    buffer_.append("\\v");
+                    break;
+                default:
+                    buffer_.push_back(ch);
+            }
+        }
+        return *this;
+    }
+    CopyTextWriter &operator<<(const std::string &value)
+    {
+        return *this << string_view{value.data(), value.length()};
+    }
+    CopyTextWriter &operator<<(const char *value)
+    {
+        return *this << string_view{value};
+    }
+    CopyTextWriter &operator<<(std::nullptr_t)
+    {
+        separate();
+        buffer_.append("\\N");
+        return *this;
+    }
+    CopyTextWriter &operator<<(bool value)
+    {
+        separate();
+        buffer_.push_back(value ? 't' : 'f');
+        return *this;
+    }
+    CopyTextWriter &operator<<(char value)
+    {
+        return *this << string_view{&value, 1};
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value,
+                            CopyTextWriter &>::type
+    operator<<(T value)
+    {
+        separate();
+        buffer_.append(std::to_string(value));
+        return *this;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value,
+                            CopyTextWriter &>::type
+    operator<<(T value)
+    {
+        separate();
+        if (std::isnan(value))
+        {
+            buffer_.append("NaN");
+            return *this;
+        }
+        if (std::isinf(value))
+        {
+            buffer_.append(value > 0 ? "Infinity" : "-Infinity");
+            return *this;
+        }
+        // The shortest form that reads back as the same value
+        char text[32];
+        auto number = static_cast<long double>(value);
+        for (int precision = std::numeric_limits<T>::digits10;
+             precision <= std::numeric_limits<T>::max_digits10;
+             ++precision)
+        {
+            std::snprintf(text, sizeof(text), "%.*Lg", precision, number);
+            if (readBack(text, value) == value)
+                break;
+        }
+        buffer_.append(text);
+        return *this;
+    }
+    CopyTextWriter &operator<<(const trantor::Date &date)
+    {
+        separate();
+        buffer_.append(date.toDbStringLocal());
+        return *this;
+    }
+
+    /// End the current row, the next field starts a new one
+    void endRow()
+    {
+        buffer_.push_back('\n');
+        newRow_ = true;
+    }
+
+  private:
+    static float readBack(const char *text, float)
+    {
+        return std::strtof(text, nullptr);
+    }
+    static double readBack(const char *text, double)
+    {
+        return std::strtod(text, nullptr);
+    }
+    static long double readBack(const char *text, long double)
+    {
+        return std::strtold(text, nullptr);
+    }
+    void separate()
+    {
+        if (!newRow_)
+            buffer_.push_back('\t');
+        newRow_ = false;
+    }
+
+    std::string &buffer_;
+    bool newRow_{true};
+};
+
+}  // namespace orm
+}  // namespace drogon
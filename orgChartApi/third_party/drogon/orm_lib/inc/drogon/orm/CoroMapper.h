@@ -88,13 +88,9 @@ class CoroMapper : public Mapper<T>
                     "make sure that the model class is generated by the latest "
                     "version of drogon_ctl");
                 // return findFutureOne(Criteria(T::primaryKeyName, key));
-                std::string sql = T::sqlForFindingByPrimaryKey();
-                if (this->forUpdate_)
-                {
-                    sql += " for update";
-                }
+                auto sql = this->findByPrimaryKeySql(this->forUpdate_);
                 this->clear();
-                auto binder = *(this->client_) << std::move(sql);
+                auto binder = *(this->client_) << sql;
                 this->outputPrimeryKeyToBinder(key, binder);
 
                 binder >> [callback = std::move(callback),
@@ -409,20 +405,7 @@ class CoroMapper : public Mapper<T>
             static_assert(
                 !std::is_same<typename T::PrimaryKeyType, void>::value,
                 "No primary key in the table!");
-            std::string sql = "update ";
-            sql += T::tableName;
-            sql += " set ";
-            for (auto const &colName : obj.updateColumns())
-            {
-                sql += colName;
-                sql += " = $?,";
-            }
-            sql[sql.length() - 1] = ' ';  // Replace the last ','
-
-            this->makePrimaryKeyCriteria(sql);
-
-            sql = this->replaceSqlPlaceHolder(sql, "$?");
-            auto binder = *(this->client_) << std::move(sql);
+            auto binder = this->updateBinder(obj.updateColumns());
             obj.updateArgs(binder);
             this->outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
             binder >> [callback = std::move(callback)](const Result &r) {
@@ -522,14 +505,7 @@ class CoroMapper : public Mapper<T>
             static_assert(
                 !std::is_same<typename T::PrimaryKeyType, void>::value,
                 "No primary key in the table!");
-            std::string sql = "delete from ";
-            sql += T::tableName;
-            sql += " ";
-
-            this->makePrimaryKeyCriteria(sql);
-
-            sql = this->replaceSqlPlaceHolder(sql, "$?");
-            auto binder = *(this->client_) << std::move(sql);
+            auto binder = *(this->client_) << this->deleteOneSql();
             this->outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
             binder >> [callback = std::move(callback)](const Result &r) {
                 callback(r.affectedRows());
@@ -581,7 +557,8 @@ class CoroMapper : public Mapper<T>
         auto lb = [this, key](CountCallback &&callback,
                               ExceptPtrCallback &&errCallback) {
             this->clear();
-            auto binder = *(this->client_) << T::sqlForDeletingByPrimaryKey();
+            auto binder = *(this->client_)
+                          << string_view{T::sqlForDeletingByPrimaryKey()};
             this->outputPrimeryKeyToBinder(key, binder);
             binder >> [callback = std::move(callback)](const Result &r) {
                 callback(r.affectedRows());
@@ -22,10 +22,13 @@
 #include <drogon/orm/Row.h>
 #include <drogon/orm/RowIterator.h>
 #include <drogon/orm/SqlBinder.h>
+#include <array>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <future>
 #include <string>
+#include <vector>
 #include <trantor/utils/Logger.h>
 #include <trantor/utils/NonCopyable.h>
 
@@ -39,10 +42,68 @@ namespace orm
 {
 using ResultCallback = std::function<void(const Result &)>;
 using ExceptionCallback = std::function<void(const DrogonDbException &)>;
+/// Receives a chunk of streamed rows and the function that continues the
+/// stream: true fetches the next chunk, false ends the stream.
+using RowChunkCallback =
+    std::function<void(const Result &, std::function<void(bool)> &&)>;
+/// Appends the next rows of a COPY FROM STDIN to the buffer, returns false
+/// after the last ones.
+using CopyInCallback = std::function<bool(std::string &)>;
+/// Receives every row of a COPY TO STDOUT.
+using CopyOutCallback = std::function<void(const char *, size_t)>;
 
 class Transaction;
 class DbClient;
 
+/// Connection pool and queue metrics of a database client
+struct DbClientStats
+{
+    /// Open connections, including the ones still connecting
+    size_t connections{0};
+    size_t minConnections{0};
+    size_t maxConnections{0};
+    /// Connections running a query or holding a transaction
+    size_t busyConnections{0};
+    /// Queries and transactions waiting for a connection
+    size_t queueDepth{0};
+    /// Queries failed with "Too many queries in buffer"
+    uint64_t rejected{0};
+    /**
+     * Number of queries and transactions by the time they waited for a
+     * connection: [0] none, [1] up to 100us, [2] up to 1ms, [3] up to 10ms,
+     * [4] up to 100ms, [5] up to 1s, [6] longer.
+     */
+    std::array<uint64_t, 7> waitTimeHistogram{};
+    /// Statements prepared on the PostgreSQL connections of the client
+    size_t preparedStatements{0};
+    /// Lookups of the prepared statement caches of the connections
+    uint64_t preparedStatementHits{0};
+    uint64_t preparedStatementMisses{0};
+    /// Prepared statements deallocated to keep the caches bounded
+    uint64_t preparedStatementEvictions{0};
+};
+
+/// Calls, rows and times of the statements of one normalized SQL text
+struct StatementStat
+{
+    /// The statement with its literals replaced with '?'
+    std::string sql;
+    uint64_t calls{0};
+    /// Calls that ended with an exception, timeouts included
+    uint64_t errors{0};
+    /// Rows returned, or affected by the statements that return none
+    uint64_t rows{0};
+    /// Total time the calls waited for a connection
+    uint64_t queueMicroseconds{0};
+    /// Total time from the connection to the result
+    uint64_t execMicroseconds{0};
+    /**
+     * Number of calls by their execution time: [0] up to 100us, [1] up to
+     * 1ms, [2] up to 10ms, [3] up to 100ms, [4] up to 1s, [5] longer.
+     */
+    std::array<uint64_t, 6> execTimeHistogram{};
+};
+
 namespace internal
 {
 #ifdef __cpp_impl_coroutine
@@ -112,19 +173,81 @@ class DROGON_EXPORT DbClient : public trantor::NonCopyable
      * - client_encoding: The character set to be used on database connections.
      *
      * For other key words on PostgreSQL, see the PostgreSQL documentation.
-     * Only a pair of key values is valid for Sqlite3, and its keyword is
-     * 'filename'.
+     * The keywords for Sqlite3 are 'filename', which may also be a URI such
+     * as "file:name?mode=memory&cache=shared" for an in-memory database
+     * shared by all connections, and 'journal_mode', the journal mode the
+     * connections set on the database (with 'wal' they also use
+     * synchronous=NORMAL).
      *
      * @param connNum: The number of connections to database server;
+     * @param binaryResults: Fetch the results of prepared statements whose
+     * columns are all integers, bool, character types, date or timestamp in
+     * binary format. Field::getValue() still returns the text of such values.
      */
-    static std::shared_ptr<DbClient> newPgClient(const std::string &connInfo,
-                                                 const size_t connNum);
+    static std::shared_ptr<DbClient> newPgClient(
+        const std::string &connInfo,
+        const size_t connNum,
+        const bool binaryResults = false);
     static std::shared_ptr<DbClient> newMysqlClient(const std::string &connInfo,
                                                     const size_t connNum);
     static std::shared_ptr<DbClient> newSqlite3Client(
         const std::string &connInfo,
         const size_t connNum);
 
+    /// Create a client that coalesces identical concurrent reads;
+    /**
+     * @param client: The client that actually executes the SQL.
+     *
+     * While a SELECT statement is in flight, further calls with the same SQL
+     * text and the same bound parameters don't reach the database, they
+     * receive the result (or exception) of the running query instead. All
+     * other statements and transactions are passed through unchanged.
+     *
+     * @note Coalesced callers may observe a result that was computed slightly
+     * before they issued the query, so don't route reads through this client
+     * that must see their own preceding writes.
+     */
+    static std::shared_ptr<DbClient> newSingleFlightClient(
+        const std::shared_ptr<DbClient> &client);
+
+    /**
+     * @param client: The client that actually executes the SQL.
+     * @param deadline: The time by which every statement executed through the
+     * returned client has to finish, usually derived from the deadline of a
+     * request.
+     *
+     * Statements still waiting for a connection at the deadline fail with a
+     * TimeoutError. PostgreSQL connections also run each statement with a
+     * statement_timeout of the time left and cancel it on the server if it
+     * is still running at the deadline, so that its connection is freed.
+     * Transactions are passed through without a deadline.
+     */
+    static std::shared_ptr<DbClient> newDeadlineClient(
+        const std::shared_ptr<DbClient> &client,
+        std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @param client: The client that actually executes the SQL.
+     * @param window: The number of seconds an INSERT, UPDATE or DELETE
+     * waits for others to be committed with.
+     * @param maxStatements: The number of such statements that are committed
+     * together right away, without waiting for the window to end.
+     *
+     * The statements of a group run one after another in one transaction on
+     * one connection, each inside a savepoint, so a failing statement is
+     * rolled back alone and only its own exception callback is called. The
+     * result callbacks of the others are called once the transaction is
+     * committed, or their exception callbacks if the commit fails. Every
+     * other statement is passed through, as are transactions.
+     *
+     * @note Grouped statements must not depend on each other's failure, they
+     * see the writes of the statements committed before them in the group.
+     */
+    static std::shared_ptr<DbClient> newGroupCommitClient(
+        const std::shared_ptr<DbClient> &client,
+        double window = 0.002,
+        size_t maxStatements = 64);
+
     /// Async and nonblocking method
     /**
      * @param sql is the SQL statement to be executed;
@@ -212,6 +335,84 @@ class DROGON_EXPORT DbClient : public trantor::NonCopyable
     }
 #endif
 
+    /// Async method that delivers the rows of a query in chunks
+    /**
+     * @param sql is a SELECT statement, args are bound to its placeholders
+     * and copied until the statement is sent;
+     * @param chunkRows is the maximum number of rows in a chunk;
+     * @param chunkCallback is called with every chunk and the function that
+     * continues the stream, which must be called once. No more rows are
+     * fetched until then, so a slow consumer holds the query back instead of
+     * piling up its rows;
+     * @param finishCallback is called after the last chunk was consumed, or
+     * when the stream was ended early;
+     *
+     * On PostgreSQL the rows are fetched from a cursor, chunkRows at a time,
+     * in a transaction of their own (or in this one if the client is a
+     * transaction), so the memory used doesn't grow with the result. Other
+     * databases deliver the whole result as one chunk.
+     *
+     * @note The transaction and its connection are held until the stream
+     * ends. Dropping the continuation without calling it ends the stream
+     * as well, without calling finishCallback. A transaction runs one stream
+     * at a time.
+     */
+    template <typename... Arguments>
+    void execSqlStreaming(const std::string &sql,
+                          size_t chunkRows,
+                          RowChunkCallback &&chunkCallback,
+                          std::function<void()> &&finishCallback,
+                          ExceptionCallback &&exceptCallback,
+                          Arguments &&...args) noexcept
+    {
+        streamSql(sql,
+                  chunkRows,
+                  [args...](internal::SqlBinder &binder) {
+                      (void)binder;
+                      (void)std::initializer_list<int>{
+                          (binder << args, 0)...};
+                  },
+                  std::move(chunkCallback),
+                  std::move(finishCallback),
+                  std::move(exceptCallback));
+    }
+
+    /// Async method that loads rows with a COPY ... FROM STDIN statement
+    /**
+     * @param sql is the COPY statement, e.g.
+     * "copy person (first_name, last_name) from stdin";
+     * @param producer is called on the IO thread of the connection whenever
+     * it can take more data. It appends rows in the format of the statement
+     * (see CopyTextWriter for the text format) and returns false after the
+     * last ones. Throwing from it aborts the COPY with the message of the
+     * exception;
+     * @param rCallback receives the result of the statement, whose
+     * affectedRows() is the number of rows loaded;
+     *
+     * The data is sent as it is produced, only what the socket can't take yet
+     * is buffered. The COPY runs in a transaction of its own, or in this one
+     * if the client is a transaction, and only on PostgreSQL. Timeouts don't
+     * apply to it.
+     */
+    void copyIn(const std::string &sql,
+                CopyInCallback &&producer,
+                ResultCallback &&rCallback,
+                ExceptionCallback &&exceptCallback);
+
+    /// Async method that reads rows with a COPY ... TO STDOUT statement
+    /**
+     * @param consumer is called on the IO thread of the connection with every
+     * row, in the format of the statement, as soon as it arrives;
+     * @param rCallback receives the result of the statement after the last
+     * row, whose affectedRows() is the number of rows.
+     *
+     * As with copyIn(), it runs in a transaction and only on PostgreSQL.
+     */
+    void copyOut(const std::string &sql,
+                 CopyOutCallback &&consumer,
+                 ResultCallback &&rCallback,
+                 ExceptionCallback &&exceptCallback);
+
     /// Streaming-like method for sql execution. For more information, see the
     /// wiki page.
     internal::SqlBinder operator<<(const std::string &sql);
@@ -267,6 +468,27 @@ class DROGON_EXPORT DbClient : public trantor::NonCopyable
      */
     virtual bool hasAvailableConnections() const noexcept = 0;
 
+    /**
+     * @brief Get the pool and queue metrics of the client.
+     *
+     * @note Clients that don't keep these metrics return all zeros.
+     */
+    virtual DbClientStats stats() const
+    {
+        return DbClientStats{};
+    }
+
+    /**
+     * @brief Get the statements executed by the client so far, by their
+     * normalized text. Statements run in transactions are not counted.
+     *
+     * @note Clients that don't keep these metrics return none.
+     */
+    virtual std::vector<StatementStat> statementStats() const
+    {
+        return {};
+    }
+
     ClientType type() const
     {
         return type_;
@@ -290,6 +512,22 @@ class DROGON_EXPORT DbClient : public trantor::NonCopyable
 
   private:
     friend internal::SqlBinder;
+    friend class SingleFlightDbClient;
+    friend class ReplicaDbClient;
+    friend class DeadlineDbClient;
+    friend class GroupCommitDbClient;
+    virtual void execCopy(
+        std::string &&sql,
+        CopyInCallback &&producer,
+        CopyOutCallback &&consumer,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback);
+    void streamSql(const std::string &sql,
+                   size_t chunkRows,
+                   std::function<void(internal::SqlBinder &)> &&bind,
+                   RowChunkCallback &&chunkCallback,
+                   std::function<void()> &&finishCallback,
+                   ExceptionCallback &&exceptCallback);
     virtual void execSql(
         const char *sql,
         size_t sqlLength,
@@ -299,8 +537,37 @@ class DROGON_EXPORT DbClient : public trantor::NonCopyable
         std::vector<int> &&format,
         ResultCallback &&rcb,
         std::function<void(const std::exception_ptr &)> &&exceptCallback) = 0;
+    /**
+     * Execute a statement that has to finish by the deadline. Clients that
+     * can't enforce it run the statement like any other, unless the
+     * deadline has passed already.
+     */
+    virtual void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline);
 
   protected:
+    /// Execute the statement on another client, with the deadline unless it
+    /// is time_point::max()
+    static void forwardSql(
+        DbClient &client,
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline);
+
     ClientType type_;
     std::string connectionInfo_;
 };
@@ -313,6 +580,19 @@ class Transaction : public DbClient
     // virtual void commit() = 0;
     virtual void setCommitCallback(
         const std::function<void(bool)> &commitCallback) = 0;
+
+  private:
+    friend class DbClient;
+    void execCopy(std::string &&,
+                  CopyInCallback &&,
+                  CopyOutCallback &&,
+                  ResultCallback &&,
+                  std::function<void(const std::exception_ptr &)>
+                      &&exceptCallback) override
+    {
+        exceptCallback(std::make_exception_ptr(
+            Failure("COPY is not supported by this transaction")));
+    }
 };
 
 #ifdef __cpp_impl_coroutine
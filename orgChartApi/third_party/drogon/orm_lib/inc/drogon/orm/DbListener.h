@@ -0,0 +1,75 @@
+/**
+ *
+ *  @file DbListener.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/exports.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace trantor
+{
+class EventLoop;
+}
+
+namespace drogon
+{
+namespace orm
+{
+class DbListener;
+using DbListenerPtr = std::shared_ptr<DbListener>;
+
+/**
+ * @brief Receives the notifications of database channels, PostgreSQL
+ * LISTEN/NOTIFY, on a connection of its own.
+ *
+ * Callbacks run on the event loop of the listener. A broken connection is
+ * opened again every second and listens to the same channels; notifications
+ * sent in between are lost, which the reconnect callback is told of.
+ */
+class DROGON_EXPORT DbListener
+{
+  public:
+    /// Receives the payload of a notification
+    using MessageCallback = std::function<void(const std::string &)>;
+
+    virtual ~DbListener() = default;
+
+    /**
+     * @brief Create a listener of a PostgreSQL database.
+     *
+     * @param connInfo The connection string, as for DbClient::newPgClient().
+     * @param loop The event loop to run the connection and the callbacks in.
+     * Without one the listener starts a thread of its own.
+     */
+    static DbListenerPtr newPgListener(const std::string &connInfo,
+                                       trantor::EventLoop *loop = nullptr);
+
+    /**
+     * @brief Call messageCallback with every notification of the channel.
+     * A channel may have several callbacks.
+     */
+    virtual void listen(const std::string &channel,
+                        MessageCallback messageCallback) noexcept = 0;
+
+    /// Stop listening to the channel and drop its callbacks
+    virtual void unlisten(const std::string &channel) noexcept = 0;
+
+    /**
+     * @brief Called after the connection was opened again, when
+     * notifications may have been missed, e.g. to clear a cache.
+     */
+    virtual void setReconnectCallback(std::function<void()> callback) = 0;
+};
+
+}  // namespace orm
+}  // namespace drogon
@@ -22,6 +22,7 @@
 #include <drogon/orm/ArrayParser.h>
 #include <drogon/orm/Result.h>
 #include <drogon/orm/Row.h>
+#include <trantor/utils/Date.h>
 #include <trantor/utils/Logger.h>
 #include <memory>
 #include <sstream>
@@ -158,6 +159,9 @@ class DROGON_EXPORT Field
 
   private:
     const Result result_;
+    /// The value of a bool or integer field the database sent in binary
+    /// format, false for fields in text format
+    bool binaryInteger(int64_t &value) const;
 };
 template <>
 DROGON_EXPORT std::string Field::as<std::string>() const;
@@ -167,6 +171,13 @@ template <>
 DROGON_EXPORT char *Field::as<char *>() const;
 template <>
 DROGON_EXPORT std::vector<char> Field::as<std::vector<char>>() const;
+/**
+ * Dates and timestamps are taken as local time, in text
+ * "YYYY-MM-DD[ HH:MM:SS[.ffffff]]". A null or unparsable field gives the
+ * default Date.
+ */
+template <>
+DROGON_EXPORT trantor::Date Field::as<trantor::Date>() const;
 template <>
 inline drogon::string_view Field::as<drogon::string_view>() const
 {
@@ -194,6 +205,9 @@ inline double Field::as<double>() const
 template <>
 inline bool Field::as<bool>() const
 {
+    int64_t integer;
+    if (!isNull() && binaryInteger(integer))
+        return integer != 0;
     if (result_.getLength(row_, column_) != 1)
     {
         return false;
@@ -209,6 +223,9 @@ inline int Field::as<int>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<int>(value);
     return std::stoi(result_.getValue(row_, column_));
 }
 
@@ -217,6 +234,9 @@ inline long Field::as<long>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<long>(value);
     return std::stol(result_.getValue(row_, column_));
 }
 
@@ -225,6 +245,9 @@ inline int8_t Field::as<int8_t>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<int8_t>(value);
     return static_cast<int8_t>(atoi(result_.getValue(row_, column_)));
 }
 
@@ -233,6 +256,9 @@ inline long long Field::as<long long>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<long long>(value);
     return atoll(result_.getValue(row_, column_));
 }
 
@@ -241,6 +267,9 @@ inline unsigned int Field::as<unsigned int>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<unsigned int>(value);
     return static_cast<unsigned int>(
         std::stoi(result_.getValue(row_, column_)));
 }
@@ -250,6 +279,9 @@ inline unsigned long Field::as<unsigned long>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<unsigned long>(value);
     return std::stoul(result_.getValue(row_, column_));
 }
 
@@ -258,6 +290,9 @@ inline uint8_t Field::as<uint8_t>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<uint8_t>(value);
     return static_cast<uint8_t>(atoi(result_.getValue(row_, column_)));
 }
 
@@ -266,6 +301,9 @@ inline unsigned long long Field::as<unsigned long long>() const
 {
     if (isNull())
         return 0;
+    int64_t value;
+    if (binaryInteger(value))
+        return static_cast<unsigned long long>(value);
     return std::stoull(result_.getValue(row_, column_));
 }
 
@@ -16,8 +16,10 @@
 #include <drogon/orm/Criteria.h>
 #include <drogon/orm/DbClient.h>
 #include <drogon/utils/Utilities.h>
+#include <mutex>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #ifdef _WIN32
@@ -205,15 +207,11 @@ class Mapper
             "make sure that the model class is generated by the latest "
             "version of drogon_ctl");
         // return findOne(Criteria(T::primaryKeyName, key));
-        std::string sql = T::sqlForFindingByPrimaryKey();
-        if (forUpdate_)
-        {
-            sql += " for update";
-        }
+        auto sql = findByPrimaryKeySql(forUpdate_);
         clear();
         Result r(nullptr);
         {
-            auto binder = *client_ << std::move(sql);
+            auto binder = *client_ << sql;
             outputPrimeryKeyToBinder(key, binder);
             binder << Mode::Blocking;
             binder >> [&r](const Result &result) { r = result; };
@@ -264,13 +262,9 @@ class Mapper
             "make sure that the model class is generated by the latest "
             "version of drogon_ctl");
         // findOne(Criteria(T::primaryKeyName, key), rcb, ecb);
-        std::string sql = T::sqlForFindingByPrimaryKey();
-        if (forUpdate_)
-        {
-            sql += " for update";
-        }
+        auto sql = findByPrimaryKeySql(forUpdate_);
         clear();
-        auto binder = *client_ << std::move(sql);
+        auto binder = *client_ << sql;
         outputPrimeryKeyToBinder(key, binder);
         binder >> [ecb, rcb](const Result &r) {
             if (r.size() == 0)
@@ -323,13 +317,9 @@ class Mapper
             "make sure that the model class is generated by the latest "
             "version of drogon_ctl");
         // return findFutureOne(Criteria(T::primaryKeyName, key));
-        std::string sql = T::sqlForFindingByPrimaryKey();
-        if (forUpdate_)
-        {
-            sql += " for update";
-        }
+        auto sql = findByPrimaryKeySql(forUpdate_);
         clear();
-        auto binder = *client_ << std::move(sql);
+        auto binder = *client_ << sql;
         outputPrimeryKeyToBinder(key, binder);
 
         std::shared_ptr<std::promise<T>> prom =
@@ -693,9 +683,88 @@ class Mapper
         orderByString_.clear();
         forUpdate_ = false;
     }
+
+    // The statements by the primary key only depend on T and on the
+    // placeholders of the client, so each is built once and handed to the
+    // client as a view instead of being built and copied on every call.
+    string_view findByPrimaryKeySql(bool forUpdate) const
+    {
+        static const std::string forUpdateSql =
+            T::sqlForFindingByPrimaryKey() + " for update";
+        return forUpdate ? forUpdateSql : T::sqlForFindingByPrimaryKey();
+    }
+    string_view deleteOneSql() const
+    {
+        static const std::string sqls[] = {
+            makeDeleteOneSql(ClientType::PostgreSQL),
+            makeDeleteOneSql(ClientType::Sqlite3)};
+        return sqls[client_->type() == ClientType::PostgreSQL ? 0 : 1];
+    }
+    static std::string makeDeleteOneSql(ClientType type)
+    {
+        std::string sql = "delete from ";
+        sql += T::tableName;
+        sql += " ";
+        makePrimaryKeyCriteria(sql);
+        return replaceSqlPlaceHolder(sql, "$?", type);
+    }
+    /**
+     * The statement updating the columns by the primary key is cached for
+     * every set of columns, which come in the order of the model.
+     */
+    internal::SqlBinder updateBinder(const std::vector<std::string> &columns)
+    {
+        auto type = client_->type();
+        uint64_t mask = 0;
+        size_t next = 0;
+        if (T::getColumnNumber() <= 64)
+        {
+            for (size_t i = 0;
+                 i < T::getColumnNumber() && next < columns.size();
+                 ++i)
+            {
+                if (columns[next] == T::getColumnName(i))
+                {
+                    mask |= uint64_t(1) << i;
+                    ++next;
+                }
+            }
+        }
+        if (next < columns.size())
+            return *client_ << makeUpdateSql(columns, type);
+        static std::mutex mutex;
+        static std::unordered_map<uint64_t, std::string> sqls[2];
+        const std::string *sql;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto &cache = sqls[type == ClientType::PostgreSQL ? 0 : 1];
+            auto iter = cache.find(mask);
+            if (iter == cache.end())
+                iter = cache.emplace(mask, makeUpdateSql(columns, type)).first;
+            sql = &iter->second;
+        }
+        return *client_ << string_view{*sql};
+    }
+    static std::string makeUpdateSql(const std::vector<std::string> &columns,
+                                     ClientType type)
+    {
+        std::string sql = "update ";
+        sql += T::tableName;
+        sql += " set ";
+        for (auto const &colName : columns)
+        {
+            sql += colName;
+            sql += " = $?,";
+        }
+        sql[sql.length() - 1] = ' ';  // Replace the last ','
+        makePrimaryKeyCriteria(sql);
+        return replaceSqlPlaceHolder(sql, "$?", type);
+    }
+
     template <typename PKType = decltype(T::primaryKeyName)>
-    typename std::enable_if<std::is_same<const std::string, PKType>::value,
-                            void>::type
+    static typename std::enable_if<
+        std::is_same<const std::string, PKType>::value,
+        void>::type
     makePrimaryKeyCriteria(std::string &sql)
     {
         sql += " where ";
@@ -703,7 +772,7 @@ class Mapper
         sql += " = $?";
     }
     template <typename PKType = decltype(T::primaryKeyName)>
-    typename std::enable_if<
+    static typename std::enable_if<
         std::is_same<const std::vector<std::string>, PKType>::value,
         void>::type
     makePrimaryKeyCriteria(std::string &sql)
@@ -754,7 +823,13 @@ class Mapper
     }
 
     std::string replaceSqlPlaceHolder(const std::string &sqlStr,
-                                      const std::string &holderStr) const;
+                                      const std::string &holderStr) const
+    {
+        return replaceSqlPlaceHolder(sqlStr, holderStr, client_->type());
+    }
+    static std::string replaceSqlPlaceHolder(const std::string &sqlStr,
+                                             const std::string &holderStr,
+                                             ClientType type);
 };
 
 template <typename T>
@@ -1300,22 +1375,9 @@ inline size_t Mapper<T>::update(const T &obj) noexcept(false)
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "update ";
-    sql += T::tableName;
-    sql += " set ";
-    for (auto const &colName : obj.updateColumns())
-    {
-        sql += colName;
-        sql += " = $?,";
-    }
-    sql[sql.length() - 1] = ' ';  // Replace the last ','
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
     Result r(nullptr);
     {
-        auto binder = *client_ << std::move(sql);
+        auto binder = updateBinder(obj.updateColumns());
         obj.updateArgs(binder);
         outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
         binder << Mode::Blocking;
@@ -1372,20 +1434,7 @@ inline void Mapper<T>::update(const T &obj,
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "update ";
-    sql += T::tableName;
-    sql += " set ";
-    for (auto const &colName : obj.updateColumns())
-    {
-        sql += colName;
-        sql += " = $?,";
-    }
-    sql[sql.length() - 1] = ' ';  // Replace the last ','
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
-    auto binder = *client_ << std::move(sql);
+    auto binder = updateBinder(obj.updateColumns());
     obj.updateArgs(binder);
     outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
     binder >> [rcb](const Result &r) { rcb(r.affectedRows()); };
@@ -1434,20 +1483,7 @@ inline std::future<size_t> Mapper<T>::updateFuture(const T &obj) noexcept
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "update ";
-    sql += T::tableName;
-    sql += " set ";
-    for (auto const &colName : obj.updateColumns())
-    {
-        sql += colName;
-        sql += " = $?,";
-    }
-    sql[sql.length() - 1] = ' ';  // Replace the last ','
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
-    auto binder = *client_ << std::move(sql);
+    auto binder = updateBinder(obj.updateColumns());
     obj.updateArgs(binder);
     outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
 
@@ -1505,17 +1541,9 @@ inline size_t Mapper<T>::deleteOne(const T &obj) noexcept(false)
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "delete from ";
-    sql += T::tableName;
-
-    sql += " ";  // Replace the last ','
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
     Result r(nullptr);
     {
-        auto binder = *client_ << std::move(sql);
+        auto binder = *client_ << deleteOneSql();
         outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
         binder << Mode::Blocking;
         binder >> [&r](const Result &result) { r = result; };
@@ -1531,14 +1559,7 @@ inline void Mapper<T>::deleteOne(const T &obj,
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "delete from ";
-    sql += T::tableName;
-    sql += " ";
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
-    auto binder = *client_ << std::move(sql);
+    auto binder = *client_ << deleteOneSql();
     outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
     binder >> [rcb](const Result &r) { rcb(r.affectedRows()); };
     binder >> ecb;
@@ -1549,14 +1570,7 @@ inline std::future<size_t> Mapper<T>::deleteFutureOne(const T &obj) noexcept
     clear();
     static_assert(!std::is_same<typename T::PrimaryKeyType, void>::value,
                   "No primary key in the table!");
-    std::string sql = "delete from ";
-    sql += T::tableName;
-    sql += " ";
-
-    makePrimaryKeyCriteria(sql);
-
-    sql = replaceSqlPlaceHolder(sql, "$?");
-    auto binder = *client_ << std::move(sql);
+    auto binder = *client_ << deleteOneSql();
     outputPrimeryKeyToBinder(obj.getPrimaryKey(), binder);
 
     std::shared_ptr<std::promise<size_t>> prom =
@@ -1710,9 +1724,10 @@ inline Mapper<T> &Mapper<T>::forUpdate()
 template <typename T>
 inline std::string Mapper<T>::replaceSqlPlaceHolder(
     const std::string &sqlStr,
-    const std::string &holderStr) const
+    const std::string &holderStr,
+    ClientType type)
 {
-    if (client_->type() == ClientType::PostgreSQL)
+    if (type == ClientType::PostgreSQL)
     {
         std::string::size_type startPos = 0;
         std::string::size_type pos;
@@ -1732,8 +1747,7 @@ inline std::string Mapper<T>::replaceSqlPlaceHolder(
             startPos = pos + holderStr.length();
         } while (1);
     }
-    else if (client_->type() == ClientType::Mysql ||
-             client_->type() == ClientType::Sqlite3)
+    else if (type == ClientType::Mysql || type == ClientType::Sqlite3)
     {
         std::string::size_type startPos = 0;
         std::string::size_type pos;
@@ -1770,7 +1784,8 @@ inline size_t Mapper<T>::deleteByPrimaryKey(
     clear();
     Result r(nullptr);
     {
-        auto binder = *client_ << T::sqlForDeletingByPrimaryKey();
+        auto binder =
+            *client_ << string_view{T::sqlForDeletingByPrimaryKey()};
         outputPrimeryKeyToBinder(key, binder);
         binder << Mode::Blocking;
         binder >> [&r](const Result &result) { r = result; };
@@ -1792,7 +1807,7 @@ inline void Mapper<T>::deleteByPrimaryKey(
                   "make sure that the model class is generated by the latest "
                   "version of drogon_ctl");
     clear();
-    auto binder = *client_ << T::sqlForDeletingByPrimaryKey();
+    auto binder = *client_ << string_view{T::sqlForDeletingByPrimaryKey()};
     outputPrimeryKeyToBinder(key, binder);
     binder >>
         [rcb = std::move(rcb)](const Result &r) { rcb(r.affectedRows()); };
@@ -1810,7 +1825,7 @@ inline std::future<size_t> Mapper<T>::deleteFutureByPrimaryKey(
                   "make sure that the model class is generated by the latest "
                   "version of drogon_ctl");
     clear();
-    auto binder = *client_ << T::sqlForDeletingByPrimaryKey();
+    auto binder = *client_ << string_view{T::sqlForDeletingByPrimaryKey()};
     outputPrimeryKeyToBinder(key, binder);
 
     std::shared_ptr<std::promise<T>> prom = std::make_shared<std::promise<T>>();
@@ -147,6 +147,8 @@ class DROGON_EXPORT Result
     const char *getValue(SizeType row, RowSizeType column) const;
     bool isNull(SizeType row, RowSizeType column) const;
     FieldSizeType getLength(SizeType row, RowSizeType column) const;
+    /// The binary value of a field, nullptr if it was sent as text
+    const char *getBinaryValue(SizeType row, RowSizeType column) const;
 };
 inline void swap(Result &one, Result &two) noexcept
 {
@@ -30,6 +30,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <new>
 #include <sstream>
 #include <string.h>
 #include <string>
@@ -265,6 +266,22 @@ class CallbackHolder : public CallbackHolderBase
         return field.as<ValueType>();
     }
 };
+/**
+ * The bound parameters of a query, kept alive until the query is done. The
+ * first kInlineParameters numbers, dates and short strings are copied into
+ * inline slots, so that binding them doesn't allocate. Longer strings,
+ * blobs and the parameters beyond those are held as separate objects.
+ */
+struct ParameterStorage
+{
+    static constexpr size_t kInlineParameters = 8;
+    // Fits any number and the text of a date
+    static constexpr size_t kSlotSize = 32;
+    alignas(8) char slots_[kInlineParameters][kSlotSize];
+    size_t usedSlots_{0};
+    std::vector<std::shared_ptr<void>> objs_;
+};
+
 class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
 {
     using self = SqlBinder;
@@ -307,7 +324,7 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
           parameters_(std::move(that.parameters_)),
           lengths_(std::move(that.lengths_)),
           formats_(std::move(that.formats_)),
-          objs_(std::move(that.objs_)),
+          storage_(std::move(that.storage_)),
           mode_(that.mode_),
           callbackHolder_(std::move(that.callbackHolder_)),
           exceptionCallback_(std::move(that.exceptionCallback_)),
@@ -367,38 +384,37 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
         self &>::type
     operator<<(T &&parameter)
     {
-        ++parametersNumber_;
         using ParaType = typename std::remove_cv<
             typename std::remove_reference<T>::type>::type;
-        std::shared_ptr<void> obj = std::make_shared<ParaType>(parameter);
+        auto value = storeValue<ParaType>(parameter);
         if (type_ == ClientType::PostgreSQL)
         {
+            // Numbers are sent in binary format, in network byte order
 #if __cplusplus >= 201703L || (defined _MSC_VER && _MSC_VER > 1900)
             const size_t size = sizeof(T);
             if constexpr (size == 2)
             {
-                *std::static_pointer_cast<uint16_t>(obj) = htons(parameter);
+                *reinterpret_cast<uint16_t *>(value) = htons(parameter);
             }
             else if constexpr (size == 4)
             {
-                *std::static_pointer_cast<uint32_t>(obj) = htonl(parameter);
+                *reinterpret_cast<uint32_t *>(value) = htonl(parameter);
             }
             else if constexpr (size == 8)
             {
-                *std::static_pointer_cast<uint64_t>(obj) = htonll(parameter);
+                *reinterpret_cast<uint64_t *>(value) = htonll(parameter);
             }
 #else
             switch (sizeof(T))
             {
                 case 2:
-                    *std::static_pointer_cast<uint16_t>(obj) = htons(parameter);
+                    *reinterpret_cast<uint16_t *>(value) = htons(parameter);
                     break;
                 case 4:
-                    *std::static_pointer_cast<uint32_t>(obj) = htonl(parameter);
+                    *reinterpret_cast<uint32_t *>(value) = htonl(parameter);
                     break;
                 case 8:
-                    *std::static_pointer_cast<uint64_t>(obj) =
-                        htonll(parameter);
+                    *reinterpret_cast<uint64_t *>(value) = htonll(parameter);
                     break;
                 case 1:
                 default:
@@ -406,37 +422,28 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
                     break;
             }
 #endif
-            objs_.push_back(obj);
-            parameters_.push_back((char *)obj.get());
-            lengths_.push_back(sizeof(T));
-            formats_.push_back(1);
+            addParameter((char *)value, sizeof(T), 1);
         }
         else if (type_ == ClientType::Mysql)
         {
-            objs_.push_back(obj);
-            parameters_.push_back((char *)obj.get());
-            lengths_.push_back(0);
-            formats_.push_back(getMysqlTypeBySize(sizeof(T)));
+            addParameter((char *)value, 0, getMysqlTypeBySize(sizeof(T)));
         }
         else if (type_ == ClientType::Sqlite3)
         {
-            objs_.push_back(obj);
-            parameters_.push_back((char *)obj.get());
-            lengths_.push_back(0);
             switch (sizeof(T))
             {
                 case 1:
-                    formats_.push_back(Sqlite3TypeChar);
+                    addParameter((char *)value, 0, Sqlite3TypeChar);
                     break;
                 case 2:
-                    formats_.push_back(Sqlite3TypeShort);
+                    addParameter((char *)value, 0, Sqlite3TypeShort);
                     break;
                 case 4:
-                    formats_.push_back(Sqlite3TypeInt);
+                    addParameter((char *)value, 0, Sqlite3TypeInt);
                     break;
                 case 8:
-                    formats_.push_back(Sqlite3TypeInt64);
                 default:
+                    addParameter((char *)value, 0, Sqlite3TypeInt64);
                     break;
             }
         }
@@ -460,12 +467,9 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
     self &operator<<(std::string &&str);
     self &operator<<(trantor::Date &&date)
     {
-        return operator<<(date.toDbStringLocal());
-    }
-    self &operator<<(const trantor::Date &date)
-    {
-        return operator<<(date.toDbStringLocal());
+        return operator<<(static_cast<const trantor::Date &>(date));
     }
+    self &operator<<(const trantor::Date &date);
     self &operator<<(const std::vector<char> &v);
     self &operator<<(std::vector<char> &v)
     {
@@ -567,6 +571,49 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
 
   private:
     int getMysqlTypeBySize(size_t size);
+    void addParameter(const char *data, int length, int format)
+    {
+        if (parameters_.empty())
+        {
+            parameters_.reserve(ParameterStorage::kInlineParameters);
+            lengths_.reserve(ParameterStorage::kInlineParameters);
+            formats_.reserve(ParameterStorage::kInlineParameters);
+        }
+        ++parametersNumber_;
+        parameters_.push_back(data);
+        lengths_.push_back(length);
+        formats_.push_back(format);
+    }
+    void addText(const char *text, size_t length);
+    void addBlob(const char *data, size_t length);
+    // A free inline slot for size bytes, or nullptr
+    char *inlineSlot(size_t size)
+    {
+        if (!storage_)
+            storage_ = std::make_shared<ParameterStorage>();
+        if (size > ParameterStorage::kSlotSize ||
+            storage_->usedSlots_ == ParameterStorage::kInlineParameters)
+            return nullptr;
+        return storage_->slots_[storage_->usedSlots_++];
+    }
+    void keepObject(std::shared_ptr<void> obj)
+    {
+        if (!storage_)
+            storage_ = std::make_shared<ParameterStorage>();
+        storage_->objs_.push_back(std::move(obj));
+    }
+    template <typename T>
+    T *storeValue(const T &value)
+    {
+        auto slot = std::is_trivially_copyable<T>::value
+                        ? inlineSlot(sizeof(T))
+                        : nullptr;
+        if (slot)
+            return new (slot) T(value);
+        auto obj = std::make_shared<T>(value);
+        keepObject(obj);
+        return obj.get();
+    }
     std::shared_ptr<std::string> sqlPtr_;
     const char *sqlViewPtr_;
     size_t sqlViewLength_;
@@ -575,7 +622,7 @@ class DROGON_EXPORT SqlBinder : public trantor::NonCopyable
     std::vector<const char *> parameters_;
     std::vector<int> lengths_;
     std::vector<int> formats_;
-    std::vector<std::shared_ptr<void>> objs_;
+    std::shared_ptr<ParameterStorage> storage_;
     Mode mode_{Mode::NonBlocking};
     std::shared_ptr<CallbackHolderBase> callbackHolder_;
     DrogonDbExceptionCallback exceptionCallback_;
@@ -13,6 +13,10 @@
  */
 
 #include "DbClientImpl.h"
+#include "DbConnection.h"
+#include "DeadlineDbClient.h"
+#include "GroupCommitDbClient.h"
+#include "SingleFlightDbClient.h"
 #include <drogon/config.h>
 #include <drogon/orm/DbClient.h>
 using namespace drogon::orm;
@@ -29,12 +33,17 @@ orm::internal::SqlBinder DbClient::operator<<(std::string &&sql)
 }
 
 std::shared_ptr<DbClient> DbClient::newPgClient(const std::string &connInfo,
-                                                const size_t connNum)
+                                                const size_t connNum,
+                                                const bool binaryResults)
 {
 #if USE_POSTGRESQL
-    auto client = std::make_shared<DbClientImpl>(connInfo,
-                                                 connNum,
-                                                 ClientType::PostgreSQL);
+    auto client =
+        std::make_shared<DbClientImpl>(connInfo,
+                                       connNum,
+                                       ClientType::PostgreSQL,
+                                       std::vector<trantor::EventLoop *>(),
+                                       0,
+                                       binaryResults);
     client->init();
     return client;
 #else
@@ -77,3 +86,166 @@ std::shared_ptr<DbClient> DbClient::newSqlite3Client(
     (void)(connNum);
 #endif
 }
+
+std::shared_ptr<DbClient> DbClient::newSingleFlightClient(
+    const std::shared_ptr<DbClient> &client)
+{
+    return std::make_shared<SingleFlightDbClient>(client);
+}
+
+std::shared_ptr<DbClient> DbClient::newDeadlineClient(
+    const std::shared_ptr<DbClient> &client,
+    std::chrono::steady_clock::time_point deadline)
+{
+    return std::make_shared<DeadlineDbClient>(client, deadline);
+}
+
+std::shared_ptr<DbClient> DbClient::newGroupCommitClient(
+    const std::shared_ptr<DbClient> &client,
+    double window,
+    size_t maxStatements)
+{
+    return std::make_shared<GroupCommitDbClient>(client, window, maxStatements);
+}
+
+void DbClient::execSqlWithDeadline(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    if (deadline <= std::chrono::steady_clock::now())
+    {
+        exceptCallback(std::make_exception_ptr(
+            TimeoutError("Deadline exceeded before the SQL was sent")));
+        return;
+    }
+    execSql(sql,
+            sqlLength,
+            paraNum,
+            std::move(parameters),
+            std::move(length),
+            std::move(format),
+            std::move(rcb),
+            std::move(exceptCallback));
+}
+
+void DbClient::forwardSql(
+    DbClient &client,
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    if (deadline == std::chrono::steady_clock::time_point::max())
+    {
+        client.execSql(sql,
+                       sqlLength,
+                       paraNum,
+                       std::move(parameters),
+                       std::move(length),
+                       std::move(format),
+                       std::move(rcb),
+                       std::move(exceptCallback));
+        return;
+    }
+    client.execSqlWithDeadline(sql,
+                               sqlLength,
+                               paraNum,
+                               std::move(parameters),
+                               std::move(length),
+                               std::move(format),
+                               std::move(rcb),
+                               std::move(exceptCallback),
+                               deadline);
+}
+
+void DbClient::copyIn(const std::string &sql,
+                      CopyInCallback &&producer,
+                      ResultCallback &&rCallback,
+                      ExceptionCallback &&exceptCallback)
+{
+    execCopy(std::string(sql),
+             std::move(producer),
+             nullptr,
+             std::move(rCallback),
+             [exceptCallback = std::move(exceptCallback)](
+                 const std::exception_ptr &exception) {
+                 try
+                 {
+                     std::rethrow_exception(exception);
+                 }
+                 catch (const DrogonDbException &e)
+                 {
+                     exceptCallback(e);
+                 }
+             });
+}
+
+void DbClient::copyOut(const std::string &sql,
+                       CopyOutCallback &&consumer,
+                       ResultCallback &&rCallback,
+                       ExceptionCallback &&exceptCallback)
+{
+    execCopy(std::string(sql),
+             nullptr,
+             std::move(consumer),
+             std::move(rCallback),
+             [exceptCallback = std::move(exceptCallback)](
+                 const std::exception_ptr &exception) {
+                 try
+                 {
+                     std::rethrow_exception(exception);
+                 }
+                 catch (const DrogonDbException &e)
+                 {
+                     exceptCallback(e);
+                 }
+             });
+}
+
+void DbClient::execCopy(
+    std::string &&sql,
+    CopyInCallback &&producer,
+    CopyOutCallback &&consumer,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    if (type_ != ClientType::PostgreSQL)
+    {
+        exceptCallback(std::make_exception_ptr(
+            Failure("COPY is only supported by PostgreSQL")));
+        return;
+    }
+    // A transaction holds a connection of its own, which is idle between
+    // its statements
+    auto cmd = std::make_shared<CopyCmd>(CopyCmd{std::move(sql),
+                                                 std::move(producer),
+                                                 std::move(consumer),
+                                                 std::move(rcb),
+                                                 std::move(exceptCallback)});
+    newTransactionAsync(
+        [cmd](const std::shared_ptr<Transaction> &transaction) {
+            if (!transaction)
+            {
+                cmd->exceptionCallback_(std::make_exception_ptr(TimeoutError(
+                    "Timeout, no connection available for COPY")));
+                return;
+            }
+            transaction->execCopy(std::move(cmd->sql_),
+                                  std::move(cmd->producer_),
+                                  std::move(cmd->consumer_),
+                                  std::move(cmd->callback_),
+                                  std::move(cmd->exceptionCallback_));
+        });
+}
@@ -14,12 +14,14 @@
 
 #include "DbClientImpl.h"
 #include "DbConnection.h"
+#include "StatementStats.h"
 #include "../../lib/src/TaskTimeoutFlag.h"
 #include <drogon/config.h>
 #include <drogon/utils/string_view.h>
 #if USE_POSTGRESQL
 #include "postgresql_impl/PgConnection.h"
 #endif
+#include "postgresql_impl/PreparedStatementCache.h"
 #if USE_MYSQL
 #include "mysql_impl/MysqlConnection.h"
 #endif
@@ -41,65 +43,133 @@
 #include <thread>
 #include <trantor/net/EventLoop.h>
 #include <trantor/net/Channel.h>
-#include <unordered_set>
 #include <vector>
 
 using namespace drogon;
 using namespace drogon::orm;
 
+namespace
+{
+constexpr size_t kMaxPendingTasks = 200000;
+// The pool grows by one connection per second while queued tasks waited at
+// least this long on average
+constexpr uint64_t kGrowWaitMicroseconds = 1000;
+// and shrinks by one after this many seconds without waiting at less than
+// half utilization
+constexpr size_t kShrinkIdleTicks = 30;
+#if LIBPQ_SUPPORTS_BATCH_MODE
+// Most queries written to one PostgreSQL connection as a single pipeline
+constexpr size_t kMaxPipelineDepth = 64;
+#endif
+}
+
 DbClientImpl::DbClientImpl(const std::string &connInfo,
                            const size_t connNum,
-                           ClientType type)
+                           ClientType type,
+                           std::vector<trantor::EventLoop *> ioLoops,
+                           const size_t maxConnNum,
+                           const bool binaryResults)
     : numberOfConnections_(connNum),
-      loops_(type == ClientType::Sqlite3
+      maxConnections_(maxConnNum > connNum ? maxConnNum : connNum),
+      // With IO loops the own pool only runs timers
+      loops_(type == ClientType::Sqlite3 || !ioLoops.empty()
                  ? 1
-                 : (connNum < std::thread::hardware_concurrency()
-                        ? connNum
+                 : (maxConnections_ < std::thread::hardware_concurrency()
+                        ? maxConnections_
                         : std::thread::hardware_concurrency()),
-             "DbLoop")
+             "DbLoop"),
+      statementCounters_(std::make_shared<PreparedStatementCounters>()),
+      statementStats_(new StatementStats),
+      binaryResults_(binaryResults),
+      slots_(new ConnectionSlot[maxConnections_]),
+      ioLoops_(std::move(ioLoops)),
+      groupCount_(ioLoops_.empty() ? 1 : ioLoops_.size()),
+      readyHeads_(new std::atomic<uint64_t>[groupCount_])
 {
     type_ = type;
     connectionInfo_ = connInfo;
     LOG_TRACE << "type=" << (int)type;
     assert(connNum > 0);
+    assert(ioLoops_.empty() || type != ClientType::Sqlite3);
+    for (size_t i = 0; i < groupCount_; ++i)
+    {
+        readyHeads_[i].store(0, std::memory_order_relaxed);
+    }
 }
 void DbClientImpl::init()
 {
     // LOG_DEBUG << loops_.getLoopNum();
     loops_.start();
-    if (type_ == ClientType::PostgreSQL || type_ == ClientType::Mysql)
-    {
-        for (size_t i = 0; i < numberOfConnections_; ++i)
-        {
-            auto loop = loops_.getNextLoop();
-            loop->runInLoop([this, loop]() {
-                std::lock_guard<std::mutex> lock(connectionsMutex_);
-                connections_.insert(newConnection(loop));
-            });
-        }
-    }
-    else if (type_ == ClientType::Sqlite3)
+    if (type_ == ClientType::Sqlite3)
     {
         sharedMutexPtr_ = std::make_shared<SharedMutex>();
         assert(sharedMutexPtr_);
-
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        for (size_t i = 0; i < numberOfConnections_; ++i)
+    }
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        auto &slot = slots_[i];
+        if (!ioLoops_.empty())
+        {
+            slot.group_ = i % groupCount_;
+            slot.loop_ = ioLoops_[slot.group_];
+        }
+        else if (type_ != ClientType::Sqlite3)
+        {
+            slot.loop_ = loops_.getNextLoop();
+        }
+        if (i < numberOfConnections_)
         {
-            connections_.insert(newConnection(nullptr));
+            openConnection(i);
         }
+        else
+        {
+            slot.state_.store(SlotState::Unused, std::memory_order_relaxed);
+        }
+    }
+    std::weak_ptr<DbClientImpl> weakPtr = shared_from_this();
+    // The IO loops may stop before this client is destroyed
+    for (auto loop : ioLoops_)
+    {
+        loop->runOnQuit([weakPtr, loop]() {
+            auto thisPtr = weakPtr.lock();
+            if (!thisPtr)
+                return;
+            thisPtr->closeConnections(loop);
+        });
+    }
+    if (maxConnections_ > numberOfConnections_)
+    {
+        loops_.getNextLoop()->runEvery(1.0, [weakPtr]() {
+            auto thisPtr = weakPtr.lock();
+            if (!thisPtr)
+                return;
+            thisPtr->adjustPoolSize();
+        });
+    }
+}
+void DbClientImpl::openConnection(size_t index)
+{
+    auto loop = slots_[index].loop_;
+    if (loop)
+    {
+        loop->runInLoop([this, loop, index]() { newConnection(loop, index); });
+    }
+    else
+    {
+        newConnection(nullptr, index);
     }
 }
 DbClientImpl::~DbClientImpl() noexcept
 {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    for (auto const &conn : connections_)
+    for (size_t i = 0; i < maxConnections_; ++i)
     {
-        conn->disconnect();
+        auto conn = std::atomic_load(&slots_[i].connection_);
+        if (conn)
+        {
+            conn->disconnect();
+        }
+        std::atomic_store(&slots_[i].connection_, DbConnectionPtr());
     }
-    connections_.clear();
-    readyConnections_.clear();
-    busyConnections_.clear();
 }
 
 void DbClientImpl::execSql(
@@ -130,12 +200,51 @@ void DbClientImpl::execSql(
     std::vector<int> &&format,
     ResultCallback &&rcb,
     std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    execSqlWithDeadline(sql,
+                        sqlLength,
+                        paraNum,
+                        std::move(parameters),
+                        std::move(length),
+                        std::move(format),
+                        std::move(rcb),
+                        std::move(exceptCallback),
+                        std::chrono::steady_clock::time_point::max());
+}
+void DbClientImpl::execSqlWithDeadline(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
 {
     assert(paraNum == parameters.size());
     assert(paraNum == length.size());
     assert(paraNum == format.size());
     assert(rcb);
-    if (timeout_ > 0.0)
+    auto call = statementStats_->start(string_view{sql, sqlLength},
+                                       rcb,
+                                       exceptCallback);
+    auto timeout = timeout_;
+    if (deadline != std::chrono::steady_clock::time_point::max())
+    {
+        auto left = std::chrono::duration<double>(
+                        deadline - std::chrono::steady_clock::now())
+                        .count();
+        if (left <= 0.0)
+        {
+            exceptCallback(std::make_exception_ptr(
+                TimeoutError("Deadline exceeded before the SQL was sent")));
+            return;
+        }
+        if (timeout <= 0.0 || left < timeout)
+            timeout = left;
+    }
+    if (timeout > 0.0)
     {
         execSqlWithTimeout(sql,
                            sqlLength,
@@ -144,135 +253,104 @@ void DbClientImpl::execSql(
                            std::move(length),
                            std::move(format),
                            std::move(rcb),
-                           std::move(exceptCallback));
+                           std::move(exceptCallback),
+                           timeout,
+                           deadline,
+                           std::move(call));
         return;
     }
-    DbConnectionPtr conn;
-    bool busy = false;
+    size_t index;
+    if (popReadyConnection(index))
     {
-        std::lock_guard<std::mutex> guard(connectionsMutex_);
-
-        if (readyConnections_.size() == 0)
-        {
-            if (sqlCmdBuffer_.size() > 200000)
-            {
-                // too many queries in buffer;
-                busy = true;
-            }
-            else
-            {
-                // LOG_TRACE << "Push query to buffer";
-                std::shared_ptr<SqlCmd> cmd =
-                    std::make_shared<SqlCmd>(string_view{sql, sqlLength},
-                                             paraNum,
-                                             std::move(parameters),
-                                             std::move(length),
-                                             std::move(format),
-                                             std::move(rcb),
-                                             std::move(exceptCallback));
-                sqlCmdBuffer_.push_back(std::move(cmd));
-            }
-        }
-        else
+        auto conn = std::atomic_load(&slots_[index].connection_);
+        if (conn)
         {
-            auto iter = readyConnections_.begin();
-            busyConnections_.insert(*iter);
-            conn = *iter;
-            readyConnections_.erase(iter);
+            slots_[index].immediate_.fetch_add(1, std::memory_order_relaxed);
+            execSql(conn,
+                    string_view{sql, sqlLength},
+                    paraNum,
+                    std::move(parameters),
+                    std::move(length),
+                    std::move(format),
+                    std::move(rcb),
+                    std::move(exceptCallback));
+            return;
         }
+        // The connection closed right after it was taken, the slot now
+        // belongs to the reconnection and the query waits like any other.
     }
-    if (conn)
-    {
-        execSql(conn,
-                string_view{sql, sqlLength},
-                paraNum,
-                std::move(parameters),
-                std::move(length),
-                std::move(format),
-                std::move(rcb),
-                std::move(exceptCallback));
-        return;
-    }
-    if (busy)
+    if (pendingCount_.load(std::memory_order_relaxed) > kMaxPendingTasks)
     {
+        // too many queries in buffer;
+        rejected_.fetch_add(1, std::memory_order_relaxed);
         auto exceptPtr =
             std::make_exception_ptr(Failure("Too many queries in buffer"));
         exceptCallback(exceptPtr);
         return;
     }
+    // LOG_TRACE << "Push query to buffer";
+    PendingTask task;
+    task.cmd_ = std::make_shared<SqlCmd>(string_view{sql, sqlLength},
+                                         paraNum,
+                                         std::move(parameters),
+                                         std::move(length),
+                                         std::move(format),
+                                         std::move(rcb),
+                                         std::move(exceptCallback));
+    task.cmd_->statementCall_ = std::move(call);
+    queueTask(std::move(task));
 }
 void DbClientImpl::newTransactionAsync(
     const std::function<void(const std::shared_ptr<Transaction> &)> &callback)
 {
-    DbConnectionPtr conn;
+    size_t index;
+    if (popReadyConnection(index))
     {
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        if (!readyConnections_.empty())
+        auto conn = std::atomic_load(&slots_[index].connection_);
+        if (conn)
         {
-            auto iter = readyConnections_.begin();
-            busyConnections_.insert(*iter);
-            conn = *iter;
-            readyConnections_.erase(iter);
-        }
-        else
-        {
-            auto callbackPtr = std::make_shared<
-                std::function<void(const std::shared_ptr<Transaction> &)>>(
-                callback);
-            if (timeout_ > 0.0)
-            {
-                auto newCallbackPtr =
-                    std::make_shared<std::weak_ptr<std::function<void(
-                        const std::shared_ptr<Transaction> &)>>>();
-                auto timeoutFlagPtr = std::make_shared<TaskTimeoutFlag>(
-                    loops_.getNextLoop(),
-                    std::chrono::duration<double>(timeout_),
-                    [newCallbackPtr, callbackPtr, this]() {
-                        auto cbPtr = (*newCallbackPtr).lock();
-                        if (cbPtr)
-                        {
-                            std::lock_guard<std::mutex> lock(connectionsMutex_);
-                            for (auto iter = transCallbacks_.begin();
-                                 iter != transCallbacks_.end();
-                                 ++iter)
-                            {
-                                if (cbPtr == *iter)
-                                {
-                                    transCallbacks_.erase(iter);
-                                    break;
-                                }
-                            }
-                        }
-                        (*callbackPtr)(nullptr);
-                    });
-                callbackPtr = std::make_shared<
-                    std::function<void(const std::shared_ptr<Transaction> &)>>(
-                    [callbackPtr, timeoutFlagPtr](
-                        const std::shared_ptr<Transaction> &trans) {
-                        if (timeoutFlagPtr->done())
-                            return;
-                        (*callbackPtr)(trans);
-                    });
-                (*newCallbackPtr) = callbackPtr;
-                timeoutFlagPtr->runTimer();
-            }
-            transCallbacks_.push_back(callbackPtr);
+            slots_[index].immediate_.fetch_add(1, std::memory_order_relaxed);
+            makeTrans(index,
+                      conn,
+                      std::function<void(const std::shared_ptr<Transaction> &)>(
+                          callback));
+            return;
         }
     }
-    if (conn)
+    PendingTask task;
+    task.transCallback_ = callback;
+    if (timeout_ > 0.0)
     {
-        makeTrans(conn,
-                  std::function<void(const std::shared_ptr<Transaction> &)>(
-                      callback));
+        auto callbackPtr = std::make_shared<
+            std::function<void(const std::shared_ptr<Transaction> &)>>(
+            callback);
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        auto timeoutFlagPtr = std::make_shared<TaskTimeoutFlag>(
+            loops_.getNextLoop(),
+            std::chrono::duration<double>(timeout_),
+            [callbackPtr, cancelled]() {
+                cancelled->store(true, std::memory_order_release);
+                (*callbackPtr)(nullptr);
+            });
+        task.transCallback_ = [callbackPtr, timeoutFlagPtr](
+                                  const std::shared_ptr<Transaction> &trans) {
+            if (timeoutFlagPtr->done())
+                return;
+            (*callbackPtr)(trans);
+        };
+        task.cancelled_ = std::move(cancelled);
+        timeoutFlagPtr->runTimer();
     }
+    queueTask(std::move(task));
 }
 void DbClientImpl::makeTrans(
+    size_t index,
     const DbConnectionPtr &conn,
     std::function<void(const std::shared_ptr<Transaction> &)> &&callback)
 {
     std::weak_ptr<DbClientImpl> weakThis = shared_from_this();
     auto trans = std::shared_ptr<TransactionImpl>(new TransactionImpl(
-        type_, conn, std::function<void(bool)>(), [weakThis, conn]() {
+        type_, conn, std::function<void(bool)>(), [weakThis, conn, index]() {
             auto thisPtr = weakThis.lock();
             if (!thisPtr)
                 return;
@@ -280,35 +358,17 @@ void DbClientImpl::makeTrans(
             {
                 return;
             }
+            if (std::atomic_load(&thisPtr->slots_[index].connection_) != conn)
             {
-                std::lock_guard<std::mutex> guard(thisPtr->connectionsMutex_);
-                if (thisPtr->connections_.find(conn) ==
-                    thisPtr->connections_.end())
-                {
-                    // connection is broken and removed
-                    assert(thisPtr->busyConnections_.find(conn) ==
-                               thisPtr->busyConnections_.end() &&
-                           thisPtr->readyConnections_.find(conn) ==
-                               thisPtr->readyConnections_.end());
-
-                    return;
-                }
+                // connection is broken and removed
+                return;
             }
-            conn->loop()->queueInLoop([weakThis, conn]() {
+            conn->loop()->queueInLoop([weakThis, conn, index]() {
                 auto thisPtr = weakThis.lock();
                 if (!thisPtr)
                     return;
-                std::weak_ptr<DbConnection> weakConn = conn;
-                conn->setIdleCallback([weakThis, weakConn]() {
-                    auto thisPtr = weakThis.lock();
-                    if (!thisPtr)
-                        return;
-                    auto connPtr = weakConn.lock();
-                    if (!connPtr)
-                        return;
-                    thisPtr->handleNewTask(connPtr);
-                });
-                thisPtr->handleNewTask(conn);
+                thisPtr->setIdleCallback(conn, index);
+                thisPtr->handleNewTask(index);
             });
         }));
     trans->doBegin();
@@ -336,57 +396,322 @@ std::shared_ptr<Transaction> DbClientImpl::newTransaction(
     return trans;
 }
 
-void DbClientImpl::handleNewTask(const DbConnectionPtr &connPtr)
+size_t DbClientImpl::localGroup() const
+{
+    if (groupCount_ == 1)
+        return 0;
+    auto loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    for (size_t i = 0; i < groupCount_; ++i)
+    {
+        if (ioLoops_[i] == loop)
+            return i;
+    }
+    return 0;
+}
+
+bool DbClientImpl::popReadyConnection(size_t &index)
 {
-    std::function<void(const std::shared_ptr<Transaction> &)> transCallback;
-    std::shared_ptr<SqlCmd> cmd;
+    // Connections of the calling thread's loop first, then the other loops
+    // in turn
+    auto first = localGroup();
+    for (size_t i = 0; i < groupCount_; ++i)
     {
-        std::lock_guard<std::mutex> guard(connectionsMutex_);
-        if (!transCallbacks_.empty())
+        if (popReadyConnection((first + i) % groupCount_, index))
+            return true;
+    }
+    return false;
+}
+
+bool DbClientImpl::popReadyConnection(size_t group, size_t &index)
+{
+    auto &readyHead = readyHeads_[group];
+    auto head = readyHead.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto top = static_cast<uint32_t>(head);
+        if (top == 0)
+            return false;
+        auto &slot = slots_[top - 1];
+        // next_ may be stale if the slot was popped and pushed again in the
+        // meantime, the tag makes the exchange fail in that case
+        uint64_t next = (((head >> 32) + 1) << 32) |
+                        slot.next_.load(std::memory_order_relaxed);
+        if (!readyHead.compare_exchange_weak(head,
+                                             next,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
         {
-            transCallback = std::move(*(transCallbacks_.front()));
-            transCallbacks_.pop_front();
+            continue;
         }
-        else if (!sqlCmdBuffer_.empty())
+        auto state = SlotState::Idle;
+        if (slot.state_.compare_exchange_strong(state,
+                                                SlotState::Busy,
+                                                std::memory_order_acq_rel))
         {
-            cmd = std::move(sqlCmdBuffer_.front());
-            sqlCmdBuffer_.pop_front();
+            index = top - 1;
+            return true;
         }
-        else
+        // The connection closed while it was waiting on the stack
+        assert(state == SlotState::Dead);
+        slot.state_.store(SlotState::Empty, std::memory_order_release);
+        reconnect(top - 1);
+        head = readyHead.load(std::memory_order_acquire);
+    }
+}
+
+void DbClientImpl::pushReadyConnection(size_t index)
+{
+    auto &slot = slots_[index];
+    auto &readyHead = readyHeads_[slot.group_];
+    auto head = readyHead.load(std::memory_order_relaxed);
+    uint64_t top;
+    do
+    {
+        slot.next_.store(static_cast<uint32_t>(head),
+                         std::memory_order_relaxed);
+        top = (((head >> 32) + 1) << 32) | (index + 1);
+    } while (!readyHead.compare_exchange_weak(head,
+                                              top,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+void DbClientImpl::flushReadyConnections()
+{
+    // Popping the whole stack reconnects every Dead slot on it, the idle
+    // ones are handed back through handleNewTask().
+    std::vector<size_t> idle;
+    size_t index;
+    while (popReadyConnection(index))
+    {
+        idle.push_back(index);
+    }
+    for (auto i : idle)
+    {
+        handleNewTask(i);
+    }
+}
+
+void DbClientImpl::closeConnections(trantor::EventLoop *loop)
+{
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        if (slots_[i].loop_ != loop)
+            continue;
+        // Dropping the connection first keeps its close callback from
+        // scheduling a reconnection
+        auto conn = std::atomic_exchange(&slots_[i].connection_,
+                                         DbConnectionPtr());
+        if (conn)
         {
-            // Connection is idle, put it into the readyConnections_ set;
-            busyConnections_.erase(connPtr);
-            readyConnections_.insert(connPtr);
+            conn->disconnect();
         }
     }
-    if (transCallback)
+}
+
+void DbClientImpl::queueTask(PendingTask &&task)
+{
+    task.queuedAt_ = std::chrono::steady_clock::now();
+    pendingTasks_.enqueue(std::move(task));
+    pendingCount_.fetch_add(1);
+    // Pairs with the fence in handleNewTask(): either a connection going
+    // idle sees the task, or the task sees the connection on the stack.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_t index;
+    if (popReadyConnection(index))
+    {
+        handleNewTask(index);
+    }
+}
+
+bool DbClientImpl::nextPendingTask(PendingTask &task)
+{
+#if LIBPQ_SUPPORTS_BATCH_MODE
+    if (hasDeferredTask_)
+    {
+        hasDeferredTask_ = false;
+        task = std::move(deferredTask_);
+        return true;
+    }
+#endif
+    return pendingTasks_.dequeue(task);
+}
+
+bool DbClientImpl::takePendingTask(PendingTask &task, bool &incomplete)
+{
+    incomplete = false;
+    if (pendingCount_.load() == 0)
+        return false;
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    while (pendingCount_.load(std::memory_order_relaxed) > 0)
     {
-        makeTrans(connPtr, std::move(transCallback));
+        if (!nextPendingTask(task))
+        {
+            // An earlier producer has not linked its task yet, it looks for
+            // an idle connection itself as soon as it has.
+            incomplete = true;
+            return false;
+        }
+        pendingCount_.fetch_sub(1);
+        recordWait(task);
+        if (!task.cancelled_ ||
+            !task.cancelled_->load(std::memory_order_acquire))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if LIBPQ_SUPPORTS_BATCH_MODE
+void DbClientImpl::takePipelinedTasks(
+    std::deque<std::shared_ptr<SqlCmd>> &cmds)
+{
+    if (pendingCount_.load() == 0)
         return;
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    PendingTask task;
+    while (cmds.size() < kMaxPipelineDepth &&
+           pendingCount_.load(std::memory_order_relaxed) > 0)
+    {
+        if (!nextPendingTask(task))
+            return;
+        if (task.transCallback_)
+        {
+            // A transaction needs a connection of its own, keep it at the
+            // front of the queue for the next idle one.
+            deferredTask_ = std::move(task);
+            hasDeferredTask_ = true;
+            return;
+        }
+        pendingCount_.fetch_sub(1);
+        recordWait(task);
+        if (!task.cancelled_ ||
+            !task.cancelled_->load(std::memory_order_acquire))
+        {
+            cmds.push_back(std::move(task.cmd_));
+        }
     }
-    if (cmd)
+}
+#endif
+
+void DbClientImpl::runTask(size_t index, PendingTask &&task)
+{
+    auto conn = std::atomic_load(&slots_[index].connection_);
+    if (!conn)
+    {
+        queueTask(std::move(task));
+        return;
+    }
+    if (task.transCallback_)
+    {
+        makeTrans(index, conn, std::move(task.transCallback_));
+        return;
+    }
+#if LIBPQ_SUPPORTS_BATCH_MODE
+    if (type_ == ClientType::PostgreSQL)
     {
-        execSql(connPtr,
-                std::move(cmd->sql_),
-                cmd->parametersNumber_,
-                std::move(cmd->parameters_),
-                std::move(cmd->lengths_),
-                std::move(cmd->formats_),
-                std::move(cmd->callback_),
-                std::move(cmd->exceptionCallback_));
+        // Write the queries waiting behind this one on the same connection
+        // and read their results back in order.
+        std::deque<std::shared_ptr<SqlCmd>> cmds;
+        cmds.push_back(std::move(task.cmd_));
+        takePipelinedTasks(cmds);
+        conn->batchSql(std::move(cmds));
         return;
     }
+#endif
+    auto &cmd = task.cmd_;
+    if (cmd->deadline_ != std::chrono::steady_clock::time_point::max())
+    {
+        conn->execSqlCmd(std::move(cmd));
+        return;
+    }
+    execSql(conn,
+            std::move(cmd->sql_),
+            cmd->parametersNumber_,
+            std::move(cmd->parameters_),
+            std::move(cmd->lengths_),
+            std::move(cmd->formats_),
+            std::move(cmd->callback_),
+            std::move(cmd->exceptionCallback_));
+}
+
+void DbClientImpl::handleNewTask(size_t index)
+{
+    while (true)
+    {
+        // index may name another connection after popReadyConnection()
+        // below, so the slot is looked up on every pass
+        auto &slot = slots_[index];
+        PendingTask task;
+        bool incomplete;
+        if (takePendingTask(task, incomplete))
+        {
+            runTask(index, std::move(task));
+            return;
+        }
+        // Connection is idle, put it onto the ready stack
+        auto state = SlotState::Busy;
+        if (!slot.state_.compare_exchange_strong(state,
+                                                 SlotState::Idle,
+                                                 std::memory_order_acq_rel))
+        {
+            // closed in the meantime and being reconnected
+            return;
+        }
+        pushReadyConnection(index);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (incomplete || pendingCount_.load() == 0)
+            return;
+        // A task was queued while this connection was being parked and its
+        // producer may have missed it
+        if (!popReadyConnection(index))
+            return;
+    }
+}
+
+void DbClientImpl::setIdleCallback(const DbConnectionPtr &conn, size_t index)
+{
+    std::weak_ptr<DbClientImpl> weakPtr = shared_from_this();
+    std::weak_ptr<DbConnection> weakConn = conn;
+    conn->setIdleCallback([weakPtr, weakConn, index]() {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr)
+            return;
+        auto connPtr = weakConn.lock();
+        if (!connPtr ||
+            std::atomic_load(&thisPtr->slots_[index].connection_) != connPtr)
+            return;
+        thisPtr->handleNewTask(index);
+    });
+}
+
+void DbClientImpl::reconnect(size_t index)
+{
+    // Reconnect after 1 second
+    auto loop = slots_[index].loop_;
+    std::weak_ptr<DbClientImpl> weakPtr = shared_from_this();
+    (loop ? loop : loops_.getNextLoop())
+        ->runAfter(1, [weakPtr, loop, index] {
+            auto thisPtr = weakPtr.lock();
+            if (!thisPtr)
+                return;
+            thisPtr->newConnection(loop, index);
+        });
 }
 
-DbConnectionPtr DbClientImpl::newConnection(trantor::EventLoop *loop)
+void DbClientImpl::newConnection(trantor::EventLoop *loop, size_t index)
 {
     DbConnectionPtr connPtr;
     if (type_ == ClientType::PostgreSQL)
     {
 #if USE_POSTGRESQL
-        connPtr = std::make_shared<PgConnection>(loop, connectionInfo_);
+        connPtr = std::make_shared<PgConnection>(loop,
+                                                 connectionInfo_,
+                                                 statementCounters_,
+                                                 binaryResults_);
 #else
-        return nullptr;
+        return;
 #endif
     }
     else if (type_ == ClientType::Mysql)
@@ -394,82 +719,227 @@ DbConnectionPtr DbClientImpl::newConnection(trantor::EventLoop *loop)
 #if USE_MYSQL
         connPtr = std::make_shared<MysqlConnection>(loop, connectionInfo_);
 #else
-        return nullptr;
+        return;
 #endif
     }
     else if (type_ == ClientType::Sqlite3)
     {
 #if USE_SQLITE3
-        auto sqlite3ConnPtr =
-            std::make_shared<Sqlite3Connection>(loop,
-                                                connectionInfo_,
-                                                sharedMutexPtr_);
-        sqlite3ConnPtr->init();
-        connPtr = sqlite3ConnPtr;
+        connPtr = std::make_shared<Sqlite3Connection>(loop,
+                                                      connectionInfo_,
+                                                      sharedMutexPtr_);
 #else
-        return nullptr;
+        return;
 #endif
     }
     else
     {
-        return nullptr;
+        return;
         (void)(loop);
     }
     std::weak_ptr<DbClientImpl> weakPtr = shared_from_this();
-    connPtr->setCloseCallback([weakPtr](const DbConnectionPtr &closeConnPtr) {
-        // Erase the connection
-        auto thisPtr = weakPtr.lock();
-        if (!thisPtr)
-            return;
-        {
-            std::lock_guard<std::mutex> guard(thisPtr->connectionsMutex_);
-            thisPtr->readyConnections_.erase(closeConnPtr);
-            thisPtr->busyConnections_.erase(closeConnPtr);
-            assert(thisPtr->connections_.find(closeConnPtr) !=
-                   thisPtr->connections_.end());
-            thisPtr->connections_.erase(closeConnPtr);
-        }
-        // Reconnect after 1 second
-        auto loop = closeConnPtr->loop();
-        loop->runAfter(1, [weakPtr, loop, closeConnPtr] {
+    connPtr->setCloseCallback(
+        [weakPtr, index](const DbConnectionPtr &closeConnPtr) {
             auto thisPtr = weakPtr.lock();
             if (!thisPtr)
                 return;
-            std::lock_guard<std::mutex> guard(thisPtr->connectionsMutex_);
-            thisPtr->connections_.insert(thisPtr->newConnection(loop));
+            auto &slot = thisPtr->slots_[index];
+            if (std::atomic_load(&slot.connection_) != closeConnPtr)
+                return;
+            std::atomic_store(&slot.connection_, DbConnectionPtr());
+            auto state = slot.state_.load(std::memory_order_acquire);
+            while (true)
+            {
+                if (state == SlotState::Idle)
+                {
+                    // The slot is on the ready stack, let the pop reconnect it
+                    if (slot.state_.compare_exchange_weak(state,
+                                                          SlotState::Dead))
+                    {
+                        thisPtr->flushReadyConnections();
+                        return;
+                    }
+                }
+                else if (slot.state_.compare_exchange_weak(state,
+                                                           SlotState::Empty))
+                {
+                    thisPtr->reconnect(index);
+                    return;
+                }
+            }
         });
-    });
-    connPtr->setOkCallback([weakPtr](const DbConnectionPtr &okConnPtr) {
+    connPtr->setOkCallback([weakPtr, index](const DbConnectionPtr &okConnPtr) {
         LOG_TRACE << "connected!";
         auto thisPtr = weakPtr.lock();
         if (!thisPtr)
             return;
-        {
-            std::lock_guard<std::mutex> guard(thisPtr->connectionsMutex_);
-            thisPtr->busyConnections_.insert(
-                okConnPtr);  // For new connections, this sentence is
-                             // necessary
-        }
-        thisPtr->handleNewTask(okConnPtr);
-    });
-    std::weak_ptr<DbConnection> weakConn = connPtr;
-    connPtr->setIdleCallback([weakPtr, weakConn]() {
-        auto thisPtr = weakPtr.lock();
-        if (!thisPtr)
-            return;
-        auto connPtr = weakConn.lock();
-        if (!connPtr)
+        auto &slot = thisPtr->slots_[index];
+        if (std::atomic_load(&slot.connection_) != okConnPtr)
             return;
-        thisPtr->handleNewTask(connPtr);
+        // For new connections, this sentence is necessary
+        slot.state_.store(SlotState::Busy, std::memory_order_release);
+        thisPtr->handleNewTask(index);
     });
-    // std::cout<<"newConn end"<<connPtr<<std::endl;
-    return connPtr;
+    setIdleCallback(connPtr, index);
+    std::atomic_store(&slots_[index].connection_, connPtr);
+#if USE_SQLITE3
+    // The sqlite3 connection opens the database on its own thread and calls
+    // back from there, so it must not be started before the callbacks are set
+    if (type_ == ClientType::Sqlite3)
+    {
+        std::static_pointer_cast<Sqlite3Connection>(connPtr)->init();
+    }
+#endif
 }
 
 bool DbClientImpl::hasAvailableConnections() const noexcept
 {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    return (!readyConnections_.empty()) || (!busyConnections_.empty());
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        auto state = slots_[i].state_.load(std::memory_order_relaxed);
+        if (state == SlotState::Idle || state == SlotState::Busy)
+            return true;
+    }
+    return false;
+}
+
+DbClientStats DbClientImpl::stats() const
+{
+    DbClientStats stats;
+    stats.minConnections = numberOfConnections_;
+    stats.maxConnections = maxConnections_;
+    uint64_t immediate = 0;
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        auto state = slots_[i].state_.load(std::memory_order_relaxed);
+        if (state != SlotState::Unused)
+            ++stats.connections;
+        if (state == SlotState::Busy)
+            ++stats.busyConnections;
+        immediate += slots_[i].immediate_.load(std::memory_order_relaxed);
+    }
+    stats.queueDepth = pendingCount_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stats.waitTimeHistogram = waitTimeHistogram_;
+    }
+    stats.waitTimeHistogram[0] = immediate;
+    auto cached = statementCounters_->cached_.load(std::memory_order_relaxed);
+    stats.preparedStatements = cached > 0 ? static_cast<size_t>(cached) : 0;
+    stats.preparedStatementHits =
+        statementCounters_->hits_.load(std::memory_order_relaxed);
+    stats.preparedStatementMisses =
+        statementCounters_->misses_.load(std::memory_order_relaxed);
+    stats.preparedStatementEvictions =
+        statementCounters_->evictions_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<StatementStat> DbClientImpl::statementStats() const
+{
+    return statementStats_->snapshot();
+}
+
+void DbClientImpl::recordWait(const PendingTask &task)
+{
+    // pendingMutex_ is held by the caller
+    static const uint64_t bounds[] = {100, 1000, 10000, 100000, 1000000};
+    auto wait = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - task.queuedAt_)
+            .count());
+    if (task.cmd_ && task.cmd_->statementCall_)
+        task.cmd_->statementCall_->dispatched();
+    size_t bucket = 1;
+    while (bucket < waitTimeHistogram_.size() - 1 && wait > bounds[bucket - 1])
+    {
+        ++bucket;
+    }
+    ++waitTimeHistogram_[bucket];
+    ++windowTasks_;
+    windowWaitMicroseconds_ += wait;
+}
+
+void DbClientImpl::adjustPoolSize()
+{
+    uint64_t tasks;
+    uint64_t waited;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        tasks = windowTasks_;
+        waited = windowWaitMicroseconds_;
+        windowTasks_ = 0;
+        windowWaitMicroseconds_ = 0;
+    }
+    size_t open = 0;
+    size_t busy = 0;
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        auto state = slots_[i].state_.load(std::memory_order_relaxed);
+        if (state != SlotState::Unused)
+            ++open;
+        if (state == SlotState::Busy)
+            ++busy;
+    }
+    auto queued = pendingCount_.load(std::memory_order_relaxed);
+    // Queries stuck behind connections that are all busy count as waiting
+    // too, even if none of them got a connection in the last second
+    if ((tasks > 0 && waited / tasks >= kGrowWaitMicroseconds) ||
+        (tasks == 0 && queued > 0 && busy == open))
+    {
+        idleTicks_ = 0;
+        if (open < maxConnections_)
+        {
+            growPool();
+        }
+        return;
+    }
+    if (tasks == 0 && queued == 0 && busy * 2 < open)
+    {
+        ++idleTicks_;
+    }
+    else
+    {
+        idleTicks_ = 0;
+    }
+    if (idleTicks_ >= kShrinkIdleTicks && open > numberOfConnections_)
+    {
+        idleTicks_ = 0;
+        shrinkPool();
+    }
+}
+
+void DbClientImpl::growPool()
+{
+    for (size_t i = 0; i < maxConnections_; ++i)
+    {
+        auto state = SlotState::Unused;
+        if (slots_[i].state_.compare_exchange_strong(state, SlotState::Empty))
+        {
+            LOG_DEBUG << "Add a database connection, slot " << i;
+            openConnection(i);
+            return;
+        }
+    }
+}
+
+void DbClientImpl::shrinkPool()
+{
+    size_t index;
+    if (!popReadyConnection(index))
+        return;
+    auto &slot = slots_[index];
+    // Dropping the connection first makes its callbacks ignore the slot
+    auto conn = std::atomic_exchange(&slot.connection_, DbConnectionPtr());
+    if (!conn)
+    {
+        // Closed right after it was taken, the reconnection owns the slot
+        return;
+    }
+    LOG_DEBUG << "Remove the idle database connection of slot " << index;
+    slot.state_.store(SlotState::Unused, std::memory_order_release);
+    conn->disconnect();
 }
 
 void DbClientImpl::execSqlWithTimeout(
@@ -480,34 +950,23 @@ void DbClientImpl::execSqlWithTimeout(
     std::vector<int> &&length,
     std::vector<int> &&format,
     ResultCallback &&rcb,
-    std::function<void(const std::exception_ptr &)> &&ecb)
+    std::function<void(const std::exception_ptr &)> &&ecb,
+    double timeout,
+    std::chrono::steady_clock::time_point deadline,
+    std::shared_ptr<StatementCall> &&call)
 {
-    DbConnectionPtr conn;
-    assert(timeout_ > 0.0);
-    auto cmd = std::make_shared<std::weak_ptr<SqlCmd>>();
-    bool busy = false;
+    assert(timeout > 0.0);
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
     auto ecpPtr =
         std::make_shared<std::function<void(const std::exception_ptr &)>>(
             std::move(ecb));
     auto timeoutFlagPtr = std::make_shared<drogon::TaskTimeoutFlag>(
         loops_.getNextLoop(),
-        std::chrono::duration<double>(timeout_),
-        [cmd, ecpPtr, thisPtr = shared_from_this()]() {
-            auto cbPtr = (*cmd).lock();
-            if (cbPtr)
-            {
-                std::lock_guard<std::mutex> lock(thisPtr->connectionsMutex_);
-                for (auto iter = thisPtr->sqlCmdBuffer_.begin();
-                     iter != thisPtr->sqlCmdBuffer_.end();
-                     ++iter)
-                {
-                    if (*iter == cbPtr)
-                    {
-                        thisPtr->sqlCmdBuffer_.erase(iter);
-                        break;
-                    }
-                }
-            }
+        std::chrono::duration<double>(timeout),
+        [cancelled, ecpPtr]() {
+            // A query still waiting for a connection is skipped when its
+            // turn comes
+            cancelled->store(true, std::memory_order_release);
             (*ecpPtr)(
                 std::make_exception_ptr(TimeoutError("SQL execution timeout")));
         });
@@ -525,59 +984,61 @@ void DbClientImpl::execSqlWithTimeout(
         (*ecpPtr)(err);
     };
 
+    size_t index;
+    if (popReadyConnection(index))
     {
-        std::lock_guard<std::mutex> guard(connectionsMutex_);
-
-        if (readyConnections_.size() == 0)
+        auto conn = std::atomic_load(&slots_[index].connection_);
+        if (conn)
         {
-            if (sqlCmdBuffer_.size() > 200000)
+            slots_[index].immediate_.fetch_add(1, std::memory_order_relaxed);
+            if (deadline == std::chrono::steady_clock::time_point::max())
             {
-                // too many queries in buffer;
-                busy = true;
+                execSql(conn,
+                        string_view{sql, sqlLength},
+                        paraNum,
+                        std::move(parameters),
+                        std::move(length),
+                        std::move(format),
+                        std::move(resultCallback),
+                        std::move(exceptionCallback));
             }
             else
             {
-                // LOG_TRACE << "Push query to buffer";
-                auto command =
-                    std::make_shared<SqlCmd>(string_view{sql, sqlLength},
-                                             paraNum,
-                                             std::move(parameters),
-                                             std::move(length),
-                                             std::move(format),
-                                             std::move(resultCallback),
-                                             std::move(exceptionCallback));
-                sqlCmdBuffer_.emplace_back(command);
-                *cmd = command;
+                auto cmd = std::make_shared<SqlCmd>(
+                    string_view{sql, sqlLength},
+                    paraNum,
+                    std::move(parameters),
+                    std::move(length),
+                    std::move(format),
+                    std::move(resultCallback),
+                    std::move(exceptionCallback));
+                cmd->deadline_ = deadline;
+                conn->execSqlCmd(std::move(cmd));
             }
+            timeoutFlagPtr->runTimer();
+            return;
         }
-        else
-        {
-            auto iter = readyConnections_.begin();
-            busyConnections_.insert(*iter);
-            conn = *iter;
-            readyConnections_.erase(iter);
-        }
-    }
-    if (conn)
-    {
-        execSql(conn,
-                string_view{sql, sqlLength},
-                paraNum,
-                std::move(parameters),
-                std::move(length),
-                std::move(format),
-                std::move(resultCallback),
-                std::move(exceptionCallback));
-        timeoutFlagPtr->runTimer();
-        return;
     }
 
-    if (busy)
+    if (pendingCount_.load(std::memory_order_relaxed) > kMaxPendingTasks)
     {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
         exceptionCallback(
             std::make_exception_ptr(Failure("Too many queries in buffer")));
         return;
     }
 
+    PendingTask task;
+    task.cmd_ = std::make_shared<SqlCmd>(string_view{sql, sqlLength},
+                                         paraNum,
+                                         std::move(parameters),
+                                         std::move(length),
+                                         std::move(format),
+                                         std::move(resultCallback),
+                                         std::move(exceptionCallback));
+    task.cmd_->statementCall_ = std::move(call);
+    task.cmd_->deadline_ = deadline;
+    task.cancelled_ = std::move(cancelled);
     timeoutFlagPtr->runTimer();
+    queueTask(std::move(task));
 }
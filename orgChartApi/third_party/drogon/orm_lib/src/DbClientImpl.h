@@ -17,24 +17,48 @@
 #include "DbConnection.h"
 #include <drogon/orm/DbClient.h>
 #include <trantor/net/EventLoopThreadPool.h>
+#include <trantor/utils/LockFreeQueue.h>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
-#include <unordered_set>
+#include <vector>
 
 namespace drogon
 {
 namespace orm
 {
+struct PreparedStatementCounters;
+class StatementStats;
+class StatementCall;
+
 class DbClientImpl : public DbClient,
                      public std::enable_shared_from_this<DbClientImpl>
 {
   public:
+    /**
+     * If ioLoops is not empty, connections are spread over those loops and
+     * a query prefers a connection that runs on the loop of the calling
+     * thread. It takes one from another loop only when the local ones are
+     * all busy.
+     *
+     * If maxConnNum is larger than connNum, the pool starts with connNum
+     * connections and grows up to maxConnNum while queries wait too long for
+     * a connection, then shrinks back when connections sit idle.
+     *
+     * binaryResults lets PostgreSQL connections fetch the results of
+     * prepared statements in binary format, see PgConnection.
+     */
     DbClientImpl(const std::string &connInfo,
                  const size_t connNum,
-                 ClientType type);
+                 ClientType type,
+                 std::vector<trantor::EventLoop *> ioLoops = {},
+                 const size_t maxConnNum = 0,
+                 const bool binaryResults = false);
     ~DbClientImpl() noexcept override;
     void execSql(const char *sql,
                  size_t sqlLength,
@@ -45,6 +69,16 @@ class DbClientImpl : public DbClient,
                  ResultCallback &&rcb,
                  std::function<void(const std::exception_ptr &)>
                      &&exceptCallback) override;
+    void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline) override;
     std::shared_ptr<Transaction> newTransaction(
         const std::function<void(bool)> &commitCallback =
             std::function<void(bool)>()) noexcept(false) override;
@@ -52,6 +86,8 @@ class DbClientImpl : public DbClient,
         const std::function<void(const std::shared_ptr<Transaction> &)>
             &callback) override;
     bool hasAvailableConnections() const noexcept override;
+    DbClientStats stats() const override;
+    std::vector<StatementStat> statementStats() const override;
     void setTimeout(double timeout) override
     {
         timeout_ = timeout;
@@ -60,9 +96,14 @@ class DbClientImpl : public DbClient,
 
   private:
     size_t numberOfConnections_;
+    size_t maxConnections_;
     trantor::EventLoopThreadPool loops_;
     std::shared_ptr<SharedMutex> sharedMutexPtr_;
     double timeout_{-1.0};
+    // Shared by the PostgreSQL connections
+    std::shared_ptr<PreparedStatementCounters> statementCounters_;
+    std::unique_ptr<StatementStats> statementStats_;
+    bool binaryResults_;
     void execSql(
         const DbConnectionPtr &conn,
         string_view &&sql,
@@ -73,24 +114,104 @@ class DbClientImpl : public DbClient,
         ResultCallback &&rcb,
         std::function<void(const std::exception_ptr &)> &&exceptCallback);
 
-    DbConnectionPtr newConnection(trantor::EventLoop *loop);
+    /**
+     * Every connection lives in a fixed slot. Idle slots are kept on a
+     * lock-free stack threaded through next_, and the state of a slot says
+     * who owns it: the stack (Idle), the thread that popped it or the query
+     * running on it (Busy), or nobody while it is (re)connecting (Empty).
+     * A slot whose connection closed while it was on the stack is marked
+     * Dead and reconnected by whoever pops it. Slots above the current pool
+     * size are Unused.
+     */
+    enum class SlotState
+    {
+        Empty = 0,
+        Idle,
+        Busy,
+        Dead,
+        Unused
+    };
+    struct ConnectionSlot
+    {
+        // Read and written with std::atomic_load/std::atomic_store
+        DbConnectionPtr connection_;
+        trantor::EventLoop *loop_{nullptr};
+        size_t group_{0};
+        std::atomic<SlotState> state_{SlotState::Empty};
+        std::atomic<uint32_t> next_{0};
+        // Tasks that got this connection without waiting
+        std::atomic<uint64_t> immediate_{0};
+    };
+    struct PendingTask
+    {
+        std::shared_ptr<SqlCmd> cmd_;
+        std::function<void(const std::shared_ptr<Transaction> &)>
+            transCallback_;
+        // Set when the task timed out while it was waiting for a connection
+        std::shared_ptr<std::atomic<bool>> cancelled_;
+        std::chrono::steady_clock::time_point queuedAt_;
+    };
+
+    void openConnection(size_t index);
+    void newConnection(trantor::EventLoop *loop, size_t index);
+    void reconnect(size_t index);
+    void setIdleCallback(const DbConnectionPtr &conn, size_t index);
 
     void makeTrans(
+        size_t index,
         const DbConnectionPtr &conn,
         std::function<void(const std::shared_ptr<Transaction> &)> &&callback);
 
-    mutable std::mutex connectionsMutex_;
-    std::unordered_set<DbConnectionPtr> connections_;
-    std::unordered_set<DbConnectionPtr> readyConnections_;
-    std::unordered_set<DbConnectionPtr> busyConnections_;
+    size_t localGroup() const;
+    bool popReadyConnection(size_t &index);
+    bool popReadyConnection(size_t group, size_t &index);
+    void pushReadyConnection(size_t index);
+    void flushReadyConnections();
+    void closeConnections(trantor::EventLoop *loop);
+
+    std::unique_ptr<ConnectionSlot[]> slots_;
+    // Connections of one IO loop form a group with its own ready stack,
+    // without ioLoops there is a single group.
+    std::vector<trantor::EventLoop *> ioLoops_;
+    size_t groupCount_;
+    // The top of each ready stack as (index + 1) in the low 32 bits, 0 if
+    // the stack is empty. The high 32 bits count pushes and pops against ABA.
+    std::unique_ptr<std::atomic<uint64_t>[]> readyHeads_;
 
-    std::list<std::shared_ptr<
-        std::function<void(const std::shared_ptr<Transaction> &)>>>
-        transCallbacks_;
+    // Producers enqueue without locking; connections that become idle take
+    // tasks one at a time under pendingMutex_, which is only touched while
+    // pendingCount_ says the pool is saturated.
+    trantor::MpscQueue<PendingTask> pendingTasks_;
+    std::atomic<size_t> pendingCount_{0};
+    mutable std::mutex pendingMutex_;
+    std::atomic<uint64_t> rejected_{0};
 
-    std::deque<std::shared_ptr<SqlCmd>> sqlCmdBuffer_;
+    // Guarded by pendingMutex_, bucket 0 is the sum of the immediate_
+    // counters of the slots
+    std::array<uint64_t, 7> waitTimeHistogram_{};
+    // Tasks taken from the queue and their total wait since the last
+    // adjustPoolSize(), guarded by pendingMutex_
+    uint64_t windowTasks_{0};
+    uint64_t windowWaitMicroseconds_{0};
+    size_t idleTicks_{0};
+    void recordWait(const PendingTask &task);
+    void adjustPoolSize();
+    void growPool();
+    void shrinkPool();
 
-    void handleNewTask(const DbConnectionPtr &connPtr);
+    void queueTask(PendingTask &&task);
+    bool nextPendingTask(PendingTask &task);
+    bool takePendingTask(PendingTask &task, bool &incomplete);
+#if LIBPQ_SUPPORTS_BATCH_MODE
+    // A transaction met while collecting queries for a pipeline, it is
+    // handed out before anything else in the queue. Guarded by
+    // pendingMutex_ and still counted in pendingCount_.
+    PendingTask deferredTask_;
+    bool hasDeferredTask_{false};
+    void takePipelinedTasks(std::deque<std::shared_ptr<SqlCmd>> &cmds);
+#endif
+    void runTask(size_t index, PendingTask &&task);
+    void handleNewTask(size_t index);
     void execSqlWithTimeout(
         const char *sql,
         size_t sqlLength,
@@ -99,7 +220,10 @@ class DbClientImpl : public DbClient,
         std::vector<int> &&length,
         std::vector<int> &&format,
         ResultCallback &&rcb,
-        std::function<void(const std::exception_ptr &)> &&exceptCallback);
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        double timeout,
+        std::chrono::steady_clock::time_point deadline,
+        std::shared_ptr<StatementCall> &&call);
 };
 
 }  // namespace orm
@@ -14,6 +14,7 @@
 
 #include "DbClientLockFree.h"
 #include "DbConnection.h"
+#include "StatementStats.h"
 #include "TransactionImpl.h"
 #include "../../lib/src/TaskTimeoutFlag.h"
 #include <drogon/config.h>
@@ -47,10 +48,13 @@ using namespace drogon::orm;
 DbClientLockFree::DbClientLockFree(const std::string &connInfo,
                                    trantor::EventLoop *loop,
                                    ClientType type,
-                                   size_t connectionNumberPerLoop)
+                                   size_t connectionNumberPerLoop,
+                                   bool binaryResults)
     : connectionInfo_(connInfo),
+      binaryResults_(binaryResults),
       loop_(loop),
-      numberOfConnections_(connectionNumberPerLoop)
+      numberOfConnections_(connectionNumberPerLoop),
+      statementStats_(new StatementStats)
 {
     type_ = type;
     LOG_TRACE << "type=" << (int)type;
@@ -90,6 +94,9 @@ void DbClientLockFree::execSql(
     assert(paraNum == format.size());
     assert(rcb);
     loop_->assertInLoopThread();
+    auto call = statementStats_->start(string_view{sql, sqlLength},
+                                       rcb,
+                                       exceptCallback);
     if (timeout_ > 0.0)
     {
         execSqlWithTimeout(sql,
@@ -99,7 +106,8 @@ void DbClientLockFree::execSql(
                            std::move(length),
                            std::move(format),
                            std::move(rcb),
-                           std::move(exceptCallback));
+                           std::move(exceptCallback),
+                           std::move(call));
         return;
     }
     if (!connections_.empty() && sqlCmdBuffer_.empty() &&
@@ -216,6 +224,12 @@ void DbClientLockFree::execSql(
             }
         },
         std::move(exceptCallback)));
+    sqlCmdBuffer_.back()->statementCall_ = std::move(call);
+}
+
+std::vector<StatementStat> DbClientLockFree::statementStats() const
+{
+    return statementStats_->snapshot();
 }
 
 std::shared_ptr<Transaction> DbClientLockFree::newTransaction(
@@ -362,6 +376,8 @@ void DbClientLockFree::handleNewTask(const DbConnectionPtr &conn)
         {
             std::shared_ptr<SqlCmd> cmd = std::move(sqlCmdBuffer_.front());
             sqlCmdBuffer_.pop_front();
+            if (cmd->statementCall_)
+                cmd->statementCall_->dispatched();
             conn->execSql(std::move(cmd->sql_),
                           cmd->parametersNumber_,
                           std::move(cmd->parameters_),
@@ -375,11 +391,18 @@ void DbClientLockFree::handleNewTask(const DbConnectionPtr &conn)
             std::deque<std::shared_ptr<SqlCmd>> cmds;
             using std::swap;
             swap(cmds, sqlCmdBuffer_);
+            for (auto &cmd : cmds)
+            {
+                if (cmd->statementCall_)
+                    cmd->statementCall_->dispatched();
+            }
             conn->batchSql(std::move(cmds));
         }
 #else
         std::shared_ptr<SqlCmd> cmd = std::move(sqlCmdBuffer_.front());
         sqlCmdBuffer_.pop_front();
+        if (cmd->statementCall_)
+            cmd->statementCall_->dispatched();
         conn->execSql(std::move(cmd->sql_),
                       cmd->parametersNumber_,
                       std::move(cmd->parameters_),
@@ -398,7 +421,10 @@ DbConnectionPtr DbClientLockFree::newConnection()
     if (type_ == ClientType::PostgreSQL)
     {
 #if USE_POSTGRESQL
-        connPtr = std::make_shared<PgConnection>(loop_, connectionInfo_);
+        connPtr = std::make_shared<PgConnection>(loop_,
+                                                 connectionInfo_,
+                                                 nullptr,
+                                                 binaryResults_);
 #else
         return nullptr;
 #endif
@@ -488,7 +514,8 @@ void DbClientLockFree::execSqlWithTimeout(
     std::vector<int> &&length,
     std::vector<int> &&format,
     ResultCallback &&rcb,
-    std::function<void(const std::exception_ptr &)> &&ecb)
+    std::function<void(const std::exception_ptr &)> &&ecb,
+    std::shared_ptr<StatementCall> &&call)
 {
     auto commandPtr = std::make_shared<std::weak_ptr<SqlCmd>>();
     auto ecpPtr =
@@ -649,6 +676,7 @@ void DbClientLockFree::execSqlWithTimeout(
             }
         },
         std::move(exceptionCallback));
+    cmdPtr->statementCall_ = std::move(call);
     sqlCmdBuffer_.emplace_back(cmdPtr);
     *commandPtr = cmdPtr;
     timeoutFlagPtr->runTimer();
@@ -29,6 +29,9 @@ namespace drogon
 {
 namespace orm
 {
+class StatementStats;
+class StatementCall;
+
 class DbClientLockFree : public DbClient,
                          public std::enable_shared_from_this<DbClientLockFree>
 {
@@ -36,7 +39,8 @@ class DbClientLockFree : public DbClient,
     DbClientLockFree(const std::string &connInfo,
                      trantor::EventLoop *loop,
                      ClientType type,
-                     size_t connectionNumberPerLoop);
+                     size_t connectionNumberPerLoop,
+                     bool binaryResults = false);
     ~DbClientLockFree() noexcept override;
     void execSql(const char *sql,
                  size_t sqlLength,
@@ -54,6 +58,7 @@ class DbClientLockFree : public DbClient,
         const std::function<void(const std::shared_ptr<Transaction> &)>
             &callback) override;
     bool hasAvailableConnections() const noexcept override;
+    std::vector<StatementStat> statementStats() const override;
     void setTimeout(double timeout) override
     {
         timeout_ = timeout;
@@ -61,6 +66,7 @@ class DbClientLockFree : public DbClient,
 
   private:
     std::string connectionInfo_;
+    bool binaryResults_;
     trantor::EventLoop *loop_;
     DbConnectionPtr newConnection();
     const size_t numberOfConnections_;
@@ -68,6 +74,7 @@ class DbClientLockFree : public DbClient,
     std::vector<DbConnectionPtr> connectionHolders_;
     std::unordered_set<DbConnectionPtr> transSet_;
     std::deque<std::shared_ptr<SqlCmd>> sqlCmdBuffer_;
+    std::unique_ptr<StatementStats> statementStats_;
 
     std::list<std::shared_ptr<
         std::function<void(const std::shared_ptr<Transaction> &)>>>
@@ -86,7 +93,8 @@ class DbClientLockFree : public DbClient,
         std::vector<int> &&length,
         std::vector<int> &&format,
         ResultCallback &&rcb,
-        std::function<void(const std::exception_ptr &)> &&ecb);
+        std::function<void(const std::exception_ptr &)> &&ecb,
+        std::shared_ptr<StatementCall> &&call);
     void handleNewTask(const DbConnectionPtr &conn);
 #if LIBPQ_SUPPORTS_BATCH_MODE
     size_t connectionPos_{0};  // Used for pg batch mode.
@@ -13,7 +13,9 @@
  */
 
 #include "../../lib/src/DbClientManager.h"
+#include "DbClientImpl.h"
 #include "DbClientLockFree.h"
+#include "ReplicaDbClient.h"
 #include <drogon/config.h>
 #include <drogon/HttpAppFramework.h>
 #include <drogon/utils/Utilities.h>
@@ -42,6 +44,32 @@ inline std::string escapeConnString(const std::string &str)
     return escaped;
 }
 
+static std::string connectionString(const std::string &host,
+                                    const unsigned short port,
+                                    const std::string &databaseName,
+                                    const std::string &userName,
+                                    const std::string &password,
+                                    const std::string &characterSet)
+{
+    auto connStr =
+        utils::formattedString("host=%s port=%u dbname=%s user=%s",
+                               escapeConnString(host).c_str(),
+                               port,
+                               escapeConnString(databaseName).c_str(),
+                               escapeConnString(userName).c_str());
+    if (!password.empty())
+    {
+        connStr += " password=";
+        connStr += escapeConnString(password);
+    }
+    if (!characterSet.empty())
+    {
+        connStr += " client_encoding=";
+        connStr += escapeConnString(characterSet);
+    }
+    return connStr;
+}
+
 void DbClientManager::createDbClients(
     const std::vector<trantor::EventLoop *> &ioloops)
 {
@@ -71,7 +99,8 @@ void DbClientManager::createDbClients(
                             dbInfo.connectionInfo_,
                             ioloops[idx],
                             dbInfo.dbType_,
-                            dbInfo.connectionNumber_));
+                            dbInfo.connectionNumber_,
+                            dbInfo.binaryResults_));
                     if (dbInfo.timeout_ > 0.0)
                     {
                         c->setTimeout(dbInfo.timeout_);
@@ -84,44 +113,83 @@ void DbClientManager::createDbClients(
         }
         else
         {
-            if (dbInfo.dbType_ == drogon::orm::ClientType::PostgreSQL)
+            auto client = newDbClient(dbInfo, dbInfo.connectionInfo_, ioloops);
+            if (!client)
+                continue;
+            if (!dbInfo.replicaConnectionInfos_.empty())
             {
-#if USE_POSTGRESQL
-                dbClientsMap_[dbInfo.name_] =
-                    drogon::orm::DbClient::newPgClient(
-                        dbInfo.connectionInfo_, dbInfo.connectionNumber_);
-                if (dbInfo.timeout_ > 0.0)
+                std::vector<DbClientPtr> replicas;
+                for (auto &connectionInfo : dbInfo.replicaConnectionInfos_)
                 {
-                    dbClientsMap_[dbInfo.name_]->setTimeout(dbInfo.timeout_);
+                    replicas.push_back(
+                        newDbClient(dbInfo, connectionInfo, ioloops));
                 }
-#endif
+                auto readClient =
+                    std::make_shared<ReplicaDbClient>(client,
+                                                      std::move(replicas),
+                                                      dbInfo.maxReplicaLag_);
+                readClient->startHealthChecks(ioloops.back(), 1.0);
+                readDbClientsMap_[dbInfo.name_] = readClient;
+                if (dbInfo.routeReads_)
+                    client = std::move(readClient);
             }
-            else if (dbInfo.dbType_ == drogon::orm::ClientType::Mysql)
-            {
+            dbClientsMap_[dbInfo.name_] = std::move(client);
+        }
+    }
+}
+
+DbClientPtr DbClientManager::newDbClient(
+    const DbInfo &dbInfo,
+    const std::string &connectionInfo,
+    const std::vector<trantor::EventLoop *> &ioloops)
+{
+    DbClientPtr client;
+    if (dbInfo.loopAffinity_ ||
+        dbInfo.maxConnectionNumber_ > dbInfo.connectionNumber_)
+    {
+        std::vector<trantor::EventLoop *> loops;
+        if (dbInfo.loopAffinity_ &&
+            dbInfo.dbType_ != drogon::orm::ClientType::Sqlite3)
+        {
+            loops = ioloops;
+        }
+        auto clientImpl =
+            std::make_shared<DbClientImpl>(connectionInfo,
+                                           dbInfo.connectionNumber_,
+                                           dbInfo.dbType_,
+                                           std::move(loops),
+                                           dbInfo.maxConnectionNumber_,
+                                           dbInfo.binaryResults_);
+        clientImpl->init();
+        client = std::move(clientImpl);
+    }
+    else if (dbInfo.dbType_ == drogon::orm::ClientType::PostgreSQL)
+    {
+#if USE_POSTGRESQL
+        client = drogon::orm::DbClient::newPgClient(connectionInfo,
+                                                    dbInfo.connectionNumber_,
+                                                    dbInfo.binaryResults_);
+#endif
+    }
+    else if (dbInfo.dbType_ == drogon::orm::ClientType::Mysql)
+    {
 #if USE_MYSQL
-                dbClientsMap_[dbInfo.name_] =
-                    drogon::orm::DbClient::newMysqlClient(
-                        dbInfo.connectionInfo_, dbInfo.connectionNumber_);
-                if (dbInfo.timeout_ > 0.0)
-                {
-                    dbClientsMap_[dbInfo.name_]->setTimeout(dbInfo.timeout_);
-                }
+        client = drogon::orm::DbClient::newMysqlClient(
+            connectionInfo, dbInfo.connectionNumber_);
 #endif
-            }
-            else if (dbInfo.dbType_ == drogon::orm::ClientType::Sqlite3)
-            {
+    }
+    else if (dbInfo.dbType_ == drogon::orm::ClientType::Sqlite3)
+    {
 #if USE_SQLITE3
-                dbClientsMap_[dbInfo.name_] =
-                    drogon::orm::DbClient::newSqlite3Client(
-                        dbInfo.connectionInfo_, dbInfo.connectionNumber_);
-                if (dbInfo.timeout_ > 0.0)
-                {
-                    dbClientsMap_[dbInfo.name_]->setTimeout(dbInfo.timeout_);
-                }
+        client = drogon::orm::DbClient::newSqlite3Client(
+            connectionInfo, dbInfo.connectionNumber_);
 #endif
-            }
-        }
     }
+    if (client && dbInfo.timeout_ > 0.0)
+    {
+        client->setTimeout(dbInfo.timeout_);
+    }
+    return client;
 }
 
 void DbClientManager::createDbClient(const std::string &dbType,
@@ -139,30 +207,31 @@ void DbClientManager::createDbClient(const std::string &dbType,
                                      const std::string &name,
                                      const bool isFast,
                                      const std::string &characterSet,
-                                     double timeout)
+                                     double timeout,
+                                     const bool loopAffinity,
+                                     const size_t maxConnectionNum,
+                                     const bool binaryResults,
+                                     const bool routeReads,
+                                     const double maxReplicaLag,
+#if USE_SQLITE3
+                                     const std::string &journalMode)
+#else
+                                     const std::string &)
+#endif
 {
-    auto connStr =
-        utils::formattedString("host=%s port=%u dbname=%s user=%s",
-                               escapeConnString(host).c_str(),
-                               port,
-                               escapeConnString(databaseName).c_str(),
-                               escapeConnString(userName).c_str());
-    if (!password.empty())
-    {
-        connStr += " password=";
-        connStr += escapeConnString(password);
-    }
+    auto connStr = connectionString(
+        host, port, databaseName, userName, password, characterSet);
     std::string type = dbType;
     std::transform(type.begin(), type.end(), type.begin(), tolower);
-    if (!characterSet.empty())
-    {
-        connStr += " client_encoding=";
-        connStr += escapeConnString(characterSet);
-    }
     DbInfo info;
     info.connectionInfo_ = connStr;
     info.connectionNumber_ = connectionNum;
     info.isFast_ = isFast;
+    info.loopAffinity_ = loopAffinity;
+    info.maxConnectionNumber_ = maxConnectionNum;
+    info.binaryResults_ = binaryResults;
+    info.routeReads_ = routeReads;
+    info.maxReplicaLag_ = maxReplicaLag;
     info.name_ = name;
     info.timeout_ = timeout;
 
@@ -195,6 +264,8 @@ void DbClientManager::createDbClient(const std::string &dbType,
     {
 #if USE_SQLITE3
         std::string sqlite3ConnStr = "filename=" + filename;
+        if (!journalMode.empty())
+            sqlite3ConnStr += " journal_mode=" + journalMode;
         info.connectionInfo_ = sqlite3ConnStr;
         info.dbType_ = orm::ClientType::Sqlite3;
         dbInfos_.push_back(info);
@@ -208,6 +279,36 @@ void DbClientManager::createDbClient(const std::string &dbType,
     }
 }
 
+void DbClientManager::addDbReplica(const std::string &name,
+                                   const std::string &host,
+                                   const unsigned short port,
+                                   const std::string &databaseName,
+                                   const std::string &userName,
+                                   const std::string &password,
+                                   const std::string &characterSet)
+{
+    auto iter = std::find_if(dbInfos_.begin(),
+                             dbInfos_.end(),
+                             [&name](const DbInfo &info) {
+                                 return info.name_ == name;
+                             });
+    if (iter == dbInfos_.end())
+    {
+        LOG_ERROR << "No database client named " << name
+                  << " to add the replica to";
+        return;
+    }
+    if (iter->isFast_ || iter->dbType_ == orm::ClientType::Sqlite3)
+    {
+        LOG_ERROR << "Read replicas are not supported by fast clients and "
+                     "sqlite3, ignoring the replica of "
+                  << name;
+        return;
+    }
+    iter->replicaConnectionInfos_.push_back(connectionString(
+        host, port, databaseName, userName, password, characterSet));
+}
+
 bool DbClientManager::areAllDbClientsAvailable() const noexcept
 {
     for (auto const &pair : dbClientsMap_)
@@ -19,6 +19,7 @@
 #include <drogon/utils/string_view.h>
 #include <trantor/net/EventLoop.h>
 #include <trantor/utils/NonCopyable.h>
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -45,6 +46,8 @@ enum class ConnectStatus
     Bad
 };
 
+class StatementCall;
+
 struct SqlCmd
 {
     string_view sql_;
@@ -55,8 +58,16 @@ struct SqlCmd
     QueryCallback callback_;
     ExceptPtrCallback exceptionCallback_;
     std::string preparingStatement_;
+    // Told when a queued statement gets a connection, see StatementStats
+    std::shared_ptr<StatementCall> statementCall_;
+    // The statement is cancelled on the server if it runs past this
+    std::chrono::steady_clock::time_point deadline_{
+        std::chrono::steady_clock::time_point::max()};
 #if LIBPQ_SUPPORTS_BATCH_MODE
     bool isChanging_{false};
+    int resultFormat_{0};
+    // Learn from the result whether the statement can return binary results
+    bool checkResultFormat_{false};
 #endif
     SqlCmd(string_view &&sql,
            const size_t paraNum,
@@ -76,6 +87,17 @@ struct SqlCmd
     }
 };
 
+// A COPY statement with the callback that produces its rows (FROM STDIN) or
+// the one that consumes them (TO STDOUT)
+struct CopyCmd
+{
+    std::string sql_;
+    CopyInCallback producer_;
+    CopyOutCallback consumer_;
+    QueryCallback callback_;
+    ExceptPtrCallback exceptionCallback_;
+};
+
 class DbConnection;
 using DbConnectionPtr = std::shared_ptr<DbConnection>;
 class DbConnection : public trantor::NonCopyable
@@ -107,6 +129,23 @@ class DbConnection : public trantor::NonCopyable
         std::function<void(const std::exception_ptr &)> &&exceptCallback) = 0;
     virtual void batchSql(
         std::deque<std::shared_ptr<SqlCmd>> &&sqlCommands) = 0;
+    /// Run a statement with a deadline, connections that can't stop it on
+    /// the server run it like any other
+    virtual void execSqlCmd(std::shared_ptr<SqlCmd> &&cmd)
+    {
+        execSql(std::move(cmd->sql_),
+                cmd->parametersNumber_,
+                std::move(cmd->parameters_),
+                std::move(cmd->lengths_),
+                std::move(cmd->formats_),
+                std::move(cmd->callback_),
+                std::move(cmd->exceptionCallback_));
+    }
+    /// Run a COPY on the idle connection, only PostgreSQL connections can
+    virtual void copySql(std::shared_ptr<CopyCmd> &&)
+    {
+        assert(false);
+    }
     virtual ~DbConnection()
     {
         LOG_TRACE << "Destruct DbConn" << this;
@@ -0,0 +1,34 @@
+/**
+ *
+ *  @file DbListener.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include <drogon/config.h>
+#include <drogon/orm/DbListener.h>
+#include <trantor/utils/Logger.h>
+#if USE_POSTGRESQL
+#include "postgresql_impl/PgListener.h"
+#endif
+
+using namespace drogon::orm;
+
+DbListenerPtr DbListener::newPgListener(const std::string &connInfo,
+                                        trantor::EventLoop *loop)
+{
+#if USE_POSTGRESQL
+    auto listener = std::make_shared<PgListener>(connInfo, loop);
+    listener->init();
+    return listener;
+#else
+    LOG_FATAL << "PostgreSQL is not supported!";
+    exit(1);
+    (void)(connInfo);
+    (void)(loop);
+#endif
+}
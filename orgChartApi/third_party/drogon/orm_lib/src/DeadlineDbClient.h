@@ -0,0 +1,118 @@
+/**
+ *
+ *  @file DeadlineDbClient.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+/**
+ * @brief A client that forwards every statement to another client with a
+ * deadline, see DbClient::newDeadlineClient(). It is cheap enough to be
+ * made for every request.
+ */
+class DeadlineDbClient : public DbClient
+{
+  public:
+    DeadlineDbClient(DbClientPtr client,
+                     std::chrono::steady_clock::time_point deadline)
+        : client_(std::move(client)), deadline_(deadline)
+    {
+        type_ = client_->type();
+        connectionInfo_ = client_->connectionInfo();
+    }
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override
+    {
+        forwardSql(*client_,
+                   sql,
+                   sqlLength,
+                   paraNum,
+                   std::move(parameters),
+                   std::move(length),
+                   std::move(format),
+                   std::move(rcb),
+                   std::move(exceptCallback),
+                   deadline_);
+    }
+    void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline) override
+    {
+        forwardSql(*client_,
+                   sql,
+                   sqlLength,
+                   paraNum,
+                   std::move(parameters),
+                   std::move(length),
+                   std::move(format),
+                   std::move(rcb),
+                   std::move(exceptCallback),
+                   (std::min)(deadline, deadline_));
+    }
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback =
+            std::function<void(bool)>()) noexcept(false) override
+    {
+        return client_->newTransaction(commitCallback);
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        client_->newTransactionAsync(callback);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return client_->hasAvailableConnections();
+    }
+    DbClientStats stats() const override
+    {
+        return client_->stats();
+    }
+    std::vector<StatementStat> statementStats() const override
+    {
+        return client_->statementStats();
+    }
+    void setTimeout(double timeout) override
+    {
+        client_->setTimeout(timeout);
+    }
+
+  private:
+    DbClientPtr client_;
+    std::chrono::steady_clock::time_point deadline_;
+};
+
+}  // namespace orm
+}  // namespace drogon
@@ -12,10 +12,13 @@
  *
  */
 
+#include "postgresql_impl/PgBinaryFormat.h"
 #include <drogon/orm/Field.h>
 #include <drogon/utils/Utilities.h>
 #include <trantor/utils/Logger.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 using namespace drogon::orm;
 Field::Field(const Row &row, Row::SizeType columnNum) noexcept
@@ -89,6 +92,84 @@ const char *Field::c_str() const
 {
     return as<const char *>();
 }
+
+bool Field::binaryInteger(int64_t &value) const
+{
+    auto data = result_.getBinaryValue(row_, column_);
+    return data && pg_binary::readInteger(result_.oid(column_), data, value);
+}
+
+namespace
+{
+bool parseNumber(const char *&p, unsigned digits, int64_t &value)
+{
+    value = 0;
+    unsigned n = 0;
+    while (*p >= '0' && *p <= '9' && (digits == 0 || n < digits))
+    {
+        value = value * 10 + (*p++ - '0');
+        ++n;
+    }
+    return n > 0;
+}
+
+bool parseDateTime(const char *p, pg_binary::DateTime &dateTime)
+{
+    int64_t month, day, hour, minute, second;
+    if (!parseNumber(p, 0, dateTime.year) || *p++ != '-' ||
+        !parseNumber(p, 2, month) || *p++ != '-' || !parseNumber(p, 2, day))
+        return false;
+    dateTime.month = static_cast<unsigned>(month);
+    dateTime.day = static_cast<unsigned>(day);
+    if (*p != ' ' && *p != 'T')
+        return true;
+    ++p;
+    if (!parseNumber(p, 2, hour) || *p++ != ':' ||
+        !parseNumber(p, 2, minute) || *p++ != ':' ||
+        !parseNumber(p, 2, second))
+        return true;
+    dateTime.hour = static_cast<unsigned>(hour);
+    dateTime.minute = static_cast<unsigned>(minute);
+    dateTime.second = static_cast<unsigned>(second);
+    if (*p == '.')
+    {
+        ++p;
+        unsigned scale = 100000;
+        while (*p >= '0' && *p <= '9')
+        {
+            dateTime.microsecond += (*p++ - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+template <>
+trantor::Date Field::as<trantor::Date>() const
+{
+    if (isNull())
+        return trantor::Date();
+    pg_binary::DateTime dateTime;
+    auto data = result_.getBinaryValue(row_, column_);
+    if (data ? !pg_binary::readDateTime(result_.oid(column_), data, dateTime)
+             : !parseDateTime(result_.getValue(row_, column_), dateTime))
+    {
+        return trantor::Date();
+    }
+    // The same conversion the generated models did on the text
+    struct tm stm;
+    memset(&stm, 0, sizeof(stm));
+    stm.tm_year = static_cast<int>(dateTime.year - 1900);
+    stm.tm_mon = static_cast<int>(dateTime.month) - 1;
+    stm.tm_mday = static_cast<int>(dateTime.day);
+    stm.tm_hour = static_cast<int>(dateTime.hour);
+    stm.tm_min = static_cast<int>(dateTime.minute);
+    stm.tm_sec = static_cast<int>(dateTime.second);
+    time_t t = mktime(&stm);
+    return trantor::Date(static_cast<int64_t>(t) * 1000000 +
+                         dateTime.microsecond);
+}
 // template <>
 // std::vector<short> Field::as<std::vector<short>>() const
 // {
@@ -0,0 +1,308 @@
+/**
+ *
+ *  @file GroupCommitDbClient.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "GroupCommitDbClient.h"
+#include "TransactionImpl.h"
+#include <drogon/orm/Exception.h>
+#include <trantor/utils/Logger.h>
+#include <cctype>
+#include <cstring>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+// One name for all the savepoints, every statement releases its own before
+// the next one takes it
+const char kSavepoint[] = "savepoint drogon_group_commit";
+const char kRelease[] = "release savepoint drogon_group_commit";
+const char kRollback[] = "rollback to savepoint drogon_group_commit";
+}  // namespace
+
+GroupCommitDbClient::GroupCommitDbClient(DbClientPtr client,
+                                         double window,
+                                         size_t maxStatements)
+    : client_(std::move(client)),
+      window_(window),
+      maxStatements_(maxStatements > 0 ? maxStatements : 1),
+      loopThread_("GroupCommit")
+{
+    assert(client_);
+    type_ = client_->type();
+    connectionInfo_ = client_->connectionInfo();
+    loopThread_.run();
+}
+
+GroupCommitDbClient::~GroupCommitDbClient()
+{
+    std::shared_ptr<Group> group;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        group = std::move(pending_);
+    }
+    if (group)
+        commitGroup(std::move(group));
+}
+
+bool GroupCommitDbClient::isGroupable(const char *sql, size_t sqlLength)
+{
+    size_t pos = 0;
+    while (pos < sqlLength &&
+           (std::isspace(static_cast<unsigned char>(sql[pos])) ||
+            sql[pos] == '('))
+    {
+        ++pos;
+    }
+    for (auto keyword : {"insert", "update", "delete"})
+    {
+        auto length = strlen(keyword);
+        if (sqlLength - pos < length)
+            continue;
+        size_t i = 0;
+        while (i < length &&
+               std::tolower(static_cast<unsigned char>(sql[pos + i])) ==
+                   keyword[i])
+        {
+            ++i;
+        }
+        if (i == length &&
+            (pos + length == sqlLength ||
+             !std::isalnum(static_cast<unsigned char>(sql[pos + length]))))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GroupCommitDbClient::execSql(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    execSqlWithDeadline(sql,
+                        sqlLength,
+                        paraNum,
+                        std::move(parameters),
+                        std::move(length),
+                        std::move(format),
+                        std::move(rcb),
+                        std::move(exceptCallback),
+                        std::chrono::steady_clock::time_point::max());
+}
+
+void GroupCommitDbClient::execSqlWithDeadline(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    if (!isGroupable(sql, sqlLength))
+    {
+        forwardSql(*client_,
+                   sql,
+                   sqlLength,
+                   paraNum,
+                   std::move(parameters),
+                   std::move(length),
+                   std::move(format),
+                   std::move(rcb),
+                   std::move(exceptCallback),
+                   deadline);
+        return;
+    }
+    // A group isn't cut short for the deadline of one of its statements
+    if (deadline <= std::chrono::steady_clock::now())
+    {
+        exceptCallback(std::make_exception_ptr(
+            TimeoutError("Deadline exceeded before the SQL was sent")));
+        return;
+    }
+    auto statement = std::make_shared<Statement>();
+    statement->sql_ = sql;
+    statement->sqlLength_ = sqlLength;
+    statement->paraNum_ = paraNum;
+    statement->parameters_ = std::move(parameters);
+    statement->lengths_ = std::move(length);
+    statement->formats_ = std::move(format);
+    statement->resultCallback_ = std::move(rcb);
+    statement->exceptionCallback_ = std::move(exceptCallback);
+    enqueue(std::move(statement));
+}
+
+void GroupCommitDbClient::enqueue(std::shared_ptr<Statement> &&statement)
+{
+    std::shared_ptr<Group> full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pending_)
+        {
+            pending_ = std::make_shared<Group>();
+            pending_->reserve(maxStatements_);
+            std::weak_ptr<GroupCommitDbClient> weakPtr = shared_from_this();
+            loopThread_.getLoop()->runAfter(
+                window_, [weakPtr, groupId = groupId_]() {
+                    if (auto thisPtr = weakPtr.lock())
+                        thisPtr->flush(groupId);
+                });
+        }
+        pending_->push_back(std::move(statement));
+        if (pending_->size() >= maxStatements_)
+        {
+            full = std::move(pending_);
+            ++groupId_;
+        }
+    }
+    if (full)
+        commitGroup(std::move(full));
+}
+
+void GroupCommitDbClient::flush(uint64_t groupId)
+{
+    std::shared_ptr<Group> group;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The group was full before its window ended
+        if (!pending_ || groupId != groupId_)
+            return;
+        group = std::move(pending_);
+        ++groupId_;
+    }
+    commitGroup(std::move(group));
+}
+
+void GroupCommitDbClient::commitGroup(std::shared_ptr<Group> &&group)
+{
+    LOG_TRACE << "Commit a group of " << group->size() << " statements";
+    client_->newTransactionAsync(
+        [client = client_,
+         group](const std::shared_ptr<Transaction> &transaction) {
+            if (!transaction)
+            {
+                failGroup(*group,
+                          std::make_exception_ptr(Failure(
+                              "No transaction for the group of statements")));
+                return;
+            }
+            auto trans =
+                std::dynamic_pointer_cast<TransactionImpl>(transaction);
+            if (!trans)
+            {
+                // Can't keep it open past a failed statement, run them one by
+                // one instead
+                for (auto &statement : *group)
+                {
+                    forwardSql(*client,
+                               statement->sql_,
+                               statement->sqlLength_,
+                               statement->paraNum_,
+                               std::move(statement->parameters_),
+                               std::move(statement->lengths_),
+                               std::move(statement->formats_),
+                               std::move(statement->resultCallback_),
+                               std::move(statement->exceptionCallback_),
+                               std::chrono::steady_clock::time_point::max());
+                }
+                return;
+            }
+            trans->setRollbackOnError(false);
+            trans->setCommitCallback([group](bool committed) {
+                auto err = std::make_exception_ptr(
+                    Failure("The transaction of the group failed to commit"));
+                for (auto &statement : *group)
+                {
+                    // The failed statements were told already
+                    if (!statement->result_)
+                        continue;
+                    if (committed)
+                        statement->resultCallback_(*statement->result_);
+                    else
+                        statement->exceptionCallback_(err);
+                }
+            });
+            runStatement(trans, group, 0);
+        });
+}
+
+void GroupCommitDbClient::runStatement(
+    const std::shared_ptr<TransactionImpl> &trans,
+    const std::shared_ptr<Group> &group,
+    size_t index)
+{
+    // After the last statement the transaction commits as soon as the
+    // callbacks drop it
+    if (index == group->size())
+        return;
+    auto &statement = (*group)[index];
+    // A failure of the savepoint commands leaves the transaction unusable,
+    // everything is rolled back
+    auto abort = [trans, group](const DrogonDbException &e) {
+        LOG_ERROR << "Group commit failed: " << e.base().what();
+        trans->rollback();
+        failGroup(*group, std::current_exception());
+    };
+    trans->execSqlAsync(
+        kSavepoint, [](const Result &) {}, abort);
+    forwardSql(
+        *trans,
+        statement->sql_,
+        statement->sqlLength_,
+        statement->paraNum_,
+        std::move(statement->parameters_),
+        std::move(statement->lengths_),
+        std::move(statement->formats_),
+        [trans, group, index, abort](const Result &result) {
+            (*group)[index]->result_ = std::make_shared<Result>(result);
+            trans->execSqlAsync(
+                kRelease, [](const Result &) {}, abort);
+            runStatement(trans, group, index + 1);
+        },
+        [trans, group, index, abort](const std::exception_ptr &err) {
+            auto &statement = (*group)[index];
+            // Nothing left to do once the group was rolled back
+            if (!statement->exceptionCallback_)
+                return;
+            auto exceptionCallback = std::move(statement->exceptionCallback_);
+            statement->exceptionCallback_ = nullptr;
+            exceptionCallback(err);
+            trans->execSqlAsync(
+                kRollback, [](const Result &) {}, abort);
+            trans->execSqlAsync(
+                kRelease, [](const Result &) {}, abort);
+            runStatement(trans, group, index + 1);
+        },
+        std::chrono::steady_clock::time_point::max());
+}
+
+void GroupCommitDbClient::failGroup(const Group &group,
+                                    const std::exception_ptr &err)
+{
+    for (auto &statement : group)
+    {
+        if (!statement->exceptionCallback_)
+            continue;
+        auto exceptionCallback = std::move(statement->exceptionCallback_);
+        statement->exceptionCallback_ = nullptr;
+        statement->result_.reset();
+        exceptionCallback(err);
+    }
+}
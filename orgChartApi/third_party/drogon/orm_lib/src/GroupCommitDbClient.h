@@ -0,0 +1,128 @@
+/**
+ *
+ *  @file GroupCommitDbClient.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+class TransactionImpl;
+
+/**
+ * @brief A client that commits the INSERT, UPDATE and DELETE statements
+ * arriving within a short window together, see
+ * DbClient::newGroupCommitClient().
+ */
+class GroupCommitDbClient
+    : public DbClient,
+      public std::enable_shared_from_this<GroupCommitDbClient>
+{
+  public:
+    GroupCommitDbClient(DbClientPtr client,
+                        double window,
+                        size_t maxStatements);
+    ~GroupCommitDbClient() override;
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override;
+    void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline) override;
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback =
+            std::function<void(bool)>()) noexcept(false) override
+    {
+        return client_->newTransaction(commitCallback);
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        client_->newTransactionAsync(callback);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return client_->hasAvailableConnections();
+    }
+    DbClientStats stats() const override
+    {
+        return client_->stats();
+    }
+    std::vector<StatementStat> statementStats() const override
+    {
+        return client_->statementStats();
+    }
+    void setTimeout(double timeout) override
+    {
+        client_->setTimeout(timeout);
+    }
+
+    /// Only statements starting with INSERT, UPDATE or DELETE are grouped.
+    static bool isGroupable(const char *sql, size_t sqlLength);
+
+  private:
+    struct Statement
+    {
+        const char *sql_;
+        size_t sqlLength_;
+        size_t paraNum_;
+        std::vector<const char *> parameters_;
+        std::vector<int> lengths_;
+        std::vector<int> formats_;
+        // Holds the memory of the SQL and its parameters
+        ResultCallback resultCallback_;
+        std::function<void(const std::exception_ptr &)> exceptionCallback_;
+        std::shared_ptr<Result> result_;
+    };
+    using Group = std::vector<std::shared_ptr<Statement>>;
+
+    void enqueue(std::shared_ptr<Statement> &&statement);
+    void flush(uint64_t groupId);
+    void commitGroup(std::shared_ptr<Group> &&group);
+    static void runStatement(const std::shared_ptr<TransactionImpl> &trans,
+                             const std::shared_ptr<Group> &group,
+                             size_t index);
+    static void failGroup(const Group &group, const std::exception_ptr &err);
+
+    DbClientPtr client_;
+    double window_;
+    size_t maxStatements_;
+    trantor::EventLoopThread loopThread_;
+    std::mutex mutex_;
+    std::shared_ptr<Group> pending_;
+    uint64_t groupId_{0};
+};
+
+}  // namespace orm
+}  // namespace drogon
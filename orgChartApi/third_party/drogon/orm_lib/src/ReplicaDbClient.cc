@@ -0,0 +1,286 @@
+/**
+ *
+ *  @file ReplicaDbClient.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "ReplicaDbClient.h"
+#include "SingleFlightDbClient.h"
+#include "StatementStats.h"
+#include <drogon/orm/Exception.h>
+#include <trantor/utils/Logger.h>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+// Zero while the replica has replayed all it received, otherwise the age of
+// the last transaction it replayed
+const char kReplayLagSql[] =
+    "select case when pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() "
+    "then 0 else coalesce(extract(epoch from now() - "
+    "pg_last_xact_replay_timestamp()), 0) end";
+}  // namespace
+
+ReplicaDbClient::ReplicaDbClient(DbClientPtr primary,
+                                 std::vector<DbClientPtr> replicas,
+                                 double maxLag)
+    : primary_(std::move(primary)),
+      replicas_(std::move(replicas)),
+      maxLag_(maxLag),
+      states_(new ReplicaState[replicas_.size()])
+{
+    assert(primary_);
+    type_ = primary_->type();
+    connectionInfo_ = primary_->connectionInfo();
+    // The lag of PostgreSQL replicas is unknown until the first check
+    for (size_t i = 0; i < replicas_.size(); ++i)
+    {
+        states_[i].healthy_ = type_ != ClientType::PostgreSQL;
+    }
+}
+
+void ReplicaDbClient::setTimeout(double timeout)
+{
+    primary_->setTimeout(timeout);
+    for (auto &replica : replicas_)
+    {
+        replica->setTimeout(timeout);
+    }
+}
+
+std::vector<StatementStat> ReplicaDbClient::statementStats() const
+{
+    auto stats = primary_->statementStats();
+    for (auto &replica : replicas_)
+    {
+        StatementStats::merge(stats, replica->statementStats());
+    }
+    return stats;
+}
+
+DbClientPtr ReplicaDbClient::pickReplica()
+{
+    for (size_t i = 0; i < replicas_.size(); ++i)
+    {
+        auto index =
+            next_.fetch_add(1, std::memory_order_relaxed) % replicas_.size();
+        if (states_[index].healthy_.load(std::memory_order_acquire) &&
+            replicas_[index]->hasAvailableConnections())
+        {
+            return replicas_[index];
+        }
+    }
+    return nullptr;
+}
+
+void ReplicaDbClient::execSql(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    routeSql(sql,
+             sqlLength,
+             paraNum,
+             std::move(parameters),
+             std::move(length),
+             std::move(format),
+             std::move(rcb),
+             std::move(exceptCallback),
+             std::chrono::steady_clock::time_point::max());
+}
+
+void ReplicaDbClient::execSqlWithDeadline(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    routeSql(sql,
+             sqlLength,
+             paraNum,
+             std::move(parameters),
+             std::move(length),
+             std::move(format),
+             std::move(rcb),
+             std::move(exceptCallback),
+             deadline);
+}
+
+void ReplicaDbClient::routeSql(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    DbClientPtr replica;
+    if (!replicas_.empty() &&
+        SingleFlightDbClient::isCoalescable(sql, sqlLength))
+    {
+        replica = pickReplica();
+    }
+    if (!replica)
+    {
+        forwardSql(*primary_,
+                   sql,
+                   sqlLength,
+                   paraNum,
+                   std::move(parameters),
+                   std::move(length),
+                   std::move(format),
+                   std::move(rcb),
+                   std::move(exceptCallback),
+                   deadline);
+        return;
+    }
+
+    // The callbacks own the SQL text and the parameters, they are kept
+    // alive to run the query again on the primary if the replica fails.
+    struct Retry
+    {
+        ResultCallback resultCallback_;
+        std::function<void(const std::exception_ptr &)> exceptionCallback_;
+        std::vector<const char *> parameters_;
+        std::vector<int> lengths_;
+        std::vector<int> formats_;
+    };
+    auto retry = std::make_shared<Retry>(Retry{std::move(rcb),
+                                               std::move(exceptCallback),
+                                               parameters,
+                                               length,
+                                               format});
+    std::weak_ptr<ReplicaDbClient> weakPtr = shared_from_this();
+    forwardSql(
+        *replica,
+        sql,
+        sqlLength,
+        paraNum,
+        std::move(parameters),
+        std::move(length),
+        std::move(format),
+        [retry](const Result &result) { retry->resultCallback_(result); },
+        [weakPtr, retry, sql, sqlLength, paraNum, deadline](
+            const std::exception_ptr &exception) {
+            auto thisPtr = weakPtr.lock();
+            if (thisPtr)
+            {
+                try
+                {
+                    std::rethrow_exception(exception);
+                }
+                catch (const BrokenConnection &)
+                {
+                    LOG_WARN << "Read replica connection broken, running the "
+                                "query on the primary";
+                    forwardSql(
+                        *thisPtr->primary_,
+                        sql,
+                        sqlLength,
+                        paraNum,
+                        std::move(retry->parameters_),
+                        std::move(retry->lengths_),
+                        std::move(retry->formats_),
+                        [retry](const Result &result) {
+                            retry->resultCallback_(result);
+                        },
+                        [retry](const std::exception_ptr &exception) {
+                            retry->exceptionCallback_(exception);
+                        },
+                        deadline);
+                    return;
+                }
+                catch (...)
+                {
+                }
+            }
+            retry->exceptionCallback_(exception);
+        },
+        deadline);
+}
+
+void ReplicaDbClient::startHealthChecks(trantor::EventLoop *loop,
+                                        double interval)
+{
+    if (type_ != ClientType::PostgreSQL)
+        return;
+    std::weak_ptr<ReplicaDbClient> weakPtr = shared_from_this();
+    loop->queueInLoop([weakPtr]() {
+        if (auto thisPtr = weakPtr.lock())
+            thisPtr->checkReplicas();
+    });
+    loop->runEvery(interval, [weakPtr]() {
+        if (auto thisPtr = weakPtr.lock())
+            thisPtr->checkReplicas();
+    });
+}
+
+void ReplicaDbClient::checkReplicas()
+{
+    std::weak_ptr<ReplicaDbClient> weakPtr = shared_from_this();
+    for (size_t i = 0; i < replicas_.size(); ++i)
+    {
+        // A replica that didn't answer the last check is still being checked
+        if (states_[i].checking_.exchange(true))
+            continue;
+        *replicas_[i] << kReplayLagSql >> [weakPtr, i](const Result &result) {
+            if (auto thisPtr = weakPtr.lock())
+            {
+                double lag = 0;
+                if (!result.empty() && !result[0][0].isNull())
+                    lag = result[0][0].as<double>();
+                thisPtr->updateReplica(i, true, lag);
+                thisPtr->states_[i].checking_ = false;
+            }
+        } >> [weakPtr, i](const DrogonDbException &) {
+            if (auto thisPtr = weakPtr.lock())
+            {
+                thisPtr->updateReplica(i, false, 0);
+                thisPtr->states_[i].checking_ = false;
+            }
+        };
+    }
+}
+
+void ReplicaDbClient::updateReplica(size_t index, bool reachable, double lag)
+{
+    assert(index < replicas_.size());
+    bool healthy = reachable && lag <= maxLag_;
+    if (states_[index].healthy_.exchange(healthy) == healthy)
+        return;
+    if (healthy)
+    {
+        LOG_INFO << "Read replica " << index << " is back, lag " << lag
+                 << "s";
+    }
+    else if (reachable)
+    {
+        LOG_WARN << "Read replica " << index << " lags " << lag
+                 << "s, reading from the primary instead";
+    }
+    else
+    {
+        LOG_WARN << "Read replica " << index
+                 << " is unreachable, reading from the primary instead";
+    }
+}
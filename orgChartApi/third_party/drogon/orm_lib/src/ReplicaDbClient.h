@@ -0,0 +1,122 @@
+/**
+ *
+ *  @file ReplicaDbClient.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoop.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+/**
+ * @brief A client over a primary database and its read replicas. Statements
+ * that only read (see SingleFlightDbClient::isCoalescable()) go to a healthy
+ * replica, picked round-robin; everything else, transactions included, goes
+ * to the primary.
+ *
+ * A replica is healthy while it has a connection and, for PostgreSQL, the
+ * replay lag found by the last checkReplicas() is at most maxLag seconds.
+ * Reads fall back to the primary when no replica is healthy, or when the
+ * connection of the chosen replica breaks before it answers.
+ */
+class ReplicaDbClient : public DbClient,
+                        public std::enable_shared_from_this<ReplicaDbClient>
+{
+  public:
+    ReplicaDbClient(DbClientPtr primary,
+                    std::vector<DbClientPtr> replicas,
+                    double maxLag);
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override;
+    void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline) override;
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback =
+            std::function<void(bool)>()) noexcept(false) override
+    {
+        return primary_->newTransaction(commitCallback);
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        primary_->newTransactionAsync(callback);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return primary_->hasAvailableConnections();
+    }
+    /// The stats of the primary
+    DbClientStats stats() const override
+    {
+        return primary_->stats();
+    }
+    /// The statements of the primary and the replicas together
+    std::vector<StatementStat> statementStats() const override;
+    void setTimeout(double timeout) override;
+
+    /// Check the replicas every interval seconds on the loop
+    void startHealthChecks(trantor::EventLoop *loop, double interval);
+    /// Query the replay lag of every PostgreSQL replica
+    void checkReplicas();
+    /// Record the outcome of a health check of a replica
+    void updateReplica(size_t index, bool reachable, double lag);
+
+  private:
+    struct ReplicaState
+    {
+        std::atomic<bool> healthy_{false};
+        std::atomic<bool> checking_{false};
+    };
+    DbClientPtr pickReplica();
+    void routeSql(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline);
+
+    DbClientPtr primary_;
+    std::vector<DbClientPtr> replicas_;
+    double maxLag_;
+    std::unique_ptr<ReplicaState[]> states_;
+    std::atomic<size_t> next_{0};
+};
+
+}  // namespace orm
+}  // namespace drogon
@@ -165,6 +165,12 @@ Result::FieldSizeType Result::getLength(Result::SizeType row,
     return resultPtr_->getLength(row, column);
 }
 
+const char *Result::getBinaryValue(Result::SizeType row,
+                                   Result::RowSizeType column) const
+{
+    return resultPtr_->getBinaryValue(row, column);
+}
+
 unsigned long long Result::insertId() const noexcept
 {
     return resultPtr_->insertId();
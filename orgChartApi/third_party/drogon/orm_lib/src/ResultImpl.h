@@ -45,6 +45,16 @@ class ResultImpl : public trantor::NonCopyable
         (void)column;
         return 0;
     }
+    /**
+     * The value of a column the database sent in binary format, nullptr for
+     * columns in text format. getValue() returns the text even then.
+     */
+    virtual const char *getBinaryValue(SizeType row, RowSizeType column) const
+    {
+        (void)row;
+        (void)column;
+        return nullptr;
+    }
     virtual ~ResultImpl()
     {
     }
@@ -0,0 +1,150 @@
+/**
+ *
+ *  @file RowStream.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+// Only one stream runs in a transaction at a time, so the name is fixed and
+// the statements below stay prepared on the connection
+const char kCursorName[] = "drogon_row_stream";
+
+struct StreamCallbacks
+{
+    RowChunkCallback chunkCallback_;
+    std::function<void()> finishCallback_;
+    ExceptionCallback exceptionCallback_;
+};
+
+// Fetches the rows of the cursor one chunk after the consumer took the last
+class RowStream : public std::enable_shared_from_this<RowStream>
+{
+  public:
+    RowStream(std::shared_ptr<Transaction> transaction,
+              size_t chunkRows,
+              std::shared_ptr<StreamCallbacks> callbacks)
+        : transaction_(std::move(transaction)),
+          fetchSql_("fetch forward " + std::to_string(chunkRows) + " from " +
+                    kCursorName),
+          chunkRows_(chunkRows),
+          callbacks_(std::move(callbacks))
+    {
+    }
+    void fetch()
+    {
+        auto thisPtr = shared_from_this();
+        *transaction_ << fetchSql_ >> [thisPtr](const Result &result) {
+            thisPtr->deliver(result);
+        } >> [thisPtr](const DrogonDbException &e) {
+            thisPtr->callbacks_->exceptionCallback_(e);
+        };
+    }
+
+  private:
+    void deliver(const Result &result)
+    {
+        if (result.empty())
+        {
+            finish();
+            return;
+        }
+        // A short chunk is the last one, the cursor needn't be asked again
+        bool last = result.size() < chunkRows_;
+        auto thisPtr = shared_from_this();
+        callbacks_->chunkCallback_(result, [thisPtr, last](bool more) {
+            if (more && !last)
+                thisPtr->fetch();
+            else
+                thisPtr->finish();
+        });
+    }
+    void finish()
+    {
+        // The transaction commits once the last reference to it goes, but
+        // a transaction of the caller lives on without the cursor
+        auto thisPtr = shared_from_this();
+        *transaction_ << std::string("close ") + kCursorName >>
+            [thisPtr](const Result &) {
+                thisPtr->callbacks_->finishCallback_();
+            } >>
+            [thisPtr](const DrogonDbException &e) {
+                thisPtr->callbacks_->exceptionCallback_(e);
+            };
+    }
+
+    std::shared_ptr<Transaction> transaction_;
+    std::string fetchSql_;
+    size_t chunkRows_;
+    std::shared_ptr<StreamCallbacks> callbacks_;
+};
+}  // namespace
+
+void DbClient::streamSql(const std::string &sql,
+                         size_t chunkRows,
+                         std::function<void(internal::SqlBinder &)> &&bind,
+                         RowChunkCallback &&chunkCallback,
+                         std::function<void()> &&finishCallback,
+                         ExceptionCallback &&exceptCallback)
+{
+    auto callbacks = std::make_shared<StreamCallbacks>(
+        StreamCallbacks{std::move(chunkCallback),
+                        std::move(finishCallback),
+                        std::move(exceptCallback)});
+    if (type_ != ClientType::PostgreSQL)
+    {
+        auto binder = *this << sql;
+        bind(binder);
+        binder >> [callbacks](const Result &result) {
+            if (result.empty())
+            {
+                callbacks->finishCallback_();
+                return;
+            }
+            callbacks->chunkCallback_(result, [callbacks](bool) {
+                callbacks->finishCallback_();
+            });
+        } >> [callbacks](const DrogonDbException &e) {
+            callbacks->exceptionCallback_(e);
+        };
+        return;
+    }
+
+    chunkRows = (std::max)(chunkRows, size_t(1));
+    auto declareSql =
+        std::string("declare ") + kCursorName + " no scroll cursor for " + sql;
+    newTransactionAsync([callbacks,
+                         chunkRows,
+                         declareSql = std::move(declareSql),
+                         bind = std::move(bind)](
+                            const std::shared_ptr<Transaction> &transaction) {
+        if (!transaction)
+        {
+            callbacks->exceptionCallback_(TimeoutError(
+                "Timeout, no connection available for the row stream"));
+            return;
+        }
+        auto stream =
+            std::make_shared<RowStream>(transaction, chunkRows, callbacks);
+        auto binder = *transaction << declareSql;
+        bind(binder);
+        binder >> [stream](const Result &) { stream->fetch(); } >>
+            [callbacks](const DrogonDbException &e) {
+                callbacks->exceptionCallback_(e);
+            };
+    });
+}
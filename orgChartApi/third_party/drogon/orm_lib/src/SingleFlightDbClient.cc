@@ -0,0 +1,229 @@
+/**
+ *
+ *  @file SingleFlightDbClient.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "SingleFlightDbClient.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+SingleFlightDbClient::SingleFlightDbClient(DbClientPtr client)
+    : client_(std::move(client))
+{
+    assert(client_);
+    type_ = client_->type();
+    connectionInfo_ = client_->connectionInfo();
+}
+
+bool SingleFlightDbClient::isCoalescable(const char *sql, size_t sqlLength)
+{
+    std::string lower(sql, sqlLength);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+        return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    });
+    auto pos = lower.find_first_not_of(" \t\r\n(");
+    if (pos == std::string::npos || lower.compare(pos, 6, "select") != 0)
+        return false;
+    for (auto keyword : {" for update",
+                         " for no key update",
+                         " for share",
+                         " for key share",
+                         "nextval(",
+                         "setval(",
+                         " into "})
+    {
+        if (lower.find(keyword) != std::string::npos)
+            return false;
+    }
+    return true;
+}
+
+bool SingleFlightDbClient::makeKey(const char *sql,
+                                   size_t sqlLength,
+                                   const std::vector<const char *> &parameters,
+                                   const std::vector<int> &length,
+                                   const std::vector<int> &format,
+                                   std::string &key) const
+{
+    key.assign(sql, sqlLength);
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        size_t size = static_cast<size_t>(length[i]);
+        if (parameters[i] == nullptr)
+        {
+            key.append("\0N", 2);
+            continue;
+        }
+        if (size == 0 && type_ == ClientType::Sqlite3)
+        {
+            switch (format[i])
+            {
+                case Sqlite3TypeChar:
+                    size = 1;
+                    break;
+                case Sqlite3TypeShort:
+                    size = 2;
+                    break;
+                case Sqlite3TypeInt:
+                    size = 4;
+                    break;
+                case Sqlite3TypeInt64:
+                case Sqlite3TypeDouble:
+                    size = 8;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (size == 0 && type_ == ClientType::Mysql)
+        {
+            // Integral MySQL parameters carry their size in the format field
+            // only, don't guess.
+            return false;
+        }
+        key.append("\0P", 2);
+        key.append(reinterpret_cast<const char *>(&format[i]),
+                   sizeof(format[i]));
+        key.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        key.append(parameters[i], size);
+    }
+    return true;
+}
+
+std::vector<SingleFlightDbClient::Waiter> SingleFlightDbClient::takeWaiters(
+    const std::string &key,
+    const FlightPtr &flight)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = inflight_.find(key);
+    if (iter != inflight_.end() && iter->second == flight)
+    {
+        inflight_.erase(iter);
+    }
+    return std::move(flight->waiters_);
+}
+
+void SingleFlightDbClient::execSql(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    coalesceSql(sql,
+                sqlLength,
+                paraNum,
+                std::move(parameters),
+                std::move(length),
+                std::move(format),
+                std::move(rcb),
+                std::move(exceptCallback),
+                std::chrono::steady_clock::time_point::max());
+}
+
+void SingleFlightDbClient::execSqlWithDeadline(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    coalesceSql(sql,
+                sqlLength,
+                paraNum,
+                std::move(parameters),
+                std::move(length),
+                std::move(format),
+                std::move(rcb),
+                std::move(exceptCallback),
+                deadline);
+}
+
+void SingleFlightDbClient::coalesceSql(
+    const char *sql,
+    size_t sqlLength,
+    size_t paraNum,
+    std::vector<const char *> &&parameters,
+    std::vector<int> &&length,
+    std::vector<int> &&format,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback,
+    std::chrono::steady_clock::time_point deadline)
+{
+    std::string key;
+    if (!isCoalescable(sql, sqlLength) ||
+        !makeKey(sql, sqlLength, parameters, length, format, key))
+    {
+        forwardSql(*client_,
+                   sql,
+                   sqlLength,
+                   paraNum,
+                   std::move(parameters),
+                   std::move(length),
+                   std::move(format),
+                   std::move(rcb),
+                   std::move(exceptCallback),
+                   deadline);
+        return;
+    }
+    auto flight = std::make_shared<Flight>();
+    flight->deadline_ = deadline;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto &current = inflight_[key];
+        if (current && current->deadline_ >= deadline)
+        {
+            // An identical query is running and may take as long as this
+            // caller allows, wait for its result.
+            current->waiters_.push_back(
+                Waiter{std::move(rcb), std::move(exceptCallback)});
+            return;
+        }
+        // Otherwise this query takes over for the callers to come, the
+        // running one keeps its own waiters
+        flight->waiters_.push_back(
+            Waiter{std::move(rcb), std::move(exceptCallback)});
+        current = flight;
+    }
+    // The first caller's callbacks keep the SQL and parameter buffers alive
+    // until the result arrives, so they can be passed on as they are.
+    auto thisPtr = shared_from_this();
+    forwardSql(
+        *client_,
+        sql,
+        sqlLength,
+        paraNum,
+        std::move(parameters),
+        std::move(length),
+        std::move(format),
+        [thisPtr, key, flight](const Result &r) {
+            for (auto &waiter : thisPtr->takeWaiters(key, flight))
+            {
+                waiter.resultCallback_(r);
+            }
+        },
+        [thisPtr, key, flight](const std::exception_ptr &exception) {
+            for (auto &waiter : thisPtr->takeWaiters(key, flight))
+            {
+                waiter.exceptionCallback_(exception);
+            }
+        },
+        deadline);
+}
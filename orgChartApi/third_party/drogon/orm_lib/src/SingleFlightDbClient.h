@@ -0,0 +1,132 @@
+/**
+ *
+ *  @file SingleFlightDbClient.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+/**
+ * @brief A client that forwards everything to another client, except that
+ * identical read-only queries (same SQL text and parameters) issued while one
+ * of them is still in flight are executed only once. Every caller receives
+ * the same Result or exception. A caller only joins a query whose deadline is
+ * not earlier than its own, so a short deadline can't fail the reads of other
+ * callers.
+ */
+class SingleFlightDbClient
+    : public DbClient,
+      public std::enable_shared_from_this<SingleFlightDbClient>
+{
+  public:
+    explicit SingleFlightDbClient(DbClientPtr client);
+    void execSql(const char *sql,
+                 size_t sqlLength,
+                 size_t paraNum,
+                 std::vector<const char *> &&parameters,
+                 std::vector<int> &&length,
+                 std::vector<int> &&format,
+                 ResultCallback &&rcb,
+                 std::function<void(const std::exception_ptr &)>
+                     &&exceptCallback) override;
+    void execSqlWithDeadline(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline) override;
+    std::shared_ptr<Transaction> newTransaction(
+        const std::function<void(bool)> &commitCallback =
+            std::function<void(bool)>()) noexcept(false) override
+    {
+        return client_->newTransaction(commitCallback);
+    }
+    void newTransactionAsync(
+        const std::function<void(const std::shared_ptr<Transaction> &)>
+            &callback) override
+    {
+        client_->newTransactionAsync(callback);
+    }
+    bool hasAvailableConnections() const noexcept override
+    {
+        return client_->hasAvailableConnections();
+    }
+    DbClientStats stats() const override
+    {
+        return client_->stats();
+    }
+    std::vector<StatementStat> statementStats() const override
+    {
+        return client_->statementStats();
+    }
+    void setTimeout(double timeout) override
+    {
+        client_->setTimeout(timeout);
+    }
+
+    /// Only plain SELECT statements without locking clauses or sequence
+    /// functions are coalesced.
+    static bool isCoalescable(const char *sql, size_t sqlLength);
+
+  private:
+    struct Waiter
+    {
+        ResultCallback resultCallback_;
+        std::function<void(const std::exception_ptr &)> exceptionCallback_;
+    };
+    // A query in flight and the callers waiting for it
+    struct Flight
+    {
+        std::chrono::steady_clock::time_point deadline_;
+        std::vector<Waiter> waiters_;
+    };
+    using FlightPtr = std::shared_ptr<Flight>;
+    void coalesceSql(
+        const char *sql,
+        size_t sqlLength,
+        size_t paraNum,
+        std::vector<const char *> &&parameters,
+        std::vector<int> &&length,
+        std::vector<int> &&format,
+        ResultCallback &&rcb,
+        std::function<void(const std::exception_ptr &)> &&exceptCallback,
+        std::chrono::steady_clock::time_point deadline);
+    bool makeKey(const char *sql,
+                 size_t sqlLength,
+                 const std::vector<const char *> &parameters,
+                 const std::vector<int> &length,
+                 const std::vector<int> &format,
+                 std::string &key) const;
+    std::vector<Waiter> takeWaiters(const std::string &key,
+                                    const FlightPtr &flight);
+
+    DbClientPtr client_;
+    std::mutex mutex_;
+    // The flight new callers join for each key, an earlier one may still run
+    std::unordered_map<std::string, FlightPtr> inflight_;
+};
+
+}  // namespace orm
+}  // namespace drogon
@@ -40,9 +40,9 @@ void SqlBinder::exec()
             std::move(lengths_),
             std::move(formats_),
             [holder = std::move(callbackHolder_),
-             objs = std::move(objs_),
+             storage = std::move(storage_),
              sqlptr = std::move(sqlPtr_)](const Result &r) mutable {
-                objs.clear();
+                storage.reset();
                 if (holder)
                 {
                     holder->execCallback(r);
@@ -133,71 +133,69 @@ SqlBinder::~SqlBinder()
     }
 }
 
-SqlBinder &SqlBinder::operator<<(const std::string &str)
+void SqlBinder::addText(const char *text, size_t length)
 {
-    std::shared_ptr<std::string> obj = std::make_shared<std::string>(str);
-    objs_.push_back(obj);
-    ++parametersNumber_;
-    parameters_.push_back((char *)obj->c_str());
-    lengths_.push_back(static_cast<int>(obj->length()));
     if (type_ == ClientType::PostgreSQL)
     {
-        formats_.push_back(0);
+        addParameter(text, static_cast<int>(length), 0);
     }
     else if (type_ == ClientType::Mysql)
     {
-        formats_.push_back(MySqlString);
+        addParameter(text, static_cast<int>(length), MySqlString);
     }
     else if (type_ == ClientType::Sqlite3)
     {
-        formats_.push_back(Sqlite3TypeText);
+        addParameter(text, static_cast<int>(length), Sqlite3TypeText);
     }
-    return *this;
 }
 
-SqlBinder &SqlBinder::operator<<(std::string &&str)
+SqlBinder &SqlBinder::operator<<(const std::string &str)
 {
-    std::shared_ptr<std::string> obj =
-        std::make_shared<std::string>(std::move(str));
-    objs_.push_back(obj);
-    ++parametersNumber_;
-    parameters_.push_back((char *)obj->c_str());
-    lengths_.push_back(static_cast<int>(obj->length()));
-    if (type_ == ClientType::PostgreSQL)
+    // Short strings are copied inline with their terminating null
+    if (auto slot = inlineSlot(str.length() + 1))
     {
-        formats_.push_back(0);
+        memcpy(slot, str.c_str(), str.length() + 1);
+        addText(slot, str.length());
+        return *this;
     }
-    else if (type_ == ClientType::Mysql)
+    std::shared_ptr<std::string> obj = std::make_shared<std::string>(str);
+    keepObject(obj);
+    addText(obj->c_str(), obj->length());
+    return *this;
+}
+
+SqlBinder &SqlBinder::operator<<(std::string &&str)
+{
+    if (auto slot = inlineSlot(str.length() + 1))
     {
-        formats_.push_back(MySqlString);
+        memcpy(slot, str.c_str(), str.length() + 1);
+        addText(slot, str.length());
+        return *this;
     }
-    else if (type_ == ClientType::Sqlite3)
+    std::shared_ptr<std::string> obj =
+        std::make_shared<std::string>(std::move(str));
+    keepObject(obj);
+    addText(obj->c_str(), obj->length());
+    return *this;
+}
+
+SqlBinder &SqlBinder::operator<<(const trantor::Date &date)
+{
+    if (auto slot = inlineSlot(ParameterStorage::kSlotSize))
     {
-        formats_.push_back(Sqlite3TypeText);
+        addText(slot,
+                date.toDbStringLocal(slot, ParameterStorage::kSlotSize));
+        return *this;
     }
-    return *this;
+    return operator<<(date.toDbStringLocal());
 }
 
 SqlBinder &SqlBinder::operator<<(const std::vector<char> &v)
 {
     std::shared_ptr<std::vector<char>> obj =
         std::make_shared<std::vector<char>>(v);
-    objs_.push_back(obj);
-    ++parametersNumber_;
-    parameters_.push_back((char *)obj->data());
-    lengths_.push_back(static_cast<int>(obj->size()));
-    if (type_ == ClientType::PostgreSQL)
-    {
-        formats_.push_back(1);
-    }
-    else if (type_ == ClientType::Mysql)
-    {
-        formats_.push_back(MySqlString);
-    }
-    else if (type_ == ClientType::Sqlite3)
-    {
-        formats_.push_back(Sqlite3TypeBlob);
-    }
+    keepObject(obj);
+    addBlob(obj->data(), obj->size());
     return *this;
 }
 
@@ -205,35 +203,32 @@ SqlBinder &SqlBinder::operator<<(std::vector<char> &&v)
 {
     std::shared_ptr<std::vector<char>> obj =
         std::make_shared<std::vector<char>>(std::move(v));
-    objs_.push_back(obj);
-    ++parametersNumber_;
-    parameters_.push_back((char *)obj->data());
-    lengths_.push_back(static_cast<int>(obj->size()));
+    keepObject(obj);
+    addBlob(obj->data(), obj->size());
+    return *this;
+}
+
+void SqlBinder::addBlob(const char *data, size_t length)
+{
     if (type_ == ClientType::PostgreSQL)
     {
-        formats_.push_back(1);
+        addParameter(data, static_cast<int>(length), 1);
     }
     else if (type_ == ClientType::Mysql)
     {
-        formats_.push_back(MySqlString);
+        addParameter(data, static_cast<int>(length), MySqlString);
     }
     else if (type_ == ClientType::Sqlite3)
     {
-        formats_.push_back(Sqlite3TypeBlob);
+        addParameter(data, static_cast<int>(length), Sqlite3TypeBlob);
     }
-    return *this;
 }
 
 SqlBinder &SqlBinder::operator<<(double f)
 {
     if (type_ == ClientType::Sqlite3)
     {
-        ++parametersNumber_;
-        auto obj = std::make_shared<double>(f);
-        objs_.push_back(obj);
-        formats_.push_back(Sqlite3TypeDouble);
-        lengths_.push_back(0);
-        parameters_.push_back((char *)(obj.get()));
+        addParameter((char *)storeValue(f), 0, Sqlite3TypeDouble);
         return *this;
     }
     return operator<<(std::to_string(f));
@@ -242,20 +237,17 @@ SqlBinder &SqlBinder::operator<<(double f)
 SqlBinder &SqlBinder::operator<<(std::nullptr_t nullp)
 {
     (void)nullp;
-    ++parametersNumber_;
-    parameters_.push_back(NULL);
-    lengths_.push_back(0);
     if (type_ == ClientType::PostgreSQL)
     {
-        formats_.push_back(0);
+        addParameter(NULL, 0, 0);
     }
     else if (type_ == ClientType::Mysql)
     {
-        formats_.push_back(MySqlNull);
+        addParameter(NULL, 0, MySqlNull);
     }
     else if (type_ == ClientType::Sqlite3)
     {
-        formats_.push_back(Sqlite3TypeNull);
+        addParameter(NULL, 0, Sqlite3TypeNull);
     }
     return *this;
 }
@@ -290,10 +282,7 @@ SqlBinder &SqlBinder::operator<<(DefaultValue dv)
     }
     else if (type_ == ClientType::Mysql)
     {
-        ++parametersNumber_;
-        parameters_.push_back(NULL);
-        lengths_.push_back(0);
-        formats_.push_back(DrogonDefaultValue);
+        addParameter(NULL, 0, DrogonDefaultValue);
     }
     else if (type_ == ClientType::Sqlite3)
     {
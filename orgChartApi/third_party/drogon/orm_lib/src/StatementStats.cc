@@ -0,0 +1,272 @@
+/**
+ *
+ *  @file StatementStats.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "StatementStats.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace
+{
+// Raw texts remembered per thread, texts built with literals in them would
+// otherwise grow the slots without bound
+constexpr size_t kMaxRawTexts = 4096;
+// Normalized statements per thread, the rest are counted together
+constexpr size_t kMaxStatements = 1024;
+const char kOtherStatements[] = "(other statements)";
+
+std::atomic<uint64_t> nextStatsId{0};
+
+bool isIdentifierChar(char ch)
+{
+    return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' ||
+           ch == '$';
+}
+}  // namespace
+
+void StatementCall::finish(uint64_t rows, bool failed)
+{
+    static const uint64_t bounds[] = {100, 1000, 10000, 100000, 1000000};
+    auto total = elapsedMicroseconds();
+    auto queue = queueMicroseconds_.load(std::memory_order_relaxed);
+    auto exec = total > queue ? total - queue : 0;
+    counters_->calls_.fetch_add(1, std::memory_order_relaxed);
+    if (failed)
+        counters_->errors_.fetch_add(1, std::memory_order_relaxed);
+    counters_->rows_.fetch_add(rows, std::memory_order_relaxed);
+    counters_->queueMicroseconds_.fetch_add(queue, std::memory_order_relaxed);
+    counters_->execMicroseconds_.fetch_add(exec, std::memory_order_relaxed);
+    size_t bucket = 0;
+    while (bucket < counters_->execTimeHistogram_.size() - 1 &&
+           exec > bounds[bucket])
+    {
+        ++bucket;
+    }
+    counters_->execTimeHistogram_[bucket].fetch_add(1,
+                                                    std::memory_order_relaxed);
+}
+
+StatementStats::StatementStats()
+    : id_(nextStatsId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+std::shared_ptr<StatementCall> StatementStats::start(
+    string_view sql,
+    std::function<void(const Result &)> &rcb,
+    std::function<void(const std::exception_ptr &)> &ecb)
+{
+    auto call = std::make_shared<StatementCall>(counters(sql));
+    rcb = [rcb = std::move(rcb), call](const Result &result) {
+        // Statements that return no rows tell how many they changed
+        call->finish(result.empty() ? result.affectedRows() : result.size(),
+                     false);
+        rcb(result);
+    };
+    ecb = [ecb = std::move(ecb), call](const std::exception_ptr &err) {
+        call->finish(0, true);
+        ecb(err);
+    };
+    return call;
+}
+
+StatementStats::ThreadSlot &StatementStats::slotOfThread()
+{
+    static thread_local std::unordered_map<uint64_t, ThreadSlot *> slots;
+    auto &slot = slots[id_];
+    if (!slot)
+    {
+        std::lock_guard<std::mutex> lock(slotsMutex_);
+        slots_.emplace_back(new ThreadSlot);
+        slot = slots_.back().get();
+    }
+    return *slot;
+}
+
+const std::shared_ptr<StatementCounters> &StatementStats::counters(
+    string_view sql)
+{
+    auto &slot = slotOfThread();
+    auto iter = slot.raw_.find(sql);
+    if (iter != slot.raw_.end())
+        return iter->second;
+
+    auto normalized = normalize(sql);
+    std::shared_ptr<StatementCounters> *counters;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex_);
+        if (slot.normalized_.size() >= kMaxStatements &&
+            slot.normalized_.find(normalized) == slot.normalized_.end())
+        {
+            normalized = kOtherStatements;
+        }
+        counters = &slot.normalized_[normalized];
+        if (!*counters)
+            *counters = std::make_shared<StatementCounters>();
+    }
+    if (slot.raw_.size() >= kMaxRawTexts)
+        return *counters;
+    slot.rawTexts_.emplace_back(sql.data(), sql.length());
+    const auto &text = slot.rawTexts_.back();
+    return slot.raw_
+        .emplace(string_view{text.data(), text.length()}, *counters)
+        .first->second;
+}
+
+std::vector<StatementStat> StatementStats::snapshot() const
+{
+    std::unordered_map<std::string, StatementStat> merged;
+    {
+        std::lock_guard<std::mutex> slotsLock(slotsMutex_);
+        for (auto &slot : slots_)
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex_);
+            for (auto &entry : slot->normalized_)
+            {
+                auto &counters = *entry.second;
+                auto &stat = merged[entry.first];
+                stat.calls +=
+                    counters.calls_.load(std::memory_order_relaxed);
+                stat.errors +=
+                    counters.errors_.load(std::memory_order_relaxed);
+                stat.rows += counters.rows_.load(std::memory_order_relaxed);
+                stat.queueMicroseconds +=
+                    counters.queueMicroseconds_.load(std::memory_order_relaxed);
+                stat.execMicroseconds +=
+                    counters.execMicroseconds_.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < stat.execTimeHistogram.size(); ++i)
+                {
+                    stat.execTimeHistogram[i] +=
+                        counters.execTimeHistogram_[i].load(
+                            std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    std::vector<StatementStat> stats;
+    stats.reserve(merged.size());
+    for (auto &entry : merged)
+    {
+        // Statements still waiting for their first result are left out
+        if (entry.second.calls == 0)
+            continue;
+        entry.second.sql = entry.first;
+        stats.push_back(std::move(entry.second));
+    }
+    std::sort(stats.begin(),
+              stats.end(),
+              [](const StatementStat &a, const StatementStat &b) {
+                  return a.execMicroseconds > b.execMicroseconds;
+              });
+    return stats;
+}
+
+void StatementStats::merge(std::vector<StatementStat> &into,
+                           std::vector<StatementStat> &&from)
+{
+    for (auto &stat : from)
+    {
+        auto iter = std::find_if(into.begin(),
+                                 into.end(),
+                                 [&stat](const StatementStat &known) {
+                                     return known.sql == stat.sql;
+                                 });
+        if (iter == into.end())
+        {
+            into.push_back(std::move(stat));
+            continue;
+        }
+        iter->calls += stat.calls;
+        iter->errors += stat.errors;
+        iter->rows += stat.rows;
+        iter->queueMicroseconds += stat.queueMicroseconds;
+        iter->execMicroseconds += stat.execMicroseconds;
+        for (size_t i = 0; i < stat.execTimeHistogram.size(); ++i)
+        {
+            iter->execTimeHistogram[i] += stat.execTimeHistogram[i];
+        }
+    }
+    std::sort(into.begin(),
+              into.end(),
+              [](const StatementStat &a, const StatementStat &b) {
+                  return a.execMicroseconds > b.execMicroseconds;
+              });
+}
+
+std::string StatementStats::normalize(string_view sql)
+{
+    std::string normalized;
+    normalized.reserve(sql.length());
+    bool space = false;
+    size_t i = 0;
+    while (i < sql.length())
+    {
+        auto ch = sql[i];
+        if (std::isspace(static_cast<unsigned char>(ch)))
+        {
+            space = !normalized.empty();
+            ++i;
+            continue;
+        }
+        if (space)
+        {
+            normalized.push_back(' ');
+            space = false;
+        }
+        if (ch == '\'')
+        {
+            // A quote in a string literal is doubled
+            ++i;
+            while (i < sql.length())
+            {
+                if (sql[i] == '\'')
+                {
+                    if (i + 1 < sql.length() && sql[i + 1] == '\'')
+                    {
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++i;
+            }
+            ++i;
+            normalized.push_back('?');
+            continue;
+        }
+        if (ch == '"')
+        {
+            // Quoted identifiers stay as they are
+            auto end = sql.find('"', i + 1);
+            end = end == string_view::npos ? sql.length() : end + 1;
+            normalized.append(sql.data() + i, end - i);
+            i = end;
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(ch)) &&
+            (normalized.empty() || !isIdentifierChar(normalized.back())))
+        {
+            while (i < sql.length() &&
+                   (std::isalnum(static_cast<unsigned char>(sql[i])) ||
+                    sql[i] == '.'))
+            {
+                ++i;
+            }
+            normalized.push_back('?');
+            continue;
+        }
+        normalized.push_back(ch);
+        ++i;
+    }
+    return normalized;
+}
@@ -0,0 +1,141 @@
+/**
+ *
+ *  @file StatementStats.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/orm/DbClient.h>
+#include <drogon/utils/string_view.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+/// The counters of one normalized statement in the slot of one thread
+struct StatementCounters
+{
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> rows_{0};
+    std::atomic<uint64_t> queueMicroseconds_{0};
+    std::atomic<uint64_t> execMicroseconds_{0};
+    std::array<std::atomic<uint64_t>, 6> execTimeHistogram_{};
+};
+
+/// One execution of a statement, from the call of execSql to its callback
+class StatementCall
+{
+  public:
+    explicit StatementCall(std::shared_ptr<StatementCounters> counters)
+        : counters_(std::move(counters)),
+          startedAt_(std::chrono::steady_clock::now())
+    {
+    }
+    /// The statement got a connection, the time until now was queue time
+    void dispatched()
+    {
+        queueMicroseconds_.store(elapsedMicroseconds(),
+                                 std::memory_order_relaxed);
+    }
+    void finish(uint64_t rows, bool failed);
+
+  private:
+    uint64_t elapsedMicroseconds() const
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startedAt_)
+                .count());
+    }
+
+    // Shared, the callback may outlive the client
+    std::shared_ptr<StatementCounters> counters_;
+    std::chrono::steady_clock::time_point startedAt_;
+    // Written by the thread that dispatches the statement, which may race
+    // with the timeout of a queued one
+    std::atomic<uint64_t> queueMicroseconds_{0};
+};
+
+/**
+ * @brief Calls, rows and times of the statements of a client by their
+ * normalized text, literals replaced with '?'.
+ *
+ * Every thread that executes statements counts them in a slot of its own:
+ * the raw text of a statement finds its counters without a lock, only the
+ * first execution of a text takes the lock of the slot to normalize it.
+ * The counters are atomics because the callbacks run on the IO threads.
+ */
+class StatementStats
+{
+  public:
+    StatementStats();
+    StatementStats(const StatementStats &) = delete;
+    StatementStats &operator=(const StatementStats &) = delete;
+
+    /**
+     * @brief Start an execution of the statement, the callbacks are wrapped
+     * to finish it before they run.
+     *
+     * @return The call to mark dispatched once the statement got a
+     * connection, it counts no queue time otherwise.
+     */
+    std::shared_ptr<StatementCall> start(
+        string_view sql,
+        std::function<void(const Result &)> &rcb,
+        std::function<void(const std::exception_ptr &)> &ecb);
+
+    /// The statements of all threads, merged by normalized text
+    std::vector<StatementStat> snapshot() const;
+
+    /// Collapse whitespace and replace string and number literals with '?',
+    /// placeholders like $1 are kept
+    static std::string normalize(string_view sql);
+
+    /// Add the statements of from to the ones of into with the same text
+    static void merge(std::vector<StatementStat> &into,
+                      std::vector<StatementStat> &&from);
+
+  private:
+    struct ThreadSlot
+    {
+        // Only touched by the thread of the slot
+        std::unordered_map<string_view, std::shared_ptr<StatementCounters>>
+            raw_;
+        std::deque<std::string> rawTexts_;
+        // Guarded by mutex_ against snapshot()
+        std::mutex mutex_;
+        std::unordered_map<std::string, std::shared_ptr<StatementCounters>>
+            normalized_;
+    };
+
+    const std::shared_ptr<StatementCounters> &counters(string_view sql);
+    ThreadSlot &slotOfThread();
+
+    // Tells the slots of this client in the threads apart from the ones of
+    // clients destroyed before
+    uint64_t id_;
+    mutable std::mutex slotsMutex_;
+    std::vector<std::unique_ptr<ThreadSlot>> slots_;
+};
+
+}  // namespace orm
+}  // namespace drogon
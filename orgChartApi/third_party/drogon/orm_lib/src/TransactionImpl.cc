@@ -120,7 +120,8 @@ void TransactionImpl::execSqlInLoop(
                                     std::move(rcb),
                                     [exceptCallback,
                                      thisPtr](const std::exception_ptr &ePtr) {
-                                        thisPtr->rollback();
+                                        if (thisPtr->rollbackOnError_)
+                                            thisPtr->rollback();
                                         if (exceptCallback)
                                             exceptCallback(ePtr);
                                     });
@@ -149,6 +150,46 @@ void TransactionImpl::execSqlInLoop(
     }
 }
 
+void TransactionImpl::execCopy(
+    std::string &&sql,
+    CopyInCallback &&producer,
+    CopyOutCallback &&consumer,
+    ResultCallback &&rcb,
+    std::function<void(const std::exception_ptr &)> &&exceptCallback)
+{
+    auto copy = std::make_shared<CopyCmd>(CopyCmd{std::move(sql),
+                                                  std::move(producer),
+                                                  std::move(consumer),
+                                                  std::move(rcb),
+                                                  std::move(exceptCallback)});
+    loop_->runInLoop([thisPtr = shared_from_this(), copy]() {
+        if (thisPtr->isCommitedOrRolledback_)
+        {
+            copy->exceptionCallback_(std::make_exception_ptr(
+                TransactionRollback("The transaction has been rolled back")));
+            return;
+        }
+        // A failed COPY rolls the transaction back as a failed statement does
+        auto exceptCallback = std::move(copy->exceptionCallback_);
+        copy->exceptionCallback_ =
+            [thisPtr, exceptCallback](const std::exception_ptr &ePtr) {
+                thisPtr->rollback();
+                exceptCallback(ePtr);
+            };
+        if (!thisPtr->isWorking_)
+        {
+            thisPtr->isWorking_ = true;
+            thisPtr->thisPtr_ = thisPtr;
+            thisPtr->connectionPtr_->copySql(std::shared_ptr<CopyCmd>(copy));
+            return;
+        }
+        auto cmdPtr = std::make_shared<SqlCmd>();
+        cmdPtr->copy_ = copy;
+        cmdPtr->thisPtr_ = thisPtr;
+        thisPtr->sqlCmdBuffer_.push_back(std::move(cmdPtr));
+    });
+}
+
 void TransactionImpl::rollback()
 {
     auto thisPtr = shared_from_this();
@@ -211,6 +252,11 @@ void TransactionImpl::execNewTask()
             auto cmd = std::move(sqlCmdBuffer_.front());
             sqlCmdBuffer_.pop_front();
             auto conn = connectionPtr_;
+            if (cmd->copy_)
+            {
+                conn->copySql(std::move(cmd->copy_));
+                return;
+            }
             conn->execSql(
                 std::move(cmd->sql_),
                 cmd->parametersNumber_,
@@ -227,12 +273,14 @@ void TransactionImpl::execNewTask()
                         callback(r);
                 },
                 [cmd, thisPtr](const std::exception_ptr &ePtr) {
-                    if (!cmd->isRollbackCmd_)
-                        thisPtr->rollback();
-                    else
+                    if (cmd->isRollbackCmd_)
                     {
                         thisPtr->isCommitedOrRolledback_ = true;
                     }
+                    else if (thisPtr->rollbackOnError_)
+                    {
+                        thisPtr->rollback();
+                    }
                     if (cmd->exceptionCallback_)
                         cmd->exceptionCallback_(ePtr);
                 });
@@ -249,7 +297,9 @@ void TransactionImpl::execNewTask()
                 TransactionRollback("The transaction has been rolled back"));
             for (auto const &cmd : sqlCmdBuffer_)
             {
-                if (cmd->exceptionCallback_)
+                if (cmd->copy_)
+                    cmd->copy_->exceptionCallback_(exceptPtr);
+                else if (cmd->exceptionCallback_)
                 {
                     cmd->exceptionCallback_(exceptPtr);
                 }
@@ -353,7 +403,8 @@ void TransactionImpl::execSqlInLoopWithTimeout(
                                 std::move(resultCallback),
                                 [ecpPtr, timeoutFlagPtr, thisPtr](
                                     const std::exception_ptr &ePtr) {
-                                    thisPtr->rollback();
+                                    if (thisPtr->rollbackOnError_)
+                                        thisPtr->rollback();
                                     if (timeoutFlagPtr->done())
                                         return;
                                     if (*ecpPtr)
@@ -46,6 +46,13 @@ class TransactionImpl : public Transaction,
     {
         timeout_ = timeout;
     }
+    /// Keep the transaction open when a statement fails, for callers that
+    /// roll back to a savepoint themselves. Statements that time out still
+    /// roll it back.
+    void setRollbackOnError(bool rollbackOnError)
+    {
+        rollbackOnError_ = rollbackOnError;
+    }
 
   private:
     DbConnectionPtr connectionPtr_;
@@ -91,6 +98,13 @@ class TransactionImpl : public Transaction,
         }
     }
 
+    void execCopy(std::string &&sql,
+                  CopyInCallback &&producer,
+                  CopyOutCallback &&consumer,
+                  ResultCallback &&rcb,
+                  std::function<void(const std::exception_ptr &)>
+                      &&exceptCallback) override;
+
     void execSqlInLoop(
         string_view &&sql,
         size_t paraNum,
@@ -133,6 +147,8 @@ class TransactionImpl : public Transaction,
         QueryCallback callback_;
         ExceptPtrCallback exceptionCallback_;
         bool isRollbackCmd_{false};
+        // Set for a COPY, which runs instead of the statement
+        std::shared_ptr<CopyCmd> copy_;
         std::shared_ptr<TransactionImpl> thisPtr_;
     };
     using SqlCmdPtr = std::shared_ptr<SqlCmd>;
@@ -145,6 +161,7 @@ class TransactionImpl : public Transaction,
     std::function<void(bool)> commitCallback_;
     std::shared_ptr<TransactionImpl> thisPtr_;
     double timeout_{-1.0};
+    bool rollbackOnError_{true};
 };
 }  // namespace orm
 }  // namespace drogon
@@ -20,6 +20,7 @@
 #include <exception>
 #include <memory>
 #include <algorithm>
+#include <chrono>
 #include <stdio.h>
 
 using namespace drogon::orm;
@@ -28,7 +29,6 @@ namespace drogon
 {
 namespace orm
 {
-static const unsigned int maxBatchCount = 256;
 Result makeResult(
     const std::shared_ptr<PGresult> &r = std::shared_ptr<PGresult>(nullptr))
 {
@@ -74,13 +74,18 @@ int PgConnection::flush()
     }
     return ret;
 }
-PgConnection::PgConnection(trantor::EventLoop *loop,
-                           const std::string &connInfo)
+PgConnection::PgConnection(
+    trantor::EventLoop *loop,
+    const std::string &connInfo,
+    std::shared_ptr<PreparedStatementCounters> counters,
+    bool binaryResults)
     : DbConnection(loop),
       connectionPtr_(
           std::shared_ptr<PGconn>(PQconnectStart(connInfo.c_str()),
                                   [](PGconn *conn) { PQfinish(conn); })),
-      channel_(loop, PQsocket(connectionPtr_.get()))
+      channel_(loop, PQsocket(connectionPtr_.get())),
+      preparedStatements_(maxPreparedStatements, std::move(counters)),
+      binaryResults_(binaryResults)
 {
     PQsetnonblocking(connectionPtr_.get(), 1);
     if (channel_.fd() < 0)
@@ -101,7 +106,11 @@ PgConnection::PgConnection(trantor::EventLoop *loop,
         }
     });
     channel_.setWriteCallback([this]() {
-        if (status_ == ConnectStatus::Ok)
+        if (status_ == ConnectStatus::Ok && copyingIn_)
+        {
+            sendCopyData();
+        }
+        else if (status_ == ConnectStatus::Ok)
         {
             auto ret = PQflush(connectionPtr_.get());
             if (ret == 0)
@@ -136,6 +145,7 @@ void PgConnection::handleClosed()
     status_ = ConnectStatus::Bad;
     channel_.disableAll();
     channel_.remove();
+    abortCopy();
     assert(closeCallback_);
     auto thisPtr = shared_from_this();
     closeCallback_(thisPtr);
@@ -186,7 +196,7 @@ void PgConnection::pgPoll()
             if (status_ != ConnectStatus::Ok)
             {
                 status_ = ConnectStatus::Ok;
-                if (!PQbeginBatchMode(connectionPtr_.get()))
+                if (!PQenterPipelineMode(connectionPtr_.get()))
                 {
                     handleClosed();
                     return;
@@ -234,15 +244,140 @@ void PgConnection::execSqlInLoop(
 }
 int PgConnection::sendBatchEnd()
 {
-    if (!PQsendEndBatch(connectionPtr_.get()))
+    if (!PQpipelineSync(connectionPtr_.get()))
     {
         isWorking_ = false;
         handleFatalError(true);
         handleClosed();
         return 0;
     }
+    ++pendingSyncs_;
     return 1;
 }
+int PgConnection::sendDeallocations()
+{
+    if (statementsToDeallocate_.empty())
+    {
+        return 1;
+    }
+    // Written ahead of the next query in a pipeline segment of their own,
+    // so that a failing deallocation (e.g. in an aborted transaction) can't
+    // abort the queries that follow.
+    for (auto &name : statementsToDeallocate_)
+    {
+        auto sql = "deallocate \"" + name + "\"";
+        if (PQsendQueryParams(connectionPtr_.get(),
+                              sql.c_str(),
+                              0,
+                              NULL,
+                              NULL,
+                              NULL,
+                              NULL,
+                              0) == 0)
+        {
+            LOG_ERROR << "send query error: "
+                      << PQerrorMessage(connectionPtr_.get());
+            statementsToDeallocate_.clear();
+            isWorking_ = false;
+            handleFatalError(true);
+            handleClosed();
+            return 0;
+        }
+        batchCommandsForWaitingResults_.push_back(std::make_shared<SqlCmd>(
+            string_view{},
+            0,
+            std::vector<const char *>{},
+            std::vector<int>{},
+            std::vector<int>{},
+            [](const Result &) {},
+            [](const std::exception_ptr &) {}));
+    }
+    statementsToDeallocate_.clear();
+    return sendBatchEnd();
+}
+
+int PgConnection::sendStatementTimeout(const SqlCmd &cmd)
+{
+    long timeout = 0;
+    if (cmd.deadline_ != std::chrono::steady_clock::time_point::max())
+    {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        cmd.deadline_ - std::chrono::steady_clock::now())
+                        .count();
+        timeout = (std::max)(static_cast<long>(left), 1L);
+        // A timeout up to a quarter longer is kept, the cancel at the
+        // deadline stops the statement if the server doesn't
+        if (statementTimeout_ >= timeout &&
+            statementTimeout_ <= timeout + timeout / 4)
+        {
+            return 1;
+        }
+    }
+    else if (statementTimeout_ == 0)
+    {
+        return 1;
+    }
+    // Like the deallocations, in a pipeline segment of its own
+    auto sql = timeout > 0
+                   ? "set statement_timeout = " + std::to_string(timeout)
+                   : std::string("reset statement_timeout");
+    if (PQsendQueryParams(connectionPtr_.get(),
+                          sql.c_str(),
+                          0,
+                          NULL,
+                          NULL,
+                          NULL,
+                          NULL,
+                          0) == 0)
+    {
+        LOG_ERROR << "send query error: "
+                  << PQerrorMessage(connectionPtr_.get());
+        isWorking_ = false;
+        handleFatalError(true);
+        handleClosed();
+        return 0;
+    }
+    batchCommandsForWaitingResults_.push_back(
+        std::make_shared<SqlCmd>(string_view{},
+                                 0,
+                                 std::vector<const char *>{},
+                                 std::vector<int>{},
+                                 std::vector<int>{},
+                                 [](const Result &) {},
+                                 [](const std::exception_ptr &) {}));
+    statementTimeout_ = timeout;
+    return sendBatchEnd();
+}
+
+void PgConnection::cancelAtDeadline(const std::shared_ptr<SqlCmd> &cmd)
+{
+    auto left = std::chrono::duration<double>(
+                    cmd->deadline_ - std::chrono::steady_clock::now())
+                    .count();
+    std::weak_ptr<PgConnection> weakThis = shared_from_this();
+    std::weak_ptr<SqlCmd> weakCmd = cmd;
+    loop_->runAfter((std::max)(left, 0.0), [weakThis, weakCmd]() {
+        auto thisPtr = weakThis.lock();
+        auto cmd = weakCmd.lock();
+        // The cancel stops whatever runs on the server when it arrives. With
+        // statements pipelined behind this one, that may already be the next
+        // one, so only the statement_timeout of its segment stops it then.
+        if (thisPtr && cmd &&
+            thisPtr->batchCommandsForWaitingResults_.size() == 1 &&
+            thisPtr->batchCommandsForWaitingResults_.front() == cmd)
+        {
+            thisPtr->cancelQuery();
+        }
+    });
+}
+
+void PgConnection::execSqlCmd(std::shared_ptr<SqlCmd> &&cmd)
+{
+    std::deque<std::shared_ptr<SqlCmd>> cmds;
+    cmds.push_back(std::move(cmd));
+    batchSql(std::move(cmds));
+}
+
 void PgConnection::sendBatchedSql()
 {
     if (isWorking_)
@@ -271,10 +406,16 @@ void PgConnection::sendBatchedSql()
     {
         auto &cmd = batchSqlCommands_.front();
         std::string statName;
+        auto hasDeadline =
+            cmd->deadline_ != std::chrono::steady_clock::time_point::max();
         if (cmd->preparingStatement_.empty())
         {
-            auto iter = preparedStatementsMap_.find(cmd->sql_);
-            if (iter == preparedStatementsMap_.end())
+            if (!sendDeallocations() || !sendStatementTimeout(*cmd))
+            {
+                return;
+            }
+            auto statement = preparedStatements_.find(cmd->sql_);
+            if (!statement)
             {
                 statName = newStmtName();
                 if (PQsendPrepare(connectionPtr_.get(),
@@ -293,6 +434,8 @@ void PgConnection::sendBatchedSql()
                 }
                 cmd->preparingStatement_ = statName;
                 cmd->isChanging_ = checkSql(cmd->sql_);
+                cmd->resultFormat_ = 0;
+                cmd->checkResultFormat_ = binaryResults_;
                 if (flush())
                 {
                     return;
@@ -300,39 +443,39 @@ void PgConnection::sendBatchedSql()
             }
             else
             {
-                statName = iter->second.first;
-                cmd->isChanging_ = iter->second.second;
+                statName = statement->name_;
+                cmd->isChanging_ = statement->isChanging_;
+                cmd->resultFormat_ = statement->resultFormat_ > 0 ? 1 : 0;
+                cmd->checkResultFormat_ =
+                    binaryResults_ && statement->resultFormat_ < 0;
             }
         }
         else
         {
             statName = cmd->preparingStatement_;
         }
-        if (batchSqlCommands_.size() == 1 || cmd->sql_.length() > 1024 ||
-            batchCount_ > maxBatchCount)
-        {
-            sendBatchEnd_ = true;
-            batchCount_ = 0;
-        }
-        else if (cmd->isChanging_)
-        {
-            sendBatchEnd_ = true;
-            batchCount_ = 0;
-        }
-        ++batchCount_;
+        // Every statement ends its pipeline segment. A statement failing at
+        // runtime, or cancelled at its deadline, aborts the rest of its
+        // segment, and the statements pipelined here belong to unrelated
+        // requests. The sync is one more message, not one more round trip.
+        sendBatchEnd_ = true;
         if (PQsendQueryPrepared(connectionPtr_.get(),
                                 statName.c_str(),
                                 cmd->parametersNumber_,
                                 cmd->parameters_.data(),
                                 cmd->lengths_.data(),
                                 cmd->formats_.data(),
-                                0) == 0)
+                                cmd->resultFormat_) == 0)
         {
             isWorking_ = false;
             handleFatalError(true);
             handleClosed();
             return;
         }
+        if (hasDeadline)
+        {
+            cancelAtDeadline(cmd);
+        }
         batchCommandsForWaitingResults_.push_back(std::move(cmd));
         batchSqlCommands_.pop_front();
         if (flush())
@@ -371,6 +514,15 @@ void PgConnection::handleRead()
         handleClosed();
         return;
     }
+    if (notificationCallback_)
+    {
+        handleNotifications();
+    }
+    if (copyCmd_)
+    {
+        handleCopy();
+        return;
+    }
     if (PQisBusy(connectionPtr_.get()))
     {
         // need read more data from socket;
@@ -386,10 +538,10 @@ void PgConnection::handleRead()
         if (!res)
         {
             /*
-             * No more results from this query, advance to
-             * the next result
+             * No more results from this query, the next PQgetResult()
+             * moves on to the next query of the pipeline if there is one
              */
-            if (!PQgetNextQuery(connectionPtr_.get()))
+            if (pendingSyncs_ == 0)
             {
                 return;
             }
@@ -397,13 +549,14 @@ void PgConnection::handleRead()
         }
         auto type = PQresultStatus(res.get());
         if (type == PGRES_BAD_RESPONSE || type == PGRES_FATAL_ERROR ||
-            type == PGRES_BATCH_ABORTED)
+            type == PGRES_PIPELINE_ABORTED)
         {
             handleFatalError(false);
             continue;
         }
-        if (type == PGRES_BATCH_END)
+        if (type == PGRES_PIPELINE_SYNC)
         {
+            --pendingSyncs_;
             if (batchCommandsForWaitingResults_.empty() &&
                 batchSqlCommands_.empty())
             {
@@ -418,14 +571,15 @@ void PgConnection::handleRead()
             auto &cmd = batchCommandsForWaitingResults_.front();
             if (!cmd->preparingStatement_.empty())
             {
-                auto r = preparedStatements_.insert(
-                    std::string{cmd->sql_.data(), cmd->sql_.length()});
-                preparedStatementsMap_[string_view{r.first->c_str(),
-                                                   r.first->length()}] = {
-                    std::move(cmd->preparingStatement_), cmd->isChanging_};
+                dropStatement(preparedStatements_.insert(
+                    std::string{cmd->sql_.data(), cmd->sql_.length()},
+                    std::move(cmd->preparingStatement_),
+                    cmd->isChanging_));
                 cmd->preparingStatement_.clear();
                 continue;
             }
+            if (cmd->checkResultFormat_)
+                checkResultFormat(cmd->sql_, res.get());
             auto r = makeResult(res);
             cmd->callback_(r);
             batchCommandsForWaitingResults_.pop_front();
@@ -436,11 +590,10 @@ void PgConnection::handleRead()
         auto &cmd = batchSqlCommands_.front();
         if (!cmd->preparingStatement_.empty())
         {
-            auto r = preparedStatements_.insert(
-                std::string{cmd->sql_.data(), cmd->sql_.length()});
-            preparedStatementsMap_[string_view{r.first->c_str(),
-                                               r.first->length()}] = {
-                std::move(cmd->preparingStatement_), cmd->isChanging_};
+            dropStatement(preparedStatements_.insert(
+                std::string{cmd->sql_.data(), cmd->sql_.length()},
+                std::move(cmd->preparingStatement_),
+                cmd->isChanging_));
             cmd->preparingStatement_.clear();
             continue;
         }
@@ -499,7 +652,24 @@ void PgConnection::handleFatalError(bool clearAll)
 
 void PgConnection::batchSql(std::deque<std::shared_ptr<SqlCmd>> &&sqlCommands)
 {
-    loop_->assertInLoopThread();
-    batchSqlCommands_ = std::move(sqlCommands);
+    if (!loop_->isInLoopThread())
+    {
+        loop_->queueInLoop([thisPtr = shared_from_this(),
+                            sqlCommands = std::move(sqlCommands)]() mutable {
+            thisPtr->batchSql(std::move(sqlCommands));
+        });
+        return;
+    }
+    if (batchSqlCommands_.empty())
+    {
+        batchSqlCommands_ = std::move(sqlCommands);
+    }
+    else
+    {
+        for (auto &cmd : sqlCommands)
+        {
+            batchSqlCommands_.push_back(std::move(cmd));
+        }
+    }
     sendBatchedSql();
 }
@@ -0,0 +1,245 @@
+/**
+ *
+ *  @file PgBinaryFormat.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace drogon
+{
+namespace orm
+{
+/**
+ * Decoding of the PostgreSQL binary wire format for the column types that a
+ * client may request in binary: integers, bool, character types, date and
+ * timestamp without time zone.
+ */
+namespace pg_binary
+{
+enum Oid
+{
+    kBool = 16,
+    kInt8 = 20,
+    kInt2 = 21,
+    kInt4 = 23,
+    kText = 25,
+    kBpchar = 1042,
+    kVarchar = 1043,
+    kDate = 1082,
+    kTimestamp = 1114
+};
+
+/// Whether a result column of this type may be sent in binary format
+inline bool isSupported(int oid)
+{
+    switch (oid)
+    {
+        case kBool:
+        case kInt8:
+        case kInt2:
+        case kInt4:
+        case kText:
+        case kBpchar:
+        case kVarchar:
+        case kDate:
+        case kTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Whether the binary format of the type is its text format
+inline bool isTextual(int oid)
+{
+    return oid == kText || oid == kBpchar || oid == kVarchar;
+}
+
+inline uint64_t readBigEndian(const char *data, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+    {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+/**
+ * @brief The value of a bool or integer column.
+ *
+ * @return false if the column has another type.
+ */
+inline bool readInteger(int oid, const char *data, int64_t &value)
+{
+    switch (oid)
+    {
+        case kBool:
+            value = data[0] != 0;
+            return true;
+        case kInt2:
+            value = static_cast<int16_t>(readBigEndian(data, 2));
+            return true;
+        case kInt4:
+            value = static_cast<int32_t>(readBigEndian(data, 4));
+            return true;
+        case kInt8:
+            value = static_cast<int64_t>(readBigEndian(data, 8));
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Dates count days and timestamps microseconds since 2000-01-01, the
+// extreme values stand for -infinity and infinity.
+constexpr int32_t kDateNegInfinity = INT32_MIN;
+constexpr int32_t kDateInfinity = INT32_MAX;
+constexpr int64_t kTimestampNegInfinity = INT64_MIN;
+constexpr int64_t kTimestampInfinity = INT64_MAX;
+constexpr int64_t kMicrosecondsPerDay = 86400LL * 1000000;
+
+/// Calendar date of a day count since 2000-01-01 (proleptic Gregorian)
+inline void civilFromDays(int64_t days,
+                          int64_t &year,
+                          unsigned &month,
+                          unsigned &day)
+{
+    // Howard Hinnant's algorithm, shifted from 1970-01-01 to 2000-01-01
+    days += 10957 + 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+}
+
+/// Broken down date and time of a date or timestamp column
+struct DateTime
+{
+    int64_t year{0};
+    unsigned month{1};
+    unsigned day{1};
+    unsigned hour{0};
+    unsigned minute{0};
+    unsigned second{0};
+    unsigned microsecond{0};
+};
+
+/**
+ * @brief The value of a date or timestamp column.
+ *
+ * @return false if the column has another type or the value is infinite.
+ */
+inline bool readDateTime(int oid, const char *data, DateTime &dateTime)
+{
+    int64_t days;
+    int64_t microseconds = 0;
+    if (oid == kDate)
+    {
+        auto value = static_cast<int32_t>(readBigEndian(data, 4));
+        if (value == kDateNegInfinity || value == kDateInfinity)
+            return false;
+        days = value;
+    }
+    else if (oid == kTimestamp)
+    {
+        auto value = static_cast<int64_t>(readBigEndian(data, 8));
+        if (value == kTimestampNegInfinity || value == kTimestampInfinity)
+            return false;
+        days = value / kMicrosecondsPerDay;
+        microseconds = value % kMicrosecondsPerDay;
+        if (microseconds < 0)
+        {
+            --days;
+            microseconds += kMicrosecondsPerDay;
+        }
+    }
+    else
+    {
+        return false;
+    }
+    civilFromDays(days, dateTime.year, dateTime.month, dateTime.day);
+    auto seconds = microseconds / 1000000;
+    dateTime.hour = static_cast<unsigned>(seconds / 3600);
+    dateTime.minute = static_cast<unsigned>(seconds / 60 % 60);
+    dateTime.second = static_cast<unsigned>(seconds % 60);
+    dateTime.microsecond = static_cast<unsigned>(microseconds % 1000000);
+    return true;
+}
+
+/**
+ * @brief The text PostgreSQL sends for a value in binary format, with the
+ * default DateStyle (ISO, MDY).
+ */
+inline std::string toText(int oid, const char *data, int length)
+{
+    int64_t integer;
+    if (oid == kBool)
+    {
+        return data[0] ? "t" : "f";
+    }
+    if (readInteger(oid, data, integer))
+    {
+        return std::to_string(integer);
+    }
+    if (oid == kDate || oid == kTimestamp)
+    {
+        DateTime dt;
+        if (!readDateTime(oid, data, dt))
+        {
+            bool negative = oid == kDate
+                                ? static_cast<int32_t>(readBigEndian(
+                                      data, 4)) == kDateNegInfinity
+                                : static_cast<int64_t>(readBigEndian(
+                                      data, 8)) == kTimestampNegInfinity;
+            return negative ? "-infinity" : "infinity";
+        }
+        // There is no year 0, 1 BC precedes 1 AD
+        bool bc = dt.year <= 0;
+        char buf[64];
+        int n = snprintf(buf,
+                         sizeof(buf),
+                         "%04lld-%02u-%02u",
+                         static_cast<long long>(bc ? 1 - dt.year : dt.year),
+                         dt.month,
+                         dt.day);
+        if (oid == kTimestamp)
+        {
+            n += snprintf(buf + n,
+                          sizeof(buf) - n,
+                          " %02u:%02u:%02u",
+                          dt.hour,
+                          dt.minute,
+                          dt.second);
+            if (dt.microsecond)
+            {
+                n += snprintf(buf + n, sizeof(buf) - n, ".%06u", dt.microsecond);
+                while (buf[n - 1] == '0')
+                    --n;
+            }
+        }
+        std::string text(buf, n);
+        if (bc)
+            text += " BC";
+        return text;
+    }
+    return std::string(data, length);
+}
+
+}  // namespace pg_binary
+}  // namespace orm
+}  // namespace drogon
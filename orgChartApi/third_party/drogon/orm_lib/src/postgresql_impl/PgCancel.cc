@@ -0,0 +1,51 @@
+/**
+ *
+ *  @file PgCancel.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "PgConnection.h"
+#include <trantor/net/EventLoopThread.h>
+#include <trantor/utils/Logger.h>
+#include <memory>
+#include <mutex>
+
+using namespace drogon::orm;
+
+namespace
+{
+// PQcancel() opens a connection to the server and waits for it, so cancel
+// requests are sent from a thread of their own instead of the IO loops
+trantor::EventLoop *cancelLoop()
+{
+    static trantor::EventLoopThread thread("PgCancel");
+    static std::once_flag once;
+    std::call_once(once, []() { thread.run(); });
+    return thread.getLoop();
+}
+}  // namespace
+
+void PgConnection::cancelQuery()
+{
+    loop_->assertInLoopThread();
+    std::shared_ptr<PGcancel> cancel(PQgetCancel(connectionPtr_.get()),
+                                     [](PGcancel *p) {
+                                         if (p)
+                                             PQfreeCancel(p);
+                                     });
+    if (!cancel)
+        return;
+    LOG_DEBUG << "Cancel the statement running past its deadline";
+    cancelLoop()->queueInLoop([cancel]() {
+        char error[256];
+        if (!PQcancel(cancel.get(), error, sizeof(error)))
+        {
+            LOG_WARN << "Can't cancel the statement: " << error;
+        }
+    });
+}
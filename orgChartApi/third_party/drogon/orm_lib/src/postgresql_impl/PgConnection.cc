@@ -18,6 +18,8 @@
 #include <drogon/utils/Utilities.h>
 #include <drogon/utils/string_view.h>
 #include <trantor/utils/Logger.h>
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <stdio.h>
 
@@ -56,13 +58,18 @@ int PgConnection::flush()
     }
     return ret;
 }
-PgConnection::PgConnection(trantor::EventLoop *loop,
-                           const std::string &connInfo)
+PgConnection::PgConnection(
+    trantor::EventLoop *loop,
+    const std::string &connInfo,
+    std::shared_ptr<PreparedStatementCounters> counters,
+    bool binaryResults)
     : DbConnection(loop),
       connectionPtr_(
           std::shared_ptr<PGconn>(PQconnectStart(connInfo.c_str()),
                                   [](PGconn *conn) { PQfinish(conn); })),
-      channel_(loop, PQsocket(connectionPtr_.get()))
+      channel_(loop, PQsocket(connectionPtr_.get())),
+      preparedStatements_(maxPreparedStatements, std::move(counters)),
+      binaryResults_(binaryResults)
 {
     PQsetnonblocking(connectionPtr_.get(), 1);
     if (channel_.fd() < 0)
@@ -83,7 +90,11 @@ PgConnection::PgConnection(trantor::EventLoop *loop,
         }
     });
     channel_.setWriteCallback([this]() {
-        if (status_ == ConnectStatus::Ok)
+        if (status_ == ConnectStatus::Ok && copyingIn_)
+        {
+            sendCopyData();
+        }
+        else if (status_ == ConnectStatus::Ok)
         {
             auto ret = PQflush(connectionPtr_.get());
             if (ret == 0)
@@ -118,6 +129,7 @@ void PgConnection::handleClosed()
     status_ = ConnectStatus::Bad;
     channel_.disableAll();
     channel_.remove();
+    abortCopy();
     assert(closeCallback_);
     auto thisPtr = shared_from_this();
     closeCallback_(thisPtr);
@@ -184,6 +196,43 @@ void PgConnection::pgPoll()
     }
 }
 
+void PgConnection::execSqlCmd(std::shared_ptr<SqlCmd> &&cmd)
+{
+    if (!loop_->isInLoopThread())
+    {
+        loop_->queueInLoop([thisPtr = shared_from_this(), cmd]() mutable {
+            thisPtr->execSqlCmd(std::move(cmd));
+        });
+        return;
+    }
+    auto deadline = cmd->deadline_;
+    execSqlInLoop(std::move(cmd->sql_),
+                  cmd->parametersNumber_,
+                  std::move(cmd->parameters_),
+                  std::move(cmd->lengths_),
+                  std::move(cmd->formats_),
+                  std::move(cmd->callback_),
+                  std::move(cmd->exceptionCallback_));
+    if (deadline == std::chrono::steady_clock::time_point::max() ||
+        !isWorking_)
+    {
+        return;
+    }
+    // Without pipeline mode a statement_timeout would cost a round trip, the
+    // cancel alone stops the statement
+    auto left = std::chrono::duration<double>(
+                    deadline - std::chrono::steady_clock::now())
+                    .count();
+    std::weak_ptr<PgConnection> weakThis = shared_from_this();
+    loop_->runAfter((std::max)(left, 0.0), [weakThis, id = queryId_]() {
+        auto thisPtr = weakThis.lock();
+        if (thisPtr && thisPtr->isWorking_ && thisPtr->queryId_ == id)
+        {
+            thisPtr->cancelQuery();
+        }
+    });
+}
+
 void PgConnection::execSqlInLoop(
     string_view &&sql,
     size_t paraNum,
@@ -204,7 +253,9 @@ void PgConnection::execSqlInLoop(
     sql_ = std::move(sql);
     callback_ = std::move(rcb);
     isWorking_ = true;
+    ++queryId_;
     exceptionCallback_ = std::move(exceptCallback);
+    checkResultFormat_ = false;
     if (paraNum == 0)
     {
         isRreparingStatement_ = false;
@@ -226,17 +277,18 @@ void PgConnection::execSqlInLoop(
     }
     else
     {
-        auto iter = preparedStatementsMap_.find(sql_);
-        if (iter != preparedStatementsMap_.end())
+        auto statement = preparedStatements_.find(sql_);
+        if (statement)
         {
             isRreparingStatement_ = false;
+            checkResultFormat_ = binaryResults_ && statement->resultFormat_ < 0;
             if (PQsendQueryPrepared(connectionPtr_.get(),
-                                    iter->second.c_str(),
+                                    statement->name_.c_str(),
                                     static_cast<int>(paraNum),
                                     parameters.data(),
                                     length.data(),
                                     format.data(),
-                                    0) == 0)
+                                    statement->resultFormat_ > 0 ? 1 : 0) == 0)
             {
                 LOG_ERROR << "send query error: "
                           << PQerrorMessage(connectionPtr_.get());
@@ -299,6 +351,15 @@ void PgConnection::handleRead()
         handleClosed();
         return;
     }
+    if (notificationCallback_)
+    {
+        handleNotifications();
+    }
+    if (copyCmd_)
+    {
+        handleCopy();
+        return;
+    }
     if (PQisBusy(connectionPtr_.get()))
     {
         // need read more data from socket;
@@ -308,6 +369,14 @@ void PgConnection::handleRead()
                                             [](PGresult *p) { PQclear(p); })))
     {
         auto type = PQresultStatus(res.get());
+        if (isDeallocating_)
+        {
+            if (type == PGRES_BAD_RESPONSE || type == PGRES_FATAL_ERROR)
+            {
+                LOG_WARN << PQerrorMessage(connectionPtr_.get());
+            }
+            continue;
+        }
         if (type == PGRES_BAD_RESPONSE || type == PGRES_FATAL_ERROR)
         {
             LOG_WARN << PQerrorMessage(connectionPtr_.get());
@@ -323,6 +392,8 @@ void PgConnection::handleRead()
             {
                 if (!isRreparingStatement_)
                 {
+                    if (checkResultFormat_)
+                        checkResultFormat(sql_, res.get());
                     auto r = makeResult(res);
                     callback_(r);
                     callback_ = nullptr;
@@ -331,6 +402,13 @@ void PgConnection::handleRead()
             }
         }
     }
+    if (isDeallocating_)
+    {
+        isDeallocating_ = false;
+        isWorking_ = false;
+        idleCb_();
+        return;
+    }
     if (isWorking_)
     {
         if (isRreparingStatement_ && callback_)
@@ -339,19 +417,45 @@ void PgConnection::handleRead()
         }
         else
         {
-            isWorking_ = false;
             isRreparingStatement_ = false;
-            idleCb_();
+            // Statements dropped from the cache are deallocated before the
+            // connection takes the next query
+            if (!sendDeallocations())
+            {
+                isWorking_ = false;
+                idleCb_();
+            }
         }
     }
 }
 
+bool PgConnection::sendDeallocations()
+{
+    if (statementsToDeallocate_.empty())
+        return false;
+    std::string sql;
+    for (auto &name : statementsToDeallocate_)
+    {
+        sql.append("deallocate \"").append(name).append("\";");
+    }
+    statementsToDeallocate_.clear();
+    if (PQsendQuery(connectionPtr_.get(), sql.c_str()) == 0)
+    {
+        LOG_ERROR << "send query error: "
+                  << PQerrorMessage(connectionPtr_.get());
+        return false;
+    }
+    isDeallocating_ = true;
+    flush();
+    return true;
+}
+
 void PgConnection::doAfterPreparing()
 {
     isRreparingStatement_ = false;
-    auto r = preparedStatements_.insert(std::string{sql_});
-    preparedStatementsMap_[string_view{r.first->data(), r.first->length()}] =
-        statementName_;
+    dropStatement(preparedStatements_.insert(
+        std::string{sql_.data(), sql_.length()}, statementName_));
+    checkResultFormat_ = binaryResults_;
     if (PQsendQueryPrepared(connectionPtr_.get(),
                             statementName_.c_str(),
                             parametersNumber_,
@@ -376,6 +480,9 @@ void PgConnection::doAfterPreparing()
 
 void PgConnection::handleFatalError()
 {
+    // Nobody waits for the result of a deallocation
+    if (!exceptionCallback_)
+        return;
     auto exceptPtr =
         std::make_exception_ptr(Failure(PQerrorMessage(connectionPtr_.get())));
     exceptionCallback_(exceptPtr);
@@ -15,6 +15,8 @@
 #pragma once
 
 #include "../DbConnection.h"
+#include "PgBinaryFormat.h"
+#include "PreparedStatementCache.h"
 #include <drogon/orm/DbClient.h>
 #include <trantor/net/EventLoop.h>
 #include <trantor/net/Channel.h>
@@ -26,7 +28,7 @@
 #include <functional>
 #include <iostream>
 #include <list>
-#include <set>
+#include <vector>
 
 namespace drogon
 {
@@ -38,7 +40,20 @@ class PgConnection : public DbConnection,
                      public std::enable_shared_from_this<PgConnection>
 {
   public:
-    PgConnection(trantor::EventLoop *loop, const std::string &connInfo);
+    /**
+     * The connection keeps at most maxPreparedStatements prepared
+     * statements on the server and deallocates the least recently used ones
+     * beyond that. Its cache hits and misses are added to counters if given.
+     *
+     * With binaryResults, a prepared statement whose result columns all have
+     * types in pg_binary::isSupported() returns its results in binary format
+     * from its second execution on.
+     */
+    PgConnection(trantor::EventLoop *loop,
+                 const std::string &connInfo,
+                 std::shared_ptr<PreparedStatementCounters> counters = nullptr,
+                 bool binaryResults = false);
+    static constexpr size_t maxPreparedStatements = 128;
 
     virtual void execSql(string_view &&sql,
                          size_t paraNum,
@@ -85,8 +100,24 @@ class PgConnection : public DbConnection,
     virtual void batchSql(
         std::deque<std::shared_ptr<SqlCmd>> &&sqlCommands) override;
 
+    /**
+     * A statement with a deadline is cancelled with PQcancel() if it still
+     * runs at the deadline. In pipeline mode it also runs with a
+     * statement_timeout of the time left when it was sent.
+     */
+    virtual void execSqlCmd(std::shared_ptr<SqlCmd> &&cmd) override;
+
+    virtual void copySql(std::shared_ptr<CopyCmd> &&cmd) override;
+
     virtual void disconnect() override;
 
+    /// Receives the channel and payload of every LISTEN notification
+    void setNotificationCallback(
+        std::function<void(const std::string &, const std::string &)> &&cb)
+    {
+        notificationCallback_ = std::move(cb);
+    }
+
   private:
     std::shared_ptr<PGconn> connectionPtr_;
     trantor::Channel channel_;
@@ -117,8 +148,64 @@ class PgConnection : public DbConnection,
     std::vector<int> formats_;
     int flush();
     void handleFatalError();
-    std::set<std::string> preparedStatements_;
+    PreparedStatementCache preparedStatements_;
+    bool binaryResults_;
+    // Decide the result format of the statement from its first text result
+    void checkResultFormat(const string_view &sql, const PGresult *result)
+    {
+        auto statement = preparedStatements_.peek(sql);
+        if (!statement || statement->resultFormat_ >= 0)
+            return;
+        int columns = PQnfields(result);
+        statement->resultFormat_ = columns > 0 ? 1 : 0;
+        for (int i = 0; i < columns; ++i)
+        {
+            if (!pg_binary::isSupported(static_cast<int>(PQftype(result, i))))
+            {
+                statement->resultFormat_ = 0;
+                break;
+            }
+        }
+    }
+    // Names of statements dropped from preparedStatements_ that still exist
+    // on the server
+    std::vector<std::string> statementsToDeallocate_;
+    void dropStatement(std::string &&name)
+    {
+        if (!name.empty())
+            statementsToDeallocate_.push_back(std::move(name));
+    }
     string_view sql_;
+    std::function<void(const std::string &, const std::string &)>
+        notificationCallback_;
+    void handleNotifications()
+    {
+        PGnotify *notify;
+        while ((notify = PQnotifies(connectionPtr_.get())) != nullptr)
+        {
+            std::string channel{notify->relname};
+            std::string payload{notify->extra};
+            PQfreemem(notify);
+            notificationCallback_(channel, payload);
+        }
+    }
+    // The COPY running on the connection, see PgCopy.cc
+    std::shared_ptr<CopyCmd> copyCmd_;
+    bool copyingIn_{false};
+    bool copyingOut_{false};
+    // The producer returned its last rows
+    bool copyDataEnded_{false};
+    // Produced rows that libpq couldn't take yet
+    std::string copyBuffer_;
+    std::shared_ptr<PGresult> copyResult_;
+    std::string copyError_;
+    void copySqlInLoop(std::shared_ptr<CopyCmd> &&cmd);
+    void handleCopy();
+    void sendCopyData();
+    void finishCopy();
+    void abortCopy();
+    // Ask the server to stop the running statement, see PgCancel.cc
+    void cancelQuery();
 #if LIBPQ_SUPPORTS_BATCH_MODE
     void handleFatalError(bool clearAll);
     std::list<std::shared_ptr<SqlCmd>> batchCommandsForWaitingResults_;
@@ -126,11 +213,20 @@ class PgConnection : public DbConnection,
     void sendBatchedSql();
     int sendBatchEnd();
     bool sendBatchEnd_{false};
-    unsigned int batchCount_{0};
-    std::unordered_map<string_view, std::pair<std::string, bool>>
-        preparedStatementsMap_;
+    // Pipeline syncs sent whose PGRES_PIPELINE_SYNC has not been read yet
+    unsigned int pendingSyncs_{0};
+    int sendDeallocations();
+    // The statement_timeout of the session in milliseconds, 0 while it is
+    // the default
+    long statementTimeout_{0};
+    int sendStatementTimeout(const SqlCmd &cmd);
+    void cancelAtDeadline(const std::shared_ptr<SqlCmd> &cmd);
 #else
-    std::unordered_map<string_view, std::string> preparedStatementsMap_;
+    bool isDeallocating_{false};
+    bool checkResultFormat_{false};
+    bool sendDeallocations();
+    // Tells the statements apart for the cancel at a deadline
+    uint64_t queryId_{0};
 #endif
 };
 
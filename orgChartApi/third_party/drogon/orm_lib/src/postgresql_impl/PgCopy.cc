@@ -0,0 +1,235 @@
+/**
+ *
+ *  @file PgCopy.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "PgConnection.h"
+#include "PostgreSQLResultImpl.h"
+#include <drogon/orm/Exception.h>
+#include <trantor/utils/Logger.h>
+#include <exception>
+#include <memory>
+
+using namespace drogon::orm;
+
+// COPY is run outside of the pipeline (it isn't allowed in one), on a
+// connection that a transaction keeps idle around it. Rows are produced only
+// after libpq handed the previous ones to the socket, and received rows go
+// to the consumer as they arrive, so neither side is buffered beyond one
+// chunk of the producer.
+
+void PgConnection::copySql(std::shared_ptr<CopyCmd> &&cmd)
+{
+    if (loop_->isInLoopThread())
+    {
+        copySqlInLoop(std::move(cmd));
+    }
+    else
+    {
+        loop_->queueInLoop([thisPtr = shared_from_this(), cmd]() mutable {
+            thisPtr->copySqlInLoop(std::move(cmd));
+        });
+    }
+}
+
+void PgConnection::copySqlInLoop(std::shared_ptr<CopyCmd> &&cmd)
+{
+    LOG_TRACE << cmd->sql_;
+    loop_->assertInLoopThread();
+    assert(!copyCmd_);
+    copyCmd_ = std::move(cmd);
+    copyResult_.reset();
+    copyError_.clear();
+    copyDataEnded_ = false;
+    isWorking_ = true;
+#if LIBPQ_SUPPORTS_BATCH_MODE
+    if (!PQexitPipelineMode(connectionPtr_.get()))
+    {
+        copyError_ = PQerrorMessage(connectionPtr_.get());
+        finishCopy();
+        return;
+    }
+#endif
+    if (PQsendQuery(connectionPtr_.get(), copyCmd_->sql_.c_str()) == 0)
+    {
+        copyError_ = PQerrorMessage(connectionPtr_.get());
+        finishCopy();
+        return;
+    }
+    flush();
+}
+
+void PgConnection::handleCopy()
+{
+    auto conn = connectionPtr_.get();
+    // The result of COPY FROM STDIN only comes after the end of the data
+    if (copyingIn_)
+        return;
+    if (copyingOut_)
+    {
+        for (;;)
+        {
+            char *row = nullptr;
+            auto length = PQgetCopyData(conn, &row, 1);
+            if (length > 0)
+            {
+                copyCmd_->consumer_(row, static_cast<size_t>(length));
+                PQfreemem(row);
+                continue;
+            }
+            if (length == 0)
+                return;
+            // Done or failed, the result tells
+            copyingOut_ = false;
+            break;
+        }
+    }
+    while (!PQisBusy(conn))
+    {
+        std::shared_ptr<PGresult> res(PQgetResult(conn),
+                                      [](PGresult *p) { PQclear(p); });
+        if (!res)
+        {
+            finishCopy();
+            return;
+        }
+        switch (PQresultStatus(res.get()))
+        {
+            case PGRES_COPY_IN:
+                if (!copyCmd_->producer_)
+                {
+                    PQputCopyEnd(conn, "no rows to copy in");
+                    flush();
+                    break;
+                }
+                copyingIn_ = true;
+                sendCopyData();
+                return;
+            case PGRES_COPY_OUT:
+                if (!copyCmd_->consumer_)
+                    copyCmd_->consumer_ = [](const char *, size_t) {};
+                copyingOut_ = true;
+                handleCopy();
+                return;
+            case PGRES_COMMAND_OK:
+                copyResult_ = std::move(res);
+                break;
+            default:
+                if (copyError_.empty())
+                {
+                    copyError_ = PQresultErrorMessage(res.get());
+                    if (copyError_.empty())
+                        copyError_ = "The statement is not a COPY";
+                }
+                break;
+        }
+    }
+}
+
+void PgConnection::sendCopyData()
+{
+    auto conn = connectionPtr_.get();
+    while (copyingIn_)
+    {
+        if (!copyBuffer_.empty())
+        {
+            auto ret = PQputCopyData(conn,
+                                     copyBuffer_.data(),
+                                     static_cast<int>(copyBuffer_.size()));
+            if (ret == 0)
+            {
+                if (!channel_.isWriting())
+                    channel_.enableWriting();
+                return;
+            }
+            if (ret < 0)
+            {
+                LOG_ERROR << "COPY error: " << PQerrorMessage(conn);
+                copyingIn_ = false;
+                return;
+            }
+            copyBuffer_.clear();
+            // The write callback comes back here once the socket took it
+            if (flush() != 0)
+                return;
+        }
+        if (copyDataEnded_)
+        {
+            if (PQputCopyEnd(conn, nullptr) == 0)
+            {
+                if (!channel_.isWriting())
+                    channel_.enableWriting();
+                return;
+            }
+            copyingIn_ = false;
+            flush();
+            return;
+        }
+        try
+        {
+            copyDataEnded_ = !copyCmd_->producer_(copyBuffer_);
+        }
+        catch (const std::exception &e)
+        {
+            // The server fails the COPY with the message
+            copyingIn_ = false;
+            copyBuffer_.clear();
+            PQputCopyEnd(conn, e.what());
+            flush();
+            return;
+        }
+    }
+}
+
+void PgConnection::finishCopy()
+{
+    auto cmd = std::move(copyCmd_);
+    auto result = std::move(copyResult_);
+    copyingIn_ = false;
+    copyingOut_ = false;
+    copyBuffer_.clear();
+    bool broken = false;
+#if LIBPQ_SUPPORTS_BATCH_MODE
+    if (PQpipelineStatus(connectionPtr_.get()) == PQ_PIPELINE_OFF &&
+        !PQenterPipelineMode(connectionPtr_.get()))
+    {
+        LOG_ERROR << "Can't enter pipeline mode after COPY: "
+                  << PQerrorMessage(connectionPtr_.get());
+        broken = true;
+    }
+#endif
+    isWorking_ = false;
+    if (copyError_.empty())
+    {
+        cmd->callback_(
+            Result(std::make_shared<PostgreSQLResultImpl>(result)));
+    }
+    else
+    {
+        cmd->exceptionCallback_(std::make_exception_ptr(Failure(copyError_)));
+    }
+    if (broken)
+    {
+        handleClosed();
+        return;
+    }
+    idleCb_();
+}
+
+void PgConnection::abortCopy()
+{
+    if (!copyCmd_)
+        return;
+    auto cmd = std::move(copyCmd_);
+    copyingIn_ = false;
+    copyingOut_ = false;
+    copyBuffer_.clear();
+    cmd->exceptionCallback_(std::make_exception_ptr(
+        BrokenConnection("The connection broke during COPY")));
+}
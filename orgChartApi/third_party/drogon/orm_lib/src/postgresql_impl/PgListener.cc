@@ -0,0 +1,188 @@
+/**
+ *
+ *  @file PgListener.cc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#include "PgListener.h"
+#include <drogon/orm/Exception.h>
+#include <trantor/utils/Logger.h>
+#include <exception>
+
+using namespace drogon::orm;
+
+PgListener::PgListener(std::string connInfo, trantor::EventLoop *loop)
+    : connInfo_(std::move(connInfo)), loop_(loop)
+{
+    if (!loop_)
+    {
+        loopThread_ = std::make_unique<trantor::EventLoopThread>("DbListener");
+        loopThread_->run();
+        loop_ = loopThread_->getLoop();
+    }
+}
+
+PgListener::~PgListener()
+{
+    if (connection_)
+        connection_->disconnect();
+}
+
+void PgListener::init()
+{
+    std::weak_ptr<PgListener> weakPtr = shared_from_this();
+    loop_->runInLoop([weakPtr]() {
+        if (auto thisPtr = weakPtr.lock())
+            thisPtr->connect();
+    });
+}
+
+std::string PgListener::listenSql(const std::string &channel, bool listen)
+{
+    std::string sql = listen ? "listen \"" : "unlisten \"";
+    for (auto ch : channel)
+    {
+        if (ch == '"')
+            sql.push_back('"');
+        sql.push_back(ch);
+    }
+    sql.push_back('"');
+    return sql;
+}
+
+void PgListener::listen(const std::string &channel,
+                        MessageCallback messageCallback) noexcept
+{
+    std::weak_ptr<PgListener> weakPtr = shared_from_this();
+    loop_->runInLoop([weakPtr,
+                      channel,
+                      messageCallback = std::move(messageCallback)]() mutable {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr)
+            return;
+        auto &callbacks = thisPtr->channels_[channel];
+        callbacks.push_back(std::move(messageCallback));
+        // A new connection listens to every channel once it's open
+        if (callbacks.size() == 1 && thisPtr->connected_)
+        {
+            thisPtr->statements_.push_back(listenSql(channel, true));
+            thisPtr->sendNext();
+        }
+    });
+}
+
+void PgListener::unlisten(const std::string &channel) noexcept
+{
+    std::weak_ptr<PgListener> weakPtr = shared_from_this();
+    loop_->runInLoop([weakPtr, channel]() {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr || thisPtr->channels_.erase(channel) == 0)
+            return;
+        if (thisPtr->connected_)
+        {
+            thisPtr->statements_.push_back(listenSql(channel, false));
+            thisPtr->sendNext();
+        }
+    });
+}
+
+void PgListener::setReconnectCallback(std::function<void()> callback)
+{
+    std::weak_ptr<PgListener> weakPtr = shared_from_this();
+    loop_->runInLoop([weakPtr, callback = std::move(callback)]() mutable {
+        if (auto thisPtr = weakPtr.lock())
+            thisPtr->reconnectCallback_ = std::move(callback);
+    });
+}
+
+void PgListener::connect()
+{
+    loop_->assertInLoopThread();
+    std::weak_ptr<PgListener> weakPtr = shared_from_this();
+    connection_ = std::make_shared<PgConnection>(loop_, connInfo_);
+    connection_->setNotificationCallback(
+        [weakPtr](const std::string &channel, const std::string &payload) {
+            if (auto thisPtr = weakPtr.lock())
+                thisPtr->deliver(channel, payload);
+        });
+    connection_->setOkCallback([weakPtr](const DbConnectionPtr &) {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr)
+            return;
+        thisPtr->connected_ = true;
+        thisPtr->statements_.clear();
+        for (auto &channel : thisPtr->channels_)
+        {
+            thisPtr->statements_.push_back(listenSql(channel.first, true));
+        }
+        thisPtr->sendNext();
+        if (thisPtr->hasConnected_ && thisPtr->reconnectCallback_)
+            thisPtr->reconnectCallback_();
+        thisPtr->hasConnected_ = true;
+    });
+    connection_->setIdleCallback([weakPtr]() {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr)
+            return;
+        thisPtr->working_ = false;
+        thisPtr->sendNext();
+    });
+    connection_->setCloseCallback([weakPtr](const DbConnectionPtr &) {
+        auto thisPtr = weakPtr.lock();
+        if (!thisPtr)
+            return;
+        LOG_ERROR << "The connection of the listener broke, reconnecting";
+        thisPtr->connected_ = false;
+        thisPtr->working_ = false;
+        thisPtr->connection_.reset();
+        thisPtr->loop_->runAfter(1.0, [weakPtr]() {
+            if (auto thisPtr = weakPtr.lock())
+                thisPtr->connect();
+        });
+    });
+}
+
+void PgListener::sendNext()
+{
+    if (working_ || !connected_ || statements_.empty())
+        return;
+    working_ = true;
+    auto sql = std::make_shared<std::string>(std::move(statements_.front()));
+    statements_.pop_front();
+    connection_->execSql(
+        string_view{sql->data(), sql->length()},
+        0,
+        {},
+        {},
+        {},
+        [sql](const Result &) {},
+        [sql](const std::exception_ptr &exception) {
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+            catch (const std::exception &e)
+            {
+                LOG_ERROR << *sql << " failed: " << e.what();
+            }
+        });
+}
+
+void PgListener::deliver(const std::string &channel,
+                         const std::string &payload)
+{
+    auto iter = channels_.find(channel);
+    if (iter == channels_.end())
+        return;
+    // A callback may listen to or unlisten from channels
+    auto callbacks = iter->second;
+    for (auto &callback : callbacks)
+    {
+        callback(payload);
+    }
+}
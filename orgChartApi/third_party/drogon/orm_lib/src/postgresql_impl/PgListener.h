@@ -0,0 +1,64 @@
+/**
+ *
+ *  @file PgListener.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include "PgConnection.h"
+#include <drogon/orm/DbListener.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/net/EventLoopThread.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace drogon
+{
+namespace orm
+{
+class PgListener : public DbListener,
+                   public std::enable_shared_from_this<PgListener>
+{
+  public:
+    PgListener(std::string connInfo, trantor::EventLoop *loop);
+    ~PgListener() override;
+    void init();
+
+    void listen(const std::string &channel,
+                MessageCallback messageCallback) noexcept override;
+    void unlisten(const std::string &channel) noexcept override;
+    void setReconnectCallback(std::function<void()> callback) override;
+
+    /// The statement that (un)listens to the channel, whose name is quoted
+    static std::string listenSql(const std::string &channel, bool listen);
+
+  private:
+    void connect();
+    void sendNext();
+    void deliver(const std::string &channel, const std::string &payload);
+
+    std::string connInfo_;
+    std::unique_ptr<trantor::EventLoopThread> loopThread_;
+    trantor::EventLoop *loop_;
+    // The members below are only used in the loop
+    PgConnectionPtr connection_;
+    bool connected_{false};
+    bool working_{false};
+    bool hasConnected_{false};
+    std::unordered_map<std::string, std::vector<MessageCallback>> channels_;
+    // LISTEN and UNLISTEN statements to send one after another
+    std::deque<std::string> statements_;
+    std::function<void()> reconnectCallback_;
+};
+
+}  // namespace orm
+}  // namespace drogon
@@ -13,11 +13,46 @@
  */
 
 #include "PostgreSQLResultImpl.h"
+#include "PgBinaryFormat.h"
+#include <algorithm>
 #include <cassert>
 #include <drogon/orm/Exception.h>
 
 using namespace drogon::orm;
 
+PostgreSQLResultImpl::PostgreSQLResultImpl(
+    const std::shared_ptr<PGresult> &r) noexcept
+    : result_(r)
+{
+    if (!PQbinaryTuples(result_.get()))
+        return;
+    auto columns = PQnfields(result_.get());
+    binaryColumns_.resize(columns, 0);
+    for (int i = 0; i < columns; ++i)
+    {
+        if (PQfformat(result_.get(), i) == 1)
+        {
+            binaryColumns_[i] =
+                pg_binary::isTextual(PQftype(result_.get(), i)) ? 1 : 2;
+        }
+    }
+}
+
+const std::string &PostgreSQLResultImpl::text(SizeType row,
+                                              RowSizeType column) const
+{
+    auto key = row * binaryColumns_.size() + column;
+    std::lock_guard<std::mutex> lock(textsMutex_);
+    auto iter = texts_.find(key);
+    if (iter != texts_.end())
+        return iter->second;
+    auto &text = texts_[key];
+    text = pg_binary::toText(PQftype(result_.get(), int(column)),
+                             PQgetvalue(result_.get(), int(row), int(column)),
+                             PQgetlength(result_.get(), int(row), int(column)));
+    return text;
+}
+
 Result::SizeType PostgreSQLResultImpl::size() const noexcept
 {
     return result_ ? PQntuples(result_.get()) : 0;
@@ -55,6 +90,29 @@ Result::RowSizeType PostgreSQLResultImpl::columnNumber(
     auto ptr = const_cast<PGresult *>(result_.get());
     if (ptr)
     {
+        // PQfnumber() scans all columns and folds the name to lower case
+        // unless it is quoted, so only such names are looked up in the map
+        string_view name{colName};
+        if (std::none_of(name.begin(), name.end(), [](char ch) {
+                return ch == '"' || (ch >= 'A' && ch <= 'Z');
+            }))
+        {
+            std::call_once(columnNumbersOnce_, [this, ptr]() {
+                auto columns = PQnfields(ptr);
+                columnNumbers_.reserve(columns);
+                for (int i = 0; i < columns; ++i)
+                {
+                    // The first of columns with the same name wins, as with
+                    // PQfnumber()
+                    columnNumbers_.emplace(PQfname(ptr, i), i);
+                }
+            });
+            auto iter = columnNumbers_.find(name);
+            if (iter == columnNumbers_.end())
+                throw RangeError(std::string("there is no column named ") +
+                                 colName);
+            return iter->second;
+        }
         auto N = PQfnumber(ptr, colName);
         if (N == -1)
             throw RangeError(std::string("there is no column named ") +
@@ -67,6 +125,19 @@ Result::RowSizeType PostgreSQLResultImpl::columnNumber(
 const char *PostgreSQLResultImpl::getValue(SizeType row,
                                            RowSizeType column) const
 {
+    if (!binaryColumns_.empty() && binaryColumns_[column] == 2 &&
+        !isNull(row, column))
+    {
+        return text(row, column).c_str();
+    }
+    return PQgetvalue(result_.get(), int(row), int(column));
+}
+
+const char *PostgreSQLResultImpl::getBinaryValue(SizeType row,
+                                                 RowSizeType column) const
+{
+    if (binaryColumns_.empty() || !binaryColumns_[column])
+        return nullptr;
     return PQgetvalue(result_.get(), int(row), int(column));
 }
 
@@ -78,6 +149,11 @@ bool PostgreSQLResultImpl::isNull(SizeType row, RowSizeType column) const
 Result::FieldSizeType PostgreSQLResultImpl::getLength(SizeType row,
                                                       RowSizeType column) const
 {
+    if (!binaryColumns_.empty() && binaryColumns_[column] == 2 &&
+        !isNull(row, column))
+    {
+        return text(row, column).length();
+    }
     return PQgetlength(result_.get(), int(row), int(column));
 }
 
@@ -16,9 +16,13 @@
 
 #include "../ResultImpl.h"
 
+#include <drogon/utils/string_view.h>
 #include <libpq-fe.h>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace drogon
 {
@@ -27,10 +31,7 @@ namespace orm
 class PostgreSQLResultImpl : public ResultImpl
 {
   public:
-    PostgreSQLResultImpl(const std::shared_ptr<PGresult> &r) noexcept
-        : result_(r)
-    {
-    }
+    PostgreSQLResultImpl(const std::shared_ptr<PGresult> &r) noexcept;
     virtual SizeType size() const noexcept override;
     virtual RowSizeType columns() const noexcept override;
     virtual const char *columnName(RowSizeType number) const override;
@@ -42,9 +43,22 @@ class PostgreSQLResultImpl : public ResultImpl
     virtual FieldSizeType getLength(SizeType row,
                                     RowSizeType column) const override;
     virtual int oid(RowSizeType column) const override;
+    virtual const char *getBinaryValue(SizeType row,
+                                       RowSizeType column) const override;
 
   private:
     std::shared_ptr<PGresult> result_;
+    // Per column, 1 if it is in binary format, 2 if moreover its text has to
+    // be rendered for getValue()
+    std::vector<char> binaryColumns_;
+    mutable std::mutex textsMutex_;
+    // Rendered texts by row * columns + column
+    mutable std::unordered_map<size_t, std::string> texts_;
+    const std::string &text(SizeType row, RowSizeType column) const;
+    // Column numbers by name, built on the first lookup by name so that the
+    // rows of a result share it. The names point into result_.
+    mutable std::once_flag columnNumbersOnce_;
+    mutable std::unordered_map<string_view, RowSizeType> columnNumbers_;
 };
 
 }  // namespace orm
@@ -0,0 +1,149 @@
+/**
+ *
+ *  @file PreparedStatementCache.h
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the License file.
+ *
+ *  Drogon
+ *
+ */
+
+#pragma once
+
+#include <drogon/utils/string_view.h>
+#include <trantor/utils/NonCopyable.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace drogon
+{
+namespace orm
+{
+/// Prepared statement counters shared by the connections of a client
+struct PreparedStatementCounters
+{
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    // Statements currently prepared on all the connections
+    std::atomic<int64_t> cached_{0};
+};
+
+/**
+ * The statements prepared on one connection, keyed by their SQL text. It
+ * holds at most capacity statements, adding one more drops the least
+ * recently used one and hands its name back so that the caller can
+ * DEALLOCATE it on the server.
+ */
+class PreparedStatementCache : public trantor::NonCopyable
+{
+  public:
+    struct Statement
+    {
+        std::string sql_;
+        std::string name_;
+        bool isChanging_{false};
+        // 1 for binary, 0 for text, -1 while the column types are unknown
+        int resultFormat_{-1};
+    };
+
+    PreparedStatementCache(size_t capacity,
+                           std::shared_ptr<PreparedStatementCounters> counters)
+        : capacity_(capacity > 0 ? capacity : 1),
+          counters_(counters ? std::move(counters)
+                             : std::make_shared<PreparedStatementCounters>())
+    {
+    }
+    ~PreparedStatementCache()
+    {
+        counters_->cached_.fetch_sub(static_cast<int64_t>(statements_.size()),
+                                     std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Find the statement prepared for the sql and make it the most
+     * recently used one.
+     *
+     * @return nullptr if the sql has not been prepared on this connection.
+     */
+    const Statement *find(const string_view &sql)
+    {
+        auto iter = index_.find(sql);
+        if (iter == index_.end())
+        {
+            counters_->misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        counters_->hits_.fetch_add(1, std::memory_order_relaxed);
+        statements_.splice(statements_.begin(), statements_, iter->second);
+        return &*iter->second;
+    }
+
+    /// Find the statement prepared for the sql without counting or using it
+    Statement *peek(const string_view &sql)
+    {
+        auto iter = index_.find(sql);
+        return iter == index_.end() ? nullptr : &*iter->second;
+    }
+
+    /**
+     * @brief Add a statement that has been prepared on the server.
+     *
+     * @return The name of the statement that is no longer cached because it
+     * was the least recently used one or was prepared for the same sql
+     * before, or an empty string.
+     */
+    std::string insert(std::string sql,
+                       std::string name,
+                       bool isChanging = false)
+    {
+        std::string dropped;
+        auto iter = index_.find(sql);
+        if (iter != index_.end())
+        {
+            // Queries in flight at the same time prepared the sql twice
+            auto entry = iter->second;
+            dropped = std::move(entry->name_);
+            index_.erase(iter);
+            statements_.erase(entry);
+        }
+        else if (statements_.size() >= capacity_)
+        {
+            auto entry = std::prev(statements_.end());
+            dropped = std::move(entry->name_);
+            index_.erase(string_view{entry->sql_.data(), entry->sql_.length()});
+            statements_.erase(entry);
+            counters_->evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            counters_->cached_.fetch_add(1, std::memory_order_relaxed);
+        }
+        statements_.push_front(
+            Statement{std::move(sql), std::move(name), isChanging});
+        auto &front = statements_.front();
+        index_.emplace(string_view{front.sql_.data(), front.sql_.length()},
+                       statements_.begin());
+        return dropped;
+    }
+
+    size_t size() const
+    {
+        return statements_.size();
+    }
+
+  private:
+    size_t capacity_;
+    std::shared_ptr<PreparedStatementCounters> counters_;
+    // Most recently used first, the keys of index_ point into the sql_ of
+    // the entries
+    std::list<Statement> statements_;
+    std::unordered_map<string_view, std::list<Statement>::iterator> index_;
+};
+
+}  // namespace orm
+}  // namespace drogon
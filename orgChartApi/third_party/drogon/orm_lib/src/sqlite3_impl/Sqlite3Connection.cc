@@ -16,6 +16,7 @@
 #include "Sqlite3ResultImpl.h"
 #include <drogon/utils/Utilities.h>
 #include <drogon/utils/string_view.h>
+#include <algorithm>
 #include <cctype>
 #include <exception>
 #include <mutex>
@@ -57,6 +58,7 @@ void Sqlite3Connection::init()
     // Get the key and value
     auto connParams = parseConnString(connInfo_);
     std::string filename;
+    std::string journalMode;
     for (auto const &kv : connParams)
     {
         auto key = kv.first;
@@ -66,14 +68,34 @@ void Sqlite3Connection::init()
         {
             filename = value;
         }
+        else if (key == "journal_mode")
+        {
+            journalMode = value;
+            std::transform(journalMode.begin(),
+                           journalMode.end(),
+                           journalMode.begin(),
+                           tolower);
+        }
     }
-    loop_->runInLoop([this, filename = std::move(filename)]() {
+    loop_->runInLoop([this,
+                      filename = std::move(filename),
+                      journalMode = std::move(journalMode)]() {
         sqlite3 *tmp = nullptr;
-        auto ret = sqlite3_open(filename.data(), &tmp);
+        // URI file names let the connections of a client share one
+        // in-memory database
+        auto ret = sqlite3_open_v2(filename.data(),
+                                   &tmp,
+                                   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+                                       SQLITE_OPEN_URI,
+                                   nullptr);
         connectionPtr_ = std::shared_ptr<sqlite3>(tmp, [](sqlite3 *ptr) {
             sqlite3_close(ptr);
         });
         auto thisPtr = shared_from_this();
+        if (ret == SQLITE_OK && !journalMode.empty())
+        {
+            ret = setJournalMode(journalMode);
+        }
         if (ret != SQLITE_OK)
         {
             LOG_FATAL << sqlite3_errmsg(connectionPtr_.get());
@@ -87,6 +109,34 @@ void Sqlite3Connection::init()
     });
 }
 
+int Sqlite3Connection::setJournalMode(const std::string &journalMode)
+{
+    if (!std::all_of(journalMode.begin(), journalMode.end(), [](char ch) {
+            return std::isalpha(static_cast<unsigned char>(ch));
+        }))
+    {
+        LOG_ERROR << "Invalid sqlite3 journal mode: " << journalMode;
+        return SQLITE_MISUSE;
+    }
+    auto sql = "PRAGMA journal_mode=" + journalMode;
+    // With the write-ahead log a commit only syncs at checkpoints, the
+    // database stays consistent if the machine crashes but may lose the
+    // last transactions
+    if (journalMode == "wal")
+        sql += ";PRAGMA synchronous=NORMAL";
+    // The connections of a client open at the same time and switching the
+    // mode of a file locks it for a moment
+    sqlite3_busy_timeout(connectionPtr_.get(), 5000);
+    auto ret = sqlite3_exec(
+        connectionPtr_.get(), sql.c_str(), nullptr, nullptr, nullptr);
+    sqlite3_busy_timeout(connectionPtr_.get(), 0);
+    if (ret == SQLITE_OK)
+    {
+        LOG_TRACE << "sqlite3 journal mode: " << journalMode;
+    }
+    return ret;
+}
+
 void Sqlite3Connection::execSql(
     string_view &&sql,
     size_t paraNum,
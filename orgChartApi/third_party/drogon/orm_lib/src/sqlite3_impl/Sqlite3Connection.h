@@ -72,6 +72,8 @@ class Sqlite3Connection : public DbConnection,
     void onError(
         const string_view &sql,
         const std::function<void(const std::exception_ptr &)> &exceptCallback);
+    // Returns an sqlite3 result code
+    int setJournalMode(const std::string &journalMode);
     int stmtStep(sqlite3_stmt *stmt,
                  const std::shared_ptr<Sqlite3ResultImpl> &resultPtr,
                  int columnNum);
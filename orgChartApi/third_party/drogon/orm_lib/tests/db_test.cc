@@ -18,11 +18,14 @@
 #include <drogon/drogon_test.h>
 #include <drogon/orm/CoroMapper.h>
 #include <drogon/orm/DbClient.h>
+#include <drogon/orm/DbListener.h>
 #include <drogon/orm/DbTypes.h>
 #include <trantor/utils/Logger.h>
 
 #include <stdlib.h>
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <iostream>
 #include <string>
 #include <thread>
@@ -797,6 +800,129 @@ DROGON_TEST(PostgreTest)
 
 #endif
 }
+
+DROGON_TEST(PostgreListenerTest)
+{
+    auto listener = DbListener::newPgListener(
+        "host=127.0.0.1 port=5432 dbname=postgres user=postgres password=12345 "
+        "client_encoding=utf8");
+    auto received = std::make_shared<std::promise<std::string>>();
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    listener->listen("drogon \"test\"",
+                     [received, done](const std::string &payload) {
+                         if (!done->exchange(true))
+                             received->set_value(payload);
+                     });
+    auto future = received->get_future();
+    // The listener starts listening once its connection is open, so the
+    // notification is sent again until it arrives
+    for (int i = 0; i < 50; ++i)
+    {
+        postgreClient->execSqlSync("select pg_notify($1, $2)",
+                                   "drogon \"test\"",
+                                   "hello");
+        if (future.wait_for(100ms) == std::future_status::ready)
+            break;
+    }
+    MANDATE(future.wait_for(0ms) == std::future_status::ready);
+    CHECK(future.get() == "hello");
+    listener->unlisten("drogon \"test\"");
+}
+
+DROGON_TEST(PostgreDeadlineTest)
+{
+    // One connection, the statement that runs past its deadline has to be
+    // stopped on the server before the next one can run
+    auto client = DbClient::newPgClient(
+        "host=127.0.0.1 port=5432 dbname=postgres user=postgres password=12345 "
+        "client_encoding=utf8",
+        1);
+    client->execSqlSync("select 1");
+    auto deadlineClient = DbClient::newDeadlineClient(
+        client, std::chrono::steady_clock::now() + 200ms);
+    auto start = std::chrono::steady_clock::now();
+    CHECK_THROWS_AS(deadlineClient->execSqlSync("select pg_sleep(10)"),
+                    TimeoutError);
+    client->execSqlSync("select 1");
+    CHECK(std::chrono::steady_clock::now() - start < 5s);
+
+    // A statement with time left runs as usual
+    deadlineClient = DbClient::newDeadlineClient(
+        client, std::chrono::steady_clock::now() + 5s);
+    auto result = deadlineClient->execSqlSync("select $1::int", 42);
+    CHECK(result[0][0].as<int>() == 42);
+
+    // Queued behind a busy connection, the statements below are pipelined
+    // together. The one past its deadline fails alone, the statements of
+    // the other requests around it still succeed.
+    auto busy = client->execSqlAsyncFuture("select pg_sleep(0.1)");
+    auto before = client->execSqlAsyncFuture("select $1::int", 1);
+    deadlineClient = DbClient::newDeadlineClient(
+        client, std::chrono::steady_clock::now() + 300ms);
+    auto late = deadlineClient->execSqlAsyncFuture("select pg_sleep(10)");
+    auto after = client->execSqlAsyncFuture("select $1::int", 2);
+    busy.get();
+    CHECK(before.get()[0][0].as<int>() == 1);
+    CHECK_THROWS(late.get());
+    CHECK(after.get()[0][0].as<int>() == 2);
+}
+
+DROGON_TEST(PostgrePipelineIsolationTest)
+{
+    // Queued behind a busy connection, the reads below are pipelined on it.
+    // The one failing at runtime must not abort the reads of the other
+    // requests written after it.
+    auto client = DbClient::newPgClient(
+        "host=127.0.0.1 port=5432 dbname=postgres user=postgres password=12345 "
+        "client_encoding=utf8",
+        1);
+    client->execSqlSync("select 1");
+    auto busy = client->execSqlAsyncFuture("select pg_sleep(0.1)");
+    std::vector<std::future<Result>> healthy;
+    for (int i = 0; i < 4; ++i)
+    {
+        healthy.push_back(client->execSqlAsyncFuture("select $1::int", i));
+    }
+    auto failing = client->execSqlAsyncFuture("select 1 / $1::int", 0);
+    for (int i = 4; i < 8; ++i)
+    {
+        healthy.push_back(client->execSqlAsyncFuture("select $1::int", i));
+    }
+    busy.get();
+    CHECK_THROWS(failing.get());
+    for (int i = 0; i < 8; ++i)
+    {
+        CHECK(healthy[i].get()[0][0].as<int>() == i);
+    }
+}
+
+DROGON_TEST(PostgreGroupCommitTest)
+{
+    // A failing statement aborts a PostgreSQL transaction, the savepoint
+    // around it keeps the rest of the group
+    postgreClient->execSqlSync("drop table if exists group_commit");
+    postgreClient->execSqlSync(
+        "create table group_commit (id int primary key)");
+    auto client = DbClient::newGroupCommitClient(postgreClient, 0.05, 64);
+    std::vector<std::future<bool>> results;
+    for (int id : {1, 1, 2})
+    {
+        auto done = std::make_shared<std::promise<bool>>();
+        client->execSqlAsync(
+            "insert into group_commit (id) values ($1)",
+            [done](const Result &) { done->set_value(true); },
+            [done](const DrogonDbException &) { done->set_value(false); },
+            id);
+        results.push_back(done->get_future());
+    }
+    CHECK(results[0].get());
+    CHECK(!results[1].get());
+    CHECK(results[2].get());
+    auto result =
+        postgreClient->execSqlSync("select count(*) from group_commit");
+    CHECK(result[0][0].as<int>() == 2);
+    postgreClient->execSqlSync("drop table group_commit");
+}
 #endif
 
 #if USE_MYSQL
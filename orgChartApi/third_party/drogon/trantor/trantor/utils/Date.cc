@@ -220,9 +220,9 @@ std::string Date::toFormattedStringLocal(bool showMicroseconds) const
     }
     return buf;
 }
-std::string Date::toDbStringLocal() const
+size_t Date::toDbStringLocal(char *str, size_t len) const
 {
-    char buf[128] = {0};
+    int n;
     time_t seconds =
         static_cast<time_t>(microSecondsSinceEpoch_ / MICRO_SECONDS_PRE_SEC);
     struct tm tm_time;
@@ -237,42 +237,50 @@ std::string Date::toDbStringLocal() const
     {
         int microseconds =
             static_cast<int>(microSecondsSinceEpoch_ % MICRO_SECONDS_PRE_SEC);
-        snprintf(buf,
-                 sizeof(buf),
-                 "%4d-%02d-%02d %02d:%02d:%02d.%06d",
-                 tm_time.tm_year + 1900,
-                 tm_time.tm_mon + 1,
-                 tm_time.tm_mday,
-                 tm_time.tm_hour,
-                 tm_time.tm_min,
-                 tm_time.tm_sec,
-                 microseconds);
+        n = snprintf(str,
+                     len,
+                     "%4d-%02d-%02d %02d:%02d:%02d.%06d",
+                     tm_time.tm_year + 1900,
+                     tm_time.tm_mon + 1,
+                     tm_time.tm_mday,
+                     tm_time.tm_hour,
+                     tm_time.tm_min,
+                     tm_time.tm_sec,
+                     microseconds);
     }
     else
     {
         if (*this == roundDay())
         {
-            snprintf(buf,
-                     sizeof(buf),
-                     "%4d-%02d-%02d",
-                     tm_time.tm_year + 1900,
-                     tm_time.tm_mon + 1,
-                     tm_time.tm_mday);
+            n = snprintf(str,
+                         len,
+                         "%4d-%02d-%02d",
+                         tm_time.tm_year + 1900,
+                         tm_time.tm_mon + 1,
+                         tm_time.tm_mday);
         }
         else
         {
-            snprintf(buf,
-                     sizeof(buf),
-                     "%4d-%02d-%02d %02d:%02d:%02d",
-                     tm_time.tm_year + 1900,
-                     tm_time.tm_mon + 1,
-                     tm_time.tm_mday,
-                     tm_time.tm_hour,
-                     tm_time.tm_min,
-                     tm_time.tm_sec);
+            n = snprintf(str,
+                         len,
+                         "%4d-%02d-%02d %02d:%02d:%02d",
+                         tm_time.tm_year + 1900,
+                         tm_time.tm_mon + 1,
+                         tm_time.tm_mday,
+                         tm_time.tm_hour,
+                         tm_time.tm_min,
+                         tm_time.tm_sec);
         }
     }
-    return buf;
+    if (n < 0)
+        return 0;
+    return static_cast<size_t>(n) < len ? static_cast<size_t>(n) : len - 1;
+}
+std::string Date::toDbStringLocal() const
+{
+    char buf[128] = {0};
+    auto len = toDbStringLocal(buf, sizeof(buf));
+    return std::string(buf, len);
 }
 Date Date::fromDbStringLocal(const std::string &datetime)
 {
@@ -234,6 +234,14 @@ class TRANTOR_EXPORT Date
      */
     std::string toDbStringLocal() const;
 
+    /**
+     * @brief Write the string of toDbStringLocal() into str without
+     * allocating, str should hold at least 27 characters.
+     *
+     * @return The length of the string, which is cut to len - 1 characters.
+     */
+    size_t toDbStringLocal(char *str, size_t len) const;
+
     /**
      * @brief From DB string to trantor local time zone.
      *
@@ -0,0 +1,49 @@
+#include "CacheEntry.h"
+#include <cmath>
+
+namespace {
+
+constexpr char kVersion = 1;
+constexpr size_t kHeaderSize = 1 + 8 + 8;
+
+void putInt64(std::string &out, int64_t value) {
+    auto raw = static_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(raw >> (8 * i)));
+    }
+}
+
+int64_t getInt64(const char *p) {
+    uint64_t raw = 0;
+    for (int i = 0; i < 8; ++i) {
+        raw |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    }
+    return static_cast<int64_t>(raw);
+}
+
+}  // namespace
+
+std::string encodeCacheEntry(const CacheEntry &entry) {
+    std::string out;
+    out.reserve(kHeaderSize + entry.value.size());
+    out.push_back(kVersion);
+    putInt64(out, entry.expiresAt);
+    putInt64(out, entry.delta);
+    out.append(entry.value);
+    return out;
+}
+
+bool decodeCacheEntry(const std::string &data, CacheEntry &entry) {
+    if (data.size() < kHeaderSize || data[0] != kVersion) {
+        return false;
+    }
+    entry.expiresAt = getInt64(data.data() + 1);
+    entry.delta = getInt64(data.data() + 9);
+    entry.value.assign(data, kHeaderSize, std::string::npos);
+    return true;
+}
+
+bool shouldRefreshEarly(const CacheEntry &entry, int64_t now, double beta, double random) {
+    // -ln(random) >= 0, exponentially distributed
+    return now - entry.delta * beta * std::log(random) >= entry.expiresAt;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// A cached value with a soft TTL. Past its soft expiry the value is stale but
+// can still be served while one request recomputes it.
+struct CacheEntry {
+    int64_t expiresAt{0};  // soft expiry, microseconds since the epoch
+    int64_t delta{0};      // microseconds it took to compute the value
+    std::string value;
+};
+
+// Binary form kept in Redis:
+//
+//   version    one byte, 1
+//   expiresAt  8 bytes, little endian
+//   delta      8 bytes, little endian
+//   value      the rest
+//
+// decodeCacheEntry() returns false, and leaves the entry alone, for a value
+// of another version or a truncated one.
+std::string encodeCacheEntry(const CacheEntry &entry);
+bool decodeCacheEntry(const std::string &data, CacheEntry &entry);
+
+// XFetch, probabilistic early recomputation: true when a request at now
+// should recompute the entry, that is when now - delta * beta * ln(random)
+// reaches the soft expiry. The slower the value is to compute and the closer
+// its expiry, the likelier a request recomputes it ahead of time, so the
+// concurrent requests rarely all find it expired at once. beta > 1 favours
+// earlier recomputation. random is uniform in (0, 1].
+bool shouldRefreshEarly(const CacheEntry &entry, int64_t now, double beta, double random);
@@ -0,0 +1,268 @@
+#include "ModelCodec.h"
+#include "Varint.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace drogon_model::org_chart;
+
+namespace {
+
+constexpr char kVersion = 1;
+
+// Appends the columns in order, a null column only clears its bit
+class Writer {
+ public:
+    Writer() : out_{kVersion, 0} {}
+
+    void add(const int32_t *value) {
+        if (mark(value)) {
+            putVarint(out_, zigzag(*value));
+        }
+    }
+    void add(const std::string *value) {
+        if (mark(value)) {
+            putVarint(out_, value->size());
+            out_.append(*value);
+        }
+    }
+    void add(const trantor::Date *value) {
+        if (mark(value)) {
+            putVarint(out_, zigzag(value->microSecondsSinceEpoch()));
+        }
+    }
+
+    std::string take() { return std::move(out_); }
+
+ private:
+    bool mark(const void *value) {
+        if (value) {
+            out_[1] = static_cast<char>(out_[1] | (1 << column_));
+        }
+        ++column_;
+        return value != nullptr;
+    }
+
+    std::string out_;
+    unsigned column_{0};
+};
+
+// Reads the columns in the order they were added, each read returns whether
+// the column is present and could be decoded
+class Reader {
+ public:
+    explicit Reader(const std::string &data) : p_(data.data()), end_(data.data() + data.size()) {
+        ok_ = data.size() >= 2 && data[0] == kVersion;
+        if (ok_) {
+            present_ = static_cast<uint8_t>(data[1]);
+            p_ += 2;
+        }
+    }
+
+    bool read(int32_t &value) {
+        uint64_t raw;
+        if (!next() || !varint(raw)) {
+            return false;
+        }
+        value = static_cast<int32_t>(unzigzag(raw));
+        return true;
+    }
+    bool read(std::string &value) {
+        uint64_t length;
+        if (!next() || !varint(length)) {
+            return false;
+        }
+        if (length > static_cast<uint64_t>(end_ - p_)) {
+            ok_ = false;
+            return false;
+        }
+        value.assign(p_, length);
+        p_ += length;
+        return true;
+    }
+    bool read(trantor::Date &value) {
+        uint64_t raw;
+        if (!next() || !varint(raw)) {
+            return false;
+        }
+        value = trantor::Date(unzigzag(raw));
+        return true;
+    }
+
+    // Everything decoded and nothing left over
+    bool done() const { return ok_ && p_ == end_; }
+
+ private:
+    bool next() {
+        return ok_ && (present_ & (1u << column_++));
+    }
+    bool varint(uint64_t &value) {
+        ok_ = getVarint(p_, end_, value);
+        return ok_;
+    }
+
+    const char *p_;
+    const char *end_;
+    bool ok_{false};
+    uint8_t present_{0};
+    unsigned column_{0};
+};
+
+template <typename T>
+std::string encodeList(const std::vector<T> &models) {
+    std::string out;
+    putVarint(out, models.size());
+    for (const auto &model : models) {
+        auto data = encodeModel(model);
+        putVarint(out, data.size());
+        out.append(data);
+    }
+    return out;
+}
+
+template <typename T>
+bool decodeList(const std::string &data, std::vector<T> &models) {
+    const char *p = data.data();
+    const char *end = p + data.size();
+    uint64_t count;
+    // every model takes two bytes at least
+    if (!getVarint(p, end, count) || count > static_cast<uint64_t>(end - p) / 2) {
+        return false;
+    }
+    std::vector<T> decoded(count);
+    for (auto &model : decoded) {
+        uint64_t length;
+        if (!getVarint(p, end, length) || length > static_cast<uint64_t>(end - p) ||
+            !decodeModel(std::string(p, length), model)) {
+            return false;
+        }
+        p += length;
+    }
+    if (p != end) {
+        return false;
+    }
+    models = std::move(decoded);
+    return true;
+}
+
+}  // namespace
+
+std::string encodeModel(const Person &person) {
+    Writer writer;
+    writer.add(person.getId());
+    writer.add(person.getJobId());
+    writer.add(person.getDepartmentId());
+    writer.add(person.getManagerId());
+    writer.add(person.getFirstName());
+    writer.add(person.getLastName());
+    writer.add(person.getHireDate());
+    return writer.take();
+}
+
+std::string encodeModel(const Job &job) {
+    Writer writer;
+    writer.add(job.getId());
+    writer.add(job.getTitle());
+    return writer.take();
+}
+
+std::string encodeModel(const Department &department) {
+    Writer writer;
+    writer.add(department.getId());
+    writer.add(department.getName());
+    return writer.take();
+}
+
+bool decodeModel(const std::string &data, Person &person) {
+    Reader reader(data);
+    Person decoded;
+    int32_t id;
+    std::string text;
+    trantor::Date date;
+    if (reader.read(id)) {
+        decoded.setId(id);
+    }
+    if (reader.read(id)) {
+        decoded.setJobId(id);
+    }
+    if (reader.read(id)) {
+        decoded.setDepartmentId(id);
+    }
+    if (reader.read(id)) {
+        decoded.setManagerId(id);
+    }
+    if (reader.read(text)) {
+        decoded.setFirstName(std::move(text));
+    }
+    if (reader.read(text)) {
+        decoded.setLastName(std::move(text));
+    }
+    if (reader.read(date)) {
+        decoded.setHireDate(date);
+    }
+    if (!reader.done()) {
+        return false;
+    }
+    person = std::move(decoded);
+    return true;
+}
+
+bool decodeModel(const std::string &data, Job &job) {
+    Reader reader(data);
+    Job decoded;
+    int32_t id;
+    std::string title;
+    if (reader.read(id)) {
+        decoded.setId(id);
+    }
+    if (reader.read(title)) {
+        decoded.setTitle(std::move(title));
+    }
+    if (!reader.done()) {
+        return false;
+    }
+    job = std::move(decoded);
+    return true;
+}
+
+bool decodeModel(const std::string &data, Department &department) {
+    Reader reader(data);
+    Department decoded;
+    int32_t id;
+    std::string name;
+    if (reader.read(id)) {
+        decoded.setId(id);
+    }
+    if (reader.read(name)) {
+        decoded.setName(std::move(name));
+    }
+    if (!reader.done()) {
+        return false;
+    }
+    department = std::move(decoded);
+    return true;
+}
+
+std::string encodeModels(const std::vector<Person> &persons) {
+    return encodeList(persons);
+}
+
+std::string encodeModels(const std::vector<Job> &jobs) {
+    return encodeList(jobs);
+}
+
+std::string encodeModels(const std::vector<Department> &departments) {
+    return encodeList(departments);
+}
+
+bool decodeModels(const std::string &data, std::vector<Person> &persons) {
+    return decodeList(data, persons);
+}
+
+bool decodeModels(const std::string &data, std::vector<Job> &jobs) {
+    return decodeList(data, jobs);
+}
+
+bool decodeModels(const std::string &data, std::vector<Department> &departments) {
+    return decodeList(data, departments);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../models/Department.h"
+#include "../models/Job.h"
+#include "../models/Person.h"
+#include <string>
+#include <vector>
+
+// Compact binary form of the models kept in the Redis model cache:
+//
+//   version  one byte, 1
+//   present  one byte with bit i set when column i is not null
+//   columns  in the order of the model's columns, only the present ones:
+//            integers and dates (microseconds since the epoch) as zigzag
+//            varints, strings as varint length + bytes
+//
+// decodeModel() returns false, and leaves the model alone, for a value of
+// another version or a truncated one, so such entries count as misses.
+std::string encodeModel(const drogon_model::org_chart::Person &person);
+std::string encodeModel(const drogon_model::org_chart::Job &job);
+std::string encodeModel(const drogon_model::org_chart::Department &department);
+
+bool decodeModel(const std::string &data, drogon_model::org_chart::Person &person);
+bool decodeModel(const std::string &data, drogon_model::org_chart::Job &job);
+bool decodeModel(const std::string &data, drogon_model::org_chart::Department &department);
+
+// A list of models: varint count, then every model as varint length + its
+// form above. decodeModels() fails as a whole if any model does.
+std::string encodeModels(const std::vector<drogon_model::org_chart::Person> &persons);
+std::string encodeModels(const std::vector<drogon_model::org_chart::Job> &jobs);
+std::string encodeModels(const std::vector<drogon_model::org_chart::Department> &departments);
+
+bool decodeModels(const std::string &data, std::vector<drogon_model::org_chart::Person> &persons);
+bool decodeModels(const std::string &data, std::vector<drogon_model::org_chart::Job> &jobs);
+bool decodeModels(const std::string &data, std::vector<drogon_model::org_chart::Department> &departments);
@@ -0,0 +1,219 @@
+#include "OrgSnapshot.h"
+#include "Varint.h"
+#include <trantor/utils/Logger.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[4] = {'O', 'C', 'S', '1'};
+
+enum Section {
+    kId = 0,
+    kManagerId,
+    kDepartmentId,
+    kJobId,
+    kHireDay,
+    kFirstName,
+    kLastName,
+    kDepartmentName,
+    kJobTitle,
+    kDictionary,
+    kSectionCount
+};
+
+// magic, row count, capture time, dictionary size, section offsets
+constexpr size_t kHeaderSize = 4 + 4 + 8 + 4 + 4 * kSectionCount;
+
+void putFixed(std::string &out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+uint64_t getFixed(const char *p, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+    }
+    return value;
+}
+
+}  // namespace
+
+std::string encodeOrgSnapshot(std::vector<SnapshotRecord> &records, int64_t takenAt) {
+    std::sort(records.begin(), records.end(), [](const SnapshotRecord &a, const SnapshotRecord &b) {
+        return a.id < b.id;
+    });
+
+    std::unordered_map<std::string, uint32_t> dictIndex;
+    std::vector<const std::string *> dict;
+    auto intern = [&dictIndex, &dict](const std::string &s) -> uint64_t {
+        auto r = dictIndex.emplace(s, static_cast<uint32_t>(dict.size()));
+        if (r.second) {
+            dict.push_back(&r.first->first);
+        }
+        return r.first->second;
+    };
+
+    std::string sections[kSectionCount];
+    int64_t prevId = 0;
+    int64_t prevHireDay = 0;
+    for (const auto &r : records) {
+        putVarint(sections[kId], zigzag(r.id - prevId));
+        putVarint(sections[kManagerId], zigzag(static_cast<int64_t>(r.managerId) - r.id));
+        putVarint(sections[kDepartmentId], zigzag(r.departmentId));
+        putVarint(sections[kJobId], zigzag(r.jobId));
+        putVarint(sections[kHireDay], zigzag(r.hireDay - prevHireDay));
+        putVarint(sections[kFirstName], intern(r.firstName));
+        putVarint(sections[kLastName], intern(r.lastName));
+        putVarint(sections[kDepartmentName], intern(r.departmentName));
+        putVarint(sections[kJobTitle], intern(r.jobTitle));
+        prevId = r.id;
+        prevHireDay = r.hireDay;
+    }
+    for (const auto *s : dict) {
+        putVarint(sections[kDictionary], s->size());
+        sections[kDictionary].append(*s);
+    }
+
+    std::string out;
+    size_t total = kHeaderSize;
+    for (const auto &s : sections) {
+        total += s.size();
+    }
+    out.reserve(total);
+    out.append(kMagic, sizeof(kMagic));
+    putFixed(out, records.size(), 4);
+    putFixed(out, static_cast<uint64_t>(takenAt), 8);
+    putFixed(out, dict.size(), 4);
+    size_t offset = kHeaderSize;
+    for (const auto &s : sections) {
+        putFixed(out, offset, 4);
+        offset += s.size();
+    }
+    for (const auto &s : sections) {
+        out.append(s);
+    }
+    return out;
+}
+
+std::shared_ptr<OrgSnapshotView> OrgSnapshotView::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR << "mmap failed for snapshot " << path;
+        return nullptr;
+    }
+    std::shared_ptr<OrgSnapshotView> view(
+        new OrgSnapshotView(static_cast<const char *>(addr), static_cast<size_t>(st.st_size)));
+    if (!view->decode()) {
+        LOG_ERROR << "corrupt snapshot file " << path;
+        return nullptr;
+    }
+    return view;
+}
+
+OrgSnapshotView::~OrgSnapshotView() {
+    munmap(const_cast<char *>(data_), length_);
+}
+
+bool OrgSnapshotView::decode() {
+    if (length_ < kHeaderSize || memcmp(data_, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    auto rowCount = getFixed(data_ + 4, 4);
+    takenAt_ = static_cast<int64_t>(getFixed(data_ + 8, 8));
+    auto dictCount = getFixed(data_ + 16, 4);
+    // every row takes at least one byte in each column
+    if (rowCount > length_ || dictCount > length_) {
+        return false;
+    }
+
+    const char *sections[kSectionCount + 1];
+    for (size_t i = 0; i < kSectionCount; ++i) {
+        auto offset = getFixed(data_ + 20 + 4 * i, 4);
+        if (offset < kHeaderSize || offset > length_ || (i > 0 && data_ + offset < sections[i - 1])) {
+            return false;
+        }
+        sections[i] = data_ + offset;
+    }
+    sections[kSectionCount] = data_ + length_;
+
+    std::vector<drogon::string_view> dict;
+    dict.reserve(dictCount);
+    const char *p = sections[kDictionary];
+    const char *end = sections[kDictionary + 1];
+    for (uint64_t i = 0; i < dictCount; ++i) {
+        uint64_t len;
+        if (!getVarint(p, end, len) || len > static_cast<uint64_t>(end - p)) {
+            return false;
+        }
+        dict.emplace_back(p, len);
+        p += len;
+    }
+
+    const char *cursors[kDictionary];
+    std::copy(sections, sections + kDictionary, cursors);
+    auto next = [&cursors, &sections](int column, int64_t &value) {
+        uint64_t raw;
+        if (!getVarint(cursors[column], sections[column + 1], raw)) {
+            return false;
+        }
+        value = unzigzag(raw);
+        return true;
+    };
+    auto nextString = [&cursors, &sections, &dict](int column, drogon::string_view &value) {
+        uint64_t index;
+        if (!getVarint(cursors[column], sections[column + 1], index) || index >= dict.size()) {
+            return false;
+        }
+        value = dict[index];
+        return true;
+    };
+
+    rows_.resize(rowCount);
+    int64_t id = 0;
+    int64_t hireDay = 0;
+    for (auto &row : rows_) {
+        int64_t delta, managerDelta, departmentId, jobId, hireDelta;
+        if (!next(kId, delta) || !next(kManagerId, managerDelta) || !next(kDepartmentId, departmentId) ||
+            !next(kJobId, jobId) || !next(kHireDay, hireDelta) || !nextString(kFirstName, row.firstName) ||
+            !nextString(kLastName, row.lastName) || !nextString(kDepartmentName, row.departmentName) ||
+            !nextString(kJobTitle, row.jobTitle)) {
+            return false;
+        }
+        id += delta;
+        hireDay += hireDelta;
+        row.id = static_cast<int32_t>(id);
+        row.managerId = static_cast<int32_t>(id + managerDelta);
+        row.departmentId = static_cast<int32_t>(departmentId);
+        row.jobId = static_cast<int32_t>(jobId);
+        row.hireDay = static_cast<int32_t>(hireDay);
+    }
+    return true;
+}
+
+const OrgSnapshotView::Row *OrgSnapshotView::find(int32_t id) const {
+    auto iter = std::lower_bound(rows_.begin(), rows_.end(), id, [](const Row &row, int32_t key) {
+        return row.id < key;
+    });
+    if (iter == rows_.end() || iter->id != id) {
+        return nullptr;
+    }
+    return &*iter;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <drogon/utils/string_view.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One person as captured by a point-in-time org chart snapshot.
+struct SnapshotRecord {
+    int32_t id{0};
+    int32_t managerId{0};
+    int32_t departmentId{0};
+    int32_t jobId{0};
+    int32_t hireDay{0};  // days since 1970-01-01
+    std::string firstName;
+    std::string lastName;
+    std::string departmentName;
+    std::string jobTitle;
+};
+
+// Serializes records into the columnar snapshot format:
+//
+//   header   "OCS1", row count, capture time, dictionary size and the byte
+//            offset of every column section
+//   columns  id (zigzag varint delta, rows sorted by id), manager id (zigzag
+//            varint relative to the row id), department id and job id (zigzag
+//            varint), hire day (zigzag varint delta), then one varint
+//            dictionary index per row for first name, last name, department
+//            name and job title
+//   dict     every distinct string once, as varint length + bytes
+//
+// Records are sorted by id in place.
+std::string encodeOrgSnapshot(std::vector<SnapshotRecord> &records, int64_t takenAt);
+
+// Read-only view of a snapshot file. The file is memory-mapped and strings
+// are returned as views into the mapping, so the view must outlive them.
+class OrgSnapshotView {
+ public:
+    struct Row {
+        int32_t id;
+        int32_t managerId;
+        int32_t departmentId;
+        int32_t jobId;
+        int32_t hireDay;
+        drogon::string_view firstName;
+        drogon::string_view lastName;
+        drogon::string_view departmentName;
+        drogon::string_view jobTitle;
+    };
+
+    // Returns nullptr if the file is missing or is not a valid snapshot.
+    static std::shared_ptr<OrgSnapshotView> open(const std::string &path);
+
+    ~OrgSnapshotView();
+    OrgSnapshotView(const OrgSnapshotView &) = delete;
+    OrgSnapshotView &operator=(const OrgSnapshotView &) = delete;
+
+    int64_t takenAt() const { return takenAt_; }
+    const std::vector<Row> &rows() const { return rows_; }
+    const Row *find(int32_t id) const;
+
+ private:
+    OrgSnapshotView(const char *data, size_t length) : data_(data), length_(length) {}
+    bool decode();
+
+    const char *data_;
+    size_t length_;
+    int64_t takenAt_{0};
+    std::vector<Row> rows_;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Base 128 varints, least significant group first, as used by the snapshot
+// and model cache formats. Signed values go through zigzag() first so that
+// small negative numbers stay short.
+void putVarint(std::string &out, uint64_t value);
+
+// Reads one varint at p and advances p past it. Returns false for a varint
+// running past end or longer than 64 bits.
+bool getVarint(const char *&p, const char *end, uint64_t &value);
+
+uint64_t zigzag(int64_t value);
+int64_t unzigzag(uint64_t value);
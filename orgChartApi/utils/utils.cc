@@ -1,4 +1,7 @@
 #include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
 
 void badRequest(std::function<void(const drogon::HttpResponsePtr &)> &&callback, std::string err, drogon::HttpStatusCode code)
 {
@@ -14,3 +17,91 @@ Json::Value makeErrResp(std::string err) {
     ret["error"] = err;
     return ret;
 }
+
+drogon::orm::DbClientPtr getDbClient() {
+    static auto dbClientPtr = [] {
+        auto client = drogon::app().getDbClient();
+        auto &groupCommit = drogon::app().getCustomConfig()["group_commit"];
+        auto windowMs = groupCommit.get("window_ms", 0).asDouble();
+        if (windowMs > 0)
+            client = drogon::orm::DbClient::newGroupCommitClient(client, windowMs / 1000, groupCommit.get("max_statements", 32).asUInt());
+        return drogon::orm::DbClient::newSingleFlightClient(client);
+    }();
+    return dbClientPtr;
+}
+
+drogon::orm::DbClientPtr getReadDbClient() {
+    static auto dbClientPtr = drogon::orm::DbClient::newSingleFlightClient(drogon::app().getReadDbClient());
+    return dbClientPtr;
+}
+
+namespace {
+
+struct DeadlineConfig {
+    long defaultMs{0};
+    long maxMs{0};
+    std::map<std::string, long> routes;
+};
+
+const DeadlineConfig &deadlineConfig() {
+    static const DeadlineConfig config = [] {
+        DeadlineConfig config;
+        auto &json = drogon::app().getCustomConfig()["request_deadline"];
+        config.defaultMs = json.get("default_ms", 0).asInt64();
+        config.maxMs = json.get("max_ms", 0).asInt64();
+        auto &routes = json["routes"];
+        for (auto &prefix : routes.getMemberNames()) {
+            config.routes[prefix] = routes[prefix].asInt64();
+        }
+        return config;
+    }();
+    return config;
+}
+
+// Milliseconds the request may take in all, 0 for no deadline
+long requestBudgetMs(const drogon::HttpRequestPtr &req) {
+    auto &config = deadlineConfig();
+    auto &header = req->getHeader("x-request-deadline-ms");
+    if (!header.empty()) {
+        try {
+            auto ms = std::stol(header);
+            if (ms > 0)
+                return config.maxMs > 0 ? std::min(ms, config.maxMs) : ms;
+        } catch (const std::exception &) {
+        }
+    }
+    auto &path = req->path();
+    size_t matched = 0;
+    auto ms = config.defaultMs;
+    for (auto &route : config.routes) {
+        if (route.first.size() > matched && path.compare(0, route.first.size(), route.first) == 0) {
+            matched = route.first.size();
+            ms = route.second;
+        }
+    }
+    return ms;
+}
+
+drogon::orm::DbClientPtr withDeadline(const drogon::orm::DbClientPtr &client, const drogon::HttpRequestPtr &req) {
+    auto ms = requestBudgetMs(req);
+    if (ms <= 0)
+        return client;
+    // The budget counts from when the request came in, not from the handler
+    auto age = trantor::Date::now().microSecondsSinceEpoch() - req->creationDate().microSecondsSinceEpoch();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms) - std::chrono::microseconds(std::max<int64_t>(age, 0));
+    return drogon::orm::DbClient::newDeadlineClient(client, deadline);
+}
+
+}
+
+drogon::orm::DbClientPtr getDbClient(const drogon::HttpRequestPtr &req) {
+    return withDeadline(getDbClient(), req);
+}
+
+drogon::orm::DbClientPtr getReadDbClient(const drogon::HttpRequestPtr &req) {
+    return withDeadline(getReadDbClient(), req);
+}
+
+drogon::orm::DbClientPtr getFreshDbClient(const drogon::HttpRequestPtr &req) {
+    return withDeadline(drogon::app().getDbClient(), req);
+}
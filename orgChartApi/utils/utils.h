@@ -9,3 +9,24 @@ void badRequest (
 );
 
 Json::Value makeErrResp(std::string err);
+
+// The default database client behind a single-flight layer: identical
+// concurrent reads issued by the controllers share one query. With a
+// group_commit window_ms, the writes arriving within it share one commit.
+drogon::orm::DbClientPtr getDbClient();
+
+// The same over the read replicas of the default database, for the handlers
+// that only read. Without replicas it reads from the primary.
+drogon::orm::DbClientPtr getReadDbClient();
+
+// The clients above with the deadline of the request: the time left of the
+// budget in its X-Request-Deadline-Ms header, or else of the longest
+// request_deadline route prefix matching its path, or else of the default.
+// Statements still running past it are cancelled on the server.
+drogon::orm::DbClientPtr getDbClient(const drogon::HttpRequestPtr &req);
+drogon::orm::DbClientPtr getReadDbClient(const drogon::HttpRequestPtr &req);
+
+// The primary with the deadline of the request but without the single-flight
+// layer, for the reads that fill the model cache: a read they would join may
+// have started before a write they must see.
+drogon::orm::DbClientPtr getFreshDbClient(const drogon::HttpRequestPtr &req);